@@ -21,14 +21,16 @@
 #include "Algorithms.h"
 
 #include <algorithm> // Of course we stand on the shoulders of the standard library, rather than reinvent the wheel
+#include <array>
 #include <cmath>
+#include <cstddef>
 
 #include <QDebug>
 #include <QVector>
 
 #include "PhysicalConstants.h"
 #include "measurement/SucroseConversion.h"
-#include "measurement/Unit.h"
+#include "measurement/Quantity.h"
 
 namespace {
 
@@ -37,6 +39,9 @@ namespace {
    double constexpr minPlausibleSpecificGravity = 0.900;
    double constexpr maxPlausibleSpecificGravity = 1.150;
 
+   using Celsius    = Measurement::Quantity<Measurement::StaticUnits::Celsius   >;
+   using Fahrenheit = Measurement::Quantity<Measurement::StaticUnits::Fahrenheit>;
+
    /**
     * \brief returns base^pow for the special case when pow is a positive integer
     *        (The more general case is already covered by pow() in the standard library.)
@@ -52,24 +57,162 @@ namespace {
    // This is the cubic fit to get Plato from specific gravity, measured at 20C
    // relative to density of water at 20C.
    // P = -616.868 + 1111.14(SG) - 630.272(SG)^2 + 135.997(SG)^3
-   Polynomial const platoFromSG_20C20C {
-      Polynomial() << -616.868 << 1111.14 << -630.272 << 135.997
+   //
+   // We hold the coefficients as a plain array as well as a Polynomial because the latter, being backed by a
+   // std::vector, can't be used in constexpr functions, and we want to build the inverse lookup table below at compile
+   // time.
+   double constexpr platoFromSG_20C20C_coeffs[] = {-616.868, 1111.14, -630.272, 135.997};
+   Polynomial const platoFromSG_20C20C {platoFromSG_20C20C_coeffs, 3};
+
+   //! \brief Same as \c platoFromSG_20C20C.eval(sg), but usable at compile time
+   constexpr double platoFromSg_20C20C(double const sg) {
+      return ((platoFromSG_20C20C_coeffs[3]  * sg +
+               platoFromSG_20C20C_coeffs[2]) * sg +
+               platoFromSG_20C20C_coeffs[1]) * sg +
+               platoFromSG_20C20C_coeffs[0];
+   }
+
+   //! \brief First derivative of \c platoFromSg_20C20C with respect to SG
+   constexpr double dPlatoBydSg_20C20C(double const sg) {
+      return (3.0 * platoFromSG_20C20C_coeffs[3]  * sg +
+              2.0 * platoFromSG_20C20C_coeffs[2]) * sg +
+                    platoFromSG_20C20C_coeffs[1];
+   }
+
+   /**
+    * \brief Compile-time Newton-Raphson inversion of \c platoFromSg_20C20C.  This is only used to build
+    *        \c platoToSgTable.  The cubic is monotonic and well-behaved over the range of the table, so a fixed number
+    *        of iterations from a "Plato ≈ 4 × gravity points" starting guess converges to full double precision.
+    */
+   constexpr double sgFromPlato_20C20C_newton(double const plato) {
+      double sg = 1.0 + plato / 260.0;
+      for (int ii = 0; ii < 32; ++ii) {
+         sg -= (platoFromSg_20C20C(sg) - plato) / dPlatoBydSg_20C20C(sg);
+      }
+      return sg;
+   }
+
+   //
+   // Lookup table for Algorithms::PlatoToSG_20C20C.  Rather than root-find on every call, we store, at 1°P intervals,
+   // the SG and dSG/dPlato (which is just 1 / dPlato/dSG), and do cubic Hermite interpolation between nodes.  Since the
+   // function we are approximating is smooth, the interpolation error is bounded by
+   //    (step^4 / 384) × max |d⁴SG/dPlato⁴|
+   // which, over the table range, works out at about 2×10⁻¹¹ SG -- several orders of magnitude smaller than the
+   // ROOT_PRECISION to which the secant root-finding we used to do here converges (and, of course, far smaller than
+   // anything a hydrometer can measure).  The range -29°P to 35°P covers minPlausibleSpecificGravity to
+   // maxPlausibleSpecificGravity; outside it we fall back to root-finding.
+   //
+   struct PlatoToSgNode {
+      double sg;
+      double dSgByDPlato;
    };
+   double      constexpr platoToSgTable_minPlato  = -29.0;
+   double      constexpr platoToSgTable_stepPlato = 1.0;
+   std::size_t constexpr platoToSgTable_size      = 65;
+
+   constexpr std::array<PlatoToSgNode, platoToSgTable_size> makePlatoToSgTable() {
+      std::array<PlatoToSgNode, platoToSgTable_size> table{};
+      for (std::size_t ii = 0; ii < platoToSgTable_size; ++ii) {
+         double const sg = sgFromPlato_20C20C_newton(platoToSgTable_minPlato + ii * platoToSgTable_stepPlato);
+         table[ii] = PlatoToSgNode{sg, 1.0 / dPlatoBydSg_20C20C(sg)};
+      }
+      return table;
+   }
+
+   std::array<PlatoToSgNode, platoToSgTable_size> constexpr platoToSgTable = makePlatoToSgTable();
 
    // Water density polynomial, given in kg/L as a function of degrees C.
    // 1.80544064e-8*x^3 - 6.268385468e-6*x^2 + 3.113930471e-5*x + 0.999924134
-   Polynomial const waterDensityPoly_C {
-      Polynomial() << 0.9999776532 << 6.557692037e-5 << -1.007534371e-5
-         << 1.372076106e-7 << -1.414581892e-9 << 5.6890971e-12
+   double constexpr waterDensityPoly_C_coeffs[] = {
+      0.9999776532, 6.557692037e-5, -1.007534371e-5, 1.372076106e-7, -1.414581892e-9, 5.6890971e-12
    };
+   Polynomial const waterDensityPoly_C {waterDensityPoly_C_coeffs, 5};
 
    // Polynomial in degrees Celsius that gives the additive hydrometer
    // correction for a 15C hydrometer when read at a temperature other
    // than 15C.
-   Polynomial const hydroCorrection15CPoly {
-      Polynomial() << -0.911045 << -16.2853e-3 << 5.84346e-3 << -15.3243e-6
+   double constexpr hydroCorrection15CPoly_coeffs[] = {-0.911045, -16.2853e-3, 5.84346e-3, -15.3243e-6};
+   Polynomial const hydroCorrection15CPoly {hydroCorrection15CPoly_coeffs, 3};
+
+   // Polynomial in degrees Fahrenheit used for hydrometer temperature correction.  See comments in
+   // Algorithms::correctSgForTemperature for where this comes from.
+   double constexpr sgTemperatureCorrectionPoly_F_coeffs[] = {
+      1.00130346, -0.000134722124, 0.00000204052596, -0.00000000232820948
    };
 
+   /**
+    * \brief Evaluate, by Horner's method, the polynomial whose coefficients (lowest order first) are \c coeffs.
+    *
+    *        Unlike \c Polynomial::eval, this has no loop-carried dependency on a heap-allocated vector, so, once it is
+    *        inlined into the batch functions below, the compiler is free to unroll it and vectorise across inputs.
+    */
+   template<std::size_t N>
+   constexpr double horner(double const (&coeffs)[N], double const x) {
+      double ret = coeffs[N - 1];
+      for (std::size_t ii = N - 1; ii > 0; --ii) {
+         ret = ret * x + coeffs[ii - 1];
+      }
+      return ret;
+   }
+
+   //! \brief Helper for batch functions that evaluate a single polynomial on each input
+   template<std::size_t N>
+   void hornerBatch(double const (&coeffs)[N],
+                    BtSpan::span<double const> const input,
+                    BtSpan::span<double> const output,
+                    double const scale = 1.0) {
+      Q_ASSERT(output.size() >= input.size());
+      std::size_t const size = input.size();
+      for (std::size_t ii = 0; ii < size; ++ii) {
+         output[ii] = scale * horner(coeffs, input[ii]);
+      }
+      return;
+   }
+
+   /**
+    * \brief Interpolated lookup of apparent SG @ 20/20°C for \c brix in the USDA data, clamped to the range of the
+    *        data.  (A NaN is treated as being below the range.)
+    *
+    *        Because the Brix column is evenly spaced, we can compute, rather than search for, which row \c brix falls
+    *        in.  There are no branches, so this is suitable for inlining into batch loops.
+    */
+   inline double sucroseSgForBrix(double const brix) {
+      std::size_t const lastRow = Measurement::sucroseConversions_size - 1;
+      // Not std::clamp, as that would pass a NaN through, and converting that to an index is undefined behaviour
+      double const clampedBrix = !(brix > 0.0) ? 0.0 : std::min(brix, Measurement::sucroseBrixColumn[lastRow]);
+      double const position = clampedBrix / Measurement::sucroseConversions_brixStep;
+      std::size_t const index = std::min(static_cast<std::size_t>(position), lastRow - 1);
+      double const positionInRange = position - static_cast<double>(index);
+      double const lowerSg = Measurement::sucroseSgColumn[index];
+      return lowerSg + positionInRange * (Measurement::sucroseSgColumn[index + 1] - lowerSg);
+   }
+
+   /**
+    * \brief Interpolated lookup of Brix for apparent SG @ 20/20°C \c sg in the USDA data, clamped to the range of the
+    *        data.  (A NaN is treated as being below the range.)
+    *
+    *        The SG column is not evenly spaced, so we compute which of the precomputed evenly-spaced buckets \c sg
+    *        falls in, which tells us the row at or just below it (see comments in measurement/SucroseConversion.h).  As
+    *        with \c sucroseSgForBrix, there are no branches.
+    */
+   inline double sucroseBrixForSg(double const sg) {
+      std::size_t const lastRow = Measurement::sucroseConversions_size - 1;
+      // As in sucroseSgForBrix, we can't use std::clamp here because of NaNs
+      double const clampedSg = !(sg > Measurement::sucroseSgBuckets_minSg) ?
+         Measurement::sucroseSgBuckets_minSg : std::min(sg, Measurement::sucroseSgColumn[lastRow]);
+      std::size_t const bucket = std::min(
+         static_cast<std::size_t>((clampedSg - Measurement::sucroseSgBuckets_minSg) / Measurement::sucroseSgBuckets_width),
+         Measurement::sucroseRowBySgBucket.size() - 1
+      );
+      std::size_t index = Measurement::sucroseRowBySgBucket[bucket];
+      index += (Measurement::sucroseSgColumn[index + 1] <= clampedSg) ? 1 : 0;
+      index = std::min(index, lastRow - 1);
+      double const lowerSg = Measurement::sucroseSgColumn[index];
+      double const positionInRange = (clampedSg - lowerSg) / (Measurement::sucroseSgColumn[index + 1] - lowerSg);
+      double const lowerBrix = Measurement::sucroseBrixColumn[index];
+      return lowerBrix + positionInRange * (Measurement::sucroseBrixColumn[index + 1] - lowerBrix);
+   }
+
    /**
     * \brief Convert specific gravity to excess gravity.
     *
@@ -106,79 +249,6 @@ namespace {
       {898, 1007, 12.0, 13.6, 0.135}
    };
 
-   /**
-    * \brief Extension of std::lower_bound to find an interpolated conversion in a sorted range
-    *
-    * \param first As \c std::lower_bound, first \c T in the sorted range
-    * \param last  Different from \c std::lower_bound, last \c T in the sorted range
-    * \param value As \c std::lower_bound, a \c T struct containing the value to convert
-    * \param getFrom Lambda to extract the "from" value from a struct of the type \c T
-    * \param getTo Lambda to extract the "to" value from a struct of the type \c T
-    * \param whatFrom Description for logging of what we're converting from
-    * \param whatTo   Description for logging of what we're converting from
-    */
-   template<class ForwardIt, class T, class GetFrom, class GetTo>
-   double interpolatedConversion(ForwardIt first,
-                                    ForwardIt last,
-                                    T const & value,
-                                    GetFrom getFrom,
-                                    GetTo getTo,
-                                    char const * const whatFrom,
-                                    char const * const whatTo) {
-      auto const firstLarger = std::lower_bound(
-         first,
-         last + 1,
-         value,
-         [& getFrom, & getTo](T const & lhs, T const & rhs) {return getFrom(lhs) < getFrom(rhs);}
-      );
-
-      if (firstLarger == last + 1) {
-         // We're off the end of the array
-         qWarning() <<
-            Q_FUNC_INFO << whatFrom << getFrom(value) << "too large to convert to " << whatTo <<
-            " so using max value of" << getTo(*last);
-         return getTo(*last);
-      }
-
-      // The lower bound is the first element that does not satisfy "element < value" (where value is what we're searching
-      // for.
-      Q_ASSERT(getFrom(*firstLarger) >= getFrom(value));
-
-      // If we found an exact match, then return that
-      if (getFrom(*firstLarger) == getFrom(value)) {
-         return getTo(*firstLarger);
-      }
-
-      if (firstLarger == first) {
-         qWarning() <<
-            Q_FUNC_INFO << whatFrom << getFrom(value) << "too small to convert to " << whatTo <<
-            " so using min value of" << getTo(*first);
-         return getTo(*first);
-      }
-
-      // Since firstLarger is the first element not to satisfy element < value, its predecessor must, by definition,
-      // satisfy this
-      auto const lastSmaller = firstLarger - 1;
-      Q_ASSERT(getFrom(*lastSmaller) < getFrom(value));
-
-      // Now we just do a linear interpolation
-      // positionInRange will be between 0 and 1 and tells us, in relative terms, where the supplied SG is in relation to
-      // lastSmaller and firstLarger.  Eg 0.5 would mean it was exactly half-way between the two.
-      Q_ASSERT(getFrom(*lastSmaller) < getFrom(*firstLarger));
-
-      double const positionInRange =
-         (getFrom(value) - getFrom(*lastSmaller)) / (getFrom(*firstLarger) - getFrom(*lastSmaller));
-      qDebug() <<
-         Q_FUNC_INFO << "Supplied value" << getFrom(value) << whatFrom << " lies" << (100 * positionInRange) << "% "
-         "between" << getFrom(*lastSmaller) << whatFrom << "(=" << getTo(*lastSmaller) << whatTo << ") and" <<
-         getFrom(*firstLarger) << whatFrom << "(=" << getTo(*firstLarger) << whatTo << ")";
-
-      Q_ASSERT(positionInRange >= 0.0);
-      Q_ASSERT(positionInRange <= 1.0);
-
-      return positionInRange * (getTo(*firstLarger) - getTo(*lastSmaller)) + getTo(*lastSmaller);
-   }
-
 }
 
 Polynomial::Polynomial() :
@@ -298,6 +368,31 @@ double Algorithms::SG_20C20C_toPlato(double sg) {
 }
 
 double Algorithms::PlatoToSG_20C20C(double plato) {
+   //
+   // See comment on platoToSgTable for how this works and why it's accurate enough.  Note that, if plato is NaN, the
+   // range check fails and we fall through to root-finding, which is what we want.
+   //
+   double const position = (plato - platoToSgTable_minPlato) / platoToSgTable_stepPlato;
+   if (position >= 0.0 && position < static_cast<double>(platoToSgTable_size - 1)) {
+      std::size_t const index = static_cast<std::size_t>(position);
+      double const t  = position - static_cast<double>(index);
+      double const t2 = t * t;
+      double const t3 = t2 * t;
+      PlatoToSgNode const & lower = platoToSgTable[index];
+      PlatoToSgNode const & upper = platoToSgTable[index + 1];
+      // Cubic Hermite basis functions
+      double const h00 =  2.0 * t3 - 3.0 * t2 + 1.0;
+      double const h10 =        t3 - 2.0 * t2 + t;
+      double const h01 = -2.0 * t3 + 3.0 * t2;
+      double const h11 =        t3 -       t2;
+      return h00 * lower.sg + h10 * platoToSgTable_stepPlato * lower.dSgByDPlato +
+             h01 * upper.sg + h11 * platoToSgTable_stepPlato * upper.dSgByDPlato;
+   }
+
+   return Algorithms::PlatoToSG_20C20C_byRootFinding(plato);
+}
+
+double Algorithms::PlatoToSG_20C20C_byRootFinding(double plato) {
    // Copy the polynomial, cuz we need to alter it.
    Polynomial poly(platoFromSG_20C20C);
 
@@ -345,22 +440,22 @@ double Algorithms::SgAt20CToBrix(double sg) {
 
 
    //
-   // The zeros in searchingFor are dummy values.  We need the struct for std::lower_bound below
-   //
-   // The advantage of using std::lower_bound over std::find_if is that, provided you give it random-access iterators,
-   // the former does O(log N) binary search rather than O(N) linear search.
+   // We used to do a binary search (std::lower_bound) of the data for this, but the data are fixed at compile time, so
+   // we can precompute enough to be able to go straight to the right rows.  See sucroseBrixForSg above.
    //
-   Measurement::SucroseConversion const searchingFor{0, 0, sg};
-   return interpolatedConversion(
-      &Measurement::sucroseConversions[0],
-      &Measurement::sucroseConversions[Measurement::sucroseConversions_size - 1],
-      searchingFor,
-      [](Measurement::SucroseConversion const & value) {return value.apparentSgAt2020C; },
-      [](Measurement::SucroseConversion const & value) {return value.degreesBrix; },
-      "Specific gravity",
-      "Brix"
-   );
-
+   // NB: Written this way round so that NaN also counts as too small, as it did when we searched the table
+   if (!(sg >= Measurement::sucroseSgColumn[0])) {
+      qWarning() <<
+         Q_FUNC_INFO << "Specific gravity" << sg << "too small to convert to Brix so using min value of" <<
+         Measurement::sucroseBrixColumn[0];
+   }
+   double const maxSg = Measurement::sucroseSgColumn[Measurement::sucroseConversions_size - 1];
+   if (sg > maxSg) {
+      qWarning() <<
+         Q_FUNC_INFO << "Specific gravity" << sg << "too large to convert to Brix so using max value of" <<
+         Measurement::sucroseBrixColumn[Measurement::sucroseConversions_size - 1];
+   }
+   return sucroseBrixForSg(sg);
 }
 
 double Algorithms::BrixToSgAt20C(double brix) {
@@ -395,19 +490,13 @@ double Algorithms::BrixToSgAt20C(double brix) {
    //
    // However, instead, we use the same approach as in SgAt20CToBrix of interpolating the USDA observed data.
    //
-   Measurement::SucroseConversion const searchingFor{0, brix, 0};
-
-   return interpolatedConversion(
-      &Measurement::sucroseConversions[0],
-      &Measurement::sucroseConversions[Measurement::sucroseConversions_size - 1],
-      searchingFor,
-      [](Measurement::SucroseConversion const & value) {return value.degreesBrix; },
-      [](Measurement::SucroseConversion const & value) {return value.apparentSgAt2020C; },
-      "Brix",
-      "Specific gravity"
-   );
-
-
+   // Since the Brix values in the data are evenly spaced, we don't need to search for the right rows.  See
+   // sucroseSgForBrix above.
+   //
+   if (brix < 0.0 || brix > Measurement::sucroseBrixColumn[Measurement::sucroseConversions_size - 1]) {
+      qWarning() << Q_FUNC_INFO << "Brix" << brix << "outside range of conversion data, so using nearest value";
+   }
+   return sucroseSgForBrix(brix);
 }
 
 double Algorithms::getPlato(double sugar_kg, double wort_l) {
@@ -587,12 +676,11 @@ double Algorithms::correctSgForTemperature(double measuredSg, double readingTemp
    // https://onlinelibrary.wiley.com/doi/pdf/10.1002/j.2050-0416.1970.tb03327.x for a rather old example.)  Hence the
    // use of non-SI units -- because the people in question were working in Fahrenheit.
    //
-   double tr = Measurement::Units::fahrenheit.fromCanonical(readingTempInC);
-   double tc = Measurement::Units::fahrenheit.fromCanonical(calibrationTempInC);
+   double tr = Fahrenheit{Celsius{readingTempInC}}.value();
+   double tc = Fahrenheit{Celsius{calibrationTempInC}}.value();
 
    double correctedSg = measuredSg * (
-      (1.00130346 - 0.000134722124 * tr + 0.00000204052596 * intPow(tr,2) - 0.00000000232820948 * intPow(tr,3)) /
-      (1.00130346 - 0.000134722124 * tc + 0.00000204052596 * intPow(tc,2) - 0.00000000232820948 * intPow(tc,3))
+      horner(sgTemperatureCorrectionPoly_F_coeffs, tr) / horner(sgTemperatureCorrectionPoly_F_coeffs, tc)
    );
 
    qDebug() <<
@@ -603,3 +691,106 @@ double Algorithms::correctSgForTemperature(double measuredSg, double readingTemp
    return correctedSg;
 
 }
+
+//======================================================================================================================
+// Batch versions
+//======================================================================================================================
+void Algorithms::SG_20C20C_toPlato(BtSpan::span<double const> sg, BtSpan::span<double> plato) {
+   hornerBatch(platoFromSG_20C20C_coeffs, sg, plato);
+   return;
+}
+
+void Algorithms::PlatoToSG_20C20C(BtSpan::span<double const> plato, BtSpan::span<double> sg) {
+   Q_ASSERT(sg.size() >= plato.size());
+   std::size_t const size = plato.size();
+
+   //
+   // First pass is the same Hermite interpolation as the scalar version, but with the table index clamped rather than
+   // range-checked, so there is no branch in the loop.  (Inputs off either end of the table just get extrapolated from
+   // the nearest interval, and are fixed up in the second pass.)  Note that std::clamp would pass a NaN straight
+   // through, and casting that to an index is undefined behaviour, so the clamp is written so that NaN maps to 0.  The
+   // result for a NaN input is then garbage, but it's out of range, so it too gets replaced in the second pass.
+   //
+   double constexpr maxIndex = static_cast<double>(platoToSgTable_size - 2);
+   bool anyOutOfRange = false;
+   for (std::size_t ii = 0; ii < size; ++ii) {
+      double const position = (plato[ii] - platoToSgTable_minPlato) / platoToSgTable_stepPlato;
+      double const clamped = !(position >= 0.0) ? 0.0 : std::min(position, maxIndex);
+      std::size_t const index = static_cast<std::size_t>(clamped);
+      double const t  = position - static_cast<double>(index);
+      double const t2 = t * t;
+      double const t3 = t2 * t;
+      PlatoToSgNode const & lower = platoToSgTable[index];
+      PlatoToSgNode const & upper = platoToSgTable[index + 1];
+      sg[ii] = ( 2.0 * t3 - 3.0 * t2 + 1.0) * lower.sg +
+               (       t3 - 2.0 * t2 + t  ) * platoToSgTable_stepPlato * lower.dSgByDPlato +
+               (-2.0 * t3 + 3.0 * t2      ) * upper.sg +
+               (       t3 -       t2      ) * platoToSgTable_stepPlato * upper.dSgByDPlato;
+      anyOutOfRange |= !(position >= 0.0 && position < maxIndex + 1.0);
+   }
+
+   //
+   // Second pass, which should almost never be needed in practice, is to root-find for anything outside the table
+   //
+   if (anyOutOfRange) {
+      for (std::size_t ii = 0; ii < size; ++ii) {
+         double const position = (plato[ii] - platoToSgTable_minPlato) / platoToSgTable_stepPlato;
+         if (!(position >= 0.0 && position < maxIndex + 1.0)) {
+            sg[ii] = Algorithms::PlatoToSG_20C20C_byRootFinding(plato[ii]);
+         }
+      }
+   }
+   return;
+}
+
+void Algorithms::SgAt20CToBrix(BtSpan::span<double const> sg, BtSpan::span<double> brix) {
+   Q_ASSERT(brix.size() >= sg.size());
+   // Same lookup as the scalar version (including giving 0 Brix for SG <= 1.000), but without the logging
+   std::size_t const size = sg.size();
+   for (std::size_t ii = 0; ii < size; ++ii) {
+      brix[ii] = sucroseBrixForSg(sg[ii]);
+   }
+   return;
+}
+
+void Algorithms::BrixToSgAt20C(BtSpan::span<double const> brix, BtSpan::span<double> sg) {
+   Q_ASSERT(sg.size() >= brix.size());
+   std::size_t const size = brix.size();
+   for (std::size_t ii = 0; ii < size; ++ii) {
+      sg[ii] = sucroseSgForBrix(brix[ii]);
+   }
+   return;
+}
+
+void Algorithms::getWaterDensity_kgL(BtSpan::span<double const> celsius, BtSpan::span<double> density_kgL) {
+   hornerBatch(waterDensityPoly_C_coeffs, celsius, density_kgL);
+   return;
+}
+
+void Algorithms::hydrometer15CCorrection(BtSpan::span<double const> celsius, BtSpan::span<double> correction) {
+   hornerBatch(hydroCorrection15CPoly_coeffs, celsius, correction, 1e-3);
+   return;
+}
+
+void Algorithms::refractiveIndex(BtSpan::span<double const> plato, BtSpan::span<double> ri) {
+   double constexpr refractiveIndexPoly_coeffs[] = {1.33302, 0.001427193, 0.000005791157};
+   hornerBatch(refractiveIndexPoly_coeffs, plato, ri);
+   return;
+}
+
+void Algorithms::correctSgForTemperature(BtSpan::span<double const> measuredSg,
+                                         BtSpan::span<double const> readingTempInC,
+                                         double calibrationTempInC,
+                                         BtSpan::span<double> correctedSg) {
+   Q_ASSERT(readingTempInC.size() >= measuredSg.size());
+   Q_ASSERT(correctedSg.size() >= measuredSg.size());
+   // The denominator only depends on the calibration temperature, so only needs calculating once
+   double const tc = Fahrenheit{Celsius{calibrationTempInC}}.value();
+   double const denominator = horner(sgTemperatureCorrectionPoly_F_coeffs, tc);
+   std::size_t const size = measuredSg.size();
+   for (std::size_t ii = 0; ii < size; ++ii) {
+      double const tr = Fahrenheit{Celsius{readingTempInC[ii]}}.value();
+      correctedSg[ii] = measuredSg[ii] * horner(sgTemperatureCorrectionPoly_F_coeffs, tr) / denominator;
+   }
+   return;
+}
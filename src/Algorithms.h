@@ -31,6 +31,8 @@
 #include <QColor>
 #include <QList>
 
+#include "utils/Span.h"
+
 /*!
  * \brief Class to encapsulate real polynomials in a single variable
  *
@@ -111,8 +113,15 @@ namespace Algorithms {
 
    //! \returns plato of \b sg
    double SG_20C20C_toPlato( double sg );
-   //! \returns sg of \b plato
+   /*!
+    * \returns sg of \b plato
+    *
+    * For plausible gravities, this uses a precomputed lookup table (see Algorithms.cpp), which agrees with
+    * \c PlatoToSG_20C20C_byRootFinding to better than 1e-10 SG.
+    */
    double PlatoToSG_20C20C( double plato );
+   //! \returns sg of \b plato, by root-finding on the inverse function.  Slower but valid over a wider range.
+   double PlatoToSG_20C20C_byRootFinding( double plato );
 
    //! \brief Convert Specific Gravity (measured at 20°C) to Brix
    double SgAt20CToBrix(double sg);
@@ -156,6 +165,27 @@ namespace Algorithms {
    double abvFromOgAndFg(double og, double fg);
    //! \brief Correct specific gravity reading for the temperature at which it was taken
    double correctSgForTemperature(double measuredSg, double readingTempInC, double calibrationTempInC);
+
+   //===================Batch versions=====================
+   //
+   // These are for converting large numbers of readings (eg when importing fermentation logs).  Each applies the
+   // scalar function of the same name to every element of the input span(s), writing the results to the corresponding
+   // elements of the output span, which must be at least as long as the input.  Results agree with the scalar versions
+   // to within floating-point rounding, but the loops are written without per-element branches, function calls or
+   // logging so that the compiler can vectorise them.
+   //
+   void SG_20C20C_toPlato(BtSpan::span<double const> sg, BtSpan::span<double> plato);
+   void PlatoToSG_20C20C(BtSpan::span<double const> plato, BtSpan::span<double> sg);
+   void SgAt20CToBrix(BtSpan::span<double const> sg, BtSpan::span<double> brix);
+   void BrixToSgAt20C(BtSpan::span<double const> brix, BtSpan::span<double> sg);
+   void getWaterDensity_kgL(BtSpan::span<double const> celsius, BtSpan::span<double> density_kgL);
+   void hydrometer15CCorrection(BtSpan::span<double const> celsius, BtSpan::span<double> correction);
+   void refractiveIndex(BtSpan::span<double const> plato, BtSpan::span<double> ri);
+   //! \param readingTempInC must be at least as long as \c measuredSg
+   void correctSgForTemperature(BtSpan::span<double const> measuredSg,
+                                BtSpan::span<double const> readingTempInC,
+                                double calibrationTempInC,
+                                BtSpan::span<double> correctedSg);
 }
 
 #endif
@@ -0,0 +1,332 @@
+/*
+ * BatchPlannerDialog.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BatchPlannerDialog.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QComboBox>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "BatchPlanning.h"
+#include "database/ObjectStoreWrapper.h"
+#include "measurement/Measurement.h"
+#include "model/Recipe.h"
+
+namespace {
+   // Columns of the queue table
+   int constexpr queueColumn_recipe  = 0;
+   int constexpr queueColumn_batches = 1;
+   int constexpr queueColumn_status  = 2;
+
+   // Nobody is going to queue more batches of one recipe than this
+   int constexpr maxBatches = 99;
+
+   QTableWidget * makeTable(int const numColumns, QWidget * parent) {
+      auto table = new QTableWidget(0, numColumns, parent);
+      table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+      table->setSelectionBehavior(QAbstractItemView::SelectRows);
+      table->setSelectionMode(QAbstractItemView::SingleSelection);
+      table->verticalHeader()->setVisible(false);
+      table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+      for (int column = 1; column < numColumns; ++column) {
+         table->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+      }
+      return table;
+   }
+
+   QTableWidgetItem * makeAmountItem(BatchPlanning::Item const & item, double const amount) {
+      auto tableItem = new QTableWidgetItem(
+         Measurement::displayAmount(
+            Measurement::Amount{amount, item.byVolume ? Measurement::Units::liters : Measurement::Units::kilograms}
+         )
+      );
+      tableItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+      return tableItem;
+   }
+}
+
+// This private implementation class holds all private non-virtual members of BatchPlannerDialog
+class BatchPlannerDialog::impl {
+public:
+   impl(BatchPlannerDialog & self) :
+      self              {self},
+      groupBox_queue    {new QGroupBox  (&self)},
+      comboBox_recipe   {new QComboBox  (&self)},
+      pushButton_add    {new QPushButton(&self)},
+      pushButton_remove {new QPushButton(&self)},
+      pushButton_up     {new QPushButton(&self)},
+      table_queue       {makeTable(3, &self)},
+      groupBox_purchase {new QGroupBox  (&self)},
+      table_purchase    {makeTable(4, &self)},
+      label_summary     {new QLabel     (&self)} {
+      this->doLayout();
+      this->retranslateUi();
+      connect(this->pushButton_add,    &QAbstractButton::clicked, &self, [this]() { this->addSelectedRecipe(); return; });
+      connect(this->pushButton_remove, &QAbstractButton::clicked, &self, [this]() { this->removeCurrentRow();  return; });
+      connect(this->pushButton_up,     &QAbstractButton::clicked, &self, [this]() { this->moveCurrentRowUp();  return; });
+      return;
+   }
+
+   ~impl() = default;
+
+   void doLayout() {
+      auto buttonRow = new QHBoxLayout();
+      buttonRow->addWidget(this->comboBox_recipe, 1);
+      buttonRow->addWidget(this->pushButton_add);
+      buttonRow->addWidget(this->pushButton_remove);
+      buttonRow->addWidget(this->pushButton_up);
+      auto queueLayout = new QVBoxLayout(this->groupBox_queue);
+      queueLayout->addLayout(buttonRow);
+      queueLayout->addWidget(this->table_queue);
+
+      auto purchaseLayout = new QVBoxLayout(this->groupBox_purchase);
+      purchaseLayout->addWidget(this->table_purchase);
+
+      auto mainLayout = new QVBoxLayout(&self);
+      mainLayout->addWidget(this->groupBox_queue);
+      mainLayout->addWidget(this->groupBox_purchase);
+      mainLayout->addWidget(this->label_summary);
+      return;
+   }
+
+   void retranslateUi() {
+      self.setWindowTitle(tr("Batch Planner"));
+      this->groupBox_queue->setTitle(tr("Brew queue"));
+      this->pushButton_add   ->setText(tr("Add"));
+      this->pushButton_remove->setText(tr("Remove"));
+      this->pushButton_up    ->setText(tr("Move Up"));
+      this->groupBox_purchase->setTitle(tr("Purchase list"));
+      this->table_queue   ->setHorizontalHeaderLabels({tr("Recipe"), tr("Batches"), tr("Status")});
+      this->table_purchase->setHorizontalHeaderLabels({tr("Ingredient"), tr("Needed"), tr("In stock"), tr("To buy")});
+#ifndef QT_NO_TOOLTIP
+      this->table_queue->setToolTip(
+         tr("Brews get ingredients in queue order, so if two need the last of something, the first one can be brewed")
+      );
+      this->table_purchase->setToolTip(tr("Everything the whole queue needs that there isn't enough of in stock"));
+#endif
+      if (this->table_queue->rowCount() > 0) {
+         this->plan();
+      }
+      return;
+   }
+
+   //! \brief Refill the list of recipes that can be added, keeping the current selection if it's still there
+   void loadRecipes() {
+      int const selectedId = this->comboBox_recipe->currentData().toInt();
+      QList<Recipe *> recipes = ObjectStoreWrapper::getAllDisplayableRaw<Recipe>();
+      std::sort(recipes.begin(), recipes.end(), [](Recipe const * lhs, Recipe const * rhs) {
+         return QString::localeAwareCompare(lhs->name(), rhs->name()) < 0;
+      });
+
+      QSignalBlocker blocker{this->comboBox_recipe};
+      this->comboBox_recipe->clear();
+      for (Recipe const * recipe : recipes) {
+         this->comboBox_recipe->addItem(recipe->name(), recipe->key());
+      }
+      int const selectedIndex = this->comboBox_recipe->findData(selectedId);
+      if (selectedIndex >= 0) {
+         this->comboBox_recipe->setCurrentIndex(selectedIndex);
+      }
+      return;
+   }
+
+   //! \brief Recipe ID and number of batches of each row of the queue table, in order
+   BatchPlanner::Queue queue() const {
+      BatchPlanner::Queue result;
+      for (int row = 0; row < this->table_queue->rowCount(); ++row) {
+         auto spinBox = qobject_cast<QSpinBox *>(this->table_queue->cellWidget(row, queueColumn_batches));
+         result.append(qMakePair(this->table_queue->item(row, queueColumn_recipe)->data(Qt::UserRole).toInt(),
+                                 spinBox ? spinBox->value() : 1));
+      }
+      return result;
+   }
+
+   void addRow(int const recipeId, QString const & name, int const batches) {
+      for (int row = 0; row < this->table_queue->rowCount(); ++row) {
+         if (this->table_queue->item(row, queueColumn_recipe)->data(Qt::UserRole).toInt() == recipeId) {
+            return;
+         }
+      }
+
+      int const row = this->table_queue->rowCount();
+      this->table_queue->insertRow(row);
+      auto nameItem = new QTableWidgetItem(name);
+      nameItem->setData(Qt::UserRole, recipeId);
+      this->table_queue->setItem(row, queueColumn_recipe, nameItem);
+      auto spinBox = new QSpinBox(this->table_queue);
+      spinBox->setRange(1, maxBatches);
+      spinBox->setValue(batches);
+      connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged), &self, &BatchPlannerDialog::plan);
+      this->table_queue->setCellWidget(row, queueColumn_batches, spinBox);
+      this->table_queue->setItem(row, queueColumn_status, new QTableWidgetItem());
+      return;
+   }
+
+   void addSelectedRecipe() {
+      if (this->comboBox_recipe->currentIndex() < 0) {
+         return;
+      }
+      this->addRow(this->comboBox_recipe->currentData().toInt(), this->comboBox_recipe->currentText(), 1);
+      this->plan();
+      return;
+   }
+
+   void removeCurrentRow() {
+      int const row = this->table_queue->currentRow();
+      if (row < 0) {
+         return;
+      }
+      this->table_queue->removeRow(row);
+      this->plan();
+      return;
+   }
+
+   void moveCurrentRowUp() {
+      int const row = this->table_queue->currentRow();
+      if (row <= 0) {
+         return;
+      }
+      //
+      // Cell widgets can't be moved between rows, so we rebuild the queue in the new order.  It's only ever a handful
+      // of rows.
+      //
+      BatchPlanner::Queue newQueue = this->queue();
+      std::swap(newQueue[row - 1], newQueue[row]);
+      QStringList names;
+      for (int ii = 0; ii < this->table_queue->rowCount(); ++ii) {
+         names.append(this->table_queue->item(ii, queueColumn_recipe)->text());
+      }
+      std::swap(names[row - 1], names[row]);
+      this->table_queue->setRowCount(0);
+      for (int ii = 0; ii < newQueue.size(); ++ii) {
+         this->addRow(newQueue.at(ii).first, names.at(ii), newQueue.at(ii).second);
+      }
+      this->table_queue->setCurrentCell(row - 1, queueColumn_recipe);
+      this->plan();
+      return;
+   }
+
+   void plan() {
+      QElapsedTimer timer;
+      timer.start();
+
+      BatchPlanner::Queue const queue = this->queue();
+      BatchPlanning::Plan const & plan = BatchPlanner::instance().plan(queue);
+
+      // Recipes deleted since they were queued get skipped by the planner, so we match results to rows by recipe ID
+      QHash<int, BatchPlanning::BrewResult const *> brewsByRecipe;
+      for (BatchPlanning::BrewResult const & brew : plan.brews) {
+         brewsByRecipe.insert(brew.recipeId, &brew);
+      }
+      int numBrewable = 0;
+      for (int row = 0; row < queue.size(); ++row) {
+         QTableWidgetItem * statusItem = this->table_queue->item(row, queueColumn_status);
+         BatchPlanning::BrewResult const * brew = brewsByRecipe.value(queue.at(row).first, nullptr);
+         if (!brew) {
+            statusItem->setText(tr("Recipe no longer exists"));
+         } else if (brew->canBrew) {
+            statusItem->setText(tr("Can brew"));
+            ++numBrewable;
+         } else {
+            statusItem->setText(tr("Short of %1").arg(brew->missing.join(", ")));
+         }
+      }
+
+      QVector<BatchPlanning::Requirement> const toBuy = plan.purchaseList();
+      this->table_purchase->setRowCount(toBuy.size());
+      for (int row = 0; row < toBuy.size(); ++row) {
+         BatchPlanning::Requirement const & requirement = toBuy.at(row);
+         this->table_purchase->setItem(row, 0, new QTableWidgetItem(requirement.item.name));
+         this->table_purchase->setItem(row, 1, makeAmountItem(requirement.item, requirement.required));
+         this->table_purchase->setItem(row, 2, makeAmountItem(requirement.item, requirement.available));
+         this->table_purchase->setItem(row, 3, makeAmountItem(requirement.item, requirement.shortfall()));
+      }
+
+      this->label_summary->setText(
+         tr("%1 of %2 queued brews can be made from stock (planned in %3 ms)").arg(numBrewable)
+                                                                             .arg(queue.size())
+                                                                             .arg(timer.elapsed())
+      );
+      return;
+   }
+
+   BatchPlannerDialog & self;
+   QGroupBox        * groupBox_queue;
+   QComboBox        * comboBox_recipe;
+   QPushButton      * pushButton_add;
+   QPushButton      * pushButton_remove;
+   QPushButton      * pushButton_up;
+   QTableWidget     * table_queue;
+   QGroupBox        * groupBox_purchase;
+   QTableWidget     * table_purchase;
+   QLabel           * label_summary;
+};
+
+BatchPlannerDialog::BatchPlannerDialog(QWidget * parent) : QDialog(parent),
+                                                           pimpl{std::make_unique<impl>(*this)} {
+   return;
+}
+
+BatchPlannerDialog::~BatchPlannerDialog() = default;
+
+void BatchPlannerDialog::addToQueue(Recipe * recipe) {
+   if (!recipe) {
+      return;
+   }
+   this->pimpl->addRow(recipe->key(), recipe->name(), 1);
+   if (this->isVisible()) {
+      this->plan();
+   }
+   return;
+}
+
+void BatchPlannerDialog::plan() {
+   this->pimpl->plan();
+   return;
+}
+
+void BatchPlannerDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->retranslateUi();
+   }
+   // Let base class do its work too
+   this->QDialog::changeEvent(event);
+   return;
+}
+
+void BatchPlannerDialog::showEvent(QShowEvent * event) {
+   this->pimpl->loadRecipes();
+   this->plan();
+   // Let base class do its work too
+   this->QDialog::showEvent(event);
+   return;
+}
@@ -0,0 +1,60 @@
+/*
+ * BatchPlannerDialog.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BATCHPLANNERDIALOG_H
+#define BATCHPLANNERDIALOG_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QDialog>
+
+class QEvent;
+class QShowEvent;
+class QWidget;
+class Recipe;
+
+/*!
+ * \brief Lets the user queue up brews and shows which of them can be brewed from what's in the inventory, and what
+ *        needs to be bought for the rest.  See \c BatchPlanning for how ingredients are matched to stock.
+ */
+class BatchPlannerDialog : public QDialog {
+   Q_OBJECT
+
+public:
+   BatchPlannerDialog(QWidget * parent = nullptr);
+   virtual ~BatchPlannerDialog();
+
+   //! \brief Add a recipe to the end of the queue, unless it's already in it
+   void addToQueue(Recipe * recipe);
+
+public slots:
+   //! \brief Redo the plan for the current queue
+   void plan();
+
+protected:
+   virtual void changeEvent(QEvent * event);
+   virtual void showEvent(QShowEvent * event);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
@@ -0,0 +1,314 @@
+/*
+ * BatchPlanning.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BatchPlanning.h"
+
+#include <QDebug>
+
+#include "database/ObjectStoreWrapper.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Inventory.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/Yeast.h"
+
+namespace {
+   // Amounts are doubles in kg or L, so we allow for a little rounding when deciding whether we have enough
+   double constexpr tolerance = 1e-9;
+
+   std::size_t indexOf(BatchPlanning::Kind const kind) {
+      return static_cast<std::size_t>(kind);
+   }
+
+   QString normalisedName(QString const & name) {
+      return name.simplified().toLower();
+   }
+
+   /**
+    * \brief A recipe's copy of an ingredient should share its parent's inventory, but older databases (and some
+    *        imports) have copies without one, in which case we use the parent's.
+    */
+   int inventoryIdOf(NamedEntityWithInventory const & ingredient) {
+      if (ingredient.inventoryId() > 0) {
+         return ingredient.inventoryId();
+      }
+      auto parent = dynamic_cast<NamedEntityWithInventory const *>(ingredient.getParent());
+      return parent ? parent->inventoryId() : 0;
+   }
+
+   template<class NE>
+   void addStock(BatchPlanning::Stock & stock,
+                 BatchPlanning::Kind const kind,
+                 bool (NE::*amountIsWeight)() const = nullptr) {
+      auto stocked = ObjectStoreWrapper::findAllMatching<NE>(
+         [](std::shared_ptr<NE> ne) { return (ne->getParent() == nullptr && !ne->deleted() && ne->inventory() > 0.0); }
+      );
+      for (auto ne : stocked) {
+         // Inventory is in the same units as the ingredient's own amount
+         stock.add(BatchPlanning::Item{kind,
+                                       ne->name(),
+                                       ne->inventoryId(),
+                                       ne->inventory(),
+                                       amountIsWeight ? !((*ne).*amountIsWeight)() : false});
+      }
+      return;
+   }
+
+   template<class NE>
+   void addItems(QVector<BatchPlanning::Item> & items,
+                 QList<NE *> const & ingredients,
+                 BatchPlanning::Kind const kind,
+                 double (NE::*amount)() const,
+                 bool (NE::*amountIsWeight)() const = nullptr) {
+      for (NE const * ingredient : ingredients) {
+         items.append(BatchPlanning::Item{kind,
+                                          ingredient->name(),
+                                          inventoryIdOf(*ingredient),
+                                          (ingredient->*amount)(),
+                                          amountIsWeight ? !(ingredient->*amountIsWeight)() : false});
+      }
+      return;
+   }
+}
+
+QVector<BatchPlanning::Item> BatchPlanning::itemsOf(Recipe const & recipe) {
+   QVector<BatchPlanning::Item> items;
+   using BatchPlanning::Kind;
+   addItems<Fermentable>(items, recipe.fermentables(), Kind::Fermentable, &Fermentable::amount_kg);
+   addItems<Hop>        (items, recipe.hops(),         Kind::Hop,         &Hop::amount_kg);
+   addItems<Misc>       (items, recipe.miscs(),        Kind::Misc,        &Misc::amount,  &Misc::amountIsWeight);
+   addItems<Yeast>      (items, recipe.yeasts(),       Kind::Yeast,       &Yeast::amount, &Yeast::amountIsWeight);
+   return items;
+}
+
+bool BatchPlanning::Stock::NameKey::operator==(NameKey const & other) const {
+   return this->kind == other.kind && this->byVolume == other.byVolume && this->name == other.name;
+}
+
+namespace BatchPlanning {
+   uint qHash(Stock::NameKey const & key, uint seed) {
+      return ::qHash(key.name, seed) ^ ::qHash(static_cast<int>(indexOf(key.kind) * 2 + (key.byVolume ? 1 : 0)), seed);
+   }
+}
+
+BatchPlanning::Stock::Stock() : m_rows{}, m_rowsByInventoryId{}, m_rowsByName{} {
+   return;
+}
+
+BatchPlanning::Stock BatchPlanning::Stock::fromDatabase() {
+   BatchPlanning::Stock stock;
+   addStock<Fermentable>(stock, BatchPlanning::Kind::Fermentable);
+   addStock<Hop>        (stock, BatchPlanning::Kind::Hop);
+   addStock<Misc>       (stock, BatchPlanning::Kind::Misc,  &Misc::amountIsWeight);
+   addStock<Yeast>      (stock, BatchPlanning::Kind::Yeast, &Yeast::amountIsWeight);
+   qDebug() << Q_FUNC_INFO << "Read" << stock.numRows() << "stocked ingredients";
+   return stock;
+}
+
+void BatchPlanning::Stock::add(Item const & item) {
+   auto & rowsByInventoryId = this->m_rowsByInventoryId[indexOf(item.kind)];
+   if (item.inventoryId > 0 && rowsByInventoryId.contains(item.inventoryId)) {
+      return;
+   }
+
+   int const row = this->m_rows.size();
+   this->m_rows.append(item);
+   if (item.inventoryId > 0) {
+      rowsByInventoryId.insert(item.inventoryId, row);
+   }
+   // If two stocked ingredients have the same name, matching by name picks the first one
+   NameKey const nameKey{item.kind, normalisedName(item.name), item.byVolume};
+   if (!this->m_rowsByName.contains(nameKey)) {
+      this->m_rowsByName.insert(nameKey, row);
+   }
+   return;
+}
+
+int BatchPlanning::Stock::rowFor(Item const & usage) {
+   if (usage.inventoryId > 0) {
+      auto match = this->m_rowsByInventoryId[indexOf(usage.kind)].constFind(usage.inventoryId);
+      if (match != this->m_rowsByInventoryId[indexOf(usage.kind)].constEnd()) {
+         return match.value();
+      }
+   }
+
+   auto match = this->m_rowsByName.constFind(NameKey{usage.kind, normalisedName(usage.name), usage.byVolume});
+   if (match != this->m_rowsByName.constEnd()) {
+      return match.value();
+   }
+
+   // Not in stock, so we'll need to buy all of it
+   Item unstocked = usage;
+   unstocked.amount = 0.0;
+   this->add(unstocked);
+   return this->m_rows.size() - 1;
+}
+
+int BatchPlanning::Stock::numRows() const {
+   return this->m_rows.size();
+}
+
+BatchPlanning::Item const & BatchPlanning::Stock::row(int const index) const {
+   return this->m_rows.at(index);
+}
+
+double BatchPlanning::Requirement::shortfall() const {
+   return this->required > this->available + tolerance ? this->required - this->available : 0.0;
+}
+
+QVector<BatchPlanning::Requirement> BatchPlanning::Plan::purchaseList() const {
+   QVector<BatchPlanning::Requirement> toBuy;
+   for (BatchPlanning::Requirement const & requirement : this->requirements) {
+      if (requirement.shortfall() > 0.0) {
+         toBuy.append(requirement);
+      }
+   }
+   return toBuy;
+}
+
+BatchPlanning::Plan BatchPlanning::plan(Stock & stock, QVector<Brew> const & queue) {
+   BatchPlanning::Plan result;
+   result.brews.reserve(queue.size());
+
+   // Indexed by stock row.  Entries are only made for rows that something in the queue needs.
+   QHash<int, int> requirementIndex;
+   QVector<double> remaining;
+
+   for (BatchPlanning::Brew const & brew : queue) {
+      //
+      // A recipe can use the same ingredient more than once (eg a hop for bittering and again for aroma), so first
+      // add up what this brew needs from each row.  We keep the rows in the order first used so the missing list
+      // reads in recipe order.
+      //
+      QVector<int> rows;
+      QHash<int, double> needed;
+      for (BatchPlanning::Item const & item : brew.items) {
+         int const row = stock.rowFor(item);
+         if (!needed.contains(row)) {
+            rows.append(row);
+         }
+         needed[row] += item.amount * brew.batches;
+      }
+
+      BatchPlanning::BrewResult brewResult{brew.recipeId, brew.recipeName, brew.batches, true, {}};
+      for (int const row : rows) {
+         int index = requirementIndex.value(row, -1);
+         if (index < 0) {
+            index = result.requirements.size();
+            requirementIndex.insert(row, index);
+            BatchPlanning::Item const & stocked = stock.row(row);
+            result.requirements.append(BatchPlanning::Requirement{stocked, 0.0, stocked.amount});
+            remaining.append(stocked.amount);
+         }
+         result.requirements[index].required += needed.value(row);
+         if (needed.value(row) > remaining.at(index) + tolerance) {
+            brewResult.canBrew = false;
+            brewResult.missing.append(stock.row(row).name);
+         }
+      }
+
+      // Only a brew we can actually make uses up stock
+      if (brewResult.canBrew) {
+         for (int const row : rows) {
+            remaining[requirementIndex.value(row)] -= needed.value(row);
+         }
+      }
+      result.brews.append(brewResult);
+   }
+
+   return result;
+}
+
+BatchPlanner & BatchPlanner::instance() {
+   static BatchPlanner singleton;
+   return singleton;
+}
+
+BatchPlanner::BatchPlanner() :
+   QObject{},
+   m_connected{false},
+   m_stock{},
+   m_queue{},
+   m_plan{} {
+   return;
+}
+
+BatchPlanner::~BatchPlanner() = default;
+
+template<class NE> void BatchPlanner::listenTo(void (BatchPlanner::*slot)()) {
+   ObjectStoreTyped<NE> & objectStore = ObjectStoreTyped<NE>::getInstance();
+   connect(&objectStore, &ObjectStoreTyped<NE>::signalObjectInserted,  this, slot);
+   connect(&objectStore, &ObjectStoreTyped<NE>::signalObjectDeleted,   this, slot);
+   connect(&objectStore, &ObjectStoreTyped<NE>::signalPropertyChanged, this, slot);
+   return;
+}
+
+BatchPlanning::Plan const & BatchPlanner::plan(Queue const & queue) {
+   if (!this->m_connected) {
+      //
+      // Stock amounts live in the inventory stores, but names, units and which ingredient is whose parent live in the
+      // ingredient stores -- as do the amounts used in recipes, which are on the recipes' copies of ingredients.
+      //
+      this->listenTo<InventoryFermentable>(&BatchPlanner::stockChanged);
+      this->listenTo<InventoryHop        >(&BatchPlanner::stockChanged);
+      this->listenTo<InventoryMisc       >(&BatchPlanner::stockChanged);
+      this->listenTo<InventoryYeast      >(&BatchPlanner::stockChanged);
+      this->listenTo<Fermentable         >(&BatchPlanner::stockChanged);
+      this->listenTo<Hop                 >(&BatchPlanner::stockChanged);
+      this->listenTo<Misc                >(&BatchPlanner::stockChanged);
+      this->listenTo<Yeast               >(&BatchPlanner::stockChanged);
+      this->listenTo<Recipe              >(&BatchPlanner::recipesChanged);
+      this->m_connected = true;
+   }
+
+   if (this->m_stock && this->m_queue && *this->m_queue == queue) {
+      return this->m_plan;
+   }
+
+   if (!this->m_stock) {
+      this->m_stock = BatchPlanning::Stock::fromDatabase();
+   }
+
+   QVector<BatchPlanning::Brew> brews;
+   brews.reserve(queue.size());
+   for (auto const & [recipeId, batches] : queue) {
+      Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId);
+      if (!recipe) {
+         qWarning() << Q_FUNC_INFO << "Skipping unknown recipe #" << recipeId;
+         continue;
+      }
+      brews.append(BatchPlanning::Brew{recipeId, recipe->name(), batches, BatchPlanning::itemsOf(*recipe)});
+   }
+
+   this->m_plan = BatchPlanning::plan(*this->m_stock, brews);
+   this->m_queue = queue;
+   return this->m_plan;
+}
+
+void BatchPlanner::stockChanged() {
+   this->m_stock.reset();
+   this->m_queue.reset();
+   return;
+}
+
+void BatchPlanner::recipesChanged() {
+   // Stock is unaffected, but any plan might have used the recipe that changed
+   this->m_queue.reset();
+   return;
+}
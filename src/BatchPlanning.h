@@ -0,0 +1,185 @@
+/*
+ * BatchPlanning.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BATCHPLANNING_H
+#define BATCHPLANNING_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class Recipe;
+
+/*!
+ * \namespace BatchPlanning
+ *
+ * \brief Works out, for a queue of brews, which of them we can brew with what's in stock and what we need to buy.
+ *
+ *        Stock is read once into a \c Stock table.  Each ingredient a recipe uses is then matched to a row of that
+ *        table: first by its inventory (which a recipe's copy of an ingredient normally shares with the original in the
+ *        ingredient list), then by the inventory of the ingredient it was copied from, and finally by name and unit.
+ *        Ingredients that don't match anything get a row with nothing in stock, so they end up on the purchase list.
+ */
+namespace BatchPlanning {
+
+   enum class Kind {
+      Fermentable,
+      Hop,
+      Misc,
+      Yeast
+   };
+   std::size_t constexpr numKinds = 4;
+
+   //! \brief One ingredient used in a recipe, or held in stock
+   struct Item {
+      Kind kind = Kind::Fermentable;
+      QString name;
+      //! \brief Inventory ID, or 0 (or less) if none
+      int inventoryId = 0;
+      //! \brief In kg, or in L if \c byVolume
+      double amount = 0.0;
+      bool byVolume = false;
+   };
+
+   //! \brief The ingredients of a recipe, as needed for planning
+   QVector<Item> itemsOf(Recipe const & recipe);
+
+   /**
+    * \brief Materialised inventory: one row per stocked ingredient, plus rows added for anything recipes need that
+    *        isn't stocked
+    */
+   class Stock {
+   public:
+      Stock();
+
+      //! \brief All the ingredients in the ingredient lists (ie not recipes' copies of them)
+      static Stock fromDatabase();
+
+      //! \brief Add a stocked ingredient.  A second item with the same inventory ID is ignored.
+      void add(Item const & item);
+
+      /**
+       * \brief Row for an ingredient a recipe uses, adding one (with nothing in stock) if nothing matches
+       */
+      int rowFor(Item const & usage);
+
+      int numRows() const;
+      Item const & row(int index) const;
+
+   private:
+      struct NameKey {
+         Kind kind;
+         QString name;
+         bool byVolume;
+         bool operator==(NameKey const & other) const;
+      };
+      friend uint qHash(NameKey const & key, uint seed);
+
+      QVector<Item> m_rows;
+      std::array<QHash<int, int>, numKinds> m_rowsByInventoryId;
+      QHash<NameKey, int> m_rowsByName;
+   };
+
+   struct Brew {
+      int recipeId = 0;
+      QString recipeName;
+      int batches = 1;
+      QVector<Item> items;
+   };
+
+   //! \brief What's needed, overall, of one ingredient
+   struct Requirement {
+      Item item;
+      double required = 0.0;
+      double available = 0.0;
+      double shortfall() const;
+   };
+
+   struct BrewResult {
+      int recipeId = 0;
+      QString recipeName;
+      int batches = 1;
+      //! \brief Whether there's enough left for this brew once the ones before it in the queue have had theirs
+      bool canBrew = false;
+      //! \brief Names of the ingredients we'd run out of
+      QStringList missing;
+   };
+
+   struct Plan {
+      //! \brief In queue order
+      QVector<BrewResult> brews;
+      //! \brief Everything needed for the whole queue, in the order first needed
+      QVector<Requirement> requirements;
+
+      //! \brief Requirements we don't have enough of
+      QVector<Requirement> purchaseList() const;
+   };
+
+   /**
+    * \brief Plan a queue of brews.  Brews are allocated stock in queue order, so if two brews need the last of
+    *        something, it's the first one that can be brewed.
+    *
+    *        \c stock is not const because ingredients that aren't stocked get rows added.
+    */
+   Plan plan(Stock & stock, QVector<Brew> const & queue);
+}
+
+/*!
+ * \class BatchPlanner
+ *
+ * \brief Plans queues of brews against the database, caching both the stock table and the last plan.  Any change to a
+ *        recipe, ingredient or inventory marks the cache stale, and the work is redone at the next request.
+ */
+class BatchPlanner : public QObject {
+   Q_OBJECT
+
+public:
+   //! \brief Recipe ID and number of batches
+   using Queue = QVector<QPair<int, int>>;
+
+   static BatchPlanner & instance();
+
+   BatchPlanning::Plan const & plan(Queue const & queue);
+
+private slots:
+   void stockChanged();
+   void recipesChanged();
+
+private:
+   BatchPlanner();
+   ~BatchPlanner();
+   BatchPlanner(BatchPlanner const &) = delete;
+   BatchPlanner & operator=(BatchPlanner const &) = delete;
+
+   template<class NE> void listenTo(void (BatchPlanner::*slot)());
+
+   bool m_connected;
+   std::optional<BatchPlanning::Stock> m_stock;
+   std::optional<Queue> m_queue;
+   BatchPlanning::Plan m_plan;
+};
+
+#endif
@@ -22,7 +22,9 @@
 #include "BrewNoteWidget.h"
 
 #include <QDate>
+#include <QDateTime>
 #include <QDebug>
+#include <QTableWidgetItem>
 
 #include "Localization.h"
 #include "measurement/Measurement.h"
@@ -32,6 +34,11 @@
 namespace {
    double const lowLimitPct  = 0.95;
    double const highLimitPct = 1.05;
+
+   //! \brief User's date format, plus the time, for gravity readings
+   QString dateTimeFormat() {
+      return Localization::numericToStringDateFormat(Localization::getDateFormat()) + " hh:mm";
+   }
 }
 
 BrewNoteWidget::BrewNoteWidget(QWidget *parent) : QWidget(parent) {
@@ -71,6 +78,8 @@ BrewNoteWidget::BrewNoteWidget(QWidget *parent) : QWidget(parent) {
    connect(this->lineEdit_finalVolume, &SmartLineEdit::textModified,   this, &BrewNoteWidget::updateFinalVolume_l   );
    connect(this->lineEdit_fermentDate, &QDateTimeEdit::dateChanged,    this, &BrewNoteWidget::updateFermentDate     );
    connect(this->btTextEdit_brewNotes, &BtTextEdit::textModified,      this, &BrewNoteWidget::updateNotes           );
+   connect(this->pushButton_addReading,    &QAbstractButton::clicked, this, &BrewNoteWidget::addGravityReading   );
+   connect(this->pushButton_removeReading, &QAbstractButton::clicked, this, &BrewNoteWidget::removeGravityReading);
 
    // A few labels on this page need special handling, so I connect them here
    // instead of how we would normally do this.
@@ -93,6 +102,7 @@ void BrewNoteWidget::updateDateFormat() {
    auto dateFormat = Localization::getDateFormat();
    QString format = Localization::numericToStringDateFormat(dateFormat);
    this->lineEdit_fermentDate->setDisplayFormat(format);
+   this->dateTimeEdit_reading->setDisplayFormat(dateTimeFormat());
    return;
 }
 
@@ -147,6 +157,7 @@ void BrewNoteWidget::setBrewNote(BrewNote* bNote) {
       this->lcdnumber_projAtten->setHighLim(bNoteObs->projAtten() * highLimitPct);
 
       this->showChanges();
+      this->resetGravityReadingEntry();
    }
    return;
 }
@@ -168,6 +179,26 @@ void BrewNoteWidget::updateFinalVolume_l()                     { if (this->bNote
 void BrewNoteWidget::updateFermentDate(QDate const & datetime) { if (this->bNoteObs) { this->bNoteObs->setFermentDate     (datetime);                                                                  } return; }
 void BrewNoteWidget::updateNotes()                             { if (this->bNoteObs) { this->bNoteObs->setNotes           (this->btTextEdit_brewNotes->toPlainText() );                                } return; }
 
+void BrewNoteWidget::addGravityReading() {
+   if (this->bNoteObs) {
+      this->bNoteObs->addGravityReading(this->dateTimeEdit_reading->dateTime(), this->doubleSpinBox_readingSg->value());
+      this->showFermentation();
+      this->resetGravityReadingEntry();
+   }
+   return;
+}
+
+void BrewNoteWidget::removeGravityReading() {
+   if (this->bNoteObs) {
+      int const row = this->tableWidget_gravityReadings->currentRow();
+      if (row >= 0) {
+         this->bNoteObs->removeGravityReading(row);
+         this->showFermentation();
+      }
+   }
+   return;
+}
+
 void BrewNoteWidget::changed([[maybe_unused]] QMetaProperty prop,
                              [[maybe_unused]] QVariant val) {
    if (this->sender() != this->bNoteObs) {
@@ -207,6 +238,49 @@ void BrewNoteWidget::showChanges([[maybe_unused]] QString field) {
    this->lcdnumber_abv         ->setAmount(bNoteObs->abv             ());
    this->lcdnumber_atten       ->setAmount(bNoteObs->attenuation     ());
    this->lcdnumber_projAtten   ->setAmount(bNoteObs->projAtten       ());
+
+   this->showFermentation();
+   return;
+}
+
+void BrewNoteWidget::resetGravityReadingEntry() {
+   // The next reading is most likely to be taken now, and to be a bit below the last one
+   QVector<FermentationCurve::Reading> const & readings = this->bNoteObs->gravityReadingsList();
+   this->dateTimeEdit_reading->setDateTime(QDateTime::currentDateTime());
+   this->doubleSpinBox_readingSg->setValue(readings.isEmpty() ? this->bNoteObs->og() : readings.last().sg);
+   return;
+}
+
+void BrewNoteWidget::showFermentation() {
+   QString const format = dateTimeFormat();
+
+   // Readings are in time order, which is the order we want to show them in
+   QVector<FermentationCurve::Reading> const & readings = this->bNoteObs->gravityReadingsList();
+   this->tableWidget_gravityReadings->setRowCount(readings.size());
+   for (int row = 0; row < readings.size(); ++row) {
+      this->tableWidget_gravityReadings->setItem(
+         row, 0, new QTableWidgetItem(BrewNote::readingTime(readings[row].time_h).toString(format))
+      );
+      this->tableWidget_gravityReadings->setItem(
+         row, 1, new QTableWidgetItem(QString::number(readings[row].sg, 'f', 3))
+      );
+   }
+
+   FermentationCurve::Prediction const prediction = this->bNoteObs->fermentationPrediction();
+   if (!prediction.valid) {
+      this->label_predictedFgValue   ->setText("-");
+      this->label_predictedAttenValue->setText("-");
+      this->label_terminalValue      ->setText(tr("Need more readings"));
+      return;
+   }
+   this->label_predictedFgValue   ->setText(QString::number(prediction.fg, 'f', 3));
+   this->label_predictedAttenValue->setText(QString("%1%").arg(prediction.apparentAttenuation_pct, 0, 'f', 1));
+   double const terminalTime_h = prediction.terminalTime_h();
+   if (terminalTime_h <= prediction.anchorTime_h) {
+      this->label_terminalValue->setText(tr("Yes"));
+   } else {
+      this->label_terminalValue->setText(BrewNote::readingTime(terminalTime_h).toString(format));
+   }
    return;
 }
 
@@ -70,6 +70,11 @@ public slots:
    void updateNotes();
 //   void saveAll();
 
+   //! \brief Add the gravity reading the user has entered
+   void addGravityReading();
+   //! \brief Remove the selected gravity reading
+   void removeGravityReading();
+
    void changed(QMetaProperty,QVariant);
    void showChanges(QString field = "");
 
@@ -84,6 +89,11 @@ public slots:
    void updateProjOg();
 
 private:
+   //! \brief Show the gravity readings and what they predict
+   void showFermentation();
+   //! \brief Set up the fields for entering a gravity reading ready for the next one
+   void resetGravityReadingEntry();
+
    BrewNote* bNoteObs;
 };
 
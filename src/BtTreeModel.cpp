@@ -37,6 +37,9 @@
 #include "BtTreeView.h"
 #include "RecipeFormatter.h"
 #include "database/ObjectStoreWrapper.h"
+#include "measurement/ColorMethods.h"
+#include "measurement/IbuMethods.h"
+#include "measurement/Measurement.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Hop.h"
@@ -84,7 +87,14 @@ namespace {
 // =========================================================================
 
 BtTreeModel::BtTreeModel(BtTreeView * parent, TypeMasks type) :
-   QAbstractItemModel(parent) {
+   QAbstractItemModel(parent),
+   m_itemsByThing{},
+   m_foldersByPath{},
+   m_recipeFormatter{std::make_unique<RecipeFormatter>()},
+   m_toolTipContext{},
+   m_toolTips{},
+   m_unfetched{},
+   m_brewNoteCounts{} {
    // Initialize the tree structure
    int items = 0;
    this->rootItem = new BtTreeItem();
@@ -251,6 +261,57 @@ QModelIndex BtTreeModel::parent(QModelIndex const & index) const {
    return createIndex(pItem->childNumber(), 0, pItem);
 }
 
+bool BtTreeModel::hasChildren(QModelIndex const & parent) const {
+   BtTreeItem * parentItem = this->item(parent);
+   if (!this->m_unfetched.contains(parentItem)) {
+      return QAbstractItemModel::hasChildren(parent);
+   }
+
+   Recipe * recipe = parentItem->getData<Recipe>();
+   if (!recipe) {
+      return false;
+   }
+   if (this->m_brewNoteCounts.value(recipe->key(), 0) > 0) {
+      return true;
+   }
+   // With snapshots shown, ancestors are children in their own right.  Otherwise, all they can contribute is their brew
+   // notes (see fetchMore).
+   if (PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool()) {
+      return recipe->hasAncestors();
+   }
+   for (Recipe const * ancestor : recipe->ancestors()) {
+      if (this->m_brewNoteCounts.value(ancestor->key(), 0) > 0) {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool BtTreeModel::canFetchMore(QModelIndex const & parent) const {
+   return this->m_unfetched.contains(this->item(parent));
+}
+
+void BtTreeModel::fetchMore(QModelIndex const & parent) {
+   BtTreeItem * parentItem = this->item(parent);
+   if (!this->m_unfetched.remove(parentItem)) {
+      return;
+   }
+   Recipe * recipe = parentItem->getData<Recipe>();
+   if (!recipe) {
+      return;
+   }
+
+   qDebug() << Q_FUNC_INFO << "Adding brew notes and ancestors of Recipe #" << recipe->key();
+   int const row = parentItem->childNumber();
+   if (PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool() && recipe->hasAncestors()) {
+      this->addAncestoralTree(recipe, row, parentItem->parent());
+      this->addBrewNoteSubTree(recipe, row, parentItem->parent(), false);
+   } else {
+      this->addBrewNoteSubTree(recipe, row, parentItem->parent());
+   }
+   return;
+}
+
 QModelIndex BtTreeModel::first() {
 
    // get the first item in the list, which is the place holder
@@ -296,27 +357,48 @@ QVariant BtTreeModel::data(const QModelIndex & index, int role) const {
 }
 
 QVariant BtTreeModel::toolTipData(const QModelIndex & index) const {
-   RecipeFormatter * whiskey = new RecipeFormatter();
+   NamedEntity * namedEntity = this->thing(index);
+   if (!namedEntity) {
+      return this->buildToolTip(namedEntity);
+   }
+
+   ToolTipContext const context{Measurement::displayUnitSystemGeneration(),
+                                static_cast<int>(IbuMethods::ibuFormula),
+                                static_cast<int>(ColorMethods::colorFormula)};
+   if (!(context == this->m_toolTipContext)) {
+      this->m_toolTips.clear();
+      this->m_toolTipContext = context;
+   }
+
+   auto cached = this->m_toolTips.constFind(namedEntity);
+   if (cached != this->m_toolTips.constEnd()) {
+      return cached.value();
+   }
+   QString const toolTip = this->buildToolTip(namedEntity);
+   this->m_toolTips.insert(namedEntity, toolTip);
+   return toolTip;
+}
 
+QString BtTreeModel::buildToolTip(NamedEntity * namedEntity) const {
    switch (treeMask) {
       case RECIPEMASK:
-         return whiskey->getToolTip(qobject_cast<Recipe *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Recipe *>(namedEntity));
       case STYLEMASK:
-         return whiskey->getToolTip(qobject_cast<Style *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Style *>(namedEntity));
       case EQUIPMASK:
-         return whiskey->getToolTip(qobject_cast<Equipment *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Equipment *>(namedEntity));
       case FERMENTMASK:
-         return whiskey->getToolTip(qobject_cast<Fermentable *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Fermentable *>(namedEntity));
       case HOPMASK:
-         return whiskey->getToolTip(qobject_cast<Hop *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Hop *>(namedEntity));
       case MISCMASK:
-         return whiskey->getToolTip(qobject_cast<Misc *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Misc *>(namedEntity));
       case YEASTMASK:
-         return whiskey->getToolTip(qobject_cast<Yeast *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Yeast *>(namedEntity));
       case WATERMASK:
-         return whiskey->getToolTip(qobject_cast<Water *>(thing(index)));
+         return this->m_recipeFormatter->getToolTip(qobject_cast<Water *>(namedEntity));
       default:
-         return item(index)->name();
+         return namedEntity ? namedEntity->name() : QString();
    }
 }
 
@@ -506,6 +588,7 @@ bool BtTreeModel::insertRow(int row, const QModelIndex & parent, QObject * victi
       type = (victimType ? *victimType : type);
       BtTreeItem * added = pItem->child(row);
       added->setData(type, victim);
+      this->indexSubtree(added);
    }
    endInsertRows();
 
@@ -516,6 +599,12 @@ bool BtTreeModel::removeRows(int row, int count, const QModelIndex & parent) {
    BtTreeItem * pItem = item(parent);
 
    this->beginRemoveRows(parent, row, row + count - 1);
+   for (int ii = row; ii < row + count; ++ii) {
+      BtTreeItem * victim = pItem->child(ii);
+      if (victim) {
+         this->unindexSubtree(victim);
+      }
+   }
    bool success = pItem->removeChildren(row, count);
    this->endRemoveRows();
 
@@ -529,42 +618,46 @@ bool BtTreeModel::removeRows(int row, int count, const QModelIndex & parent) {
 // One find method for all things. This .. is nice
 QModelIndex BtTreeModel::findElement(NamedEntity * thing, BtTreeItem * parent) {
    qDebug() << Q_FUNC_INFO << "Find" << thing << "in" << parent;
-   BtTreeItem * pItem;
-   QList<BtTreeItem *> folders;
-
-   int i;
-
-   if (parent == nullptr) {
-      pItem = rootItem->child(0);
-   } else {
-      pItem = parent;
-   }
+   BtTreeItem * pItem = parent ? parent : rootItem->child(0);
 
    if (! thing) {
       return createIndex(0, 0, pItem);
    }
 
-   folders.append(pItem);
-
-   // Recursion. Wonderful.
-   while (! folders.isEmpty()) {
-      BtTreeItem * target = folders.takeFirst();
-      for (i = 0; i < target->childCount(); ++i) {
-         // If we've found what we are looking for, return
-         if (target->child(i)->thing() == thing) {
-            qDebug() << Q_FUNC_INFO << "Found at" << i;
-            return createIndex(i, 0, target->child(i));
-         }
-
-         // If we have a folder, or we are looking for a brewnote and have a
-         // recipe in hand, push the child onto the stack
-         if (target->child(i)->type() == BtTreeItem::Type::FOLDER ||
-             (qobject_cast<BrewNote *>(thing) && target->child(i)->type() == BtTreeItem::Type::RECIPE)) {
-            folders.append(target->child(i));
+   //
+   // Every item is in m_itemsByThing, so we just have to check that what we find is somewhere we'd have looked: under
+   // pItem, with only folders in between -- or recipes too, if we're looking for a brewnote.  If the same thing is in
+   // the tree more than once, we want the one nearest the top, as that's what a breadth-first search would find.
+   //
+   bool const lookInRecipes = qobject_cast<BrewNote *>(thing) != nullptr;
+   BtTreeItem * found = nullptr;
+   int foundDepth = 0;
+   for (auto match = this->m_itemsByThing.constFind(thing);
+        match != this->m_itemsByThing.constEnd() && match.key() == thing;
+        ++match) {
+      int depth = 0;
+      BtTreeItem * ancestor = match.value()->parent();
+      while (ancestor && ancestor != pItem) {
+         if (ancestor->type() != BtTreeItem::Type::FOLDER &&
+             !(lookInRecipes && ancestor->type() == BtTreeItem::Type::RECIPE)) {
+            ancestor = nullptr;
+            break;
          }
+         ancestor = ancestor->parent();
+         ++depth;
+      }
+      if (ancestor && (!found || depth < foundDepth)) {
+         found = match.value();
+         foundDepth = depth;
       }
    }
-   return QModelIndex();
+
+   if (!found) {
+      return QModelIndex();
+   }
+   int const row = found->childNumber();
+   qDebug() << Q_FUNC_INFO << "Found at" << row;
+   return createIndex(row, 0, found);
 }
 
 QList<NamedEntity *> BtTreeModel::elements() {
@@ -629,6 +722,15 @@ void BtTreeModel::loadTreeModel() {
 
    qDebug() << Q_FUNC_INFO << "Got " << elems.length() << "elements matching type mask" << this->treeMask;
 
+   bool const showSnapshots = PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool();
+   if (treeMask & RECIPEMASK) {
+      for (BrewNote const * brewNote : ObjectStoreWrapper::getAllRaw<BrewNote>()) {
+         if (!brewNote->deleted()) {
+            ++this->m_brewNoteCounts[brewNote->getRecipeId()];
+         }
+      }
+   }
+
    for (NamedEntity * elem : elems) {
 
       if (! elem->folder().isEmpty()) {
@@ -651,16 +753,14 @@ void BtTreeModel::loadTreeModel() {
          continue;
       }
 
-      // If we have brewnotes, set them up here.
+      // Brew notes and ancestors get added when the recipe is expanded
       if (treeMask & RECIPEMASK) {
          Recipe * holdmebeer = qobject_cast<Recipe *>(elem);
-         if (PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool() && holdmebeer->hasAncestors()) {
+         // NB: Asking about ancestors also marks each of them as having descendants, which versioning relies on
+         if (holdmebeer->hasAncestors() && showSnapshots) {
             setShowChild(ndxLocal, true);
-            addAncestoralTree(holdmebeer, i, local);
-            addBrewNoteSubTree(holdmebeer, i, local, false);
-         } else {
-            addBrewNoteSubTree(holdmebeer, i, local);
          }
+         this->m_unfetched.insert(local->child(i));
       }
       observeElement(elem);
    }
@@ -692,6 +792,8 @@ void BtTreeModel::addAncestoralTree(Recipe * rec, int i, BtTreeItem * parent) {
 void BtTreeModel::addBrewNoteSubTree(Recipe * rec, int i, BtTreeItem * parent, bool recurse) {
    QList<BrewNote *> notes = recurse ? RecipeHelper::brewNotesForRecipeAndAncestors(*rec) : rec->brewNotes();
    BtTreeItem * temp = parent->child(i);
+   // Whoever called us is (re)building the recipe's children, so there's nothing left to fetch
+   this->m_unfetched.remove(temp);
 
    int j = 0;
 
@@ -977,9 +1079,9 @@ void BtTreeModel::folderChanged(NamedEntity * test) {
       qWarning() << Q_FUNC_INFO << "Could not insert row" << jj;
       return;
    }
-   // If we have brewnotes, set them up here.
+   // Brew notes get added if and when the recipe is expanded
    if (treeMask & RECIPEMASK) {
-      addBrewNoteSubTree(qobject_cast<Recipe *>(test), jj, local);
+      this->m_unfetched.insert(local->child(jj));
    }
 
    if (expand) {
@@ -1126,6 +1228,7 @@ QModelIndex BtTreeModel::createFolderTree(QStringList dirs, BtTreeItem * parent,
 
       pItem->insertChildren(i, 1, BtTreeItem::Type::FOLDER);
       pItem->child(i)->setData(BtTreeItem::Type::FOLDER, temp);
+      this->indexSubtree(pItem->child(i));
 
       // Set the parent item to point to the newly created tree
       pItem = pItem->child(i);
@@ -1139,6 +1242,55 @@ QModelIndex BtTreeModel::createFolderTree(QStringList dirs, BtTreeItem * parent,
    return ndx;
 }
 
+void BtTreeModel::indexSubtree(BtTreeItem * item) {
+   QList<BtTreeItem *> items{item};
+   while (!items.isEmpty()) {
+      BtTreeItem * current = items.takeLast();
+      if (current->type() == BtTreeItem::Type::FOLDER) {
+         BtFolder * folder = current->getData<BtFolder>();
+         // If two folders had the same path, findFolder would always have found the first one
+         if (folder && !this->m_foldersByPath.contains(folder->fullPath())) {
+            this->m_foldersByPath.insert(folder->fullPath(), current);
+         }
+      } else if (current->thing()) {
+         this->m_itemsByThing.insert(current->thing(), current);
+         connect(current->thing(), &NamedEntity::changed,
+                 this,             &BtTreeModel::toolTipSourceChanged,
+                 Qt::UniqueConnection);
+      }
+      for (int ii = 0; ii < current->childCount(); ++ii) {
+         items.append(current->child(ii));
+      }
+   }
+   return;
+}
+
+void BtTreeModel::unindexSubtree(BtTreeItem * item) {
+   QList<BtTreeItem *> items{item};
+   while (!items.isEmpty()) {
+      BtTreeItem * current = items.takeLast();
+      if (current->type() == BtTreeItem::Type::FOLDER) {
+         BtFolder * folder = current->getData<BtFolder>();
+         if (folder && this->m_foldersByPath.value(folder->fullPath(), nullptr) == current) {
+            this->m_foldersByPath.remove(folder->fullPath());
+         }
+      } else if (current->thing()) {
+         this->m_unfetched.remove(current);
+         NamedEntity * thing = current->thing();
+         this->m_itemsByThing.remove(thing, current);
+         if (!this->m_itemsByThing.contains(thing)) {
+            // Once it's gone from the tree, the same address could be reused for something else
+            disconnect(thing, &NamedEntity::changed, this, &BtTreeModel::toolTipSourceChanged);
+            this->m_toolTips.remove(thing);
+         }
+      }
+      for (int ii = 0; ii < current->childCount(); ++ii) {
+         items.append(current->child(ii));
+      }
+   }
+   return;
+}
+
 QModelIndex BtTreeModel::findFolder(QString name, BtTreeItem * parent, bool create) {
    BtTreeItem * pItem;
    QStringList dirs;
@@ -1168,6 +1320,30 @@ QModelIndex BtTreeModel::findFolder(QString name, BtTreeItem * parent, bool crea
       return QModelIndex();
    }
 
+   //
+   // From the top of the tree, we can look up the folder, or the deepest part of its path that already exists, by full
+   // path.  Below that, we have to walk down the tree.
+   //
+   if (pItem == rootItem->child(0)) {
+      BtTreeItem * deepest = nullptr;
+      int depth = dirs.size();
+      while (depth > 0) {
+         deepest = this->m_foldersByPath.value(QString("/") + dirs.mid(0, depth).join("/"), nullptr);
+         if (deepest) {
+            break;
+         }
+         --depth;
+      }
+      if (deepest && depth == dirs.size()) {
+         return createIndex(deepest->childNumber(), 0, deepest);
+      }
+      if (!create) {
+         return QModelIndex();
+      }
+      return deepest ? createFolderTree(dirs.mid(depth), deepest, deepest->getData<BtFolder>()->fullPath()) :
+                       createFolderTree(dirs, pItem, "/");
+   }
+
    current = dirs.takeFirst();
    fullPath = "/";
    targetPath = fullPath % current;
@@ -1283,8 +1459,14 @@ void BtTreeModel::elementAdded(NamedEntity * victim) {
    auto lType = this->itemType;
    if (qobject_cast<BrewNote *>(victim)) {
       auto brewNote = qobject_cast<BrewNote *>(victim);
+      ++this->m_brewNoteCounts[brewNote->getRecipeId()];
       Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(brewNote->getRecipeId());
       pIdx = findElement(recipe);
+      // If the recipe's brew notes aren't in the tree yet, adding them all now will include (and observe) this one
+      if (this->canFetchMore(pIdx)) {
+         this->fetchMore(pIdx);
+         return;
+      }
       lType = BtTreeItem::Type::BREWNOTE;
    } else {
       pIdx = createIndex(0, 0, rootItem->child(0));
@@ -1299,19 +1481,9 @@ void BtTreeModel::elementAdded(NamedEntity * victim) {
       return;
    }
 
-   // We need some special processing here to add brewnotes on a recipe import
+   // On a recipe import, there can be brewnotes, which get added when the recipe is expanded
    if (qobject_cast<Recipe *>(victim)) {
-      Recipe * parent = qobject_cast<Recipe *>(victim);
-      QList<BrewNote *> notes = parent->brewNotes();
-
-      if (notes.size()) {
-         pIdx = findElement(parent);
-         lType = BtTreeItem::Type::BREWNOTE;
-         int row = 0;
-         for (BrewNote * note : notes) {
-            insertRow(row++, pIdx, note, lType);
-         }
-      }
+      this->m_unfetched.insert(this->item(pIdx)->child(breadth));
    }
    observeElement(victim);
    return;
@@ -1351,6 +1523,10 @@ void BtTreeModel::elementRemoved(NamedEntity * victim) {
       return;
    }
 
+   if (auto brewNote = qobject_cast<BrewNote *>(victim)) {
+      --this->m_brewNoteCounts[brewNote->getRecipeId()];
+   }
+
    QModelIndex index = findElement(victim);
    if (!index.isValid()) {
       return;
@@ -1403,6 +1579,12 @@ void BtTreeModel::recipePropertyChanged(int recipeId, BtStringConst const & prop
 }
 
 
+void BtTreeModel::toolTipSourceChanged() {
+   NamedEntity const * namedEntity = qobject_cast<NamedEntity *>(this->sender());
+   this->m_toolTips.remove(namedEntity);
+   return;
+}
+
 void BtTreeModel::observeElement(NamedEntity * d) {
    if (! d) {
       return;
@@ -25,10 +25,12 @@
 #include <optional>
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QList>
 #include <QMetaProperty>
 #include <QModelIndex>
 #include <QObject>
+#include <QSet>
 #include <QSqlRelationalTableModel>
 #include <QVariant>
 
@@ -45,6 +47,7 @@ class Hop;
 class Misc;
 class NamedEntity;
 class Recipe;
+class RecipeFormatter;
 class Style;
 class Water;
 class Yeast;
@@ -105,6 +108,13 @@ public:
    //! \brief Reimplemented from QAbstractItemModel
    virtual QModelIndex parent(const QModelIndex & index) const;
 
+   //! \brief Reimplemented from QAbstractItemModel.  A recipe's brew notes and ancestors are only added when needed.
+   virtual bool hasChildren(QModelIndex const & parent = QModelIndex()) const;
+   //! \brief Reimplemented from QAbstractItemModel
+   virtual bool canFetchMore(QModelIndex const & parent) const;
+   //! \brief Reimplemented from QAbstractItemModel
+   virtual void fetchMore(QModelIndex const & parent);
+
    //! \brief Reimplemented from QAbstractItemModel
    bool insertRow(int row,
                   QModelIndex const & parent = QModelIndex(),
@@ -151,10 +161,18 @@ public:
    //! \brief Get NamedEntity at \c index.
    NamedEntity * thing(const QModelIndex & index) const;
 
-   //! \brief one find method to find them all, and in darkness bind them
+   /**
+    * \brief one find method to find them all, and in darkness bind them
+    *
+    *        Only looks inside folders (and, for a \c BrewNote, recipes) under \c parent.  Items are looked up by
+    *        pointer rather than by walking the tree, so this is cheap however big the tree is.
+    */
    QModelIndex findElement(NamedEntity * thing, BtTreeItem * parent = nullptr);
 
-   //! \brief Get index of \c Folder
+   /**
+    * \brief Get index of \c Folder.  Folders under the top of the tree are looked up by full path rather than by
+    *        walking the tree.
+    */
    QModelIndex findFolder(QString folder, BtTreeItem * parent = nullptr, bool create = false);
    //! \brief a new folder .
    bool addFolder(QString name);
@@ -220,6 +238,9 @@ private slots:
 
    void recipePropertyChanged(int recipeId, BtStringConst const & propertyName);
 
+   //! \brief Forget the cached tooltip of whatever sent the signal, as it's changed
+   void toolTipSourceChanged();
+
 signals:
    void expandFolder(BtTreeModel::TypeMasks kindofThing, QModelIndex fIdx);
    void recipeSpawn(Recipe * descendant);
@@ -258,8 +279,10 @@ private:
    //! \brief returns the \c section header for a folder.
    QVariant waterHeader(int section) const;
 
-   //! \brief get a tooltip
+   //! \brief get a tooltip, from the cache if we can
    QVariant toolTipData(const QModelIndex & index) const;
+   //! \brief build a tooltip from scratch
+   QString buildToolTip(NamedEntity * namedEntity) const;
 
    //! \brief Returns the list of things in a tree (e.g., recipes) as a list
    //! of NamedEntitys. It's a convenience method to make loadTree()
@@ -274,6 +297,11 @@ private:
    void setShowChild(QModelIndex child, bool val);
    void addAncestoralTree(Recipe * rec, int i, BtTreeItem * parent);
 
+   //! \brief Add \c item, and everything under it, to the lookups used by \c findElement and \c findFolder
+   void indexSubtree(BtTreeItem * item);
+   //! \brief Remove \c item, and everything under it, from the lookups, before it gets deleted
+   void unindexSubtree(BtTreeItem * item);
+
    BtTreeItem * rootItem;
    BtTreeView * parentTree;
    TypeMasks treeMask;
@@ -281,6 +309,40 @@ private:
    int m_maxColumns;
    QString _mimeType;
 
+   //! Every item showing a \c NamedEntity.  Normally one item per entity, but nothing stops it appearing twice.
+   QMultiHash<NamedEntity const *, BtTreeItem *> m_itemsByThing;
+   //! Every folder, by full path (eg "/Lagers/Pilsners")
+   QHash<QString, BtTreeItem *> m_foldersByPath;
+
+   //! Builds all our tooltips
+   std::unique_ptr<RecipeFormatter> m_recipeFormatter;
+
+   //! Everything, besides the entity itself, that goes into a tooltip.  If it changes, all cached tooltips are stale.
+   struct ToolTipContext {
+      unsigned int displayUnitSystemGeneration;
+      int ibuFormula;
+      int colorFormula;
+      bool operator==(ToolTipContext const & other) const {
+         return this->displayUnitSystemGeneration == other.displayUnitSystemGeneration &&
+                this->ibuFormula                  == other.ibuFormula                  &&
+                this->colorFormula                == other.colorFormula;
+      }
+   };
+   mutable ToolTipContext m_toolTipContext;
+   /**
+    * Tooltip HTML for entities in the tree, built the first time it's asked for.  An entry is dropped when its entity
+    * changes or leaves the tree, so hovering back and forth over the tree doesn't keep rebuilding the same HTML.
+    */
+   mutable QHash<NamedEntity const *, QString> m_toolTips;
+
+   /**
+    * Recipe items whose brew notes and ancestors haven't been added yet.  Working them out means searching all the
+    * brew notes for each recipe, so we wait until someone expands the recipe -- see \c fetchMore.
+    */
+   QSet<BtTreeItem *> m_unfetched;
+   //! Number of brew notes for each recipe ID, so we know which unfetched recipes have anything to fetch
+   QHash<int, int> m_brewNoteCounts;
+
 };
 
 #endif
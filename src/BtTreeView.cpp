@@ -28,10 +28,12 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QMimeData>
+#include <QStringList>
 
 #include "BtFolder.h"
 #include "BtTreeFilterProxyModel.h"
 #include "BtTreeModel.h"
+#include "database/ObjectStoreWrapper.h"
 #include "EquipmentEditor.h"
 #include "FermentableDialog.h"
 #include "HopDialog.h"
@@ -45,6 +47,7 @@
 #include "model/Style.h"
 #include "model/Water.h"
 #include "model/Yeast.h"
+#include "RecipeSimilarity.h"
 #include "StyleEditor.h"
 #include "WaterEditor.h"
 #include "YeastDialog.h"
@@ -409,6 +412,43 @@ void BtTreeView::spawnRecipe() {
    }
 }
 
+void BtTreeView::findSimilarRecipes() {
+   // Don't bother listing recipes that have less than this much in common
+   double constexpr minSimilarity = 0.25;
+   std::size_t constexpr maxResults = 10;
+
+   QModelIndexList ndxs = selectionModel()->selectedRows();
+   if (m_type != BtTreeModel::RECIPEMASK || ndxs.isEmpty()) {
+      return;
+   }
+   Recipe * rec = this->getItem<Recipe>(ndxs.first());
+   if (!rec) {
+      return;
+   }
+
+   QVector<RecipeSimilarity::Match> const matches =
+      RecipeSimilarityIndex::instance().nearest(*rec, maxResults, minSimilarity);
+   if (matches.isEmpty()) {
+      QMessageBox::information(this,
+                               tr("Similar Recipes"),
+                               tr("No other recipe has much in common with %1.").arg(rec->name()));
+      return;
+   }
+
+   QStringList lines;
+   for (RecipeSimilarity::Match const & match : matches) {
+      Recipe const * similar = ObjectStoreWrapper::getByIdRaw<Recipe>(match.id);
+      if (similar) {
+         lines.append(tr("%1 (%2% similar)").arg(similar->name()).arg(qRound(match.similarity * 100.0)));
+      }
+   }
+   QMessageBox::information(this,
+                            tr("Similar Recipes"),
+                            tr("Recipes with the most similar grist and hops to %1:\n\n%2").arg(rec->name(),
+                                                                                               lines.join('\n')));
+   return;
+}
+
 bool BtTreeView::ancestorsAreShowing(QModelIndex ndx) {
    if (m_type == BtTreeModel::RECIPEMASK) {
       QModelIndex translated = m_filter->mapToSource(ndx);
@@ -457,6 +497,7 @@ void BtTreeView::setupContextMenu(QWidget * top, QWidget * editor) {
          m_orphanAction = m_versionMenu->addAction(tr("Detach Recipe"), this, SLOT(orphanRecipe()));
          m_spawnAction  = m_versionMenu->addAction(tr("Snapshot Recipe"), this, SLOT(spawnRecipe()));
          m_contextMenu->addMenu(m_versionMenu);
+         m_similarAction = m_contextMenu->addAction(tr("Find Similar Recipes"), this, SLOT(findSimilarRecipes()));
 
          m_contextMenu->addSeparator();
          m_brewItAction = m_contextMenu->addAction(tr("Brew It!"), top, SLOT(brewItHelper()));
@@ -546,6 +587,7 @@ QMenu * BtTreeView::contextMenu(QModelIndex selected) {
          m_exportMenu->setEnabled(true);
          m_copyAction->setEnabled(true);
          m_brewItAction->setEnabled(true);
+         m_similarAction->setEnabled(true);
       } else {
          // This case will happen if user Right-click the top most item in the list, as that will yield a rec == nullptr.
          // In this case we will treat it like a folder and disable a bunch of options.
@@ -561,6 +603,7 @@ QMenu * BtTreeView::contextMenu(QModelIndex selected) {
          m_exportMenu->setEnabled( false );
          m_copyAction->setEnabled( false );
          m_brewItAction->setEnabled( false );
+         m_similarAction->setEnabled( false );
       }
    }
 
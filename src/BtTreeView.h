@@ -150,6 +150,8 @@ private slots:
    void revertRecipeToPreviousVersion();
    void orphanRecipe();
    void spawnRecipe();
+   //! \brief Show the recipes most like the selected one
+   void findSimilarRecipes();
 
 signals:
    void recipeSpawn(Recipe * descendant);
@@ -168,7 +170,8 @@ private:
            * m_orphanAction,
            * m_spawnAction,
            * m_copyAction,
-           * m_brewItAction;
+           * m_brewItAction,
+           * m_similarAction;
    QPoint dragStart;
    QWidget * m_editor;
 
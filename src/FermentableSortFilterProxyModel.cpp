@@ -24,75 +24,48 @@
 
 #include <QDebug>
 
-#include "Localization.h"
-#include "measurement/Measurement.h"
-#include "measurement/Unit.h"
 #include "model/Fermentable.h"
 #include "tableModels/FermentableTableModel.h"
 
 FermentableSortFilterProxyModel::FermentableSortFilterProxyModel(QObject *parent, bool filt) :
    QSortFilterProxyModel{parent},
-   filter{filt} {
+   filter{filt},
+   searchFilter{TextSearchIndex::instance<Fermentable>()} {
    return;
 }
 
 bool FermentableSortFilterProxyModel::lessThan(QModelIndex const & left,
                                                QModelIndex const & right) const {
-   QVariant leftFermentable = sourceModel()->data(left);
-   QVariant rightFermentable = sourceModel()->data(right);
+   QVariant leftFermentable  = this->sourceModel()->data(left,  BtTableModel::SortRole);
+   QVariant rightFermentable = this->sourceModel()->data(right, BtTableModel::SortRole);
 
    auto const columnIndex = static_cast<FermentableTableModel::ColumnIndex>(left.column());
    switch (columnIndex) {
       case FermentableTableModel::ColumnIndex::Inventory:
          // If the numbers are equal, compare the names and be done with it
-         if (Measurement::qStringToSI(leftFermentable.toString(), Measurement::PhysicalQuantity::Mass) ==
-             Measurement::qStringToSI(rightFermentable.toString(), Measurement::PhysicalQuantity::Mass)) {
+         if (leftFermentable.toDouble() == rightFermentable.toDouble()) {
             return getName(right) < getName(left);
-         } else if (Measurement::qStringToSI(leftFermentable.toString(),
-                                             Measurement::PhysicalQuantity::Mass).quantity() == 0.0 &&
-                    this->sortOrder() == Qt::AscendingOrder) {
+         } else if (leftFermentable.toDouble() == 0.0 && this->sortOrder() == Qt::AscendingOrder) {
             // Show non-zero entries first.
             return false;
          }
-         return Measurement::qStringToSI(leftFermentable.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightFermentable.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftFermentable.toDouble() < rightFermentable.toDouble();
 
       case FermentableTableModel::ColumnIndex::Amount:
+      case FermentableTableModel::ColumnIndex::Yield :
+      case FermentableTableModel::ColumnIndex::Color :
          // If the numbers are equal, compare the names and be done with it
-         if (Measurement::qStringToSI(leftFermentable.toString(), Measurement::PhysicalQuantity::Mass) ==
-             Measurement::qStringToSI(rightFermentable.toString(), Measurement::PhysicalQuantity::Mass)) {
+         if (leftFermentable.toDouble() == rightFermentable.toDouble()) {
             return getName(right) < getName(left);
          }
-         return Measurement::qStringToSI(leftFermentable.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightFermentable.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftFermentable.toDouble() < rightFermentable.toDouble();
 
-      case FermentableTableModel::ColumnIndex::Yield:
-         {
-            double leftDouble = toDouble(leftFermentable);
-            double rightDouble = toDouble(rightFermentable);
-
-            if (leftDouble == rightDouble) {
-               return getName(right) < getName(left);
-            }
-            return leftDouble < rightDouble;
-         }
-
-      case FermentableTableModel::ColumnIndex::Color:
-         {
-            auto leftAmount = Measurement::qStringToSI(leftFermentable.toString(),
-                                                         Measurement::PhysicalQuantity::Color);
-            auto rightAmount = Measurement::qStringToSI(rightFermentable.toString(),
-                                                          Measurement::PhysicalQuantity::Color);
-            if (leftAmount == rightAmount) {
-               return getName(right) < getName(left);
-            }
-            return leftAmount < rightAmount;
-         }
-
-      case FermentableTableModel::ColumnIndex::Name     :
       case FermentableTableModel::ColumnIndex::Type     :
       case FermentableTableModel::ColumnIndex::IsMashed :
       case FermentableTableModel::ColumnIndex::AfterBoil:
+         return leftFermentable.toInt() < rightFermentable.toInt();
+
+      case FermentableTableModel::ColumnIndex::Name     :
          // Nothing to do for these cases
          break;
    }
@@ -100,25 +73,17 @@ bool FermentableSortFilterProxyModel::lessThan(QModelIndex const & left,
    return leftFermentable.toString() < rightFermentable.toString();
 }
 
-double FermentableSortFilterProxyModel::toDouble(QVariant side) const {
-   return Localization::toDouble(side.toString(), Q_FUNC_INFO);
-}
-
 QString FermentableSortFilterProxyModel::getName( const QModelIndex &index ) const {
-   QVariant info = sourceModel()->data(
-      QAbstractItemModel::createIndex(index.row(),
-                                      static_cast<int>(FermentableTableModel::ColumnIndex::Name)))
-   ;
-   return info.toString();
+   QModelIndex nameIndex = index.sibling(index.row(), static_cast<int>(FermentableTableModel::ColumnIndex::Name));
+   return this->sourceModel()->data(nameIndex, BtTableModel::SortRole).toString();
 }
 
-bool FermentableSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const {
-   FermentableTableModel* model = qobject_cast<FermentableTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
-
-   return !filter
-          ||
-          (  sourceModel()->data(index).toString().contains(filterRegExp())
-             && model->getRow(source_row)->display()
-          );
+bool FermentableSortFilterProxyModel::filterAcceptsRow(int source_row,
+                                                       [[maybe_unused]] QModelIndex const & source_parent) const {
+   if (!this->filter) {
+      return true;
+   }
+   FermentableTableModel * model = qobject_cast<FermentableTableModel *>(this->sourceModel());
+   auto row = model->getRow(source_row);
+   return row->display() && this->searchFilter.accepts(*row, this->filterRegExp());
 }
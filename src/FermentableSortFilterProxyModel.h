@@ -24,6 +24,8 @@
 
 #include <QSortFilterProxyModel>
 
+#include "TextSearch.h"
+
 /*!
  * \class FermentableSortFilterProxyModel
  *
@@ -42,9 +44,10 @@ protected:
 
 private:
    bool filter;
+   //! Filtering is const in QSortFilterProxyModel, but remembering the last search is what makes it fast
+   mutable TextSearch::Filter searchFilter;
 
    QString getName( const QModelIndex &index ) const;
-   double toDouble(QVariant side) const;
 };
 
 #endif
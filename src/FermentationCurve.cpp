@@ -0,0 +1,263 @@
+/*
+ * FermentationCurve.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "FermentationCurve.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDebug>
+#include <QLocale>
+#include <QStringList>
+
+namespace {
+   // We work in gravity points to keep the sums well-scaled
+   double constexpr pointsPerSg = 1000.0;
+
+   // Lowest FG we'll believe.  A fit that goes below this is extrapolating from too little of the curve.
+   double constexpr minFg = 0.990;
+
+   // A reading at (or above) OG hasn't started the curve yet, which would put it infinitely far in the past.  We
+   // pretend it's this far along instead, which is roughly where a logistic curve leaves the lag phase.
+   double constexpr minAnchorFraction = 0.01;
+
+   /**
+    * \brief Fraction of the way along the curve at \c time_h, given the fraction at \c anchorTime_h.  Written so that
+    *        it does not overflow however far from the anchor we are.
+    */
+   double fractionAt(FermentationCurve::Prediction const & prediction, double const time_h) {
+      if (prediction.anchorFraction >= 1.0) {
+         return 1.0;
+      }
+      double const inverseOdds = (1.0 - prediction.anchorFraction) / prediction.anchorFraction;
+      return 1.0 / (1.0 + inverseOdds * std::exp(-prediction.rate_perHour * (time_h - prediction.anchorTime_h)));
+   }
+}
+
+double FermentationCurve::Prediction::sgAt(double const time_h) const {
+   return this->og - (this->og - this->fg) * fractionAt(*this, time_h);
+}
+
+double FermentationCurve::Prediction::terminalTime_h() const {
+   double const drop = this->og - this->fg;
+   if (drop <= terminalTolerance_sg) {
+      return this->anchorTime_h;
+   }
+   double const terminalFraction = 1.0 - terminalTolerance_sg / drop;
+   if (this->anchorFraction >= terminalFraction) {
+      return this->anchorTime_h;
+   }
+   // Inverse of fractionAt()
+   return this->anchorTime_h + (std::log(terminalFraction / (1.0 - terminalFraction)) -
+                                std::log(this->anchorFraction / (1.0 - this->anchorFraction))) / this->rate_perHour;
+}
+
+FermentationCurve::Fitter::Fitter(double const og) :
+   m_og{og},
+   m_numReadings{0},
+   m_last{},
+   m_sum11{0.0},
+   m_sum12{0.0},
+   m_sum22{0.0},
+   m_sum1y{0.0},
+   m_sum2y{0.0} {
+   return;
+}
+
+double FermentationCurve::Fitter::og() const {
+   return this->m_og;
+}
+
+std::size_t FermentationCurve::Fitter::numReadings() const {
+   return this->m_numReadings;
+}
+
+void FermentationCurve::Fitter::add(Reading const & reading) {
+   if (this->m_numReadings == 0) {
+      if (this->m_og <= 0.0) {
+         this->m_og = reading.sg;
+      }
+   } else {
+      double const interval_h = reading.time_h - this->m_last.time_h;
+      if (interval_h <= 0.0) {
+         qWarning() << Q_FUNC_INFO << "Ignoring reading at" << reading.time_h << "as it is not after the previous one";
+         return;
+      }
+      // Slope between the two readings, as the rate of change at their midpoint.  Longer intervals give less noisy
+      // slopes, so they count for more.
+      double const used    = (this->m_og - (this->m_last.sg + reading.sg) / 2.0) * pointsPerSg;
+      double const slope   = (reading.sg - this->m_last.sg) * pointsPerSg / interval_h;
+      double const used2   = used * used;
+      this->m_sum11 += interval_h * used2;
+      this->m_sum12 += interval_h * used2 * used;
+      this->m_sum22 += interval_h * used2 * used2;
+      this->m_sum1y += interval_h * used  * slope;
+      this->m_sum2y += interval_h * used2 * slope;
+   }
+   this->m_last = reading;
+   ++this->m_numReadings;
+   return;
+}
+
+FermentationCurve::Prediction FermentationCurve::Fitter::prediction() const {
+   Prediction prediction;
+   prediction.og           = this->m_og;
+   prediction.fg           = this->m_last.sg;
+   prediction.anchorTime_h = this->m_last.time_h;
+
+   // Two unknowns need at least two slopes, ie three readings
+   if (this->m_numReadings < 3) {
+      return prediction;
+   }
+
+   // Solve the 2×2 normal equations.  If all the slopes come from the same part of the curve (eg everything is still
+   // in the lag phase) the determinant is (relatively) tiny and the answer would be meaningless.
+   double const det = this->m_sum11 * this->m_sum22 - this->m_sum12 * this->m_sum12;
+   if (!(det > 1e-9 * this->m_sum11 * this->m_sum22)) {
+      return prediction;
+   }
+   double const linear    = (this->m_sum22 * this->m_sum1y - this->m_sum12 * this->m_sum2y) / det;
+   double const quadratic = (this->m_sum11 * this->m_sum2y - this->m_sum12 * this->m_sum1y) / det;
+
+   // linear = -r and quadratic = r/D
+   double const rate_perHour = -linear;
+   if (!(rate_perHour > 0.0 && quadratic > 0.0)) {
+      return prediction;
+   }
+   double const fg = this->m_og - rate_perHour / quadratic / pointsPerSg;
+   if (!(fg >= minFg && fg < this->m_og)) {
+      return prediction;
+   }
+
+   prediction.valid                   = true;
+   prediction.fg                      = fg;
+   prediction.rate_perHour            = rate_perHour;
+   prediction.apparentAttenuation_pct = this->m_og > 1.0 ? (this->m_og - fg) / (this->m_og - 1.0) * 100.0 : 0.0;
+   prediction.anchorFraction          = std::clamp((this->m_og - this->m_last.sg) / (this->m_og - fg),
+                                                   minAnchorFraction,
+                                                   1.0);
+   return prediction;
+}
+
+FermentationCurve::Series::Series(double const og) :
+   m_og{og},
+   m_readings{},
+   m_fitter{og} {
+   return;
+}
+
+QVector<FermentationCurve::Reading> const & FermentationCurve::Series::readings() const {
+   return this->m_readings;
+}
+
+void FermentationCurve::Series::setOg(double const og) {
+   if (og != this->m_og) {
+      this->m_og = og;
+      this->refit();
+   }
+   return;
+}
+
+void FermentationCurve::Series::add(Reading const & reading) {
+   if (this->m_readings.isEmpty() || reading.time_h > this->m_readings.last().time_h) {
+      // Usual case: the newest reading, so the fit can just be updated
+      this->m_readings.append(reading);
+      this->m_fitter.add(reading);
+      return;
+   }
+
+   auto position = std::lower_bound(
+      this->m_readings.begin(),
+      this->m_readings.end(),
+      reading.time_h,
+      [](Reading const & existing, double const time_h) { return existing.time_h < time_h; }
+   );
+   if (position != this->m_readings.end() && position->time_h == reading.time_h) {
+      // A second reading at the same time is a correction
+      *position = reading;
+   } else {
+      this->m_readings.insert(position, reading);
+   }
+   this->refit();
+   return;
+}
+
+void FermentationCurve::Series::remove(int const index) {
+   if (index < 0 || index >= this->m_readings.size()) {
+      return;
+   }
+   this->m_readings.removeAt(index);
+   this->refit();
+   return;
+}
+
+void FermentationCurve::Series::clear() {
+   this->m_readings.clear();
+   this->refit();
+   return;
+}
+
+FermentationCurve::Prediction FermentationCurve::Series::prediction() const {
+   return this->m_fitter.prediction();
+}
+
+QString FermentationCurve::Series::toString() const {
+   QStringList pairs;
+   for (Reading const & reading : this->m_readings) {
+      // Shortest representation that reads back as exactly the same number, so the fit of a Series read back with
+      // fromString is the same as that of the original
+      pairs.append(QString("%1:%2").arg(QString::number(reading.time_h, 'g', QLocale::FloatingPointShortest),
+                                        QString::number(reading.sg,     'g', QLocale::FloatingPointShortest)));
+   }
+   return pairs.join(';');
+}
+
+FermentationCurve::Series FermentationCurve::Series::fromString(QString const & text, double const og) {
+   Series series{og};
+   for (QString const & pair : text.split(';')) {
+      if (pair.isEmpty()) {
+         continue;
+      }
+      QStringList const parts = pair.split(':');
+      bool okTime = false, okSg = false;
+      Reading reading;
+      if (parts.size() == 2) {
+         reading.time_h = parts[0].toDouble(&okTime);
+         reading.sg     = parts[1].toDouble(&okSg);
+      }
+      if (!okTime || !okSg) {
+         qWarning() << Q_FUNC_INFO << "Skipping unparseable gravity reading" << pair;
+         continue;
+      }
+      series.m_readings.append(reading);
+   }
+   // We wrote them in order, but it costs nothing to be sure, and then one fit covers everything
+   std::stable_sort(series.m_readings.begin(),
+                    series.m_readings.end(),
+                    [](Reading const & lhs, Reading const & rhs) { return lhs.time_h < rhs.time_h; });
+   series.refit();
+   return series;
+}
+
+void FermentationCurve::Series::refit() {
+   this->m_fitter = Fitter{this->m_og};
+   for (Reading const & reading : this->m_readings) {
+      this->m_fitter.add(reading);
+   }
+   return;
+}
@@ -0,0 +1,158 @@
+/*
+ * FermentationCurve.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FERMENTATIONCURVE_H
+#define FERMENTATIONCURVE_H
+#pragma once
+
+#include <cstddef>
+
+#include <QString>
+#include <QVector>
+
+/*!
+ * \namespace FermentationCurve
+ *
+ * \brief Predicts how a fermentation will finish from the gravity readings taken so far.
+ *
+ *        We model the fraction, p, of the fermentable gravity (OG - FG) that has been used up as a logistic curve:
+ *
+ *           dp/dt = r p (1 - p)
+ *
+ *        which gives the usual lag, then roughly linear drop, then slow approach to terminal gravity.  Writing
+ *        u = OG - SG for the gravity points used up so far and D = OG - FG for the total that will be, this is
+ *
+ *           dSG/dt = -r u + (r/D) u²
+ *
+ *        which is linear in the two unknowns, -r and r/D.  So, taking the slope between consecutive readings as
+ *        dSG/dt at the midpoint, we can fit r and D by ordinary least squares.  The normal equations only need five
+ *        running sums, so \c Fitter updates its fit in constant time for each new reading, however many there have been
+ *        before.
+ *
+ *        Times are in hours from any fixed origin (\c BrewNote uses hours since the epoch) as only differences matter.
+ */
+namespace FermentationCurve {
+
+   //! \brief Within this much of the predicted FG, we say fermentation has finished
+   double constexpr terminalTolerance_sg = 0.001;
+
+   struct Reading {
+      double time_h = 0.0;
+      double sg     = 1.0;
+   };
+
+   /**
+    * \brief Result of a fit.  The curve is anchored on the most recent reading, so that predictions always start from
+    *        where the beer actually is rather than where the fit thinks it should be.
+    */
+   struct Prediction {
+      //! \brief \c false if there aren't enough readings yet, or they don't (yet) describe a sensible curve
+      bool valid = false;
+      double og = 0.0;
+      double fg = 0.0;
+      //! \brief Logistic rate constant, r
+      double rate_perHour = 0.0;
+      double apparentAttenuation_pct = 0.0;
+      //! \brief Time of the most recent reading
+      double anchorTime_h = 0.0;
+      //! \brief Fraction of (OG - FG) used up at \c anchorTime_h
+      double anchorFraction = 0.0;
+
+      //! \brief Predicted gravity at \c time_h
+      double sgAt(double time_h) const;
+
+      //! \brief When the gravity will be within \c terminalTolerance_sg of \c fg.  Never before \c anchorTime_h.
+      double terminalTime_h() const;
+   };
+
+   /**
+    * \brief Incremental least-squares fit of the logistic model.  Readings must be added in time order.
+    */
+   class Fitter {
+   public:
+      /**
+       * \param og Original gravity.  If this is not positive, the first reading is used instead.
+       */
+      Fitter(double og = 0.0);
+
+      //! \brief OG the fit is using, or 0 if we don't know it yet
+      double og() const;
+
+      std::size_t numReadings() const;
+
+      /**
+       * \brief Add the next reading.  O(1).  Readings at, or before, the time of the previous one are ignored -- use
+       *        \c Series if readings can arrive out of order.
+       */
+      void add(Reading const & reading);
+
+      //! \brief Current fit.  O(1).
+      Prediction prediction() const;
+
+   private:
+      double m_og;
+      std::size_t m_numReadings;
+      Reading m_last;
+      //
+      // Weighted sums for the normal equations, with x1 = u and x2 = u², y = dSG/dt and weight = time between
+      // readings.  All in gravity points (ie (SG - 1) × 1000) to keep the numbers sensible.
+      //
+      double m_sum11;
+      double m_sum12;
+      double m_sum22;
+      double m_sum1y;
+      double m_sum2y;
+   };
+
+   /**
+    * \brief Time-ordered store of readings and their fit.  Adding a reading later than all the others is O(1);
+    *        anything that reorders the readings, or changes the OG, refits from scratch.
+    */
+   class Series {
+   public:
+      Series(double og = 0.0);
+
+      //! \brief Readings, in time order
+      QVector<Reading> const & readings() const;
+
+      void setOg(double og);
+      void add(Reading const & reading);
+      //! \brief Remove reading \c index (in time order)
+      void remove(int index);
+      void clear();
+
+      Prediction prediction() const;
+
+      /**
+       * \brief Readings as text: "time:sg" pairs separated by semicolons, always using '.' as the decimal separator
+       */
+      QString toString() const;
+
+      //! \brief Inverse of \c toString.  Anything we can't parse is logged and skipped.
+      static Series fromString(QString const & text, double og);
+
+   private:
+      void refit();
+
+      double m_og;
+      QVector<Reading> m_readings;
+      Fitter m_fitter;
+   };
+}
+
+#endif
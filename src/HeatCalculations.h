@@ -30,7 +30,7 @@ class HeatCalculations
 {
 public:
 
-   double equivalentMCProduct(double m1, double c1, double m2, double c2);
+   static double equivalentMCProduct(double m1, double c1, double m2, double c2);
    // Water temp when mass 1 is initially at T1 and is to be brought to Tf by
    // water. MCw = (mass of water)*(water sp. heat). MC1 = (mass 1)*(sp. heat 1).
    double requiredWaterTemp( double MCw, double MC1, double Tf, double T1 );
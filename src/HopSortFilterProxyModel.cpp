@@ -22,68 +22,54 @@
 
 #include <iostream>
 
-#include "Localization.h"
-#include "measurement/Measurement.h"
-#include "measurement/Unit.h"
 #include "model/Hop.h"
 #include "tableModels/HopTableModel.h"
 
 HopSortFilterProxyModel::HopSortFilterProxyModel(QObject *parent, bool filt) :
    QSortFilterProxyModel(parent),
-   filter{filt} {
+   filter{filt},
+   searchFilter{TextSearchIndex::instance<Hop>()} {
    return;
 }
 
 bool HopSortFilterProxyModel::lessThan(QModelIndex const & left,
                                        QModelIndex const & right) const {
-   QVariant leftHop = sourceModel()->data(left);
-   QVariant rightHop = sourceModel()->data(right);
-   // .:TODO:. Change this to use Hop::useDisplayNames
-   QStringList uses = QStringList() << "Dry Hop" << "Aroma" << "Boil" << "First Wort" << "Mash";
+   QVariant leftHop  = this->sourceModel()->data(left,  BtTableModel::SortRole);
+   QVariant rightHop = this->sourceModel()->data(right, BtTableModel::SortRole);
 
    auto const columnIndex = static_cast<HopTableModel::ColumnIndex>(left.column());
    switch (columnIndex) {
       case HopTableModel::ColumnIndex::Alpha:
-         {
-            double lAlpha = Localization::toDouble(leftHop.toString(), Q_FUNC_INFO);
-            double rAlpha = Localization::toDouble(rightHop.toString(), Q_FUNC_INFO);
-            return lAlpha < rAlpha;
-         }
+      case HopTableModel::ColumnIndex::Amount:
+         return leftHop.toDouble() < rightHop.toDouble();
 
       case HopTableModel::ColumnIndex::Inventory:
-         if (Measurement::qStringToSI(leftHop.toString(), Measurement::PhysicalQuantity::Mass).quantity() == 0.0 &&
-            this->sortOrder() == Qt::AscendingOrder) {
+         if (leftHop.toDouble() == 0.0 && this->sortOrder() == Qt::AscendingOrder) {
             return false;
          }
-         return Measurement::qStringToSI(leftHop.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightHop.toString(), Measurement::PhysicalQuantity::Mass);
-
-      case HopTableModel::ColumnIndex::Amount:
-         return Measurement::qStringToSI(leftHop.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightHop.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftHop.toDouble() < rightHop.toDouble();
 
       case HopTableModel::ColumnIndex::Time:
          {
-            // Get the indexes of the Use column
+            // Sort by use first -- dry hop, aroma, boil, first wort, mash, which is the reverse of the Hop::Use enum
+            // order -- and then by time within each use
             QModelIndex lSibling =  left.sibling( left.row(), static_cast<int>(HopTableModel::ColumnIndex::Use));
             QModelIndex rSibling = right.sibling(right.row(), static_cast<int>(HopTableModel::ColumnIndex::Use));
-            // We are talking to the model, so we get the strings associated with
-            // the names, not the Hop::Use enums. We need those translated into
-            // ints to make this work
-            int lUse = uses.indexOf( (sourceModel()->data(lSibling)).toString() );
-            int rUse = uses.indexOf( (sourceModel()->data(rSibling)).toString() );
+            int lUse = this->sourceModel()->data(lSibling, BtTableModel::SortRole).toInt();
+            int rUse = this->sourceModel()->data(rSibling, BtTableModel::SortRole).toInt();
 
             if (lUse == rUse) {
-                  return Measurement::qStringToSI(leftHop.toString(), Measurement::PhysicalQuantity::Time) <
-                        Measurement::qStringToSI(rightHop.toString(), Measurement::PhysicalQuantity::Time);
+               return leftHop.toDouble() < rightHop.toDouble();
             }
 
-            return lUse < rUse;
+            return lUse > rUse;
          }
 
-      case HopTableModel::ColumnIndex::Name:
-      case HopTableModel::ColumnIndex::Form:
       case HopTableModel::ColumnIndex::Use :
+      case HopTableModel::ColumnIndex::Form:
+         return leftHop.toInt() < rightHop.toInt();
+
+      case HopTableModel::ColumnIndex::Name:
          // Nothing to do for these cases
          break;
    }
@@ -91,13 +77,12 @@ bool HopSortFilterProxyModel::lessThan(QModelIndex const & left,
    return leftHop.toString() < rightHop.toString();
 }
 
-bool HopSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const {
-   HopTableModel* model = qobject_cast<HopTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
-
-   return !filter
-          ||
-           ( sourceModel()->data(index).toString().contains(filterRegExp())
-             && model->getRow(source_row)->display()
-           );
+bool HopSortFilterProxyModel::filterAcceptsRow(int source_row,
+                                               [[maybe_unused]] QModelIndex const & source_parent) const {
+   if (!this->filter) {
+      return true;
+   }
+   HopTableModel * model = qobject_cast<HopTableModel *>(this->sourceModel());
+   auto row = model->getRow(source_row);
+   return row->display() && this->searchFilter.accepts(*row, this->filterRegExp());
 }
@@ -24,6 +24,8 @@
 
 #include <QSortFilterProxyModel>
 
+#include "TextSearch.h"
+
 /*!
  * \class HopSortFilterProxyModel
  *
@@ -41,6 +43,8 @@ protected:
 
 private:
    bool filter;
+   //! Filtering is const in QSortFilterProxyModel, but remembering the last search is what makes it fast
+   mutable TextSearch::Filter searchFilter;
 };
 
 #endif
@@ -0,0 +1,295 @@
+/*
+ * LinearAlgebra.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LinearAlgebra.h"
+
+#include <utility>
+
+//======================================================================================================================
+//================================================== Arena =============================================================
+//======================================================================================================================
+LinearAlgebra::Arena::Arena(std::size_t blockSize) :
+   m_blocks{},
+   m_blockSize{blockSize},
+   m_currentBlock{0},
+   m_used{0} {
+   return;
+}
+
+LinearAlgebra::Arena::~Arena() = default;
+
+double * LinearAlgebra::Arena::allocate(std::size_t count) {
+   // Move on through the blocks we already have until we find space, only allocating a new one if we run out.  NB
+   // Blocks can be bigger than m_blockSize if someone asked for more than that in one go.
+   while (m_currentBlock < m_blocks.size() && m_used + count > m_blocks[m_currentBlock].size) {
+      ++m_currentBlock;
+      m_used = 0;
+   }
+   if (m_currentBlock == m_blocks.size()) {
+      std::size_t const size = std::max(count, m_blockSize);
+      m_blocks.push_back(Block{std::make_unique<double[]>(size), size});
+      m_used = 0;
+   }
+
+   double * result = m_blocks[m_currentBlock].data.get() + m_used;
+   std::fill(result, result + count, 0.0);
+   m_used += count;
+   return result;
+}
+
+void LinearAlgebra::Arena::reset() {
+   m_currentBlock = 0;
+   m_used = 0;
+   return;
+}
+
+//======================================================================================================================
+//============================================== DynamicMatrix =========================================================
+//======================================================================================================================
+LinearAlgebra::DynamicMatrix::DynamicMatrix(std::size_t rows, std::size_t cols, Arena * arena) :
+   m_rows{rows},
+   m_cols{cols},
+   m_arena{arena},
+   m_data{nullptr} {
+   this->allocate();
+   return;
+}
+
+LinearAlgebra::DynamicMatrix::DynamicMatrix(DynamicMatrix const & other) :
+   DynamicMatrix{other.m_rows, other.m_cols, other.m_arena} {
+   std::copy(other.m_data, other.m_data + m_rows * m_cols, m_data);
+   return;
+}
+
+LinearAlgebra::DynamicMatrix::DynamicMatrix(DynamicMatrix && other) noexcept :
+   m_rows{other.m_rows},
+   m_cols{other.m_cols},
+   m_arena{other.m_arena},
+   m_data{std::exchange(other.m_data, nullptr)} {
+   other.m_rows = 0;
+   other.m_cols = 0;
+   return;
+}
+
+LinearAlgebra::DynamicMatrix & LinearAlgebra::DynamicMatrix::operator=(DynamicMatrix const & other) {
+   if (this == &other) {
+      return *this;
+   }
+   // Reuse our storage if it's the right size
+   if (m_rows * m_cols != other.m_rows * other.m_cols) {
+      this->release();
+      m_rows = other.m_rows;
+      m_cols = other.m_cols;
+      this->allocate();
+   }
+   m_rows = other.m_rows;
+   m_cols = other.m_cols;
+   std::copy(other.m_data, other.m_data + m_rows * m_cols, m_data);
+   return *this;
+}
+
+LinearAlgebra::DynamicMatrix & LinearAlgebra::DynamicMatrix::operator=(DynamicMatrix && other) noexcept {
+   if (this == &other) {
+      return *this;
+   }
+   this->release();
+   m_rows  = std::exchange(other.m_rows, 0);
+   m_cols  = std::exchange(other.m_cols, 0);
+   m_arena = other.m_arena;
+   m_data  = std::exchange(other.m_data, nullptr);
+   return *this;
+}
+
+LinearAlgebra::DynamicMatrix::~DynamicMatrix() {
+   this->release();
+   return;
+}
+
+void LinearAlgebra::DynamicMatrix::allocate() {
+   std::size_t const size = m_rows * m_cols;
+   if (size == 0) {
+      m_data = nullptr;
+   } else if (m_arena) {
+      m_data = m_arena->allocate(size);
+   } else {
+      m_data = new double[size]{};
+   }
+   return;
+}
+
+void LinearAlgebra::DynamicMatrix::release() {
+   // Arena storage is only freed when the arena is
+   if (!m_arena) {
+      delete [] m_data;
+   }
+   m_data = nullptr;
+   return;
+}
+
+LinearAlgebra::DynamicMatrix LinearAlgebra::DynamicMatrix::identity(std::size_t size, Arena * arena) {
+   DynamicMatrix result{size, size, arena};
+   for (std::size_t ii = 0; ii < size; ++ii) {
+      result(ii, ii) = 1.0;
+   }
+   return result;
+}
+
+BtSpan::span<double> LinearAlgebra::DynamicMatrix::row(std::size_t row) {
+   Q_ASSERT(row < m_rows);
+   return BtSpan::span<double>{m_data + row * m_cols, m_cols};
+}
+
+BtSpan::span<double const> LinearAlgebra::DynamicMatrix::row(std::size_t row) const {
+   Q_ASSERT(row < m_rows);
+   return BtSpan::span<double const>{m_data + row * m_cols, m_cols};
+}
+
+LinearAlgebra::DynamicMatrix & LinearAlgebra::DynamicMatrix::operator+=(DynamicMatrix const & rhs) {
+   Q_ASSERT(m_rows == rhs.m_rows && m_cols == rhs.m_cols);
+   for (std::size_t ii = 0; ii < m_rows * m_cols; ++ii) {
+      m_data[ii] += rhs.m_data[ii];
+   }
+   return *this;
+}
+
+LinearAlgebra::DynamicMatrix & LinearAlgebra::DynamicMatrix::operator-=(DynamicMatrix const & rhs) {
+   Q_ASSERT(m_rows == rhs.m_rows && m_cols == rhs.m_cols);
+   for (std::size_t ii = 0; ii < m_rows * m_cols; ++ii) {
+      m_data[ii] -= rhs.m_data[ii];
+   }
+   return *this;
+}
+
+void LinearAlgebra::DynamicMatrix::swapRows(std::size_t row1, std::size_t row2) {
+   Q_ASSERT(row1 < m_rows && row2 < m_rows);
+   if (row1 != row2) {
+      std::swap_ranges(m_data + row1 * m_cols, m_data + (row1 + 1) * m_cols, m_data + row2 * m_cols);
+   }
+   return;
+}
+
+void LinearAlgebra::DynamicMatrix::rref(double tolerance) {
+   std::size_t pivotRow = 0;
+   for (std::size_t col = 0; col < m_cols && pivotRow < m_rows; ++col) {
+      // Use the biggest entry in this column (on or below the current row) as the pivot
+      std::size_t best = pivotRow;
+      for (std::size_t ii = pivotRow + 1; ii < m_rows; ++ii) {
+         if (std::abs((*this)(ii, col)) > std::abs((*this)(best, col))) {
+            best = ii;
+         }
+      }
+      if (std::abs((*this)(best, col)) < tolerance) {
+         // Nothing to pivot on in this column, so try the next one
+         continue;
+      }
+      this->swapRows(pivotRow, best);
+
+      // Normalise the pivot row, then eliminate this column from every other row
+      BtSpan::span<double> const pivot = this->row(pivotRow);
+      double const pivotValue = pivot[col];
+      for (std::size_t jj = col; jj < m_cols; ++jj) {
+         pivot[jj] /= pivotValue;
+      }
+      for (std::size_t ii = 0; ii < m_rows; ++ii) {
+         if (ii != pivotRow) {
+            BtSpan::span<double> const current = this->row(ii);
+            double const factor = current[col];
+            if (std::abs(factor) >= tolerance) {
+               for (std::size_t jj = col; jj < m_cols; ++jj) {
+                  current[jj] -= factor * pivot[jj];
+               }
+            }
+         }
+      }
+      ++pivotRow;
+   }
+   return;
+}
+
+void LinearAlgebra::multiply(DynamicMatrix const & lhs, DynamicMatrix const & rhs, DynamicMatrix & result) {
+   Q_ASSERT(lhs.cols() == rhs.rows());
+   Q_ASSERT(result.rows() == lhs.rows() && result.cols() == rhs.cols());
+   Q_ASSERT(&result != &lhs && &result != &rhs);
+   std::fill(result.data(), result.data() + result.rows() * result.cols(), 0.0);
+   // i-k-j order so the inner loop runs along rows of both rhs and result
+   for (std::size_t ii = 0; ii < lhs.rows(); ++ii) {
+      BtSpan::span<double> const resultRow = result.row(ii);
+      for (std::size_t kk = 0; kk < lhs.cols(); ++kk) {
+         double const lhsValue = lhs(ii, kk);
+         BtSpan::span<double const> const rhsRow = rhs.row(kk);
+         for (std::size_t jj = 0; jj < rhs.cols(); ++jj) {
+            resultRow[jj] += lhsValue * rhsRow[jj];
+         }
+      }
+   }
+   return;
+}
+
+bool LinearAlgebra::solveInPlace(DynamicMatrix & a, DynamicMatrix & b) {
+   Q_ASSERT(a.rows() == a.cols());
+   Q_ASSERT(b.rows() == a.rows());
+   std::size_t const size = a.rows();
+
+   double maxAbs = 0.0;
+   for (std::size_t ii = 0; ii < size * size; ++ii) {
+      maxAbs = std::max(maxAbs, std::abs(a.data()[ii]));
+   }
+   double const tolerance = detail::singularTolerance * maxAbs;
+
+   // Gaussian elimination with partial pivoting, applying the same row operations to b as we go, which is the same
+   // as doing LU decomposition and then forward substitution.
+   for (std::size_t kk = 0; kk < size; ++kk) {
+      std::size_t pivotRow = kk;
+      for (std::size_t ii = kk + 1; ii < size; ++ii) {
+         if (std::abs(a(ii, kk)) > std::abs(a(pivotRow, kk))) {
+            pivotRow = ii;
+         }
+      }
+      if (std::abs(a(pivotRow, kk)) <= tolerance) {
+         return false;
+      }
+      a.swapRows(kk, pivotRow);
+      b.swapRows(kk, pivotRow);
+      // Divisions are slow, so do one per pivot rather than one per element.  We keep the reciprocal in the (otherwise
+      // unused) pivot position for the back substitution.
+      double const inversePivot = 1.0 / a(kk, kk);
+      a(kk, kk) = inversePivot;
+      for (std::size_t ii = kk + 1; ii < size; ++ii) {
+         double const factor = a(ii, kk) * inversePivot;
+         for (std::size_t jj = kk + 1; jj < size; ++jj) {
+            a(ii, jj) -= factor * a(kk, jj);
+         }
+         for (std::size_t jj = 0; jj < b.cols(); ++jj) {
+            b(ii, jj) -= factor * b(kk, jj);
+         }
+      }
+   }
+
+   // Back substitution
+   for (std::size_t ii = size; ii-- > 0; ) {
+      for (std::size_t kk = ii + 1; kk < size; ++kk) {
+         for (std::size_t jj = 0; jj < b.cols(); ++jj) {
+            b(ii, jj) -= a(ii, kk) * b(kk, jj);
+         }
+      }
+      for (std::size_t jj = 0; jj < b.cols(); ++jj) {
+         b(ii, jj) *= a(ii, ii);
+      }
+   }
+   return true;
+}
@@ -0,0 +1,616 @@
+/*
+ * LinearAlgebra.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LINEARALGEBRA_H
+#define LINEARALGEBRA_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "utils/Span.h"
+
+/*!
+ * \namespace LinearAlgebra
+ *
+ * \brief Small dense matrices and the solvers we need for things like water chemistry.
+ *
+ *        The main type is \c Matrix<Rows, Cols>, whose dimensions are known at compile time.  It is just a
+ *        \c std::array of values, so it lives on the stack, copying it doesn't allocate and mismatched dimensions are
+ *        compile errors.  Most operations are \c constexpr.
+ *
+ *        Where the dimensions are only known at run time, there is \c DynamicMatrix.  This can take its storage from an
+ *        \c Arena, so that a calculation needing lots of temporaries does one allocation rather than one per
+ *        temporary.
+ *
+ *        Solvers report failure (eg a singular matrix) through their return value rather than by throwing.  (The
+ *        legacy \c ::Matrix class in matrix.h, which is now a thin wrapper around \c DynamicMatrix, still throws, for
+ *        compatibility.)
+ */
+namespace LinearAlgebra {
+
+   namespace detail {
+      //! \c std::abs is not \c constexpr until C++23
+      constexpr double absolute(double const value) {
+         return value < 0.0 ? -value : value;
+      }
+
+      //! Pivots smaller than this, relative to the largest element of the matrix, are treated as zero
+      double constexpr singularTolerance = 1e-12;
+   }
+
+   /**
+    * \brief Dense matrix with dimensions fixed at compile time, stored by row
+    */
+   template<std::size_t Rows, std::size_t Cols>
+   class Matrix {
+   public:
+      static_assert(Rows > 0 && Cols > 0);
+
+      //! \brief All zeros
+      constexpr Matrix() : m_data{} {
+         return;
+      }
+
+      /**
+       * \brief Construct from values in row order, eg \c Matrix<2,2>{a, b, c, d} is [a b; c d].  Any values not
+       *        supplied are zero.
+       */
+      constexpr Matrix(std::initializer_list<double> values) : m_data{} {
+         Q_ASSERT(values.size() <= Rows * Cols);
+         std::size_t ii = 0;
+         for (double const value : values) {
+            if (ii < Rows * Cols) {
+               m_data[ii++] = value;
+            }
+         }
+         return;
+      }
+
+      static constexpr Matrix identity() {
+         static_assert(Rows == Cols, "Only square matrices have an identity");
+         Matrix result;
+         for (std::size_t ii = 0; ii < Rows; ++ii) {
+            result(ii, ii) = 1.0;
+         }
+         return result;
+      }
+
+      static constexpr std::size_t rows() { return Rows; }
+      static constexpr std::size_t cols() { return Cols; }
+
+      constexpr double & operator()(std::size_t const row, std::size_t const col) {
+         return m_data[row * Cols + col];
+      }
+      constexpr double operator()(std::size_t const row, std::size_t const col) const {
+         return m_data[row * Cols + col];
+      }
+
+      //! \brief Element by position in row order -- mostly useful for vectors
+      constexpr double & operator[](std::size_t const index)       { return m_data[index]; }
+      constexpr double   operator[](std::size_t const index) const { return m_data[index]; }
+
+      //! \brief View (not copy) of one row
+      constexpr BtSpan::span<double, Cols> row(std::size_t const row) {
+         return BtSpan::span<double, Cols>{m_data.data() + row * Cols, Cols};
+      }
+      constexpr BtSpan::span<double const, Cols> row(std::size_t const row) const {
+         return BtSpan::span<double const, Cols>{m_data.data() + row * Cols, Cols};
+      }
+
+      constexpr Matrix<Rows, 1> column(std::size_t const col) const {
+         Matrix<Rows, 1> result;
+         for (std::size_t ii = 0; ii < Rows; ++ii) {
+            result[ii] = (*this)(ii, col);
+         }
+         return result;
+      }
+
+      constexpr Matrix<Cols, Rows> transpose() const {
+         Matrix<Cols, Rows> result;
+         for (std::size_t ii = 0; ii < Rows; ++ii) {
+            for (std::size_t jj = 0; jj < Cols; ++jj) {
+               result(jj, ii) = (*this)(ii, jj);
+            }
+         }
+         return result;
+      }
+
+      constexpr Matrix & operator+=(Matrix const & rhs) {
+         for (std::size_t ii = 0; ii < Rows * Cols; ++ii) {
+            m_data[ii] += rhs.m_data[ii];
+         }
+         return *this;
+      }
+      constexpr Matrix & operator-=(Matrix const & rhs) {
+         for (std::size_t ii = 0; ii < Rows * Cols; ++ii) {
+            m_data[ii] -= rhs.m_data[ii];
+         }
+         return *this;
+      }
+      constexpr Matrix & operator*=(double const scalar) {
+         for (double & value : m_data) {
+            value *= scalar;
+         }
+         return *this;
+      }
+
+      friend constexpr Matrix operator+(Matrix lhs, Matrix const & rhs) { return lhs += rhs; }
+      friend constexpr Matrix operator-(Matrix lhs, Matrix const & rhs) { return lhs -= rhs; }
+      friend constexpr Matrix operator*(double const scalar, Matrix rhs) { return rhs *= scalar; }
+      friend constexpr bool operator==(Matrix const & lhs, Matrix const & rhs) {
+         // Not std::array::operator==, as that's only constexpr from C++20
+         for (std::size_t ii = 0; ii < Rows * Cols; ++ii) {
+            if (lhs.m_data[ii] != rhs.m_data[ii]) {
+               return false;
+            }
+         }
+         return true;
+      }
+      friend constexpr bool operator!=(Matrix const & lhs, Matrix const & rhs) { return !(lhs == rhs); }
+
+      //! \brief Largest absolute value of any element
+      constexpr double maxAbs() const {
+         double result = 0.0;
+         for (double const value : m_data) {
+            if (detail::absolute(value) > result) {
+               result = detail::absolute(value);
+            }
+         }
+         return result;
+      }
+
+      double       * data()       { return m_data.data(); }
+      double const * data() const { return m_data.data(); }
+
+   private:
+      std::array<double, Rows * Cols> m_data;
+   };
+
+   template<std::size_t Size> using Vector = Matrix<Size, 1>;
+
+   template<std::size_t Rows, std::size_t Inner, std::size_t Cols>
+   constexpr Matrix<Rows, Cols> operator*(Matrix<Rows, Inner> const & lhs, Matrix<Inner, Cols> const & rhs) {
+      // i-k-j order so the inner loop runs along rows of both rhs and result
+      Matrix<Rows, Cols> result;
+      for (std::size_t ii = 0; ii < Rows; ++ii) {
+         for (std::size_t kk = 0; kk < Inner; ++kk) {
+            double const lhsValue = lhs(ii, kk);
+            for (std::size_t jj = 0; jj < Cols; ++jj) {
+               result(ii, jj) += lhsValue * rhs(kk, jj);
+            }
+         }
+      }
+      return result;
+   }
+
+   /**
+    * \brief LU decomposition, with partial pivoting, of a square matrix.  Decompose once and then \c solve for as many
+    *        right-hand sides as you like.
+    */
+   template<std::size_t Size>
+   class LuDecomposition {
+   public:
+      constexpr explicit LuDecomposition(Matrix<Size, Size> const & matrix) :
+         m_lu{matrix}, m_permutation{}, m_inverseDiagonal{}, m_determinantSign{1.0}, m_singular{false} {
+         double const tolerance = detail::singularTolerance * matrix.maxAbs();
+         for (std::size_t ii = 0; ii < Size; ++ii) {
+            m_permutation[ii] = ii;
+         }
+         for (std::size_t kk = 0; kk < Size; ++kk) {
+            std::size_t pivotRow = kk;
+            for (std::size_t ii = kk + 1; ii < Size; ++ii) {
+               if (detail::absolute(m_lu(ii, kk)) > detail::absolute(m_lu(pivotRow, kk))) {
+                  pivotRow = ii;
+               }
+            }
+            if (detail::absolute(m_lu(pivotRow, kk)) <= tolerance) {
+               m_singular = true;
+               return;
+            }
+            if (pivotRow != kk) {
+               for (std::size_t jj = 0; jj < Size; ++jj) {
+                  double const temp = m_lu(kk, jj);
+                  m_lu(kk, jj) = m_lu(pivotRow, jj);
+                  m_lu(pivotRow, jj) = temp;
+               }
+               std::size_t const temp = m_permutation[kk];
+               m_permutation[kk] = m_permutation[pivotRow];
+               m_permutation[pivotRow] = temp;
+               m_determinantSign = -m_determinantSign;
+            }
+            // Divisions are slow, so do one per pivot rather than one per element
+            m_inverseDiagonal[kk] = 1.0 / m_lu(kk, kk);
+            for (std::size_t ii = kk + 1; ii < Size; ++ii) {
+               double const factor = m_lu(ii, kk) * m_inverseDiagonal[kk];
+               m_lu(ii, kk) = factor;
+               for (std::size_t jj = kk + 1; jj < Size; ++jj) {
+                  m_lu(ii, jj) -= factor * m_lu(kk, jj);
+               }
+            }
+         }
+         return;
+      }
+
+      constexpr bool isSingular() const { return m_singular; }
+
+      constexpr double determinant() const {
+         if (m_singular) {
+            return 0.0;
+         }
+         double result = m_determinantSign;
+         for (std::size_t ii = 0; ii < Size; ++ii) {
+            result *= m_lu(ii, ii);
+         }
+         return result;
+      }
+
+      /**
+       * \brief Solve AX = B.  Must not be called if \c isSingular() is \c true.
+       */
+      template<std::size_t Cols>
+      constexpr Matrix<Size, Cols> solve(Matrix<Size, Cols> const & rhs) const {
+         Q_ASSERT(!m_singular);
+         Matrix<Size, Cols> result;
+         for (std::size_t ii = 0; ii < Size; ++ii) {
+            for (std::size_t jj = 0; jj < Cols; ++jj) {
+               result(ii, jj) = rhs(m_permutation[ii], jj);
+            }
+         }
+         // Forward substitution with L (which has an implicit unit diagonal) then back substitution with U
+         for (std::size_t ii = 0; ii < Size; ++ii) {
+            for (std::size_t kk = 0; kk < ii; ++kk) {
+               for (std::size_t jj = 0; jj < Cols; ++jj) {
+                  result(ii, jj) -= m_lu(ii, kk) * result(kk, jj);
+               }
+            }
+         }
+         for (std::size_t ii = Size; ii-- > 0; ) {
+            for (std::size_t kk = ii + 1; kk < Size; ++kk) {
+               for (std::size_t jj = 0; jj < Cols; ++jj) {
+                  result(ii, jj) -= m_lu(ii, kk) * result(kk, jj);
+               }
+            }
+            for (std::size_t jj = 0; jj < Cols; ++jj) {
+               result(ii, jj) *= m_inverseDiagonal[ii];
+            }
+         }
+         return result;
+      }
+
+   private:
+      Matrix<Size, Size> m_lu;
+      std::array<std::size_t, Size> m_permutation;
+      std::array<double, Size> m_inverseDiagonal;
+      double m_determinantSign;
+      bool m_singular;
+   };
+
+   /**
+    * \brief Solve AX = B, or return \c std::nullopt if A is singular
+    */
+   template<std::size_t Size, std::size_t Cols>
+   constexpr std::optional<Matrix<Size, Cols>> solve(Matrix<Size, Size> const & a, Matrix<Size, Cols> const & b) {
+      LuDecomposition<Size> const lu{a};
+      if (lu.isSingular()) {
+         return std::nullopt;
+      }
+      return lu.solve(b);
+   }
+
+   template<std::size_t Size>
+   constexpr std::optional<Matrix<Size, Size>> inverse(Matrix<Size, Size> const & a) {
+      return solve(a, Matrix<Size, Size>::identity());
+   }
+
+   namespace detail {
+      /**
+       * \brief Least squares solution, using Householder QR, of A_P z = b, where A_P is the columns of A for which
+       *        \c useColumn is set.  Elements of z for the other columns are set to 0.
+       *
+       * \return \c false if the columns used are (numerically) linearly dependent
+       */
+      template<std::size_t Rows, std::size_t Cols>
+      bool leastSquaresOnColumns(Matrix<Rows, Cols> const & a,
+                                 Vector<Rows> const & b,
+                                 std::array<bool, Cols> const & useColumn,
+                                 Vector<Cols> & z) {
+         static_assert(Rows >= Cols);
+         double const tolerance = singularTolerance * a.maxAbs();
+
+         // Pack the columns we want to the left of r
+         Matrix<Rows, Cols> r;
+         std::array<std::size_t, Cols> columns{};
+         std::size_t numColumns = 0;
+         for (std::size_t jj = 0; jj < Cols; ++jj) {
+            if (useColumn[jj]) {
+               for (std::size_t ii = 0; ii < Rows; ++ii) {
+                  r(ii, numColumns) = a(ii, jj);
+               }
+               columns[numColumns] = jj;
+               ++numColumns;
+            }
+         }
+         Vector<Rows> rhs = b;
+         std::array<double, Cols> diagonal{};
+
+         for (std::size_t kk = 0; kk < numColumns; ++kk) {
+            double norm = 0.0;
+            for (std::size_t ii = kk; ii < Rows; ++ii) {
+               norm += r(ii, kk) * r(ii, kk);
+            }
+            norm = std::sqrt(norm);
+            if (norm <= tolerance) {
+               return false;
+            }
+
+            // Reflect column kk onto -sign(r(kk, kk)) * norm * e_kk.  The Householder vector overwrites column kk.
+            diagonal[kk] = r(kk, kk) > 0.0 ? -norm : norm;
+            r(kk, kk) -= diagonal[kk];
+            double vTv = 0.0;
+            for (std::size_t ii = kk; ii < Rows; ++ii) {
+               vTv += r(ii, kk) * r(ii, kk);
+            }
+
+            for (std::size_t jj = kk + 1; jj < numColumns; ++jj) {
+               double vTx = 0.0;
+               for (std::size_t ii = kk; ii < Rows; ++ii) {
+                  vTx += r(ii, kk) * r(ii, jj);
+               }
+               double const factor = 2.0 * vTx / vTv;
+               for (std::size_t ii = kk; ii < Rows; ++ii) {
+                  r(ii, jj) -= factor * r(ii, kk);
+               }
+            }
+            double vTb = 0.0;
+            for (std::size_t ii = kk; ii < Rows; ++ii) {
+               vTb += r(ii, kk) * rhs[ii];
+            }
+            double const factor = 2.0 * vTb / vTv;
+            for (std::size_t ii = kk; ii < Rows; ++ii) {
+               rhs[ii] -= factor * r(ii, kk);
+            }
+         }
+
+         // Back substitution with the upper triangle of R
+         std::array<double, Cols> packed{};
+         for (std::size_t kk = numColumns; kk-- > 0; ) {
+            double sum = rhs[kk];
+            for (std::size_t jj = kk + 1; jj < numColumns; ++jj) {
+               sum -= r(kk, jj) * packed[jj];
+            }
+            packed[kk] = sum / diagonal[kk];
+         }
+
+         z = Vector<Cols>{};
+         for (std::size_t kk = 0; kk < numColumns; ++kk) {
+            z[columns[kk]] = packed[kk];
+         }
+         return true;
+      }
+   }
+
+   /**
+    * \brief Minimise |Ax - b| using Householder QR, or return \c std::nullopt if A does not have full column rank
+    */
+   template<std::size_t Rows, std::size_t Cols>
+   std::optional<Vector<Cols>> leastSquares(Matrix<Rows, Cols> const & a, Vector<Rows> const & b) {
+      std::array<bool, Cols> allColumns;
+      allColumns.fill(true);
+      Vector<Cols> x;
+      if (!detail::leastSquaresOnColumns(a, b, allColumns, x)) {
+         return std::nullopt;
+      }
+      return x;
+   }
+
+   /**
+    * \brief Minimise |Ax - b| subject to x >= 0, using the active set method of Lawson and Hanson ("Solving Least
+    *        Squares Problems", 1974, chapter 23).
+    */
+   template<std::size_t Rows, std::size_t Cols>
+   Vector<Cols> nonNegativeLeastSquares(Matrix<Rows, Cols> const & a, Vector<Rows> const & b) {
+      Vector<Cols> x;
+      std::array<bool, Cols> passive{};
+
+      // Each iteration adds one column to the passive set.  In theory, the method terminates in a finite number of
+      // steps; in practice, rounding errors can make it cycle, so we put a limit on things.
+      for (std::size_t iteration = 0; iteration < 3 * Cols; ++iteration) {
+         // w = Aᵀ(b - Ax) is the negative gradient of the objective
+         Vector<Rows> const residual = b - a * x;
+         std::size_t best = Cols;
+         double bestW = 1e-10;
+         for (std::size_t jj = 0; jj < Cols; ++jj) {
+            if (!passive[jj]) {
+               double w = 0.0;
+               for (std::size_t ii = 0; ii < Rows; ++ii) {
+                  w += a(ii, jj) * residual[ii];
+               }
+               if (w > bestW) {
+                  best = jj;
+                  bestW = w;
+               }
+            }
+         }
+         if (best == Cols) {
+            // Kuhn-Tucker conditions are satisfied, so we're done
+            break;
+         }
+         passive[best] = true;
+
+         for (std::size_t step = 0; step < Cols; ++step) {
+            Vector<Cols> z;
+            if (!detail::leastSquaresOnColumns(a, b, passive, z)) {
+               // Shouldn't happen unless columns are proportional, but, if it does, stick with what we've got
+               return x;
+            }
+
+            // If the unconstrained solution is feasible, take it.  Otherwise, move as far towards it as we can
+            // without going negative, and drop the column(s) that hit zero.
+            double alpha = 1.0;
+            std::size_t limiting = Cols;
+            for (std::size_t jj = 0; jj < Cols; ++jj) {
+               if (passive[jj] && z[jj] <= 0.0) {
+                  double const ratio = x[jj] / (x[jj] - z[jj]);
+                  if (ratio < alpha) {
+                     alpha = ratio;
+                     limiting = jj;
+                  }
+               }
+            }
+            if (limiting == Cols) {
+               x = z;
+               break;
+            }
+            for (std::size_t jj = 0; jj < Cols; ++jj) {
+               if (passive[jj]) {
+                  x[jj] += alpha * (z[jj] - x[jj]);
+                  if (jj == limiting || x[jj] <= 0.0) {
+                     x[jj] = 0.0;
+                     passive[jj] = false;
+                  }
+               }
+            }
+         }
+      }
+
+      return x;
+   }
+
+   /**
+    * \brief Bump allocator for \c DynamicMatrix storage.  Allocation is just moving a pointer along a block; nothing
+    *        is freed until \c reset() or destruction.  Not thread-safe -- use one per thread.
+    */
+   class Arena {
+   public:
+      //! \param blockSize Number of doubles per block.  Requests bigger than this get a block to themselves.
+      explicit Arena(std::size_t blockSize = 4096);
+      ~Arena();
+
+      Arena(Arena const &) = delete;
+      Arena & operator=(Arena const &) = delete;
+
+      //! \brief Zero-initialised storage for \c count doubles, valid until \c reset() or destruction
+      double * allocate(std::size_t count);
+
+      //! \brief Make all the storage available again.  Anything using it must no longer be in use.
+      void reset();
+
+   private:
+      struct Block {
+         std::unique_ptr<double[]> data;
+         std::size_t size;
+      };
+      std::vector<Block> m_blocks;
+      std::size_t m_blockSize;
+      std::size_t m_currentBlock;
+      std::size_t m_used;
+   };
+
+   /**
+    * \brief Dense matrix with dimensions set at run time, stored by row.  Storage comes from an \c Arena if one is
+    *        supplied (in which case the matrix, and any copies of it, must not outlive the arena's next \c reset()),
+    *        otherwise from the heap.
+    */
+   class DynamicMatrix {
+   public:
+      //! \brief All zeros
+      DynamicMatrix(std::size_t rows, std::size_t cols, Arena * arena = nullptr);
+      template<std::size_t Rows, std::size_t Cols>
+      explicit DynamicMatrix(Matrix<Rows, Cols> const & matrix, Arena * arena = nullptr) :
+         DynamicMatrix{Rows, Cols, arena} {
+         std::copy(matrix.data(), matrix.data() + Rows * Cols, m_data);
+         return;
+      }
+      //! \brief Copies use the same arena as the original
+      DynamicMatrix(DynamicMatrix const & other);
+      DynamicMatrix(DynamicMatrix && other) noexcept;
+      DynamicMatrix & operator=(DynamicMatrix const & other);
+      DynamicMatrix & operator=(DynamicMatrix && other) noexcept;
+      ~DynamicMatrix();
+
+      static DynamicMatrix identity(std::size_t size, Arena * arena = nullptr);
+
+      std::size_t rows() const { return m_rows; }
+      std::size_t cols() const { return m_cols; }
+
+      double & operator()(std::size_t const row, std::size_t const col) {
+         Q_ASSERT(row < m_rows && col < m_cols);
+         return m_data[row * m_cols + col];
+      }
+      double operator()(std::size_t const row, std::size_t const col) const {
+         Q_ASSERT(row < m_rows && col < m_cols);
+         return m_data[row * m_cols + col];
+      }
+
+      //! \brief View (not copy) of one row
+      BtSpan::span<double>       row(std::size_t row);
+      BtSpan::span<double const> row(std::size_t row) const;
+
+      //! \brief Dimensions must match
+      DynamicMatrix & operator+=(DynamicMatrix const & rhs);
+      DynamicMatrix & operator-=(DynamicMatrix const & rhs);
+
+      /**
+       * \brief Swap two rows in place
+       */
+      void swapRows(std::size_t row1, std::size_t row2);
+
+      /**
+       * \brief Convert to reduced row echelon form in place.  Values smaller than \c tolerance are treated as zero.
+       */
+      void rref(double tolerance);
+
+      Arena * arena() const { return m_arena; }
+      double       * data()       { return m_data; }
+      double const * data() const { return m_data; }
+
+   private:
+      void allocate();
+      void release();
+
+      std::size_t m_rows;
+      std::size_t m_cols;
+      Arena * m_arena;
+      double * m_data;
+   };
+
+   /**
+    * \brief \c result = \c lhs × \c rhs, without allocating.  Dimensions must match and \c result must not be either
+    *        of the inputs.
+    */
+   void multiply(DynamicMatrix const & lhs, DynamicMatrix const & rhs, DynamicMatrix & result);
+
+   /**
+    * \brief Solve AX = B in place, using LU decomposition with partial pivoting.  On return, \c a is overwritten and
+    *        \c b holds X.
+    *
+    * \return \c false if \c a is singular (in which case \c b is unspecified)
+    */
+   bool solveInPlace(DynamicMatrix & a, DynamicMatrix & b);
+}
+
+#endif
@@ -44,6 +44,9 @@ namespace {
 
    QString currentLanguage = "en";
 
+   //! \brief See \c Localization::languageGeneration
+   unsigned int languageChanges = 0;
+
    QTranslator defaultTrans;
    QTranslator btTrans;
 
@@ -130,6 +133,7 @@ QString Localization::displayDateUserFormated(QDate const & date) {
 
 void Localization::setLanguage(QString twoLetterLanguage) {
    currentLanguage = twoLetterLanguage;
+   ++languageChanges;
    qApp->removeTranslator(&btTrans);
 
    QString filename = QString("bt_%1").arg(twoLetterLanguage);
@@ -145,6 +149,10 @@ QString const & Localization::getCurrentLanguage() {
    return currentLanguage;
 }
 
+unsigned int Localization::languageGeneration() {
+   return languageChanges;
+}
+
 QString const & Localization::getSystemLanguage() {
    // QLocale::name() is of the form language_country,
    // where 'language' is a lowercase 2-letter ISO 639-1 language code,
@@ -97,6 +97,12 @@ namespace Localization {
     */
    QString const & getCurrentLanguage();
 
+   /**
+    * \brief Goes up by one every time the language is set, so that anything holding on to translated text can tell
+    *        when it might need redoing
+    */
+   unsigned int languageGeneration();
+
    /**
     * \brief Gets the ISO 639-1 language code for the system.
     * \returns current 2-letter ISO 639-1 system language code
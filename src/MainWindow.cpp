@@ -66,6 +66,7 @@
 #include "Algorithms.h"
 #include "AncestorDialog.h"
 #include "Application.h"
+#include "BatchPlannerDialog.h"
 #include "BrewNoteWidget.h"
 #include "BtDatePopup.h"
 #include "BtFolder.h"
@@ -111,6 +112,7 @@
 #include "PrimingDialog.h"
 #include "PrintAndPreviewDialog.h"
 #include "RangedSlider.h"
+#include "RecipeDisplayQueue.h"
 #include "RecipeFormatter.h"
 #include "RefractoDialog.h"
 #include "RelationalUndoableUpdate.h"
@@ -118,6 +120,7 @@
 #include "StrikeWaterDialog.h"
 #include "StyleEditor.h"
 #include "StyleListModel.h"
+#include "StyleMatchDialog.h"
 #include "StyleSortFilterProxyModel.h"
 #include "tableModels/FermentableTableModel.h"
 #include "tableModels/HopTableModel.h"
@@ -218,12 +221,129 @@ public:
    impl(MainWindow & self) :
       self{self},
       fileOpener{},
-      fileOpenDirectory{QDir::homePath()} {
+      fileOpenDirectory{QDir::homePath()},
+      recipeDisplayQueue{self, [this](unsigned int const displays) { this->showQueuedRecipeDisplays(displays); }} {
       return;
    }
 
    ~impl() = default;
 
+   //! \brief See \c RecipeDisplayQueue::queue
+   void queueRecipeDisplays(QString const & propertyName) {
+      this->recipeDisplayQueue.queue(propertyName);
+      return;
+   }
+
+   void showQueuedRecipeDisplays(unsigned int const displays) {
+      // The recipe might have been deselected since the displays were queued
+      if (self.recipeObs) {
+         this->showRecipeDisplays(displays);
+      }
+      return;
+   }
+
+   /**
+    * \brief Update the given parts (see \c RecipeDisplayQueue::Display) of the recipe tab from the current recipe
+    */
+   void showRecipeDisplays(unsigned int const displays) {
+      using Display = RecipeDisplayQueue::Display;
+      Recipe & recipe = *self.recipeObs;
+      Style const * style = recipe.style();
+
+      if (displays & Display::Name) {
+         self.lineEdit_name->setText(recipe.name());
+         self.lineEdit_name->setCursorPosition(0);
+      }
+      if (displays & Display::BatchSize) {
+         self.lineEdit_batchSize->setAmount(recipe.batchSize_l());
+         self.lineEdit_batchSize->setCursorPosition(0);
+      }
+      if (displays & Display::BoilSize) {
+         self.lineEdit_boilSize->setAmount(recipe.boilSize_l());
+         self.lineEdit_boilSize->setCursorPosition(0);
+      }
+      if (displays & Display::Efficiency) {
+         self.lineEdit_efficiency->setAmount(recipe.efficiency_pct());
+         self.lineEdit_efficiency->setCursorPosition(0);
+      }
+      if (displays & Display::BoilTime) {
+         self.lineEdit_boilTime->setAmount(recipe.boilTime_min());
+         self.lineEdit_boilTime->setCursorPosition(0);
+      }
+      if (displays & Display::BoilSg) {
+         self.lineEdit_boilSg->setAmount(recipe.boilGrav());
+      }
+
+      if (displays & Display::OgSlider) {
+         if (style) {
+            updateDensitySlider(*self.styleRangeWidget_og, *self.oGLabel, style->ogMin(), style->ogMax(), 1.120);
+         }
+         self.styleRangeWidget_og->setValue(self.oGLabel->getAmountToDisplay(recipe.og()));
+      }
+      if (displays & Display::FgSlider) {
+         if (style) {
+            updateDensitySlider(*self.styleRangeWidget_fg, *self.fGLabel, style->fgMin(), style->fgMax(), 1.030);
+         }
+         self.styleRangeWidget_fg->setValue(self.fGLabel->getAmountToDisplay(recipe.fg()));
+      }
+      if (displays & Display::AbvSlider) {
+         self.styleRangeWidget_abv->setValue(recipe.ABV_pct());
+      }
+      if (displays & Display::IbuSlider) {
+         self.styleRangeWidget_ibu->setValue(recipe.IBU());
+      }
+
+      if (displays & Display::BatchSizeRange) {
+         double const finalVolume = self.label_batchSize->getAmountToDisplay(recipe.finalVolume_l());
+         self.rangeWidget_batchSize->setRange         (0, self.label_batchSize->getAmountToDisplay(recipe.batchSize_l()));
+         self.rangeWidget_batchSize->setPreferredRange(0, finalVolume);
+         self.rangeWidget_batchSize->setValue         (finalVolume);
+      }
+      if (displays & Display::BoilSizeRange) {
+         double const boilVolume = self.label_boilSize->getAmountToDisplay(recipe.boilVolume_l());
+         self.rangeWidget_boilsize->setRange         (0, self.label_boilSize->getAmountToDisplay(recipe.boilSize_l()));
+         self.rangeWidget_boilsize->setPreferredRange(0, boilVolume);
+         self.rangeWidget_boilsize->setValue         (boilVolume);
+      }
+
+      // Colors need the same basic treatment as gravity
+      if (displays & Display::ColorSlider) {
+         if (style) {
+            updateColorSlider(*self.styleRangeWidget_srm,
+                              *self.colorSRMLabel,
+                              style->colorMin_srm(),
+                              style->colorMax_srm());
+         }
+         self.styleRangeWidget_srm->setValue(self.colorSRMLabel->getAmountToDisplay(recipe.color_srm()));
+      }
+
+      // In some, incomplete, recipes, OG is approximately 1.000, which then makes GU close to 0 and thus IBU/GU
+      // insanely large.  Besides being meaningless, such a large number takes up a lot of space.  So, where gravity
+      // units are below 1, we just show IBU on the IBU/GU slider.
+      if (displays & Display::IbuGuSlider) {
+         auto gravityUnits = (recipe.og() - 1) * 1000;
+         if (gravityUnits < 1) {
+            gravityUnits = 1;
+         }
+         self.ibuGuSlider->setValue(recipe.IBU() / gravityUnits);
+      }
+
+      if (displays & Display::Calories) {
+         bool const metric =
+            Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) ==
+            Measurement::UnitSystems::volume_Metric;
+         self.label_calories->setText(
+            QString("%1").arg(metric ? recipe.calories33cl() : recipe.calories12oz(), 0, 'f', 0)
+         );
+      }
+
+      // See if we need to change the mash in the table.
+      if ((displays & Display::MashSteps) && recipe.mash()) {
+         self.mashStepTableModel->setMash(recipe.mash());
+      }
+      return;
+   }
+
    /**
     * @brief Import recipes, hops, equipment, etc from files specified by the user.  (Currently this is just BeerXML,
     *        but in future could well be other formats too.
@@ -338,6 +458,7 @@ private:
    MainWindow & self;
    QFileDialog* fileOpener;
    QString fileOpenDirectory;
+   RecipeDisplayQueue recipeDisplayQueue;
 };
 
 
@@ -622,6 +743,8 @@ void MainWindow::setupDialogs()
    refractoDialog = new RefractoDialog(this);
    mashDesigner = new MashDesigner(this);
    pitchDialog = new PitchDialog(this);
+   styleMatchDialog = new StyleMatchDialog(this);
+   batchPlannerDialog = new BatchPlannerDialog(this);
    btDatePopup = new BtDatePopup(this);
 
    waterDialog = new WaterDialog(this);
@@ -948,6 +1071,8 @@ void MainWindow::setupTriggers() {
    connect( actionDeleteSelected, &QAction::triggered, this, &MainWindow::deleteSelected );
    connect( actionWater_Chemistry, &QAction::triggered, this, &MainWindow::popChemistry);                               // > Tools > Water Chemistry
    connect( actionAncestors, &QAction::triggered, this, &MainWindow::setAncestor);                                      // > Tools > Ancestors
+   connect( actionStyle_Match, &QAction::triggered, this, &MainWindow::showStyleMatchDialog);                           // > Tools > Style Match
+   connect( actionBatch_Planner, &QAction::triggered, this, &MainWindow::showBatchPlannerDialog);                        // > Tools > Batch Planner
    connect( action_brewit, &QAction::triggered, this, &MainWindow::brewItHelper );
    //One Dialog to rule them all, at least all printing and export.
    connect( actionPrint, &QAction::triggered, printAndPreviewDialog, &QWidget::show);                                   // > File > Print and Preview
@@ -1335,6 +1460,7 @@ void MainWindow::setRecipe(Recipe* recipe) {
    recipeFormatter->setRecipe(recipe);
    ogAdjuster->setRecipe(recipe);
    recipeExtrasWidget->setRecipe(recipe);
+   recipeSweepWidget->setRecipe(recipe);
    mashDesigner->setRecipe(recipe);
    equipmentButton->setRecipe(recipe);
    singleEquipEditor->setEquipment(recEquip);
@@ -1460,107 +1586,17 @@ void MainWindow::showChanges(QMetaProperty* prop) {
       return;
    }
 
-   bool updateAll = (prop == nullptr);
-   QString propName;
-
    if (prop) {
-      propName = prop->name();
-   }
-
-   // May St. Stevens preserve me
-   this->lineEdit_name      ->setText  (this->recipeObs->name          ());
-   this->lineEdit_batchSize ->setAmount(this->recipeObs->batchSize_l   ());
-   this->lineEdit_boilSize  ->setAmount(this->recipeObs->boilSize_l    ());
-   this->lineEdit_efficiency->setAmount(this->recipeObs->efficiency_pct());
-   this->lineEdit_boilTime  ->setAmount(this->recipeObs->boilTime_min  ());
-   this->lineEdit_name      ->setCursorPosition(0);
-   this->lineEdit_batchSize ->setCursorPosition(0);
-   this->lineEdit_boilSize  ->setCursorPosition(0);
-   this->lineEdit_efficiency->setCursorPosition(0);
-   this->lineEdit_boilTime  ->setCursorPosition(0);
-/*
-   lineEdit_calcBatchSize->setText(recipeObs);
-   lineEdit_calcBoilSize->setText(recipeObs);
-*/
-
-   // Color manipulation
-/*
-   if( 0.95*recipeObs->batchSize_l() <= recipeObs->finalVolume_l() && recipeObs->finalVolume_l() <= 1.05*recipeObs->batchSize_l() )
-      lineEdit_calcBatchSize->setStyleSheet(goodSS);
-   else if( recipeObs->finalVolume_l() < 0.95*recipeObs->batchSize_l() )
-      lineEdit_calcBatchSize->setStyleSheet(lowSS);
-   else
-      lineEdit_calcBatchSize->setStyleSheet(highSS);
-
-   if( 0.95*recipeObs->boilSize_l() <= recipeObs->boilVolume_l() && recipeObs->boilVolume_l() <= 1.05*recipeObs->boilSize_l() )
-      lineEdit_calcBoilSize->setStyleSheet(goodSS);
-   else if( recipeObs->boilVolume_l() < 0.95* recipeObs->boilSize_l() )
-      lineEdit_calcBoilSize->setStyleSheet(lowSS);
-   else
-      lineEdit_calcBoilSize->setStyleSheet(highSS);
-*/
-   this->lineEdit_boilSg->setAmount(this->recipeObs->boilGrav());
-
-   Style const * style = this->recipeObs->style();
-   if (style) {
-      updateDensitySlider(*this->styleRangeWidget_og, *this->oGLabel, style->ogMin(), style->ogMax(), 1.120);
-   }
-   this->styleRangeWidget_og->setValue(this->oGLabel->getAmountToDisplay(recipeObs->og()));
-
-   if (style) {
-      updateDensitySlider(*this->styleRangeWidget_fg, *this->fGLabel, style->fgMin(), style->fgMax(), 1.030);
-   }
-   this->styleRangeWidget_fg->setValue(this->fGLabel->getAmountToDisplay(recipeObs->fg()));
-
-   this->styleRangeWidget_abv->setValue(recipeObs->ABV_pct());
-   this->styleRangeWidget_ibu->setValue(recipeObs->IBU());
-
-   this->rangeWidget_batchSize->setRange         (0,
-                                                  this->label_batchSize->getAmountToDisplay(this->recipeObs->batchSize_l()));
-   this->rangeWidget_batchSize->setPreferredRange(0,
-                                                  this->label_batchSize->getAmountToDisplay(this->recipeObs->finalVolume_l()));
-   this->rangeWidget_batchSize->setValue         (this->label_batchSize->getAmountToDisplay(this->recipeObs->finalVolume_l()));
-
-   this->rangeWidget_boilsize->setRange         (0,
-                                                 this->label_boilSize->getAmountToDisplay(this->recipeObs->boilSize_l()));
-   this->rangeWidget_boilsize->setPreferredRange(0,
-                                                 this->label_boilSize->getAmountToDisplay(this->recipeObs->boilVolume_l()));
-   this->rangeWidget_boilsize->setValue         (this->label_boilSize->getAmountToDisplay(this->recipeObs->boilVolume_l()));
-
-   /* Colors need the same basic treatment as gravity */
-   if (style) {
-      updateColorSlider(*this->styleRangeWidget_srm,
-                        *this->colorSRMLabel,
-                        style->colorMin_srm(),
-                        style->colorMax_srm());
-   }
-   this->styleRangeWidget_srm->setValue(this->colorSRMLabel->getAmountToDisplay(this->recipeObs->color_srm()));
-
-   // In some, incomplete, recipes, OG is approximately 1.000, which then makes GU close to 0 and thus IBU/GU insanely
-   // large.  Besides being meaningless, such a large number takes up a lot of space.  So, where gravity units are
-   // below 1, we just show IBU on the IBU/GU slider.
-   auto gravityUnits = (recipeObs->og()-1)*1000;
-   if (gravityUnits < 1) {
-      gravityUnits = 1;
+      this->pimpl->queueRecipeDisplays(prop->name());
+      return;
    }
-   ibuGuSlider->setValue(recipeObs->IBU()/gravityUnits);
-
-   label_calories->setText(
-      QString("%1").arg(Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) == Measurement::UnitSystems::volume_Metric ? recipeObs->calories33cl() : recipeObs->calories12oz(),0,'f',0)
-   );
 
-   // See if we need to change the mash in the table.
-   if ((updateAll && recipeObs->mash()) ||
-       (propName == "mash" && recipeObs->mash())) {
-      mashStepTableModel->setMash(recipeObs->mash());
-   }
+   this->pimpl->showRecipeDisplays(RecipeDisplayQueue::allDisplays);
 
    // Not sure about this, but I am annoyed that modifying the hop usage
    // modifiers isn't automatically updating my display
-   if (updateAll) {
-     recipeObs->recalcIBU();
-     hopTableProxy->invalidate();
-   }
+   recipeObs->recalcIBU();
+   hopTableProxy->invalidate();
    return;
 }
 
@@ -3093,6 +3129,20 @@ void MainWindow::showPitchDialog()
    pitchDialog->show();
 }
 
+void MainWindow::showStyleMatchDialog()
+{
+   styleMatchDialog->setRecipe(recipeObs);
+   styleMatchDialog->show();
+   styleMatchDialog->raise();
+}
+
+void MainWindow::showBatchPlannerDialog()
+{
+   batchPlannerDialog->addToQueue(recipeObs);
+   batchPlannerDialog->show();
+   batchPlannerDialog->raise();
+}
+
 void MainWindow::showEquipmentEditor()
 {
    if ( recipeObs && ! recipeObs->equipment() )
@@ -51,6 +51,7 @@
 class AboutDialog;
 class AlcoholTool;
 class AncestorDialog;
+class BatchPlannerDialog;
 class BeerColorWidget;
 class BrewDayScrollWidget;
 class BrewNoteWidget;
@@ -92,6 +93,7 @@ class ScaleRecipeTool;
 class StrikeWaterDialog;
 class StyleEditor;
 class StyleListModel;
+class StyleMatchDialog;
 class StyleSortFilterProxyModel;
 class TimerMainDialog;
 class WaterDialog;
@@ -184,6 +186,12 @@ public slots:
    //! \brief Show the pitch dialog.
    void showPitchDialog();
 
+   //! \brief Show the style match dialog for the current recipe.
+   void showStyleMatchDialog();
+
+   //! \brief Show the batch planner, with the current recipe in the queue.
+   void showBatchPlannerDialog();
+
    //! \brief Add given Hop to the Recipe.
    void addHopToRecipe(std::shared_ptr<Hop> hop);
    //! \brief Remove selected Hop(s) from the Recipe.
@@ -302,7 +310,9 @@ public slots:
     * Updates all the widgets with info about the currently
     * selected Recipe, except for the tables.
     *
-    * \param prop Not yet used. Will indicate which Recipe property has changed.
+    * \param prop Which Recipe property has changed.  If \c nullptr, everything is updated straight away.  Otherwise,
+    *             only the widgets showing that property are updated, on the next pass through the event loop, along
+    *             with those for any other properties that change in the meantime.
     */
    void showChanges(QMetaProperty* prop = nullptr);
 
@@ -383,6 +393,8 @@ private:
    RefractoDialog* refractoDialog;
    MashDesigner* mashDesigner;
    PitchDialog* pitchDialog;
+   StyleMatchDialog* styleMatchDialog;
+   BatchPlannerDialog* batchPlannerDialog;
    QPrinter *printer;
 
    WaterDialog* waterDialog;
@@ -26,7 +26,6 @@
 #include <QMessageBox>
 
 #include "database/ObjectStoreWrapper.h"
-#include "HeatCalculations.h"
 #include "measurement/Measurement.h"
 #include "model/Fermentable.h"
 #include "PhysicalConstants.h"
@@ -37,7 +36,10 @@ MashDesigner::MashDesigner(QWidget * parent) : QDialog     {parent},
                                                equip       {nullptr},
                                                mashStep    {nullptr},
                                                prevStep    {nullptr},
-                                               addedWater_l{0} {
+                                               grain_kg    {0},
+                                               curStep     {0},
+                                               simulator   {},
+                                               limits      {} {
    this->setupUi(this);
 
    // .:TODO:. Would be good to make the label & field naming a bit more consistent in the .ui file
@@ -122,14 +124,9 @@ bool MashDesigner::nextStep(int step) {
 
    this->prevStep = this->mashStep;
    if (this->mashStep) {
-      // NOTE: This needs to be changed. Assumes 1L of water is 1 kg.
-      this->MC += this->mashStep->infuseAmount_l() * HeatCalculations::Cw_calGC;
-      this->addedWater_l += this->mashStep->infuseAmount_l();
-
-      if (!this->prevStep) {
-         // If the last step is null, we need to add the influence of the tun.
-         this->MC += this->mash->tunSpecificHeat_calGC() * this->mash->tunWeight_kg();
-      }
+      // The simulator takes care of adding the water from this step, and the tun after the first step, to the thermal
+      // mass of the mash
+      this->simulator.appendStep(MashSimulation::Step::from(*this->mashStep));
    }
 
    // If we have a step number, and the step is smaller than the current
@@ -149,12 +146,14 @@ bool MashDesigner::nextStep(int step) {
    this->horizontalSlider_amount->setValue(0); // Least amount of water.
 
    // Update max amount here, instead of later. Cause later makes no sense.
+   this->refreshLimits();
    this->updateMaxAmt();
 
    return true;
 }
 
 void MashDesigner::saveStep() {
+   this->refreshLimits();
    this->mashStep->setName(this->lineEdit_name->text());
    this->mashStep->setType(static_cast<MashStep::Type>(comboBox_type->currentIndex()));
    // Bound the target temperature to what can be achieved
@@ -178,7 +177,7 @@ double MashDesigner::stepTemp_c() {
 
 bool MashDesigner::heating() {
    // Returns true if the current step is hotter than the previous step
-   return stepTemp_c() >= (this->prevStep ? this->prevStep->stepTemp_c() : this->mash->grainTemp_c());
+   return this->limits.heating;
 }
 
 double MashDesigner::boilingTemp_c() {
@@ -190,11 +189,11 @@ double MashDesigner::boilingTemp_c() {
 }
 
 double MashDesigner::maxTemp_c() {
-   return (heating())? boilingTemp_c() : tempFromVolume_c(maxAmt_l());
+   return this->limits.maxTemp_c;
 }
 
 double MashDesigner::minTemp_c() {
-   return (heating())? tempFromVolume_c(maxAmt_l()) : 0.0;
+   return this->limits.minTemp_c;
 }
 
 double MashDesigner::bound_temp_c(double temp_c) {
@@ -204,35 +203,51 @@ double MashDesigner::bound_temp_c(double temp_c) {
 
 // The mash volume up to and not including the step currently being edited.
 double MashDesigner::mashVolume_l() {
-   return grain_kg/PhysicalConstants::grainDensity_kgL + addedWater_l;
+   return grain_kg/PhysicalConstants::grainDensity_kgL + this->limits.start.water_l;
 }
 
 double MashDesigner::minAmt_l() {
-   double minVol_l = volFromTemp_l((heating())? maxTemp_c() : minTemp_c());
-
-   // Sanity checks
-   // TODO: If minVol_l > maxAmt_l(), change the target temp?
-   minVol_l = std::min(minVol_l, maxAmt_l());
-
-   return minVol_l;
+   return this->limits.minAmt_l;
 }
 
 // However much more we can add at this step.
 double MashDesigner::maxAmt_l() {
-   double amt = 0;
+   return this->limits.maxAmt_l;
+}
 
-   if (equip == nullptr) {
-      return amt;
+void MashDesigner::refreshLimits() {
+   this->limits = Limits{};
+   if (!this->mash) {
+      return;
    }
 
+   std::size_t const stepIndex = this->simulator.numSteps();
+   this->limits.target_c = this->stepTemp_c();
+   this->limits.start    = this->simulator.stateBefore(stepIndex);
+   this->limits.heating  = this->limits.target_c >= this->limits.start.temp_c;
+   this->limits.infusion = this->simulator.infusion(stepIndex, this->type(), this->limits.target_c);
+
    // However much more we can fit in the tun.
-   if (!isSparge()) {
-      amt = equip->tunVolume_l() - mashVolume_l();
+   if (this->equip) {
+      double amt = this->equip->tunVolume_l() - (this->isSparge() ? this->grainVolume_l() : this->mashVolume_l());
+      this->limits.maxAmt_l = std::min(amt, this->recObs->targetTotalMashVol_l() - this->limits.start.water_l);
+   }
+
+   double const tempAtMaxAmt_c = this->tempFromVolume_c(this->limits.maxAmt_l);
+   if (this->limits.heating) {
+      this->limits.maxTemp_c = this->boilingTemp_c();
+      this->limits.minTemp_c = tempAtMaxAmt_c;
    } else {
-      amt = equip->tunVolume_l() - grainVolume_l();
+      this->limits.maxTemp_c = tempAtMaxAmt_c;
+      this->limits.minTemp_c = 0.0;
    }
 
-   return std::min(amt, recObs->targetTotalMashVol_l() - addedWater_l);
+   // TODO: If minAmt_l > maxAmt_l, change the target temp?
+   this->limits.minAmt_l = std::min(
+      this->volFromTemp_l(this->limits.heating ? this->limits.maxTemp_c : this->limits.minTemp_c),
+      this->limits.maxAmt_l
+   );
+   return;
 }
 
 // Returns the required volume of water to infuse if the strike water is
@@ -242,22 +257,8 @@ double MashDesigner::volFromTemp_l(double temp_c) {
       return 0.0;
    }
 
-   double tw = temp_c;
-   // Final temp is target temp.
-   double tf = stepTemp_c();
-   // Initial temp is the last step's temp if the last step exists, otherwise the grain temp.
-   double t1 = (!this->prevStep) ? mash->grainTemp_c() : this->prevStep->stepTemp_c();
-   double mt = mash->tunSpecificHeat_calGC();
-   double ct = mash->tunWeight_kg();
-
-   double mw = 1/(HeatCalculations::Cw_calGC * (tw - tf)) *
-      (MC * (tf - t1) + ((!this->prevStep) ? mt * ct * (tf - this->mash->tunTemp_c()) : 0));
-
-   // Sanity check for unlikely edge cases
-   mw = std::max(0., mw);
-
    // NOTE: This needs to be changed. Assumes 1L of water is 1 kg.
-   return mw;
+   return this->limits.infusion.volumeForTemp_l(temp_c);
 }
 
 // Returns the required temp of strike water required if
@@ -267,43 +268,8 @@ double MashDesigner::tempFromVolume_c(double vol_l) {
       return 0.0;
    }
 
-   double absorption_LKg;
-   if (this->equip) {
-      absorption_LKg = this->equip->grainAbsorption_LKg();
-   } else {
-      absorption_LKg = PhysicalConstants::grainAbsorption_Lkg;
-   }
-
-   double tf = stepTemp_c();
-
    // NOTE: This needs to be changed. Assumes 1L = 1 kg.
-   double mw = vol_l;
-   if (mw <= 0) {
-      return 0.0;
-   }
-   double cw = HeatCalculations::Cw_calGC;
-   // Initial temp is the last step's temp if the last step exists, otherwise the grain temp.
-   double t1 = (!this->prevStep) ? this->mash->grainTemp_c() : this->prevStep->stepTemp_c();
-   // When batch sparging, you lose about 10C from previous step.
-   if (isSparge()) {
-      t1 = (!this->prevStep) ? this->mash->grainTemp_c() : this->prevStep->stepTemp_c() - 10;
-   }
-   double mt = this->mash->tunSpecificHeat_calGC();
-   double ct = this->mash->tunWeight_kg();
-
-   double batchMC = grain_kg * HeatCalculations::Cgrain_calGC
-                    + absorption_LKg * grain_kg * HeatCalculations::Cw_calGC
-                    + this->mash->tunWeight_kg() * this->mash->tunSpecificHeat_calGC();
-
-   double tw = 1 / (mw * cw) * (
-      (this->isSparge() ? batchMC : MC) * (tf - t1) + (!this->prevStep ? mt * ct * (tf - this->mash->tunTemp_c()) : 0)
-   ) + tf;
-
-   // Sanity check this value
-   tw = std::min(tw, boilingTemp_c());  // Can't add water above boiling
-   tw = std::max(tw, 0.0);  // (Probably) won't add water below freezing
-
-   return tw;
+   return this->limits.infusion.tempForVolume_c(vol_l);
 }
 
 // How many liters of grain are in the tun.
@@ -358,12 +324,12 @@ bool MashDesigner::initializeMash() {
    this->mash->setTunTemp_c(Measurement::qStringToSI(dialogText, Measurement::PhysicalQuantity::Temperature).quantity());
 
    this->curStep = 0;
-   this->addedWater_l = 0;
    this->mashStep.reset();
    this->prevStep.reset();
 
-   this->MC = recObs->grainsInMash_kg() * HeatCalculations::Cgrain_calGC;
    this->grain_kg = recObs->grainsInMash_kg();
+   this->simulator = MashSimulation::Simulator{MashSimulation::Constants::make(*this->mash, this->equip, this->grain_kg)};
+   this->refreshLimits();
 
    this->label_tunVol->setText(Measurement::displayAmount(Measurement::Amount{equip->tunVolume_l(), Measurement::Units::liters}));
    this->label_wortMax->setText(Measurement::displayAmount(Measurement::Amount{recObs->targetCollectedWortVol_l(), Measurement::Units::liters}));
@@ -409,7 +375,7 @@ void MashDesigner::updateFullness() {
 
    this->progressBar_fullness->setValue(static_cast<int>(ratio*progressBar_fullness->maximum()));
    this->label_mashVol->setText(Measurement::displayAmount(Measurement::Amount{vol_l, Measurement::Units::liters}));
-   this->label_thickness->setText(Measurement::displayThickness((addedWater_l + (isInfusion() ? selectedAmount_l() : 0))/grain_kg));
+   this->label_thickness->setText(Measurement::displayThickness((this->limits.start.water_l + (isInfusion() ? selectedAmount_l() : 0))/grain_kg));
    return;
 }
 
@@ -582,15 +548,17 @@ void MashDesigner::updateTemp() {
    } else if (isDecoction()) {
       label_temp->setText(Measurement::displayAmount(Measurement::Amount{maxTemp_c(), Measurement::Units::celsius}));
    } else {
-      label_temp->setText(Measurement::displayAmount(Measurement::Amount{stepTemp_c(), Measurement::Units::celsius}));
+      label_temp->setText(Measurement::displayAmount(Measurement::Amount{this->limits.target_c, Measurement::Units::celsius}));
    }
 }
 
 void MashDesigner::saveTargetTemp() {
-   double temp = this->bound_temp_c(this->stepTemp_c());
+   this->refreshLimits();
+   double temp = this->bound_temp_c(this->limits.target_c);
 
    // be nice and reset the field so it displays in proper units
    this->lineEdit_temp->setAmount(temp);
+   this->refreshLimits();
    if (this->mashStep) {
       this->mashStep->setStepTemp_c(temp);
    }
@@ -619,33 +587,14 @@ void MashDesigner::saveTargetTemp() {
 }
 
 double MashDesigner::getDecoctionAmount_l() {
-   double m_w, m_g, r;
-   double c_w, c_g;
-   double tf, t1;
-
    if (!this->prevStep) {
       QMessageBox::critical(this, tr("Decoction error"), tr("The first mash step cannot be a decoction."));
       qCritical() << "MashDesigner: First step not a decoction.";
       return 0;
    }
-   tf = stepTemp_c();
-   t1 = this->prevStep->stepTemp_c();
-
-   m_w = addedWater_l; // NOTE: this is bad. Assumes 1L = 1 kg.
-   m_g = grain_kg;
-
-   c_w = HeatCalculations::Cw_calGC;
-   c_g = HeatCalculations::Cgrain_calGC;
-
-   // r is the ratio of water and grain to take out for decoction.
-   r = ((MC)*(tf-t1)) / ((m_w*c_w + m_g*c_g)*(maxTemp_c()-tf) + (m_w*c_w + m_g*c_g)*(tf-t1));
-   if (r < 0 || r > 1) {
-      //QMessageBox::critical(this, tr("Decoction error"), tr("Something went wrong in decoction calculation."));
-      //Application::log(Application::ERROR, QString("MashDesigner Decoction: r=%1").arg(r));
-      return 0;
-   }
 
-   return r*mashVolume_l();
+   // Returns 0 if the ratio of water and grain to take out for decoction is not between 0 and 1
+   return this->simulator.decoctionAmount_l(this->simulator.numSteps(), this->limits.target_c);
 }
 
 bool MashDesigner::isBatchSparge() const {
@@ -688,6 +637,8 @@ void MashDesigner::typeChanged() {
    if (this->mashStep) {
       this->mashStep->setType(stepType);
    }
+   // Sparges have a different heat balance and maximum amount
+   this->refreshLimits();
 
    // fly sparge is the end of the line. No more steps can be added after
    if (isFlySparge()) {
@@ -26,6 +26,7 @@
 #include <QWidget>
 
 #include "ui_mashDesigner.h"
+#include "MashSimulation.h"
 #include "model/Recipe.h"
 #include "model/Mash.h"
 #include "model/MashStep.h"
@@ -66,6 +67,7 @@ private:
    bool nextStep(int step);
    void saveStep();
    bool initializeMash();
+   void refreshLimits();
    double minTemp_c();
    double maxTemp_c();
    double minAmt_l();
@@ -99,10 +101,27 @@ private:
    Equipment* equip;
    std::shared_ptr<MashStep> mashStep;
    std::shared_ptr<MashStep> prevStep;
-   double addedWater_l;
    double grain_kg;
-   double MC;
    int curStep;
+
+   //! Heat balance of the steps done so far
+   MashSimulation::Simulator simulator;
+
+   /**
+    * \brief Everything the sliders need for the step being edited.  This only changes when the step's type or target
+    *        temperature does (see \c refreshLimits), so we work it out then rather than every time a slider moves.
+    */
+   struct Limits {
+      //! Target temperature, as entered
+      double target_c  = 0.0;
+      bool   heating   = true;
+      MashSimulation::State start;
+      MashSimulation::Infusion infusion;
+      double minAmt_l  = 0.0;
+      double maxAmt_l  = 0.0;
+      double minTemp_c = 0.0;
+      double maxTemp_c = 0.0;
+   } limits;
 };
 
 #endif
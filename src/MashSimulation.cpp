@@ -0,0 +1,266 @@
+/*
+ * MashSimulation.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "MashSimulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "HeatCalculations.h"
+#include "model/Equipment.h"
+#include "model/Mash.h"
+#include "PhysicalConstants.h"
+
+namespace {
+   bool isSparge(MashStep::Type const type) {
+      return type == MashStep::Type::batchSparge || type == MashStep::Type::flySparge;
+   }
+
+   bool isInfusion(MashStep::Type const type) {
+      return type == MashStep::Type::Infusion || isSparge(type);
+   }
+}
+
+MashSimulation::Constants MashSimulation::Constants::make(Mash const & mash,
+                                                          Equipment const * equipment,
+                                                          double const grain_kg) {
+   double const absorption_LKg = equipment ? equipment->grainAbsorption_LKg() : PhysicalConstants::grainAbsorption_Lkg;
+
+   Constants constants;
+   constants.grain_kg       = grain_kg;
+   constants.grainMC        = grain_kg * HeatCalculations::Cgrain_calGC;
+   constants.tunMC          = mash.tunWeight_kg() * mash.tunSpecificHeat_calGC();
+   constants.grainTemp_c    = mash.grainTemp_c();
+   constants.tunTemp_c      = mash.tunTemp_c();
+   constants.boilingPoint_c = equipment ? equipment->boilingPoint_c() : 100.0;
+   // NOTE: Assumes 1L of water is 1 kg.
+   // equivalentMCProduct divides by the first thermal mass, so we have to check we have some grain
+   constants.spargeMC = constants.tunMC;
+   if (grain_kg > 0.0) {
+      constants.spargeMC += HeatCalculations::equivalentMCProduct(grain_kg,
+                                                                  HeatCalculations::Cgrain_calGC,
+                                                                  absorption_LKg * grain_kg,
+                                                                  HeatCalculations::Cw_calGC);
+   }
+   return constants;
+}
+
+MashSimulation::Step MashSimulation::Step::from(MashStep const & mashStep) {
+   Step step;
+   step.type              = mashStep.type();
+   step.stepTemp_c        = mashStep.stepTemp_c();
+   step.stepTime_min      = mashStep.stepTime_min();
+   step.infuseAmount_l    = mashStep.infuseAmount_l();
+   step.infuseTemp_c      = mashStep.infuseTemp_c();
+   step.decoctionAmount_l = mashStep.decoctionAmount_l();
+   return step;
+}
+
+double MashSimulation::waterTemp_c(double const heat, double const volume_l, double const target_c) {
+   // NOTE: Assumes 1L of water is 1 kg.
+   return heat / (volume_l * HeatCalculations::Cw_calGC) + target_c;
+}
+
+double MashSimulation::waterVolume_l(double const heat, double const waterTemp_c, double const target_c) {
+   // NOTE: Assumes 1L of water is 1 kg.
+   return heat / (HeatCalculations::Cw_calGC * (waterTemp_c - target_c));
+}
+
+double MashSimulation::decoctionFraction(double const thermalMass,
+                                         double const decoctableMC,
+                                         double const startTemp_c,
+                                         double const target_c,
+                                         double const boilingPoint_c) {
+   // The decocted part goes from startTemp_c to boiling and gives up enough heat on its way back down to target_c to
+   // bring thermalMass from startTemp_c up to target_c.
+   return (thermalMass * (target_c - startTemp_c)) / (decoctableMC * (boilingPoint_c - startTemp_c));
+}
+
+MashSimulation::Infusion::Infusion() : m_heat{0.0}, m_target_c{0.0}, m_boilingPoint_c{100.0} {
+   return;
+}
+
+MashSimulation::Infusion::Infusion(Constants const & constants,
+                                   State const & start,
+                                   MashStep::Type const type,
+                                   double const target_c) :
+   m_heat{0.0},
+   m_target_c{target_c},
+   m_boilingPoint_c{constants.boilingPoint_c} {
+   if (isSparge(type)) {
+      // By the time we sparge, the grain bed has cooled down a bit from the previous step
+      double const startTemp_c = start.tunHeated ? start.temp_c - spargeCooling_c : start.temp_c;
+      this->m_heat = constants.spargeMC * (target_c - startTemp_c);
+   } else {
+      this->m_heat = start.thermalMass * (target_c - start.temp_c);
+   }
+   if (!start.tunHeated) {
+      this->m_heat += constants.tunMC * (target_c - constants.tunTemp_c);
+   }
+   return;
+}
+
+double MashSimulation::Infusion::heat() const {
+   return this->m_heat;
+}
+
+double MashSimulation::Infusion::tempForVolume_c(double const volume_l) const {
+   if (volume_l <= 0.0) {
+      return 0.0;
+   }
+   // Can't add water above boiling and (probably) won't add it below freezing
+   return std::clamp(waterTemp_c(this->m_heat, volume_l, this->m_target_c), 0.0, this->m_boilingPoint_c);
+}
+
+double MashSimulation::Infusion::volumeForTemp_l(double const temp_c) const {
+   // Sanity check for unlikely edge cases
+   return std::max(0.0, waterVolume_l(this->m_heat, temp_c, this->m_target_c));
+}
+
+MashSimulation::Simulator::Simulator(Constants const & constants) :
+   m_constants{constants},
+   m_steps{},
+   m_results{},
+   m_numValid{0} {
+   return;
+}
+
+MashSimulation::Constants const & MashSimulation::Simulator::constants() const {
+   return this->m_constants;
+}
+
+std::size_t MashSimulation::Simulator::numSteps() const {
+   return this->m_steps.size();
+}
+
+void MashSimulation::Simulator::appendStep(Step const & step) {
+   this->m_steps.push_back(step);
+   this->m_results.resize(this->m_steps.size());
+   return;
+}
+
+void MashSimulation::Simulator::setStep(std::size_t const index, Step const & step) {
+   this->m_steps[index] = step;
+   this->m_numValid = std::min(this->m_numValid, index);
+   return;
+}
+
+void MashSimulation::Simulator::clear() {
+   this->m_steps.clear();
+   this->m_results.clear();
+   this->m_numValid = 0;
+   return;
+}
+
+MashSimulation::StepResult const & MashSimulation::Simulator::result(std::size_t const index) const {
+   for (; this->m_numValid <= index; ++this->m_numValid) {
+      this->m_results[this->m_numValid] = this->simulate(this->m_steps[this->m_numValid],
+                                                         this->stateBefore(this->m_numValid));
+   }
+   return this->m_results[index];
+}
+
+MashSimulation::State MashSimulation::Simulator::stateBefore(std::size_t const index) const {
+   if (index == 0) {
+      State initial;
+      initial.temp_c      = this->m_constants.grainTemp_c;
+      initial.thermalMass = this->m_constants.grainMC;
+      return initial;
+   }
+   return this->result(index - 1).end;
+}
+
+MashSimulation::Infusion MashSimulation::Simulator::infusion(std::size_t const index,
+                                                             MashStep::Type const type,
+                                                             double const target_c) const {
+   return Infusion{this->m_constants, this->stateBefore(index), type, target_c};
+}
+
+double MashSimulation::Simulator::decoctionAmount_l(std::size_t const index, double const target_c) const {
+   State const start = this->stateBefore(index);
+   // NOTE: Assumes 1L of water is 1 kg.
+   double const decoctableMC = start.water_l * HeatCalculations::Cw_calGC + this->m_constants.grainMC;
+   double const ratio = decoctionFraction(start.thermalMass,
+                                          decoctableMC,
+                                          start.temp_c,
+                                          target_c,
+                                          this->m_constants.boilingPoint_c);
+   // Also catches NaN, eg if there's nothing in the mash yet
+   if (!(ratio >= 0.0 && ratio <= 1.0)) {
+      return 0.0;
+   }
+   return ratio * (this->m_constants.grain_kg / PhysicalConstants::grainDensity_kgL + start.water_l);
+}
+
+MashSimulation::StepResult MashSimulation::Simulator::simulate(Step const & step, State const & start) const {
+   StepResult result;
+   result.start = start;
+   result.end   = start;
+   // Until the first step is done, the tun is a separate thermal mass at its own temperature
+   double const tunMC = start.tunHeated ? 0.0 : this->m_constants.tunMC;
+   // Whether the rest is held at temperature by a heat source, or left to cool
+   bool heated = false;
+
+   if (isInfusion(step.type)) {
+      // NOTE: Assumes 1L of water is 1 kg.
+      double const waterMC = step.infuseAmount_l * HeatCalculations::Cw_calGC;
+      double mashMC  = start.thermalMass;
+      double mashTemp_c = start.temp_c;
+      if (isSparge(step.type)) {
+         mashMC = this->m_constants.spargeMC;
+         if (start.tunHeated) {
+            mashTemp_c -= spargeCooling_c;
+         }
+      }
+      double const totalMC = mashMC + tunMC + waterMC;
+      result.reached_c = totalMC > 0.0 ?
+         (mashMC * mashTemp_c + tunMC * this->m_constants.tunTemp_c + waterMC * step.infuseTemp_c) / totalMC :
+         start.temp_c;
+      result.end.thermalMass += waterMC;
+      result.end.water_l     += step.infuseAmount_l;
+   } else if (step.type == MashStep::Type::Decoction) {
+      result.reached_c = start.temp_c;
+      double const mashVolume_l = this->m_constants.grain_kg / PhysicalConstants::grainDensity_kgL + start.water_l;
+      if (mashVolume_l > 0.0 && start.thermalMass > 0.0) {
+         // Inverse of decoctionFraction()
+         double const ratio = step.decoctionAmount_l / mashVolume_l;
+         double const decoctableMC = start.water_l * HeatCalculations::Cw_calGC + this->m_constants.grainMC;
+         result.reached_c += ratio * decoctableMC * (this->m_constants.boilingPoint_c - start.temp_c) /
+                             start.thermalMass;
+      }
+   } else {
+      // Temperature step: heated directly to, and held at, the step temperature
+      result.reached_c = step.stepTemp_c;
+      heated = true;
+   }
+
+   result.end.thermalMass += tunMC;
+   result.end.tunHeated = true;
+
+   //
+   // Newton's law of cooling for the rest.  The thermal mass is constant during the rest, so this is exact however
+   // long the step is.
+   //
+   result.end.temp_c = result.reached_c;
+   if (!heated && this->m_constants.heatLoss_MCPerMin > 0.0 && result.end.thermalMass > 0.0) {
+      double const ambient_c = this->m_constants.ambientTemp_c;
+      result.end.temp_c = ambient_c + (result.reached_c - ambient_c) *
+         std::exp(-this->m_constants.heatLoss_MCPerMin * step.stepTime_min / result.end.thermalMass);
+   }
+   return result;
+}
@@ -0,0 +1,223 @@
+/*
+ * MashSimulation.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MASHSIMULATION_H
+#define MASHSIMULATION_H
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "model/MashStep.h"
+
+class Equipment;
+class Mash;
+
+/*!
+ * \namespace MashSimulation
+ *
+ * \brief Heat balance of a mash, step by step.
+ *
+ *        As elsewhere in Brewtarget, "thermal mass" is mass times specific heat, in kg × cal/(g·°C), and we assume 1L of
+ *        water weighs 1kg.  Heat is thermal mass × °C.
+ *
+ *        \c Simulator runs a whole mash schedule forward in one pass -- infusions, decoctions, direct heating and the
+ *        heat lost to the surroundings while each step rests -- and keeps the state of the mash at the start and end of
+ *        every step.  Changing a step only invalidates that step and the ones after it.
+ *
+ *        \c Infusion answers "how hot does this much water need to be?" and "how much water at this temperature?" for
+ *        one step.  All the work is done when it is constructed, so each query is a single division, which is what we
+ *        want while the user is dragging a slider.
+ */
+namespace MashSimulation {
+
+   //! \brief How much cooler than the previous step the grain bed is by the time we sparge
+   double constexpr spargeCooling_c = 10.0;
+
+   /**
+    * \brief Things that do not change from step to step.  Calculate once per mash rather than on every query.
+    */
+   struct Constants {
+      double grain_kg       = 0.0;
+      //! \brief Thermal mass of the dry grain
+      double grainMC        = 0.0;
+      //! \brief Thermal mass of the tun
+      double tunMC          = 0.0;
+      double grainTemp_c    = 20.0;
+      double tunTemp_c      = 20.0;
+      //! \brief Thermal mass that sparge water has to heat: the grain, the water it has absorbed, and the tun
+      double spargeMC       = 0.0;
+      double boilingPoint_c = 100.0;
+      double ambientTemp_c  = 20.0;
+      /**
+       * \brief Heat lost per minute per °C that the mash is above \c ambientTemp_c, as a thermal mass.  0 (the default)
+       *        means a perfectly insulated tun, which is what the mash designer and wizard have always assumed.
+       */
+      double heatLoss_MCPerMin = 0.0;
+
+      /**
+       * \brief Gather the constants for \c mash in \c equipment.  \c equipment may be \c nullptr, in which case we use
+       *        the default grain absorption and a boiling point of 100°C.
+       */
+      static Constants make(Mash const & mash, Equipment const * equipment, double grain_kg);
+   };
+
+   /**
+    * \brief The parts of a \c MashStep that matter for the heat balance
+    */
+   struct Step {
+      MashStep::Type type         = MashStep::Type::Infusion;
+      double stepTemp_c           = 0.0;
+      double stepTime_min         = 0.0;
+      double infuseAmount_l       = 0.0;
+      double infuseTemp_c         = 0.0;
+      double decoctionAmount_l    = 0.0;
+
+      static Step from(MashStep const & mashStep);
+   };
+
+   /**
+    * \brief State of the mash at a point in time
+    */
+   struct State {
+      double temp_c      = 0.0;
+      //! \brief Thermal mass of everything at \c temp_c
+      double thermalMass = 0.0;
+      //! \brief Water added so far
+      double water_l     = 0.0;
+      /**
+       * \brief \c false until the first step, after which the tun is at the same temperature as the mash and its
+       *        thermal mass is included in \c thermalMass
+       */
+      bool tunHeated     = false;
+   };
+
+   struct StepResult {
+      //! \brief Before any water is added, removed or heated
+      State start;
+      //! \brief Temperature straight after the infusion, decoction or heating
+      double reached_c = 0.0;
+      //! \brief After resting for the step time
+      State end;
+   };
+
+   /**
+    * \brief Temperature that \c volume_l of water must be to supply \c heat and finish at \c target_c
+    */
+   double waterTemp_c(double heat, double volume_l, double target_c);
+
+   /**
+    * \brief Volume of water at \c waterTemp_c needed to supply \c heat and finish at \c target_c
+    */
+   double waterVolume_l(double heat, double waterTemp_c, double target_c);
+
+   /**
+    * \brief Fraction of the mash to take out, boil and return to raise the whole mash from \c startTemp_c to
+    *        \c target_c.  Result is outside [0, 1] if this can't be done.
+    *
+    * \param thermalMass Thermal mass that has to be heated
+    * \param decoctableMC Thermal mass of the grain and water in the mash, some of which will be decocted
+    * \param startTemp_c
+    * \param target_c
+    * \param boilingPoint_c
+    */
+   double decoctionFraction(double thermalMass,
+                            double decoctableMC,
+                            double startTemp_c,
+                            double target_c,
+                            double boilingPoint_c);
+
+   /**
+    * \brief Energy balance for adding water to reach one step's target temperature.  Cheap to copy.
+    */
+   class Infusion {
+   public:
+      Infusion();
+      /**
+       * \param constants
+       * \param start State of the mash before this step
+       * \param type Sparges heat \c Constants::spargeMC from \c spargeCooling_c below the previous step, other
+       *             infusions heat the mash from where it is
+       * \param target_c Step temperature
+       */
+      Infusion(Constants const & constants, State const & start, MashStep::Type type, double target_c);
+
+      //! \brief Heat the water needs to supply to reach the target
+      double heat() const;
+
+      /**
+       * \brief Strike temperature for \c volume_l of water, limited to what is possible (ie between freezing and
+       *        boiling).  Returns 0 if \c volume_l is not positive.
+       */
+      double tempForVolume_c(double volume_l) const;
+
+      //! \brief Water needed if it is at \c temp_c.  Never negative.
+      double volumeForTemp_l(double temp_c) const;
+
+   private:
+      double m_heat;
+      double m_target_c;
+      double m_boilingPoint_c;
+   };
+
+   /**
+    * \brief Runs a mash schedule forward, caching the result of each step.  Steps are only re-simulated when they, or
+    *        a step before them, have changed.
+    */
+   class Simulator {
+   public:
+      Simulator(Constants const & constants = Constants{});
+
+      Constants const & constants() const;
+
+      std::size_t numSteps() const;
+      void appendStep(Step const & step);
+      void setStep(std::size_t index, Step const & step);
+      //! \brief Remove all the steps
+      void clear();
+
+      //! \brief Result of step \c index, simulating it (and any earlier steps that need it) if necessary
+      StepResult const & result(std::size_t index) const;
+
+      /**
+       * \brief State at the start of step \c index.  \c index may be \c numSteps(), for the step that will be added
+       *        next.
+       */
+      State stateBefore(std::size_t index) const;
+
+      //! \brief Energy balance for an infusion of \c type at step \c index to reach \c target_c
+      Infusion infusion(std::size_t index, MashStep::Type type, double target_c) const;
+
+      /**
+       * \brief Amount to decoct at step \c index to reach \c target_c, or 0 if it can't be done (eg because the
+       *        target is below the previous step).
+       */
+      double decoctionAmount_l(std::size_t index, double target_c) const;
+
+   private:
+      StepResult simulate(Step const & step, State const & start) const;
+
+      Constants m_constants;
+      std::vector<Step> m_steps;
+      mutable std::vector<StepResult> m_results;
+      //! \brief Results before this index are up-to-date
+      mutable std::size_t m_numValid;
+   };
+}
+
+#endif
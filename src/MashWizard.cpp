@@ -29,6 +29,7 @@
 #include "Algorithms.h"
 #include "database/ObjectStoreWrapper.h"
 #include "HeatCalculations.h"
+#include "MashSimulation.h"
 #include "measurement/Measurement.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -123,34 +124,6 @@ void MashWizard::show()
    return;
 }
 
-double MashWizard::calcDecoctionAmount( MashStep* step, Mash* mash, double waterMass, double grainMass, double lastTemp, double boiling)
-{
-   double grainDensity = PhysicalConstants::grainDensity_kgL;
-
-   double stepTemp  = step->stepTemp_c();
-   double equipMass = (mash->equipAdjust()) ? mash->tunWeight_kg() : 0;
-   double c_e       = (mash->equipAdjust()) ? mash->tunSpecificHeat_calGC() : 0;
-
-   double grHeat = grainMass * HeatCalculations::Cw_calGC;
-   double waHeat = waterMass * HeatCalculations::Cgrain_calGC;
-   double eqHeat = equipMass * c_e;
-
-   double totalHeat = grHeat + waHeat;
-   double deltaTemp = stepTemp - lastTemp;
-
-   // r is the ratio of water and grain to take out for decoction.
-   double r = ((totalHeat + eqHeat)*deltaTemp) / (totalHeat*(boiling - stepTemp) + totalHeat*deltaTemp);
-
-   if( r < 0 || r > 1 )
-   {
-      QMessageBox::critical(this, tr("Decoction error"), tr("Something went wrong in decoction calculation.") );
-      qCritical() << Q_FUNC_INFO << "r=" << r;
-      return -1;
-   }
-   return r * (waterMass + grainMass/grainDensity);
-
-}
-
 void MashWizard::wizardry() {
    if( recObs == nullptr || recObs->mash() == nullptr )
       return;
@@ -158,17 +131,15 @@ void MashWizard::wizardry() {
    Mash* mash = recObs->mash();
    double thickness_LKg;
    double thickNum;
-   double MC, MCw; // Thermal mass of mash and water.
+   double MC; // Thermal mass of mash.
    double tw, tf, t1; // Water, final, and initial temps.
    double grainMass = 0.0, massWater = 0.0;
    double grainDensity = PhysicalConstants::grainDensity_kgL;
-   double absorption_LKg = PhysicalConstants::grainAbsorption_Lkg;
    double boilingPoint_c = 100.0;
    double lauterDeadspace = 0.0;
 
-   // If we have an equipment, utilize the custom absorption and boiling temp.
+   // If we have an equipment, utilize the custom boiling temp and lauter deadspace.
    if( recObs->equipment() != nullptr ) {
-      absorption_LKg = recObs->equipment()->grainAbsorption_LKg();
       boilingPoint_c = recObs->equipment()->boilingPoint_c();
       lauterDeadspace = recObs->equipment()->lauterDeadspace_l();
    }
@@ -222,11 +193,14 @@ void MashWizard::wizardry() {
    tf = mashStep->stepTemp_c();
    t1 = mash->grainTemp_c();
    massWater = thickness_LKg * grainMass;
-   MCw = HeatCalculations::Cw_calGC * massWater;
    MC = HeatCalculations::Cgrain_calGC * grainMass;
 
    // I am specifically ignoring BeerXML's request to only do this if mash->getEquipAdjust() is set.
-   tw = MC/MCw * (tf-t1) + (mash->tunSpecificHeat_calGC()*mash->tunWeight_kg())/MCw * (tf-mash->tunTemp_c()) + tf;
+   tw = MashSimulation::waterTemp_c(
+      MC * (tf-t1) + mash->tunSpecificHeat_calGC()*mash->tunWeight_kg() * (tf-mash->tunTemp_c()),
+      massWater,
+      tf
+   );
 
    // Can't have water above boiling.
    if( tw > boilingPoint_c ) {
@@ -269,7 +243,7 @@ void MashWizard::wizardry() {
          c_e = (mash->equipAdjust()) ? mash->tunSpecificHeat_calGC() : 0;
 
          // r is the ratio of water and grain to take out for decoction.
-         r = ((m_w*c_w + m_g*c_g + m_e*c_e)*(tf-t1)) / ((m_w*c_w + m_g*c_g)*(boilingPoint_c-tf) + (m_w*c_w + m_g*c_g)*(tf-t1));
+         r = MashSimulation::decoctionFraction(m_w*c_w + m_g*c_g + m_e*c_e, m_w*c_w + m_g*c_g, t1, tf, boilingPoint_c);
          if( r < 0 || r > 1 ) {
             QMessageBox::critical(this, tr("Decoction error"), tr("Something went wrong in decoction calculation.") );
             qCritical().nospace() << "Decoction: r=" << r;
@@ -284,7 +258,7 @@ void MashWizard::wizardry() {
          tw = boilingPoint_c; // Assume adding boiling water to minimize final volume.
          MC += massWater * HeatCalculations::Cw_calGC; // Add thermal mass of last addition.
 
-         massWater = (MC*(tf-t1))/(HeatCalculations::Cw_calGC * (tw-tf));
+         massWater = MashSimulation::waterVolume_l(MC*(tf-t1), tw, tf);
 
          mashStep->setInfuseAmount_l(massWater);
          mashStep->setInfuseTemp_c(tw);
@@ -314,7 +288,7 @@ void MashWizard::wizardry() {
       MC += massWater * HeatCalculations::Cw_calGC; // Add thermal mass of last addition.
 
 
-      tw = (MC*(tf-t1))/massWater/HeatCalculations::Cw_calGC + tf;
+      tw = MashSimulation::waterTemp_c(MC*(tf-t1), massWater, tf);
 
       if(tw > boilingPoint_c)
          QMessageBox::information(this,
@@ -338,19 +312,17 @@ void MashWizard::wizardry() {
       int lastMashStep = steps.size()-1;
       tf = mash->spargeTemp_c();
       if( lastMashStep >= 0 )
-         t1 = steps[lastMashStep]->stepTemp_c() - 10.0; // You will lose about 10C from last step.
+         t1 = steps[lastMashStep]->stepTemp_c() - MashSimulation::spargeCooling_c; // You will lose about 10C from last step.
       else
       {
          qCritical() << "MashWizard::wizardry(): Should have had at least one mash step before getting to sparging.";
          return;
       }
-      MC = recObs->grainsInMash_kg() * HeatCalculations::Cgrain_calGC
-           + absorption_LKg * recObs->grainsInMash_kg() * HeatCalculations::Cw_calGC
-           + mash->tunWeight_kg() * mash->tunSpecificHeat_calGC();
+      MC = MashSimulation::Constants::make(*mash, recObs->equipment(), recObs->grainsInMash_kg()).spargeMC;
 
       massWater = spargeWater_l;
 
-      tw = (MC/(massWater*HeatCalculations::Cw_calGC))*(tf-t1) + tf;
+      tw = MashSimulation::waterTemp_c(MC*(tf-t1), massWater, tf);
 
       if(tw > boilingPoint_c)
          QMessageBox::information(this,
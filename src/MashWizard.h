@@ -53,9 +53,6 @@ private:
    //!brief just need a holder for the three buttons
    QButtonGroup* bGroup;
 
-   //!brief helper method to calculate the volume of a decocation step
-   double calcDecoctionAmount( MashStep* step, Mash* mash, double waterMass, double grainMass, double lastTemp, double boiling);
-
 };
 
 #endif
@@ -22,16 +22,14 @@
 
 #include <QAbstractItemModel>
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-#include "measurement/Unit.h"
 #include "model/Misc.h"
 #include "tableModels/MiscTableModel.h"
 
-MiscSortFilterProxyModel::MiscSortFilterProxyModel(QObject *parent, bool filt)
-: QSortFilterProxyModel(parent)
-{
-   filter = filt;
+MiscSortFilterProxyModel::MiscSortFilterProxyModel(QObject *parent, bool filt) :
+   QSortFilterProxyModel(parent),
+   filter{filt},
+   searchFilter{TextSearchIndex::instance<Misc>()} {
+   return;
 }
 
 bool MiscSortFilterProxyModel::lessThan(const QModelIndex &left,
@@ -39,27 +37,26 @@ bool MiscSortFilterProxyModel::lessThan(const QModelIndex &left,
    QAbstractItemModel* source = sourceModel();
    QVariant leftMisc, rightMisc;
    if (source) {
-      leftMisc = source->data(left);
-      rightMisc = source->data(right);
+      leftMisc = source->data(left, BtTableModel::SortRole);
+      rightMisc = source->data(right, BtTableModel::SortRole);
    }
 
    auto const columnIndex = static_cast<MiscTableModel::ColumnIndex>(left.column());
    switch (columnIndex) {
-       case MiscTableModel::ColumnIndex::Inventory:
-         if (Measurement::qStringToSI(leftMisc.toString(), Measurement::PhysicalQuantity::Mass).quantity() == 0.0 &&
-             this->sortOrder() == Qt::AscendingOrder) {
+      case MiscTableModel::ColumnIndex::Inventory:
+         if (leftMisc.toDouble() == 0.0 && this->sortOrder() == Qt::AscendingOrder) {
             return false;
          }
-         return (Measurement::qStringToSI(leftMisc.toString(), Measurement::PhysicalQuantity::Mass) <
-                 Measurement::qStringToSI(rightMisc.toString(), Measurement::PhysicalQuantity::Mass));
+         return leftMisc.toDouble() < rightMisc.toDouble();
 
       case MiscTableModel::ColumnIndex::Amount:
-         return (Measurement::qStringToSI(leftMisc.toString(), Measurement::PhysicalQuantity::Mass) <
-                 Measurement::qStringToSI(rightMisc.toString(), Measurement::PhysicalQuantity::Mass));
-
       case MiscTableModel::ColumnIndex::Time:
-         return (Measurement::qStringToSI(leftMisc.toString(), Measurement::PhysicalQuantity::Time) <
-                 Measurement::qStringToSI(rightMisc.toString(), Measurement::PhysicalQuantity::Time));
+         return leftMisc.toDouble() < rightMisc.toDouble();
+
+      case MiscTableModel::ColumnIndex::Type:
+      case MiscTableModel::ColumnIndex::Use:
+      case MiscTableModel::ColumnIndex::IsWeight:
+         return leftMisc.toInt() < rightMisc.toInt();
 
       default:
          return leftMisc.toString() < rightMisc.toString();
@@ -67,14 +64,12 @@ bool MiscSortFilterProxyModel::lessThan(const QModelIndex &left,
 }
 
 
-bool MiscSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const
-{
-   MiscTableModel* model = qobject_cast<MiscTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
-
-   return !filter
-          ||
-          (  sourceModel()->data(index).toString().contains(filterRegExp())
-             && model->getRow(source_row)->display()
-          );
+bool MiscSortFilterProxyModel::filterAcceptsRow(int source_row,
+                                                [[maybe_unused]] QModelIndex const & source_parent) const {
+   if (!this->filter) {
+      return true;
+   }
+   MiscTableModel * model = qobject_cast<MiscTableModel *>(this->sourceModel());
+   auto row = model->getRow(source_row);
+   return row->display() && this->searchFilter.accepts(*row, this->filterRegExp());
 }
@@ -497,6 +497,11 @@ public:
       );
       optionDialog.ibuAdjustmentFirstWortDoubleSpinBox->setValue(amt * 100);
 
+      IbuMethods::RecipeIbuConstants ibuSettings{};
+      IbuMethods::loadHopStandAndChillTimes(ibuSettings);
+      optionDialog.ibuHopStandTimeDoubleSpinBox->setValue(ibuSettings.hopStandTime_min);
+      optionDialog.ibuChillTimeDoubleSpinBox->setValue(ibuSettings.chillTime_min);
+
       // Database stuff -- this looks weird, but trust me. We want SQLITE to be
       // the default for this field
       int tmp = PersistentSettings::value(PersistentSettings::Names::dbType,
@@ -655,6 +660,7 @@ void OptionDialog::configure_formulaCombos() {
    ibuFormulaComboBox->addItem(tr("Tinseth's approximation"), QVariant(IbuMethods::TINSETH));
    ibuFormulaComboBox->addItem(tr("Rager's approximation"), QVariant(IbuMethods::RAGER));
    ibuFormulaComboBox->addItem(tr("Noonan's approximation"), QVariant(IbuMethods::NOONAN));
+   ibuFormulaComboBox->addItem(tr("Time-resolved (boil, hop stand and chill)"), QVariant(IbuMethods::TIME_RESOLVED));
 
    colorFormulaComboBox->addItem(tr("Mosher's approximation"), QVariant(ColorMethods::MOSHER));
    colorFormulaComboBox->addItem(tr("Daniel's approximation"), QVariant(ColorMethods::DANIEL));
@@ -908,6 +914,8 @@ void OptionDialog::saveFormulae() {
 
    PersistentSettings::insert(PersistentSettings::Names::mashHopAdjustment, ibuAdjustmentMashHopDoubleSpinBox->value() / 100);
    PersistentSettings::insert(PersistentSettings::Names::firstWortHopAdjustment, ibuAdjustmentFirstWortDoubleSpinBox->value() / 100);
+   PersistentSettings::insert(PersistentSettings::Names::hopStandTime_min, ibuHopStandTimeDoubleSpinBox->value());
+   PersistentSettings::insert(PersistentSettings::Names::chillTime_min, ibuChillTimeDoubleSpinBox->value());
 }
 
 void OptionDialog::saveLoggingSettings() {
@@ -44,6 +44,7 @@
 //===== (Note too that property names are often used as setting names and, in such cases, are not redefined here) ======
 #define AddSettingName(name) namespace PersistentSettings::Names { BtStringConst const name{#name}; }
 AddSettingName(check_version)
+AddSettingName(chillTime_min)
 AddSettingName(color_formula)
 AddSettingName(config_version)
 AddSettingName(converted)
@@ -64,6 +65,7 @@ AddSettingName(firstWortHopAdjustment)
 AddSettingName(forcedLocale)
 AddSettingName(frequency)                        // backups section
 AddSettingName(geometry)
+AddSettingName(hopStandTime_min)
 AddSettingName(ibu_formula)
 AddSettingName(language)
 AddSettingName(last_db_merge_req)
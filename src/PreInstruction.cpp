@@ -35,24 +35,30 @@ PreInstruction::PreInstruction()
    time = 0;
 }
 
-PreInstruction::PreInstruction(const QString& txt, const QString& ti, double t)
+PreInstruction::PreInstruction(const QString& txt, const QString& ti, double t, const QList<QString>& reag)
 {
    text = QString(txt);
    title = QString(ti);
    time = t;
+   reagents = reag;
 }
 
-QString PreInstruction::getText()
+QString PreInstruction::getText() const
 {
    return text;
 }
 
-QString PreInstruction::getTitle()
+QString PreInstruction::getTitle() const
 {
    return title;
 }
 
-double PreInstruction::getTime()
+double PreInstruction::getTime() const
 {
    return time;
 }
+
+QList<QString> PreInstruction::getReagents() const
+{
+   return reagents;
+}
@@ -1,6 +1,6 @@
 /*
  * PreInstruction.h is part of Brewtarget, and is Copyright the following
- * authors 2009-2021
+ * authors 2009-2023
  * - Matt Young <mfsy@yahoo.com>
  * - Philip Greggory Lee <rocketman768@gmail.com>
  *
@@ -20,29 +20,35 @@
 #ifndef PREINSTRUCTION_H
 #define PREINSTRUCTION_H
 
+#include <QList>
 #include <QString>
 
 /*!
  * \class PreInstruction
  *
  * \brief Simple class to assist the creation of instructions.
+ *
+ *        This is a plain value (it is not stored in the database), so \c Recipe::generateInstructions can work out
+ *        the complete list of instructions before comparing it with what the recipe already has.
  */
 class PreInstruction
 {
 public:
    PreInstruction();
-   PreInstruction(const QString& txt, const QString& title, double t);
+   PreInstruction(const QString& txt, const QString& title, double t, const QList<QString>& reagents = {});
 
    friend bool operator<(const PreInstruction& lhs, const PreInstruction& rhs);
    friend bool operator>(const PreInstruction& lhs, const PreInstruction& rhs);
 
-   QString getText();
-   QString getTitle();
-   double getTime();
+   QString getText() const;
+   QString getTitle() const;
+   double getTime() const;
+   QList<QString> getReagents() const;
 private:
    QString text;
    QString title;
    double time;
+   QList<QString> reagents;
 };
 
 #endif   /* _PREINSTRUCTION_H */
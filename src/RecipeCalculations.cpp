@@ -0,0 +1,112 @@
+/*
+ * RecipeCalculations.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RecipeCalculations.h"
+
+#include <cmath>
+
+#include "Algorithms.h"
+#include "measurement/ColorMethods.h"
+#include "measurement/Quantity.h"
+
+namespace {
+   // MCU and extract IBUs are defined in terms of pounds per US gallon
+   double constexpr lbPerGalPerKgPerL = Measurement::ratioConversionFactor<Measurement::StaticUnits::Kilograms,
+                                                                           Measurement::StaticUnits::Liters,
+                                                                           Measurement::StaticUnits::Pounds,
+                                                                           Measurement::StaticUnits::UsGallons>;
+
+   using Points          = Measurement::Quantity<Measurement::StaticUnits::GravityPoints>;
+   using SpecificGravity = Measurement::Quantity<Measurement::StaticUnits::SpecificGravity>;
+
+   double sgFromSugar(double const sugar_kg, double const wort_l) {
+      return Algorithms::PlatoToSG_20C20C(Algorithms::getPlato(sugar_kg, wort_l));
+   }
+}
+
+double RecipeCalculations::postBoilSugarRatio(double const postBoilWort_l, double const trubChillerLoss_l) {
+   double const ratio = (postBoilWort_l - trubChillerLoss_l) / postBoilWort_l;
+   if (std::isnan(ratio) || ratio > 1.0) {
+      return 1.0;
+   }
+   if (ratio < 0.0) {
+      return 0.0;
+   }
+   return ratio;
+}
+
+double RecipeCalculations::attenuation_pct(BtSpan::span<double const> yeastAttenuations_pct) {
+   double attenuation_pct = 0.0;
+   for (double const yeastAttenuation_pct : yeastAttenuations_pct) {
+      if (yeastAttenuation_pct > attenuation_pct) {
+         attenuation_pct = yeastAttenuation_pct;
+      }
+   }
+   // This means we have yeast, but they neglected to provide attenuation percentages.
+   if (!yeastAttenuations_pct.empty() && attenuation_pct <= 0.0) {
+      attenuation_pct = 75.0;
+   }
+   return attenuation_pct;
+}
+
+RecipeCalculations::Gravities RecipeCalculations::gravities(double const sugar_kg,
+                                                            double sugar_kg_ignoreEfficiency,
+                                                            double nonFermentableSugars_kg,
+                                                            double const postBoilSugarRatio,
+                                                            double const efficiency_pct,
+                                                            double const attenuation_pct,
+                                                            double const finalVolumeNoLosses_l) {
+   // We might lose some sugar in the form of trub/chiller loss.  (Losses in the mash are included in efficiency, so
+   // sugar_kg isn't adjusted here.)
+   sugar_kg_ignoreEfficiency *= postBoilSugarRatio;
+   nonFermentableSugars_kg   *= postBoilSugarRatio;
+
+   // Total sugars after accounting for efficiency and mash losses. Implicitly includes non-fermentable sugars
+   double const totalSugar_kg = sugar_kg * efficiency_pct / 100.0 + sugar_kg_ignoreEfficiency;
+
+   Gravities result;
+   result.og = sgFromSugar(totalSugar_kg, finalVolumeNoLosses_l);
+   double const points = Points{SpecificGravity{result.og}}.value();
+   double const attenuationFactor = 1.0 - attenuation_pct / 100.0;
+   if (nonFermentableSugars_kg != 0.0) {
+      result.og_fermentable = sgFromSugar(totalSugar_kg - nonFermentableSugars_kg, finalVolumeNoLosses_l);
+      double const nonFermentablePoints =
+         Points{SpecificGravity{sgFromSugar(nonFermentableSugars_kg, finalVolumeNoLosses_l)}}.value();
+      // Only the fermentable sugars get attenuated
+      double const fermentablePoints = (points - nonFermentablePoints) * attenuationFactor;
+      result.fg             = SpecificGravity{Points{fermentablePoints + nonFermentablePoints}}.value();
+      result.fg_fermentable = SpecificGravity{Points{fermentablePoints}}.value();
+   } else {
+      result.og_fermentable = result.og;
+      result.fg             = SpecificGravity{Points{points * attenuationFactor}}.value();
+      result.fg_fermentable = result.fg;
+   }
+   return result;
+}
+
+double RecipeCalculations::abv_pct(double const og_fermentable, double const fg_fermentable) {
+   return (76.08 * (og_fermentable - fg_fermentable) / (1.775 - og_fermentable)) * (fg_fermentable / 0.794);
+}
+
+double RecipeCalculations::color_srm(double const colorAmount_srmKg, double const finalVolumeNoLosses_l) {
+   return ColorMethods::mcuToSrm(colorAmount_srmKg * lbPerGalPerKgPerL / finalVolumeNoLosses_l);
+}
+
+double RecipeCalculations::extractIbus(double const extractIbuAmount_kg, double const batchSize_l) {
+   return extractIbuAmount_kg / batchSize_l / lbPerGalPerKgPerL;
+}
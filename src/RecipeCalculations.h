@@ -0,0 +1,98 @@
+/*
+ * RecipeCalculations.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECIPECALCULATIONS_H
+#define RECIPECALCULATIONS_H
+#pragma once
+
+#include "utils/Span.h"
+
+/**
+ * \brief The calculations behind \c Recipe's OG, FG, ABV, color and IBU, on plain values.
+ *
+ *        \c Recipe gets the inputs from its ingredients and equipment.  \c RecipeSweep gets them from a snapshot of the
+ *        recipe with some of the parameters varied.  Having the maths in one place means the two always agree.
+ */
+namespace RecipeCalculations {
+
+   /**
+    * \brief Fraction of the sugar in the kettle at the end of the boil that makes it past the trub/chiller loss.
+    *        Clamped to [0, 1], and 1 if it can't be calculated (usually because there's no mash yet).
+    */
+   double postBoilSugarRatio(double postBoilWort_l, double trubChillerLoss_l);
+
+   /**
+    * \brief Attenuation to use for FG: that of the yeast with the greatest attenuation, 75% (an average attenuation)
+    *        if there are yeasts but none of them has an attenuation set, or 0 if there are no yeasts.
+    */
+   double attenuation_pct(BtSpan::span<double const> yeastAttenuations_pct);
+
+   struct Gravities {
+      double og;
+      double fg;
+      //! \brief OG from the fermentable sugars only
+      double og_fermentable;
+      //! \brief FG from the fermentable sugars only
+      double fg_fermentable;
+   };
+
+   /**
+    * \brief OG and FG from the sugars in the recipe (see \c Recipe::calcTotalPoints)
+    *
+    * \param sugar_kg Mass of sugar that \b is affected by mash efficiency
+    * \param sugar_kg_ignoreEfficiency Mass of sugar that \b is \b not affected by mash efficiency
+    * \param nonFermentableSugars_kg Mass of sugar that is not fermentable (also counted in
+    *                                \c sugar_kg_ignoreEfficiency)
+    * \param postBoilSugarRatio See \c postBoilSugarRatio.  1.0 if there's no equipment.
+    * \param efficiency_pct
+    * \param attenuation_pct See \c attenuation_pct
+    * \param finalVolumeNoLosses_l
+    */
+   Gravities gravities(double sugar_kg,
+                       double sugar_kg_ignoreEfficiency,
+                       double nonFermentableSugars_kg,
+                       double postBoilSugarRatio,
+                       double efficiency_pct,
+                       double attenuation_pct,
+                       double finalVolumeNoLosses_l);
+
+   /**
+    * \brief ABV from the fermentable-only OG and FG.  The formula comes from Ritchie Products Ltd, (Zymurgy, Summer
+    *        1995, vol. 18, no. 2), Michael L. Hall’s article Brew by the Numbers: Add Up What’s in Your Beer, and
+    *        Designing Great Beers by Daniels.
+    */
+   double abv_pct(double og_fermentable, double fg_fermentable);
+
+   /**
+    * \brief Color of the finished beer
+    *
+    * \param colorAmount_srmKg Sum over fermentables of color (in SRM) × amount (in kg)
+    * \param finalVolumeNoLosses_l
+    */
+   double color_srm(double colorAmount_srmKg, double finalVolumeNoLosses_l);
+
+   /**
+    * \brief Bitterness due to hopped extracts
+    *
+    * \param extractIbuAmount_kg Sum over fermentables of \c Fermentable::ibuGalPerLb × amount (in kg)
+    * \param batchSize_l
+    */
+   double extractIbus(double extractIbuAmount_kg, double batchSize_l);
+}
+
+#endif
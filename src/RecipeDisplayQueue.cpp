@@ -0,0 +1,113 @@
+/*
+ * RecipeDisplayQueue.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RecipeDisplayQueue.h"
+
+#include <utility>
+
+#include <QDebug>
+#include <QHash>
+#include <QTimer>
+
+#include "model/NamedEntity.h"
+#include "model/Recipe.h"
+
+namespace {
+   using Display = RecipeDisplayQueue::Display;
+
+   /**
+    * \brief Which parts of the recipe tab show each recipe property.
+    *
+    *        Changing the style moves the coloured "in style" band on the OG, FG and color sliders, even though their
+    *        values stay the same.
+    */
+   struct RecipeDisplayBinding {
+      BtStringConst const & property;
+      unsigned int displays;
+   };
+   RecipeDisplayBinding const recipeDisplayBindings[] {
+      {PropertyNames::NamedEntity::name     , Display::Name                                                   },
+      {PropertyNames::Recipe::batchSize_l   , Display::BatchSize | Display::BatchSizeRange                    },
+      {PropertyNames::Recipe::finalVolume_l , Display::BatchSizeRange                                         },
+      {PropertyNames::Recipe::boilSize_l    , Display::BoilSize  | Display::BoilSizeRange                     },
+      {PropertyNames::Recipe::boilVolume_l  , Display::BoilSizeRange                                          },
+      {PropertyNames::Recipe::efficiency_pct, Display::Efficiency                                             },
+      {PropertyNames::Recipe::boilTime_min  , Display::BoilTime                                               },
+      {PropertyNames::Recipe::boilGrav      , Display::BoilSg                                                 },
+      {PropertyNames::Recipe::og            , Display::OgSlider  | Display::IbuGuSlider | Display::Calories   },
+      {PropertyNames::Recipe::fg            , Display::FgSlider  | Display::Calories                          },
+      {PropertyNames::Recipe::ABV_pct       , Display::AbvSlider                                              },
+      {PropertyNames::Recipe::IBU           , Display::IbuSlider | Display::IbuGuSlider                       },
+      {PropertyNames::Recipe::color_srm     , Display::ColorSlider                                            },
+      {PropertyNames::Recipe::calories      , Display::Calories                                               },
+      {PropertyNames::Recipe::style         , Display::OgSlider  | Display::FgSlider    | Display::ColorSlider},
+      {PropertyNames::Recipe::styleId       , Display::OgSlider  | Display::FgSlider    | Display::ColorSlider},
+      {PropertyNames::Recipe::mash          , Display::MashSteps                                              },
+      {PropertyNames::Recipe::mashId        , Display::MashSteps                                              },
+   };
+
+   //! \brief How many of the \c Display flags are set in \c displays
+   int numDisplaysIn(unsigned int displays) {
+      int numDisplays = 0;
+      for (; displays; displays &= displays - 1) {
+         ++numDisplays;
+      }
+      return numDisplays;
+   }
+}
+
+unsigned int RecipeDisplayQueue::displaysFor(QString const & propertyName) {
+   static QHash<QString, unsigned int> const displaysByProperty = []() {
+      QHash<QString, unsigned int> displays;
+      for (auto const & binding : recipeDisplayBindings) {
+         displays[QString{*binding.property}] |= binding.displays;
+      }
+      return displays;
+   }();
+   return displaysByProperty.value(propertyName, 0);
+}
+
+RecipeDisplayQueue::RecipeDisplayQueue(QObject & context, std::function<void(unsigned int)> refresh) :
+   m_context{context},
+   m_refresh{std::move(refresh)},
+   m_queued{0} {
+   return;
+}
+
+void RecipeDisplayQueue::queue(QString const & propertyName) {
+   unsigned int const displays = RecipeDisplayQueue::displaysFor(propertyName);
+   if (!displays) {
+      return;
+   }
+   if (!this->m_queued) {
+      QTimer::singleShot(0, &this->m_context, [this]() { this->refreshQueued(); });
+   }
+   this->m_queued |= displays;
+   return;
+}
+
+void RecipeDisplayQueue::refreshQueued() {
+   unsigned int const displays = std::exchange(this->m_queued, 0);
+   if (displays) {
+      this->m_refresh(displays);
+      qDebug() <<
+         Q_FUNC_INFO << "Refreshed" << numDisplaysIn(displays) << "of" <<
+         numDisplaysIn(RecipeDisplayQueue::allDisplays) << "recipe displays";
+   }
+   return;
+}
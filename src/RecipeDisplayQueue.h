@@ -0,0 +1,91 @@
+/*
+ * RecipeDisplayQueue.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECIPEDISPLAYQUEUE_H
+#define RECIPEDISPLAYQUEUE_H
+#pragma once
+
+#include <functional>
+
+#include <QObject>
+#include <QString>
+
+/**
+ * \brief Works out which parts of the recipe tab (in \c MainWindow) need refreshing when recipe properties change, and
+ *        refreshes them once control gets back to the event loop.
+ *
+ *        One edit usually changes several properties (eg adding grain changes OG, FG, ABV, color and calories), and
+ *        this way each part of the tab is only refreshed once per edit, rather than once per property.  (The refresh
+ *        itself is done by whoever owns the queue, as only \c MainWindow knows about its widgets.)
+ */
+class RecipeDisplayQueue {
+public:
+   /**
+    * \brief The parts of the recipe tab that can be refreshed separately.  Each is one widget, or a couple of widgets
+    *        showing the same thing.
+    */
+   enum Display : unsigned int {
+      Name           = 1u <<  0,
+      BatchSize      = 1u <<  1,
+      BoilSize       = 1u <<  2,
+      Efficiency     = 1u <<  3,
+      BoilTime       = 1u <<  4,
+      BoilSg         = 1u <<  5,
+      OgSlider       = 1u <<  6,
+      FgSlider       = 1u <<  7,
+      AbvSlider      = 1u <<  8,
+      IbuSlider      = 1u <<  9,
+      BatchSizeRange = 1u << 10,
+      BoilSizeRange  = 1u << 11,
+      ColorSlider    = 1u << 12,
+      IbuGuSlider    = 1u << 13,
+      Calories       = 1u << 14,
+      MashSteps      = 1u << 15,
+   };
+   static unsigned int constexpr allDisplays = (MashSteps << 1) - 1;
+
+   /**
+    * \brief Which parts of the recipe tab show \c propertyName.  A property that isn't shown on the recipe tab (or,
+    *        like the ingredient lists, is shown by a table model that watches the recipe itself) gives 0.
+    */
+   static unsigned int displaysFor(QString const & propertyName);
+
+   /**
+    * \param context Owner of the queue.  Refreshes are delivered via its thread's event loop, and not at all once it
+    *                has been destroyed.
+    * \param refresh Called with the \c Display flags to refresh
+    */
+   RecipeDisplayQueue(QObject & context, std::function<void(unsigned int)> refresh);
+   ~RecipeDisplayQueue() = default;
+
+   /**
+    * \brief Refresh whatever shows \c propertyName on the next pass through the event loop, along with whatever shows
+    *        any other properties queued in the meantime
+    */
+   void queue(QString const & propertyName);
+
+private:
+   void refreshQueued();
+
+   QObject & m_context;
+   std::function<void(unsigned int)> m_refresh;
+   //! Parts of the recipe tab waiting to be refreshed
+   unsigned int m_queued;
+};
+
+#endif
@@ -86,6 +86,7 @@ void RecipeExtrasWidget::setRecipe(Recipe* rec) {
       connect(this->recipe, &NamedEntity::changed, this, &RecipeExtrasWidget::changed);
       this->showChanges();
    }
+   this->recipeUncertaintyWidget->setRecipe(rec);
    return;
 }
 
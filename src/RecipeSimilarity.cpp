@@ -0,0 +1,393 @@
+/*
+ * RecipeSimilarity.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RecipeSimilarity.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <QDebug>
+
+#include "database/ObjectStoreWrapper.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+
+namespace {
+   // Grist similarity counts for a bit more than hops, as it's what most decides what sort of beer it is
+   double constexpr gristWeight = 0.6;
+   double constexpr hopsWeight  = 0.4;
+
+   // Hops added this long (or longer) before the end of the boil are mostly there for bitterness
+   double constexpr bitteringTime_min = 30.0;
+
+   // When screening, how many more candidates than results we score exactly
+   std::size_t constexpr candidatesPerResult = 8;
+   std::size_t constexpr minCandidates = 64;
+
+   // Different seeds for grist and hops, so a hop and a fermentable with the same name are different ingredients
+   uint constexpr gristSeed = 1;
+   uint constexpr hopsSeed  = 2;
+
+   //! \brief Murmur3 finaliser -- cheap and mixes every input bit into every output bit
+   std::uint32_t mix(std::uint32_t hash) {
+      hash ^= hash >> 16;
+      hash *= 0x85ebca6bU;
+      hash ^= hash >> 13;
+      hash *= 0xc2b2ae35U;
+      hash ^= hash >> 16;
+      return hash;
+   }
+
+   //! \brief Seeds for the MinHash functions.  Slot i uses mix(token ^ slotSeeds[i]).
+   std::array<std::uint32_t, RecipeSimilarity::signatureSize> const slotSeeds = [] {
+      std::array<std::uint32_t, RecipeSimilarity::signatureSize> seeds;
+      for (std::size_t ii = 0; ii < seeds.size(); ++ii) {
+         seeds[ii] = mix(static_cast<std::uint32_t>(ii + 1) * 0x9e3779b9U);
+      }
+      return seeds;
+   }();
+
+   /**
+    * \brief Turn additions into sorted, normalised components, combining additions of the same thing
+    */
+   std::vector<RecipeSimilarity::Component> components(QVector<RecipeSimilarity::Addition> const & additions,
+                                                       uint const seed) {
+      std::vector<RecipeSimilarity::Component> result;
+      result.reserve(static_cast<std::size_t>(additions.size()));
+      double total = 0.0;
+      for (RecipeSimilarity::Addition const & addition : additions) {
+         if (addition.amount <= 0.0) {
+            continue;
+         }
+         result.push_back(RecipeSimilarity::Component{qHash(addition.key.simplified().toLower(), seed),
+                                                      addition.amount});
+         total += addition.amount;
+      }
+      std::sort(result.begin(), result.end(), [](auto const & lhs, auto const & rhs) { return lhs.token < rhs.token; });
+
+      // Combine duplicates and normalise in one pass
+      std::size_t numUnique = 0;
+      for (std::size_t ii = 0; ii < result.size(); ++ii) {
+         if (numUnique > 0 && result[numUnique - 1].token == result[ii].token) {
+            result[numUnique - 1].fraction += result[ii].fraction / total;
+         } else {
+            result[numUnique] = RecipeSimilarity::Component{result[ii].token, result[ii].fraction / total};
+            ++numUnique;
+         }
+      }
+      result.resize(numUnique);
+      return result;
+   }
+
+   /**
+    * \brief Weighted Jaccard similarity of two sorted component lists, or a negative number if both are empty (in which
+    *        case there's nothing to compare)
+    */
+   double weightedJaccard(std::vector<RecipeSimilarity::Component> const & lhs,
+                          std::vector<RecipeSimilarity::Component> const & rhs) {
+      if (lhs.empty() && rhs.empty()) {
+         return -1.0;
+      }
+      double sumMin = 0.0;
+      double sumMax = 0.0;
+      auto ll = lhs.cbegin();
+      auto rr = rhs.cbegin();
+      while (ll != lhs.cend() && rr != rhs.cend()) {
+         if (ll->token < rr->token) {
+            sumMax += ll->fraction;
+            ++ll;
+         } else if (rr->token < ll->token) {
+            sumMax += rr->fraction;
+            ++rr;
+         } else {
+            sumMin += std::min(ll->fraction, rr->fraction);
+            sumMax += std::max(ll->fraction, rr->fraction);
+            ++ll;
+            ++rr;
+         }
+      }
+      for (; ll != lhs.cend(); ++ll) {
+         sumMax += ll->fraction;
+      }
+      for (; rr != rhs.cend(); ++rr) {
+         sumMax += rr->fraction;
+      }
+      return sumMin / sumMax;
+   }
+
+   void addToSignature(std::array<std::uint32_t, RecipeSimilarity::signatureSize> & signature,
+                       std::vector<RecipeSimilarity::Component> const & components) {
+      for (RecipeSimilarity::Component const & component : components) {
+         for (std::size_t ii = 0; ii < signature.size(); ++ii) {
+            signature[ii] = std::min(signature[ii], mix(component.token ^ slotSeeds[ii]));
+         }
+      }
+      return;
+   }
+
+   bool isDisplayable(Recipe const * recipe) {
+      return recipe->display() && !recipe->deleted() && recipe->getParentKey() <= 0;
+   }
+}
+
+bool RecipeSimilarity::Fingerprint::isEmpty() const {
+   return this->grist.empty() && this->hops.empty();
+}
+
+QString RecipeSimilarity::hopKey(QString const & name, bool const dryHop, double const time_min) {
+   if (dryHop) {
+      return name + "@dry";
+   }
+   return name + (time_min >= bitteringTime_min ? "@bittering" : "@late");
+}
+
+RecipeSimilarity::Fingerprint RecipeSimilarity::fingerprint(QVector<Addition> const & grist,
+                                                            QVector<Addition> const & hops) {
+   Fingerprint result;
+   result.grist = components(grist, gristSeed);
+   result.hops  = components(hops,  hopsSeed);
+   result.signature.fill(std::numeric_limits<std::uint32_t>::max());
+   addToSignature(result.signature, result.grist);
+   addToSignature(result.signature, result.hops);
+   return result;
+}
+
+RecipeSimilarity::Fingerprint RecipeSimilarity::fingerprint(Recipe const & recipe) {
+   QVector<Addition> grist;
+   for (Fermentable const * fermentable : recipe.fermentables()) {
+      grist.append(Addition{fermentable->name(), fermentable->amount_kg()});
+   }
+   QVector<Addition> hops;
+   for (Hop const * hop : recipe.hops()) {
+      double time_min = hop->time_min();
+      switch (hop->use()) {
+         // Mash and first wort hops are in for the whole boil
+         case Hop::Use::Mash:
+         case Hop::Use::First_Wort: time_min = bitteringTime_min; break;
+         case Hop::Use::Aroma:      time_min = 0.0;               break;
+         case Hop::Use::Boil:
+         case Hop::Use::Dry_Hop:                                  break;
+      }
+      hops.append(Addition{hopKey(hop->name(), hop->use() == Hop::Use::Dry_Hop, time_min), hop->amount_kg()});
+   }
+   return fingerprint(grist, hops);
+}
+
+double RecipeSimilarity::similarity(Fingerprint const & lhs, Fingerprint const & rhs) {
+   double const grist = weightedJaccard(lhs.grist, rhs.grist);
+   double const hops  = weightedJaccard(lhs.hops,  rhs.hops );
+   if (grist < 0.0) {
+      return std::max(hops, 0.0);
+   }
+   if (hops < 0.0) {
+      return grist;
+   }
+   return gristWeight * grist + hopsWeight * hops;
+}
+
+double RecipeSimilarity::estimatedOverlap(Fingerprint const & lhs, Fingerprint const & rhs) {
+   if (lhs.isEmpty() || rhs.isEmpty()) {
+      return 0.0;
+   }
+   std::size_t numMatching = 0;
+   for (std::size_t ii = 0; ii < signatureSize; ++ii) {
+      numMatching += (lhs.signature[ii] == rhs.signature[ii]) ? 1 : 0;
+   }
+   return static_cast<double>(numMatching) / signatureSize;
+}
+
+RecipeSimilarity::Index::Index() : m_ids{}, m_signatures{}, m_fingerprints{}, m_rows{} {
+   return;
+}
+
+std::size_t RecipeSimilarity::Index::size() const {
+   return this->m_ids.size();
+}
+
+bool RecipeSimilarity::Index::contains(int const recipeId) const {
+   return this->m_rows.contains(recipeId);
+}
+
+void RecipeSimilarity::Index::set(int const recipeId, Fingerprint const & fingerprint) {
+   auto row = this->m_rows.constFind(recipeId);
+   if (row == this->m_rows.constEnd()) {
+      row = this->m_rows.insert(recipeId, this->m_ids.size());
+      this->m_ids.push_back(recipeId);
+      this->m_fingerprints.push_back(fingerprint);
+      this->m_signatures.insert(this->m_signatures.end(), fingerprint.signature.cbegin(), fingerprint.signature.cend());
+      return;
+   }
+   this->m_fingerprints[*row] = fingerprint;
+   std::copy(fingerprint.signature.cbegin(),
+             fingerprint.signature.cend(),
+             this->m_signatures.begin() + static_cast<std::ptrdiff_t>(*row * signatureSize));
+   return;
+}
+
+void RecipeSimilarity::Index::remove(int const recipeId) {
+   auto const found = this->m_rows.find(recipeId);
+   if (found == this->m_rows.end()) {
+      return;
+   }
+   std::size_t const row = *found;
+   std::size_t const lastRow = this->m_ids.size() - 1;
+   this->m_rows.erase(found);
+   if (row != lastRow) {
+      this->m_rows[this->m_ids.back()] = row;
+      this->m_ids[row] = this->m_ids.back();
+      this->m_fingerprints[row] = std::move(this->m_fingerprints.back());
+      std::copy(this->m_signatures.cbegin() + static_cast<std::ptrdiff_t>(lastRow * signatureSize),
+                this->m_signatures.cend(),
+                this->m_signatures.begin() + static_cast<std::ptrdiff_t>(row * signatureSize));
+   }
+   this->m_ids.pop_back();
+   this->m_fingerprints.pop_back();
+   this->m_signatures.resize(lastRow * signatureSize);
+   return;
+}
+
+QVector<RecipeSimilarity::Match> RecipeSimilarity::Index::nearest(Fingerprint const & query,
+                                                                  std::size_t const maxResults,
+                                                                  int const excludeId,
+                                                                  double const minSimilarity) const {
+   QVector<Match> matches;
+   if (query.isEmpty()) {
+      return matches;
+   }
+
+   //
+   // Screening: count matching signature slots for every recipe.  Recipes that share no slots have (almost certainly)
+   // next to nothing in common.
+   //
+   std::size_t const numRows = this->m_ids.size();
+   std::vector<std::pair<int, std::size_t>> candidates;
+   std::uint32_t const * signature = this->m_signatures.data();
+   for (std::size_t row = 0; row < numRows; ++row, signature += signatureSize) {
+      int numMatching = 0;
+      for (std::size_t ii = 0; ii < signatureSize; ++ii) {
+         numMatching += (signature[ii] == query.signature[ii]) ? 1 : 0;
+      }
+      if (numMatching > 0 && this->m_ids[row] != excludeId) {
+         candidates.emplace_back(numMatching, row);
+      }
+   }
+
+   // Only the most promising candidates are worth scoring exactly
+   std::size_t numCandidates = candidates.size();
+   if (maxResults > 0) {
+      numCandidates = std::min(numCandidates, std::max(maxResults * candidatesPerResult, minCandidates));
+      std::partial_sort(candidates.begin(),
+                        candidates.begin() + static_cast<std::ptrdiff_t>(numCandidates),
+                        candidates.end(),
+                        [](auto const & lhs, auto const & rhs) { return lhs.first > rhs.first; });
+   }
+
+   for (std::size_t ii = 0; ii < numCandidates; ++ii) {
+      std::size_t const row = candidates[ii].second;
+      double const score = similarity(query, this->m_fingerprints[row]);
+      if (score >= minSimilarity) {
+         matches.append(Match{this->m_ids[row], score});
+      }
+   }
+   std::sort(matches.begin(), matches.end(), [](Match const & lhs, Match const & rhs) {
+      return lhs.similarity > rhs.similarity || (lhs.similarity == rhs.similarity && lhs.id < rhs.id);
+   });
+   if (maxResults > 0 && static_cast<std::size_t>(matches.size()) > maxResults) {
+      matches.resize(static_cast<int>(maxResults));
+   }
+   return matches;
+}
+
+RecipeSimilarityIndex & RecipeSimilarityIndex::instance() {
+   static RecipeSimilarityIndex singleton;
+   return singleton;
+}
+
+RecipeSimilarityIndex::RecipeSimilarityIndex() :
+   QObject{},
+   m_populated{false},
+   m_dirty{},
+   m_index{} {
+   return;
+}
+
+RecipeSimilarityIndex::~RecipeSimilarityIndex() = default;
+
+QVector<RecipeSimilarity::Match> RecipeSimilarityIndex::nearest(Recipe const & recipe,
+                                                                std::size_t const maxResults,
+                                                                double const minSimilarity) {
+   this->update();
+   // Always fingerprint the query afresh, as it may not be in the index (eg it's a snapshot) or may be mid-edit
+   return this->m_index.nearest(RecipeSimilarity::fingerprint(recipe), maxResults, recipe.key(), minSimilarity);
+}
+
+void RecipeSimilarityIndex::update() {
+   if (!this->m_populated) {
+      connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalObjectInserted, this, &RecipeSimilarityIndex::recipeInserted);
+      connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalObjectDeleted,  this, &RecipeSimilarityIndex::recipeDeleted );
+      for (Recipe * recipe : ObjectStoreWrapper::getAllDisplayableRaw<Recipe>()) {
+         connect(recipe, &NamedEntity::changed, this, &RecipeSimilarityIndex::recipeChanged, Qt::UniqueConnection);
+         this->m_index.set(recipe->key(), RecipeSimilarity::fingerprint(*recipe));
+      }
+      this->m_populated = true;
+      qDebug() << Q_FUNC_INFO << "Fingerprinted" << this->m_index.size() << "recipes";
+      return;
+   }
+
+   for (int const id : this->m_dirty) {
+      Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(id);
+      if (recipe && isDisplayable(recipe)) {
+         this->m_index.set(id, RecipeSimilarity::fingerprint(*recipe));
+      } else {
+         this->m_index.remove(id);
+      }
+   }
+   this->m_dirty.clear();
+   return;
+}
+
+void RecipeSimilarityIndex::recipeInserted(int id) {
+   Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(id);
+   if (recipe) {
+      // Recipes that aren't displayed now might be later, so we listen to all of them
+      connect(recipe, &NamedEntity::changed, this, &RecipeSimilarityIndex::recipeChanged, Qt::UniqueConnection);
+      this->m_dirty.insert(id);
+   }
+   return;
+}
+
+void RecipeSimilarityIndex::recipeDeleted(int id, [[maybe_unused]] std::shared_ptr<QObject> object) {
+   this->m_dirty.remove(id);
+   this->m_index.remove(id);
+   return;
+}
+
+void RecipeSimilarityIndex::recipeChanged([[maybe_unused]] QMetaProperty prop, [[maybe_unused]] QVariant val) {
+   //
+   // Adding or removing ingredients, or changing how much of them there is, shows up as a change to one or more
+   // properties -- fermentable or hop IDs, OG, IBU etc.  Rather than try to keep track of exactly which, we just mark
+   // the recipe for a new fingerprint, which is cheap, and only done when we're next asked for results.
+   //
+   Recipe * recipe = qobject_cast<Recipe *>(this->sender());
+   if (recipe) {
+      this->m_dirty.insert(recipe->key());
+   }
+   return;
+}
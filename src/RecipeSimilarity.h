@@ -0,0 +1,179 @@
+/*
+ * RecipeSimilarity.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECIPESIMILARITY_H
+#define RECIPESIMILARITY_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QHash>
+#include <QMetaProperty>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+class Recipe;
+
+/*!
+ * \namespace RecipeSimilarity
+ *
+ * \brief Finds recipes with the same grist and hops in roughly the same proportions, eg to spot near-duplicates when
+ *        importing or cloning recipes.
+ *
+ *        Each recipe gets a \c Fingerprint: its grist as the fraction of total fermentable weight from each
+ *        fermentable, and its hop schedule as the fraction of total hop weight from each hop at each stage (bittering,
+ *        late or dry hop).  Ingredients are identified by name (ignoring case and spacing) so that recipes imported from
+ *        different places still match.  Two fingerprints are compared by weighted Jaccard similarity -- ie the sum,
+ *        over all ingredients, of the smaller of the two fractions divided by the sum of the larger -- which is 1 for
+ *        identical proportions and 0 for nothing in common.
+ *
+ *        Each fingerprint also carries a MinHash signature of its ingredient set.  The fraction of signature slots two
+ *        recipes share estimates how many ingredients they have in common, which \c Index uses to screen the whole
+ *        library cheaply before scoring the most promising candidates exactly.
+ */
+namespace RecipeSimilarity {
+
+   std::size_t constexpr signatureSize = 64;
+
+   //! \brief One ingredient's share of the grist or the hops
+   struct Component {
+      std::uint32_t token;
+      double fraction;
+   };
+
+   //! \brief An ingredient and how much of it there is, in any consistent units
+   struct Addition {
+      QString key;
+      double amount;
+   };
+
+   struct Fingerprint {
+      //! \brief Sorted by token, fractions add up to 1 (or empty)
+      std::vector<Component> grist;
+      //! \brief Sorted by token, fractions add up to 1 (or empty)
+      std::vector<Component> hops;
+      //! \brief MinHash of the tokens in \c grist and \c hops
+      std::array<std::uint32_t, signatureSize> signature;
+
+      bool isEmpty() const;
+   };
+
+   //! \brief Key for a hop addition, combining the hop with its stage (bittering, late or dry hop)
+   QString hopKey(QString const & name, bool dryHop, double time_min);
+
+   /**
+    * \brief Build a fingerprint from lists of additions.  Additions with the same key (after ignoring case and spacing)
+    *        are combined, and ones with no amount are ignored.
+    */
+   Fingerprint fingerprint(QVector<Addition> const & grist, QVector<Addition> const & hops);
+
+   Fingerprint fingerprint(Recipe const & recipe);
+
+   //! \brief Weighted Jaccard similarity, from 0 (nothing in common) to 1 (same ingredients in the same proportions)
+   double similarity(Fingerprint const & lhs, Fingerprint const & rhs);
+
+   //! \brief Fraction of signature slots that match, which estimates the unweighted Jaccard similarity of the
+   //!        ingredient sets
+   double estimatedOverlap(Fingerprint const & lhs, Fingerprint const & rhs);
+
+   struct Match {
+      int id;
+      double similarity;
+   };
+
+   /**
+    * \brief Fingerprints of a set of recipes.  Signatures are stored one after another in a single array so that the
+    *        screening pass over the whole library is a straight run through contiguous memory.
+    *
+    *        Adding, updating and removing a recipe is O(1).  (Removal swaps the last row into the gap.)
+    */
+   class Index {
+   public:
+      Index();
+
+      std::size_t size() const;
+      bool contains(int recipeId) const;
+
+      //! \brief Add a recipe, or replace its fingerprint if it's already in the index
+      void set(int recipeId, Fingerprint const & fingerprint);
+      void remove(int recipeId);
+
+      /**
+       * \brief Up to \c maxResults recipes most similar to \c query, most similar first.
+       *
+       * \param excludeId Recipe not to return (typically the one we're querying for)
+       * \param minSimilarity Don't return anything less similar than this
+       */
+      QVector<Match> nearest(Fingerprint const & query,
+                             std::size_t maxResults,
+                             int excludeId = -1,
+                             double minSimilarity = 0.0) const;
+
+   private:
+      std::vector<int> m_ids;
+      std::vector<std::uint32_t> m_signatures;
+      std::vector<Fingerprint> m_fingerprints;
+      QHash<int, std::size_t> m_rows;
+   };
+}
+
+/*!
+ * \class RecipeSimilarityIndex
+ *
+ * \brief Keeps a \c RecipeSimilarity::Index of every displayable recipe in the database.  It is filled the first time
+ *        it's needed.  After that, any change to a recipe just marks it as needing a new fingerprint, which it gets at
+ *        the next query, so editing a recipe costs nothing until someone asks.
+ */
+class RecipeSimilarityIndex : public QObject {
+   Q_OBJECT
+
+public:
+   static RecipeSimilarityIndex & instance();
+
+   //! \brief Up to \c maxResults other recipes most similar to \c recipe, most similar first
+   QVector<RecipeSimilarity::Match> nearest(Recipe const & recipe,
+                                            std::size_t maxResults,
+                                            double minSimilarity = 0.0);
+
+private slots:
+   void recipeInserted(int id);
+   void recipeDeleted(int id, std::shared_ptr<QObject> object);
+   void recipeChanged(QMetaProperty prop, QVariant val);
+
+private:
+   RecipeSimilarityIndex();
+   ~RecipeSimilarityIndex();
+   RecipeSimilarityIndex(RecipeSimilarityIndex const &) = delete;
+   RecipeSimilarityIndex & operator=(RecipeSimilarityIndex const &) = delete;
+
+   //! \brief Fill the index if this is the first time, otherwise catch up with any changes
+   void update();
+
+   bool m_populated;
+   QSet<int> m_dirty;
+   RecipeSimilarity::Index m_index;
+};
+
+#endif
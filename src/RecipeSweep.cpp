@@ -0,0 +1,354 @@
+/*
+ * RecipeSweep.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RecipeSweep.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <QDebug>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Recipe.h"
+#include "model/Yeast.h"
+#include "RecipeCalculations.h"
+
+namespace {
+   // Starting a thread costs more than evaluating a few hundred variants, so we don't give a thread less work than
+   // this
+   std::size_t constexpr minVariantsPerThread = 1024;
+
+   // Short names for the CSV header.  These are deliberately not translated, so that scripts can rely on them.
+   std::array<char const *, RecipeSweep::numParameters> constexpr parameterCsvNames{
+      "efficiency_pct", "boilTime_min", "batchSize_l"
+   };
+   std::array<char const *, RecipeSweep::numOutputs> constexpr outputCsvNames{
+      "og", "fg", "abv_pct", "ibu", "color_srm"
+   };
+
+   std::size_t index(RecipeSweep::Parameter const parameter) { return static_cast<std::size_t>(parameter); }
+   std::size_t index(RecipeSweep::Output    const output)    { return static_cast<std::size_t>(output);    }
+}
+
+QString RecipeSweep::parameterName(Parameter const parameter) {
+   switch (parameter) {
+      case Parameter::Efficiency_pct: return QObject::tr("Efficiency (%)");
+      case Parameter::BoilTime_min:   return QObject::tr("Boil time (min)");
+      case Parameter::BatchSize_l:    return QObject::tr("Batch size (L)");
+   }
+   // It's a coding error if we get here
+   Q_ASSERT(false);
+   return QString();
+}
+
+QString RecipeSweep::outputName(Output const output) {
+   switch (output) {
+      case Output::Og:        return QObject::tr("OG");
+      case Output::Fg:        return QObject::tr("FG");
+      case Output::Abv_pct:   return QObject::tr("ABV (%)");
+      case Output::Ibu:       return QObject::tr("IBU");
+      case Output::Color_srm: return QObject::tr("Color (SRM)");
+   }
+   // It's a coding error if we get here
+   Q_ASSERT(false);
+   return QString();
+}
+
+double & RecipeSweep::Variant::operator[](Parameter const parameter) {
+   return this->values[index(parameter)];
+}
+
+double RecipeSweep::Variant::operator[](Parameter const parameter) const {
+   return this->values[index(parameter)];
+}
+
+double RecipeSweep::Range::value(int step) const {
+   if (this->numSteps <= 1) {
+      return this->min;
+   }
+   return this->min + (this->max - this->min) * step / (this->numSteps - 1);
+}
+
+std::size_t RecipeSweep::Results::size() const {
+   return this->m_outputs[0].size();
+}
+
+void RecipeSweep::Results::resize(std::size_t numRows) {
+   for (auto & column : this->m_parameters) {
+      column.resize(numRows);
+   }
+   for (auto & column : this->m_outputs) {
+      column.resize(numRows);
+   }
+   return;
+}
+
+BtSpan::span<double> RecipeSweep::Results::column(Parameter const parameter) {
+   return this->m_parameters[index(parameter)];
+}
+
+BtSpan::span<double const> RecipeSweep::Results::column(Parameter const parameter) const {
+   return this->m_parameters[index(parameter)];
+}
+
+BtSpan::span<double> RecipeSweep::Results::column(Output const output) {
+   return this->m_outputs[index(output)];
+}
+
+BtSpan::span<double const> RecipeSweep::Results::column(Output const output) const {
+   return this->m_outputs[index(output)];
+}
+
+void RecipeSweep::Results::writeCsv(QTextStream & stream) const {
+   QStringList header;
+   for (char const * name : parameterCsvNames) {
+      header << name;
+   }
+   for (char const * name : outputCsvNames) {
+      header << name;
+   }
+   stream << header.join(',') << '\n';
+
+   std::size_t const numRows = this->size();
+   for (std::size_t row = 0; row < numRows; ++row) {
+      QStringList line;
+      for (auto const & column : this->m_parameters) {
+         line << QString::number(column[row], 'g', 8);
+      }
+      for (auto const & column : this->m_outputs) {
+         line << QString::number(column[row], 'g', 8);
+      }
+      stream << line.join(',') << '\n';
+   }
+   return;
+}
+
+RecipeSweep::Snapshot::Snapshot(Recipe & recipe) :
+   m_baseline{},
+   m_sugar_kg{0.0},
+   m_sugar_kg_ignoreEfficiency{0.0},
+   m_nonFermentableSugars_kg{0.0},
+   m_colorAmount{0.0},
+   m_extractIbuAmount{0.0},
+   m_attenuation_pct{0.0},
+   m_hasEquipment{false},
+   m_wortFromMash_l{0.0},
+   m_lauterDeadspace_l{0.0},
+   m_topUpKettle_l{0.0},
+   m_evapRate_lHr{0.0},
+   m_trubChillerLoss_l{0.0},
+   m_hops{},
+   m_ibuConstants{},
+   m_ibuFormula{IbuMethods::ibuFormula} {
+
+   // As well as getting a value we need, this ensures the recipe's calculated values (in particular OG, which
+   // Recipe::ibuConstants uses) are initialised
+   this->m_wortFromMash_l = recipe.wortFromMash_l();
+
+   QHash<QString, double> const sugars = recipe.calcTotalPoints();
+   this->m_sugar_kg                  = sugars.value("sugar_kg");
+   this->m_sugar_kg_ignoreEfficiency = sugars.value("sugar_kg_ignoreEfficiency");
+   this->m_nonFermentableSugars_kg   = sugars.value("nonFermentableSugars_kg");
+
+   for (Fermentable const * ferm : recipe.fermentables()) {
+      this->m_colorAmount      += ferm->color_srm()   * ferm->amount_kg();
+      this->m_extractIbuAmount += ferm->ibuGalPerLb() * ferm->amount_kg();
+   }
+
+   std::vector<double> yeastAttenuations_pct;
+   for (Yeast const * yeast : recipe.yeasts()) {
+      yeastAttenuations_pct.push_back(yeast->attenuation_pct());
+   }
+   this->m_attenuation_pct = RecipeCalculations::attenuation_pct(yeastAttenuations_pct);
+
+   Equipment const * equipment = recipe.equipment();
+   this->m_hasEquipment = (equipment != nullptr);
+   if (equipment) {
+      this->m_lauterDeadspace_l = equipment->lauterDeadspace_l();
+      this->m_topUpKettle_l     = equipment->topUpKettle_l();
+      this->m_evapRate_lHr      = equipment->evapRate_lHr();
+      this->m_trubChillerLoss_l = equipment->trubChillerLoss_l();
+   }
+
+   this->m_hops = recipe.hopAdditions();
+   this->m_ibuConstants = recipe.ibuConstants();
+
+   this->m_baseline[Parameter::Efficiency_pct] = recipe.efficiency_pct();
+   // Without equipment, the calculations assume a 60 minute boil (see Recipe::ibuConstants), so the boil time makes no
+   // difference to the results, but we still want something sensible to display.
+   this->m_baseline[Parameter::BoilTime_min] = equipment ? equipment->boilTime_min() : recipe.boilTime_min();
+   this->m_baseline[Parameter::BatchSize_l] = recipe.batchSize_l();
+   return;
+}
+
+RecipeSweep::Variant RecipeSweep::Snapshot::baseline() const {
+   return this->m_baseline;
+}
+
+std::size_t RecipeSweep::Snapshot::numHops() const {
+   return this->m_hops.size();
+}
+
+IbuMethods::HopAdditions const & RecipeSweep::Snapshot::hops() const {
+   return this->m_hops;
+}
+
+RecipeSweep::Snapshot::Inputs RecipeSweep::Snapshot::inputs() const {
+   return Inputs{this->m_sugar_kg,
+                 this->m_sugar_kg_ignoreEfficiency,
+                 this->m_nonFermentableSugars_kg,
+                 this->m_attenuation_pct,
+                 &this->m_hops};
+}
+
+void RecipeSweep::Snapshot::evaluate(Variant const & variant,
+                                     std::array<double, numOutputs> & outputs,
+                                     BtSpan::span<double> ibusPerHop) const {
+   this->evaluate(variant, this->inputs(), outputs, ibusPerHop);
+   return;
+}
+
+void RecipeSweep::Snapshot::evaluate(Variant const & variant,
+                                     Inputs const & inputs,
+                                     std::array<double, numOutputs> & outputs,
+                                     BtSpan::span<double> ibusPerHop) const {
+   Q_ASSERT(inputs.hops && inputs.hops->size() == this->m_hops.size());
+   double const efficiency_pct = variant[Parameter::Efficiency_pct];
+   double const boilTime_min   = variant[Parameter::BoilTime_min];
+   double const batchSize_l    = variant[Parameter::BatchSize_l];
+
+   // See Recipe::batchSizeNoLosses_l
+   double const finalVolumeNoLosses_l = batchSize_l + (this->m_hasEquipment ? this->m_trubChillerLoss_l : 0.0);
+
+   // See Recipe::recalcOgFg
+   double postBoilSugarRatio = 1.0;
+   if (this->m_hasEquipment) {
+      double const kettleWort_l = (this->m_wortFromMash_l - this->m_lauterDeadspace_l) + this->m_topUpKettle_l;
+      // See Equipment::wortEndOfBoil_l
+      double const postBoilWort_l = kettleWort_l - (boilTime_min / 60.0) * this->m_evapRate_lHr;
+      postBoilSugarRatio = RecipeCalculations::postBoilSugarRatio(postBoilWort_l, this->m_trubChillerLoss_l);
+   }
+   RecipeCalculations::Gravities const gravities = RecipeCalculations::gravities(inputs.sugar_kg,
+                                                                                 inputs.sugar_kg_ignoreEfficiency,
+                                                                                 inputs.nonFermentableSugars_kg,
+                                                                                 postBoilSugarRatio,
+                                                                                 efficiency_pct,
+                                                                                 inputs.attenuation_pct,
+                                                                                 finalVolumeNoLosses_l);
+   outputs[index(Output::Og)] = gravities.og;
+   outputs[index(Output::Fg)] = gravities.fg;
+
+   // See Recipe::recalcABV_pct
+   outputs[index(Output::Abv_pct)] = RecipeCalculations::abv_pct(gravities.og_fermentable, gravities.fg_fermentable);
+
+   // See Recipe::recalcColor_srm
+   outputs[index(Output::Color_srm)] = RecipeCalculations::color_srm(this->m_colorAmount, finalVolumeNoLosses_l);
+
+   //
+   // IBUs -- see Recipe::recalcIBU and Recipe::ibuConstants
+   //
+   IbuMethods::RecipeIbuConstants ibuConstants = this->m_ibuConstants;
+   ibuConstants.og            = gravities.og;
+   ibuConstants.finalVolume_l = finalVolumeNoLosses_l;
+   if (this->m_hasEquipment) {
+      ibuConstants.boilTime_min = static_cast<int>(boilTime_min);
+   }
+   outputs[index(Output::Ibu)] =
+      IbuMethods::getIbus(*inputs.hops, ibuConstants, ibusPerHop, this->m_ibuFormula) +
+      RecipeCalculations::extractIbus(this->m_extractIbuAmount, batchSize_l);
+
+   return;
+}
+
+std::vector<RecipeSweep::Variant> RecipeSweep::makeGrid(Variant const & baseline, QVector<Range> const & ranges) {
+   std::size_t numVariants = 1;
+   for (Range const & range : ranges) {
+      numVariants *= static_cast<std::size_t>(std::max(range.numSteps, 1));
+   }
+
+   std::vector<Variant> variants(numVariants, baseline);
+   // Treat the variant index as a mixed-radix number whose last digit is the step in the last range
+   for (std::size_t variantIndex = 0; variantIndex < numVariants; ++variantIndex) {
+      std::size_t remainder = variantIndex;
+      for (auto range = ranges.crbegin(); range != ranges.crend(); ++range) {
+         std::size_t const numSteps = static_cast<std::size_t>(std::max(range->numSteps, 1));
+         variants[variantIndex][range->parameter] = range->value(static_cast<int>(remainder % numSteps));
+         remainder /= numSteps;
+      }
+   }
+   return variants;
+}
+
+RecipeSweep::Results RecipeSweep::run(Snapshot const & snapshot,
+                                      std::vector<Variant> const & variants,
+                                      unsigned int maxThreads) {
+   Results results;
+   results.resize(variants.size());
+
+   std::array<BtSpan::span<double>, numParameters> parameterColumns;
+   for (Parameter const parameter : allParameters) {
+      parameterColumns[index(parameter)] = results.column(parameter);
+   }
+   std::array<BtSpan::span<double>, numOutputs> outputColumns;
+   for (Output const output : allOutputs) {
+      outputColumns[index(output)] = results.column(output);
+   }
+
+   // Each thread works on its own rows of the results, so there is no need for any locking
+   auto evaluateRows = [&](std::size_t const begin, std::size_t const end) {
+      std::vector<double> ibusPerHop(snapshot.numHops());
+      std::array<double, numOutputs> outputs;
+      for (std::size_t row = begin; row < end; ++row) {
+         Variant const & variant = variants[row];
+         snapshot.evaluate(variant, outputs, ibusPerHop);
+         for (std::size_t ii = 0; ii < numParameters; ++ii) {
+            parameterColumns[ii][row] = variant.values[ii];
+         }
+         for (std::size_t ii = 0; ii < numOutputs; ++ii) {
+            outputColumns[ii][row] = outputs[ii];
+         }
+      }
+   };
+
+   if (maxThreads == 0) {
+      // hardware_concurrency() is allowed to return 0 if it doesn't know
+      maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+   }
+   std::size_t const numThreads = std::clamp<std::size_t>(variants.size() / minVariantsPerThread, 1, maxThreads);
+   qDebug() << Q_FUNC_INFO << "Evaluating" << variants.size() << "variants on" << numThreads << "thread(s)";
+
+   if (numThreads == 1) {
+      evaluateRows(0, variants.size());
+      return results;
+   }
+
+   std::size_t const rowsPerThread = (variants.size() + numThreads - 1) / numThreads;
+   std::vector<std::thread> threads;
+   threads.reserve(numThreads);
+   for (std::size_t begin = 0; begin < variants.size(); begin += rowsPerThread) {
+      threads.emplace_back(evaluateRows, begin, std::min(begin + rowsPerThread, variants.size()));
+   }
+   for (auto & thread : threads) {
+      thread.join();
+   }
+   return results;
+}
@@ -0,0 +1,233 @@
+/*
+ * RecipeSweep.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECIPESWEEP_H
+#define RECIPESWEEP_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+#include "measurement/IbuMethods.h"
+#include "utils/Span.h"
+
+class Recipe;
+
+/*!
+ * \namespace RecipeSweep
+ *
+ * \brief "What if" calculations over many variants of a recipe -- eg "what would OG, IBU, color and ABV be if
+ *        efficiency were 68-78%, boil 60-90 minutes and batch size 19-25 L?"
+ *
+ *        Doing this by calling \c Recipe setters would write every intermediate value to the database and emit a
+ *        flurry of signals, with a full \c Recipe::recalcAll for each variant.  Instead, we take a \c Snapshot of
+ *        everything the calculations need from the recipe (once, on the GUI thread), and then evaluate the variants
+ *        against the snapshot.  This doesn't touch the database or any \c NamedEntity, so it can be done on as many
+ *        threads as we like.
+ *
+ *        The OG, FG, ABV, color and IBU maths is shared with \c Recipe (see \c RecipeCalculations), so, for the
+ *        recipe's own parameters, the results match what the recipe displays.  (\c Testing::testRecipeSweep checks they
+ *        agree.)
+ */
+namespace RecipeSweep {
+
+   /**
+    * \brief The recipe parameters we can vary
+    */
+   enum class Parameter {
+      Efficiency_pct,
+      //! NB: This is the boil time of the recipe's equipment, as that is what the calculations use
+      BoilTime_min,
+      BatchSize_l
+   };
+   std::size_t constexpr numParameters = 3;
+   std::array<Parameter, numParameters> constexpr allParameters{
+      Parameter::Efficiency_pct, Parameter::BoilTime_min, Parameter::BatchSize_l
+   };
+
+   //! \brief Localised display name, including units, for \c parameter
+   QString parameterName(Parameter const parameter);
+
+   /**
+    * \brief One set of values for the parameters we vary.  Indexed by \c Parameter.
+    */
+   struct Variant {
+      std::array<double, numParameters> values;
+
+      double & operator[](Parameter const parameter);
+      double   operator[](Parameter const parameter) const;
+   };
+
+   /**
+    * \brief \c numSteps evenly-spaced values of \c parameter from \c min to \c max inclusive.  (If \c numSteps is 1,
+    *        just \c min.)
+    */
+   struct Range {
+      Parameter parameter;
+      double min;
+      double max;
+      int numSteps;
+
+      double value(int step) const;
+   };
+
+   /**
+    * \brief The calculated values we report for each variant
+    */
+   enum class Output {
+      Og,
+      Fg,
+      Abv_pct,
+      Ibu,
+      Color_srm
+   };
+   std::size_t constexpr numOutputs = 5;
+   std::array<Output, numOutputs> constexpr allOutputs{
+      Output::Og, Output::Fg, Output::Abv_pct, Output::Ibu, Output::Color_srm
+   };
+
+   //! \brief Localised display name for \c output
+   QString outputName(Output const output);
+
+   /**
+    * \brief Results of a sweep, stored by column rather than by row.  Row \c i holds the parameters of the \c i-th
+    *        variant and the outputs calculated for it.
+    */
+   class Results {
+   public:
+      std::size_t size() const;
+      void resize(std::size_t numRows);
+
+      BtSpan::span<double>       column(Parameter const parameter);
+      BtSpan::span<double const> column(Parameter const parameter) const;
+      BtSpan::span<double>       column(Output const output);
+      BtSpan::span<double const> column(Output const output) const;
+
+      /**
+       * \brief Write the results as CSV, with a header line, one column per parameter and then one per output
+       */
+      void writeCsv(QTextStream & stream) const;
+
+   private:
+      std::array<std::vector<double>, numParameters> m_parameters;
+      std::array<std::vector<double>, numOutputs>    m_outputs;
+   };
+
+   /**
+    * \brief Everything from a \c Recipe (and its equipment, ingredients and settings) that the calculations depend on.
+    *        Once constructed, this is immutable and independent of the recipe, so it is safe to use from any thread.
+    */
+   class Snapshot {
+   public:
+      /**
+       * \brief The ingredient-derived values that feed the calculations.  Normally these come from the snapshot itself
+       *        (see \c inputs()), but callers that want to vary them -- eg \c RecipeUncertainty -- can supply their
+       *        own.
+       */
+      struct Inputs {
+         // Sugars -- see Recipe::calcTotalPoints
+         double sugar_kg;
+         double sugar_kg_ignoreEfficiency;
+         double nonFermentableSugars_kg;
+         //! \brief Attenuation of the most attenuative yeast, or 0 if there are no yeasts
+         double attenuation_pct;
+         //! \brief Must have the same number of hops as the snapshot
+         IbuMethods::HopAdditions const * hops;
+      };
+
+      /**
+       * \brief Must be called on the GUI thread, as it reads from \c recipe and the objects it uses
+       */
+      Snapshot(Recipe & recipe);
+
+      //! \brief The recipe's current values of the parameters
+      Variant baseline() const;
+
+      /**
+       * \brief Calculate the outputs for one variant
+       *
+       * \param variant
+       * \param outputs Receives the results, indexed by \c Output
+       * \param ibusPerHop Workspace for the IBU calculation.  Must have at least one element per hop in the recipe.
+       */
+      void evaluate(Variant const & variant,
+                    std::array<double, numOutputs> & outputs,
+                    BtSpan::span<double> ibusPerHop) const;
+
+      //! \brief As above, but with the supplied ingredient-derived values instead of the recipe's own
+      void evaluate(Variant const & variant,
+                    Inputs const & inputs,
+                    std::array<double, numOutputs> & outputs,
+                    BtSpan::span<double> ibusPerHop) const;
+
+      //! \brief The recipe's own ingredient-derived values
+      Inputs inputs() const;
+
+      std::size_t numHops() const;
+
+      IbuMethods::HopAdditions const & hops() const;
+
+   private:
+      Variant m_baseline;
+
+      // Sugars -- see Recipe::calcTotalPoints
+      double m_sugar_kg;
+      double m_sugar_kg_ignoreEfficiency;
+      double m_nonFermentableSugars_kg;
+
+      // Sum over fermentables of color × amount, and of IBU contribution × amount
+      double m_colorAmount;
+      double m_extractIbuAmount;
+
+      //! \brief Attenuation of the most attenuative yeast, or 0 if there are no yeasts
+      double m_attenuation_pct;
+
+      bool   m_hasEquipment;
+      double m_wortFromMash_l;
+      double m_lauterDeadspace_l;
+      double m_topUpKettle_l;
+      double m_evapRate_lHr;
+      double m_trubChillerLoss_l;
+
+      IbuMethods::HopAdditions       m_hops;
+      IbuMethods::RecipeIbuConstants m_ibuConstants;
+      IbuMethods::IbuType            m_ibuFormula;
+   };
+
+   /**
+    * \brief Make the full grid of variants over all the supplied ranges.  Parameters not in \c ranges keep their
+    *        value in \c baseline.  The first range varies slowest and the last one fastest.
+    */
+   std::vector<Variant> makeGrid(Variant const & baseline, QVector<Range> const & ranges);
+
+   /**
+    * \brief Evaluate all the supplied variants
+    *
+    * \param snapshot
+    * \param variants
+    * \param maxThreads Maximum number of threads to use.  0 means as many as the hardware supports.
+    */
+   Results run(Snapshot const & snapshot, std::vector<Variant> const & variants, unsigned int maxThreads = 0);
+}
+
+#endif
@@ -0,0 +1,431 @@
+/*
+ * RecipeSweepWidget.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RecipeSweepWidget.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <QComboBox>
+#include <QDebug>
+#include <QDoubleSpinBox>
+#include <QElapsedTimer>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QShowEvent>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "model/Recipe.h"
+#include "RecipeSweep.h"
+
+namespace {
+   // Space around the plot area for axis labels etc
+   int const leftMarginInPixels   = 70;
+   int const rightMarginInPixels  = 90;
+   int const topMarginInPixels    = 20;
+   int const bottomMarginInPixels = 50;
+
+   QPen const axisPen{Qt::black};
+   int const seriesLineWidth = 2;
+
+   /**
+    * \brief One line on the chart
+    */
+   struct Series {
+      QString label;
+      QVector<QPointF> points;
+   };
+
+   /**
+    * \brief A simple line chart.  We only need a few lines and some labelled axes, so it's not worth pulling in the
+    *        whole of Qt Charts.
+    */
+   class SweepChart : public QWidget {
+   public:
+      SweepChart(QWidget * parent) : QWidget(parent) {
+         this->setMinimumSize(400, 250);
+         this->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+         return;
+      }
+
+      void setData(QString const & xAxisName, QString const & yAxisName, QVector<Series> const & allSeries) {
+         this->xAxisName = xAxisName;
+         this->yAxisName = yAxisName;
+         this->allSeries = allSeries;
+         this->update();
+         return;
+      }
+
+   protected:
+      virtual void paintEvent(QPaintEvent * event) override {
+         Q_UNUSED(event);
+
+         QPainter painter(this);
+         painter.setRenderHint(QPainter::Antialiasing);
+
+         QRectF const plotArea{
+            QPointF(leftMarginInPixels, topMarginInPixels),
+            QPointF(this->width() - rightMarginInPixels, this->height() - bottomMarginInPixels)
+         };
+         if (plotArea.width() <= 0 || plotArea.height() <= 0) {
+            return;
+         }
+
+         //
+         // Work out the extent of the data so we can scale it to the plot area
+         //
+         double xMin = std::numeric_limits<double>::max();
+         double xMax = std::numeric_limits<double>::lowest();
+         double yMin = std::numeric_limits<double>::max();
+         double yMax = std::numeric_limits<double>::lowest();
+         for (Series const & series : this->allSeries) {
+            for (QPointF const & point : series.points) {
+               if (!std::isfinite(point.y())) {
+                  continue;
+               }
+               xMin = std::min(xMin, point.x());
+               xMax = std::max(xMax, point.x());
+               yMin = std::min(yMin, point.y());
+               yMax = std::max(yMax, point.y());
+            }
+         }
+         if (xMin > xMax || yMin > yMax) {
+            // No data to plot
+            return;
+         }
+         // Avoid dividing by zero if everything is on a horizontal or vertical line
+         if (xMax == xMin) { xMin -= 0.5; xMax += 0.5; }
+         if (yMax == yMin) { yMin -= 0.5; yMax += 0.5; }
+         auto toPixels = [&](QPointF const & point) {
+            return QPointF(
+               plotArea.left()   + plotArea.width()  * (point.x() - xMin) / (xMax - xMin),
+               plotArea.bottom() - plotArea.height() * (point.y() - yMin) / (yMax - yMin)
+            );
+         };
+
+         //
+         // Axes, with the range of values marked at each end
+         //
+         painter.setPen(axisPen);
+         painter.drawLine(plotArea.bottomLeft(), plotArea.bottomRight());
+         painter.drawLine(plotArea.bottomLeft(), plotArea.topLeft());
+         int const lineSpacing = painter.fontMetrics().lineSpacing();
+         painter.drawText(QRectF(plotArea.left() - leftMarginInPixels, plotArea.top() - lineSpacing / 2,
+                                 leftMarginInPixels - 5, lineSpacing),
+                          Qt::AlignRight | Qt::AlignVCenter,
+                          QString::number(yMax, 'g', 4));
+         painter.drawText(QRectF(plotArea.left() - leftMarginInPixels, plotArea.bottom() - lineSpacing / 2,
+                                 leftMarginInPixels - 5, lineSpacing),
+                          Qt::AlignRight | Qt::AlignVCenter,
+                          QString::number(yMin, 'g', 4));
+         painter.drawText(QRectF(plotArea.left() - 50, plotArea.bottom() + 2, 100, lineSpacing),
+                          Qt::AlignHCenter | Qt::AlignTop,
+                          QString::number(xMin, 'g', 4));
+         painter.drawText(QRectF(plotArea.right() - 50, plotArea.bottom() + 2, 100, lineSpacing),
+                          Qt::AlignHCenter | Qt::AlignTop,
+                          QString::number(xMax, 'g', 4));
+         painter.drawText(QRectF(plotArea.left(), plotArea.bottom() + lineSpacing + 4, plotArea.width(), lineSpacing),
+                          Qt::AlignHCenter | Qt::AlignTop,
+                          this->xAxisName);
+         painter.save();
+         painter.translate(plotArea.left() - leftMarginInPixels + lineSpacing, plotArea.center().y());
+         painter.rotate(-90);
+         painter.drawText(QRectF(-plotArea.height() / 2, -lineSpacing, plotArea.height(), lineSpacing),
+                          Qt::AlignHCenter | Qt::AlignVCenter,
+                          this->yAxisName);
+         painter.restore();
+
+         //
+         // The data, with each line labelled at its right-hand end
+         //
+         for (int ii = 0; ii < this->allSeries.size(); ++ii) {
+            Series const & series = this->allSeries[ii];
+            // Spread the colors out evenly around the color wheel
+            QColor const color = QColor::fromHsv((ii * 360) / std::max(this->allSeries.size(), 1), 200, 200);
+            painter.setPen(QPen(color, seriesLineWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+            QPolygonF line;
+            for (QPointF const & point : series.points) {
+               if (std::isfinite(point.y())) {
+                  line << toPixels(point);
+               }
+            }
+            painter.drawPolyline(line);
+            if (!series.label.isEmpty() && !line.isEmpty()) {
+               painter.drawText(line.last() + QPointF(5, lineSpacing / 3), series.label);
+            }
+         }
+         return;
+      }
+
+   private:
+      QString xAxisName;
+      QString yAxisName;
+      QVector<Series> allSeries;
+   };
+
+   std::size_t index(RecipeSweep::Parameter const parameter) { return static_cast<std::size_t>(parameter); }
+}
+
+// This private implementation class holds all private non-virtual members of RecipeSweepWidget
+class RecipeSweepWidget::impl {
+public:
+   impl(RecipeSweepWidget & self) :
+      self{self},
+      recipe{nullptr},
+      minSpinBoxes{},
+      maxSpinBoxes{},
+      stepsSpinBoxes{},
+      outputComboBox{new QComboBox(&self)},
+      xAxisComboBox{new QComboBox(&self)},
+      seriesComboBox{new QComboBox(&self)},
+      chart{new SweepChart(&self)},
+      statusLabel{new QLabel(&self)},
+      updateTimer{},
+      needsUpdate{false} {
+      return;
+   }
+
+   ~impl() = default;
+
+   RecipeSweep::Range range(RecipeSweep::Parameter const parameter) const {
+      std::size_t const ii = index(parameter);
+      return RecipeSweep::Range{parameter,
+                                this->minSpinBoxes[ii]->value(),
+                                this->maxSpinBoxes[ii]->value(),
+                                this->stepsSpinBoxes[ii]->value()};
+   }
+
+   /**
+    * \brief Set the ranges to something sensible around the recipe's current values
+    */
+   void resetRanges(RecipeSweep::Variant const & baseline) {
+      std::array<RecipeSweep::Range, RecipeSweep::numParameters> const defaultRanges{{
+         {RecipeSweep::Parameter::Efficiency_pct,
+          baseline[RecipeSweep::Parameter::Efficiency_pct] - 5.0,
+          baseline[RecipeSweep::Parameter::Efficiency_pct] + 5.0,
+          11},
+         {RecipeSweep::Parameter::BoilTime_min,
+          baseline[RecipeSweep::Parameter::BoilTime_min],
+          baseline[RecipeSweep::Parameter::BoilTime_min] + 30.0,
+          4},
+         {RecipeSweep::Parameter::BatchSize_l,
+          baseline[RecipeSweep::Parameter::BatchSize_l] * 0.9,
+          baseline[RecipeSweep::Parameter::BatchSize_l] * 1.1,
+          5}
+      }};
+      for (RecipeSweep::Range const & range : defaultRanges) {
+         std::size_t const ii = index(range.parameter);
+         // We don't want to re-run the sweep for each individual change
+         QSignalBlocker const blockMin{this->minSpinBoxes[ii]};
+         QSignalBlocker const blockMax{this->maxSpinBoxes[ii]};
+         QSignalBlocker const blockSteps{this->stepsSpinBoxes[ii]};
+         this->minSpinBoxes[ii]->setValue(range.min);
+         this->maxSpinBoxes[ii]->setValue(range.max);
+         this->stepsSpinBoxes[ii]->setValue(range.numSteps);
+      }
+      return;
+   }
+
+   RecipeSweepWidget & self;
+   Recipe * recipe;
+   std::array<QDoubleSpinBox *, RecipeSweep::numParameters> minSpinBoxes;
+   std::array<QDoubleSpinBox *, RecipeSweep::numParameters> maxSpinBoxes;
+   std::array<QSpinBox *,       RecipeSweep::numParameters> stepsSpinBoxes;
+   QComboBox * outputComboBox;
+   QComboBox * xAxisComboBox;
+   QComboBox * seriesComboBox;
+   SweepChart * chart;
+   QLabel * statusLabel;
+
+   // A single change to a recipe usually results in it emitting lots of changed signals (one for each calculated
+   // value that changes), so we use a zero-length timer to re-run the sweep once after they have all been processed.
+   QTimer updateTimer;
+
+   // Set if we need to re-run the sweep next time we're shown
+   bool needsUpdate;
+};
+
+RecipeSweepWidget::RecipeSweepWidget(QWidget * parent) : QWidget(parent), pimpl{std::make_unique<impl>(*this)} {
+   //
+   // Ranges of the parameters
+   //
+   QGridLayout * rangesLayout = new QGridLayout();
+   rangesLayout->addWidget(new QLabel(tr("From"), this),  0, 1);
+   rangesLayout->addWidget(new QLabel(tr("To"), this),    0, 2);
+   rangesLayout->addWidget(new QLabel(tr("Steps"), this), 0, 3);
+   for (RecipeSweep::Parameter const parameter : RecipeSweep::allParameters) {
+      std::size_t const ii = index(parameter);
+      int const row = static_cast<int>(ii) + 1;
+      // Efficiency and batch size are worth varying in tenths; boil time isn't
+      int const decimals = (parameter == RecipeSweep::Parameter::BoilTime_min) ? 0 : 1;
+      double const maximum = (parameter == RecipeSweep::Parameter::Efficiency_pct) ? 100.0 : 1000.0;
+
+      this->pimpl->minSpinBoxes[ii]   = new QDoubleSpinBox(this);
+      this->pimpl->maxSpinBoxes[ii]   = new QDoubleSpinBox(this);
+      this->pimpl->stepsSpinBoxes[ii] = new QSpinBox(this);
+      for (QDoubleSpinBox * spinBox : {this->pimpl->minSpinBoxes[ii], this->pimpl->maxSpinBoxes[ii]}) {
+         spinBox->setDecimals(decimals);
+         spinBox->setRange(0.0, maximum);
+         connect(spinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &RecipeSweepWidget::updateSweep);
+      }
+      this->pimpl->stepsSpinBoxes[ii]->setRange(1, 100);
+      connect(this->pimpl->stepsSpinBoxes[ii],
+              QOverload<int>::of(&QSpinBox::valueChanged),
+              this,
+              &RecipeSweepWidget::updateSweep);
+
+      rangesLayout->addWidget(new QLabel(RecipeSweep::parameterName(parameter), this), row, 0);
+      rangesLayout->addWidget(this->pimpl->minSpinBoxes[ii],   row, 1);
+      rangesLayout->addWidget(this->pimpl->maxSpinBoxes[ii],   row, 2);
+      rangesLayout->addWidget(this->pimpl->stepsSpinBoxes[ii], row, 3);
+
+      this->pimpl->xAxisComboBox->addItem(RecipeSweep::parameterName(parameter), static_cast<int>(ii));
+      this->pimpl->seriesComboBox->addItem(RecipeSweep::parameterName(parameter), static_cast<int>(ii));
+   }
+   rangesLayout->setColumnStretch(4, 1);
+
+   //
+   // What to plot
+   //
+   for (RecipeSweep::Output const output : RecipeSweep::allOutputs) {
+      this->pimpl->outputComboBox->addItem(RecipeSweep::outputName(output), static_cast<int>(output));
+   }
+   this->pimpl->outputComboBox->setCurrentIndex(static_cast<int>(RecipeSweep::Output::Og));
+   this->pimpl->xAxisComboBox->setCurrentIndex(static_cast<int>(RecipeSweep::Parameter::Efficiency_pct));
+   this->pimpl->seriesComboBox->setCurrentIndex(static_cast<int>(RecipeSweep::Parameter::BatchSize_l));
+   for (QComboBox * comboBox : {this->pimpl->outputComboBox, this->pimpl->xAxisComboBox, this->pimpl->seriesComboBox}) {
+      connect(comboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RecipeSweepWidget::updateSweep);
+   }
+   QHBoxLayout * plotLayout = new QHBoxLayout();
+   plotLayout->addWidget(new QLabel(tr("Plot"), this));
+   plotLayout->addWidget(this->pimpl->outputComboBox);
+   plotLayout->addWidget(new QLabel(tr("against"), this));
+   plotLayout->addWidget(this->pimpl->xAxisComboBox);
+   plotLayout->addWidget(new QLabel(tr("for each"), this));
+   plotLayout->addWidget(this->pimpl->seriesComboBox);
+   plotLayout->addStretch();
+
+   QVBoxLayout * mainLayout = new QVBoxLayout(this);
+   mainLayout->addLayout(rangesLayout);
+   mainLayout->addLayout(plotLayout);
+   mainLayout->addWidget(this->pimpl->chart, 1);
+   mainLayout->addWidget(this->pimpl->statusLabel);
+
+   this->pimpl->updateTimer.setSingleShot(true);
+   this->pimpl->updateTimer.setInterval(0);
+   connect(&this->pimpl->updateTimer, &QTimer::timeout, this, &RecipeSweepWidget::updateSweep);
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+RecipeSweepWidget::~RecipeSweepWidget() = default;
+
+void RecipeSweepWidget::setRecipe(Recipe * recipe) {
+   if (this->pimpl->recipe) {
+      disconnect(this->pimpl->recipe, nullptr, this, nullptr);
+   }
+
+   this->pimpl->recipe = recipe;
+   if (recipe) {
+      connect(recipe, &NamedEntity::changed, this, &RecipeSweepWidget::changed);
+      this->pimpl->resetRanges(RecipeSweep::Snapshot{*recipe}.baseline());
+   }
+   this->updateSweep();
+   return;
+}
+
+void RecipeSweepWidget::changed(QMetaProperty, QVariant) {
+   if (sender() != this->pimpl->recipe) {
+      return;
+   }
+   this->pimpl->updateTimer.start();
+   return;
+}
+
+void RecipeSweepWidget::showEvent(QShowEvent * event) {
+   QWidget::showEvent(event);
+   if (this->pimpl->needsUpdate) {
+      this->updateSweep();
+   }
+   return;
+}
+
+void RecipeSweepWidget::updateSweep() {
+   // No point doing the work if no-one is going to see it
+   if (!this->isVisible()) {
+      this->pimpl->needsUpdate = true;
+      return;
+   }
+   this->pimpl->needsUpdate = false;
+
+   if (!this->pimpl->recipe) {
+      this->pimpl->chart->setData(QString(), QString(), {});
+      this->pimpl->statusLabel->clear();
+      return;
+   }
+
+   auto const output          = static_cast<RecipeSweep::Output>(this->pimpl->outputComboBox->currentData().toInt());
+   auto const xAxisParameter  = static_cast<RecipeSweep::Parameter>(this->pimpl->xAxisComboBox->currentData().toInt());
+   auto const seriesParameter = static_cast<RecipeSweep::Parameter>(this->pimpl->seriesComboBox->currentData().toInt());
+
+   //
+   // We vary the parameter on the X axis and, if it's different, the one for the series.  The remaining parameter is
+   // held at the recipe's current value.  Since the last range varies fastest, each series is a contiguous block of
+   // the results.
+   //
+   QElapsedTimer timer;
+   timer.start();
+   RecipeSweep::Snapshot const snapshot{*this->pimpl->recipe};
+   QVector<RecipeSweep::Range> ranges;
+   if (seriesParameter != xAxisParameter) {
+      ranges.append(this->pimpl->range(seriesParameter));
+   }
+   ranges.append(this->pimpl->range(xAxisParameter));
+   std::vector<RecipeSweep::Variant> const variants = RecipeSweep::makeGrid(snapshot.baseline(), ranges);
+   RecipeSweep::Results const results = RecipeSweep::run(snapshot, variants);
+
+   auto const xValues      = results.column(xAxisParameter);
+   auto const seriesValues = results.column(seriesParameter);
+   auto const yValues      = results.column(output);
+   int const pointsPerSeries = std::max(ranges.last().numSteps, 1);
+   QVector<Series> allSeries;
+   for (std::size_t start = 0; start < results.size(); start += pointsPerSeries) {
+      Series series;
+      if (seriesParameter != xAxisParameter) {
+         series.label = QString::number(seriesValues[start], 'g', 4);
+      }
+      for (std::size_t ii = start; ii < start + pointsPerSeries; ++ii) {
+         series.points.append(QPointF(xValues[ii], yValues[ii]));
+      }
+      allSeries.append(series);
+   }
+   this->pimpl->chart->setData(RecipeSweep::parameterName(xAxisParameter), RecipeSweep::outputName(output), allSeries);
+   this->pimpl->statusLabel->setText(
+      tr("%1 variants calculated in %2 ms").arg(results.size()).arg(timer.elapsed())
+   );
+   return;
+}
@@ -0,0 +1,65 @@
+/*
+ * RecipeSweepWidget.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECIPESWEEPWIDGET_H
+#define RECIPESWEEPWIDGET_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QMetaProperty>
+#include <QVariant>
+#include <QWidget>
+
+class QShowEvent;
+class Recipe;
+
+/*!
+ * \class RecipeSweepWidget
+ *
+ * \brief "What if" tab: plots one of OG, FG, ABV, IBU or color against a range of one recipe parameter (efficiency,
+ *        boil time or batch size), with one line for each of a range of values of a second parameter.  The
+ *        calculations are done by \c RecipeSweep, so the recipe itself is never modified.
+ */
+class RecipeSweepWidget : public QWidget {
+   Q_OBJECT
+
+public:
+   RecipeSweepWidget(QWidget * parent = nullptr);
+   virtual ~RecipeSweepWidget();
+
+   //! \brief Set the recipe to plot.  Resets the ranges to ones around the recipe's current values.
+   void setRecipe(Recipe * recipe);
+
+public slots:
+   //! \brief Re-run the sweep and replot.  (Does nothing until we're visible.)
+   void updateSweep();
+
+private slots:
+   void changed(QMetaProperty, QVariant);
+
+protected:
+   virtual void showEvent(QShowEvent * event) override;
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ * RecipeUncertainty.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RecipeUncertainty.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#include <QDebug>
+
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+#include "model/Yeast.h"
+#include "utils/Span.h"
+
+namespace {
+   // Each chunk of samples has its own random number generator, and is the unit of work we give to a thread.  This
+   // needs to be big enough that seeding the generator is a negligible part of the work.
+   std::size_t constexpr samplesPerChunk = 4096;
+
+   std::size_t index(RecipeSweep::Output const output) { return static_cast<std::size_t>(output); }
+
+   /**
+    * \brief Work out the mean, standard deviation and percentiles of \c values.  NB: Reorders \c values.
+    */
+   void calculateBand(BtSpan::span<double> values, RecipeUncertainty::Band & band) {
+      std::size_t const numValues = values.size();
+      if (numValues == 0) {
+         return;
+      }
+
+      double sum = 0.0;
+      for (double const value : values) {
+         sum += value;
+      }
+      band.mean = sum / numValues;
+      double sumOfSquares = 0.0;
+      for (double const value : values) {
+         sumOfSquares += (value - band.mean) * (value - band.mean);
+      }
+      band.stdDev = std::sqrt(sumOfSquares / numValues);
+
+      // Percentiles are in ascending order, so, once we've found one, everything we need for the next one is to the
+      // right of it.  Each std::nth_element is linear (on average) in the length of the range it's given, so this is
+      // O(n * p) for p percentiles.  (The caller does this once per output, so k outputs cost O(n * p * k) in all.)
+      // With only a handful of percentiles, that's still less work than the O(n log n) of a full sort.
+      std::size_t start = 0;
+      for (std::size_t ii = 0; ii < RecipeUncertainty::numPercentiles; ++ii) {
+         auto const rank = static_cast<std::size_t>(
+            std::lround(RecipeUncertainty::percentiles[ii] / 100.0 * static_cast<double>(numValues - 1))
+         );
+         std::nth_element(values.begin() + start, values.begin() + rank, values.end());
+         band.values[ii] = values[rank];
+         start = rank;
+      }
+      return;
+   }
+}
+
+RecipeUncertainty::Band const & RecipeUncertainty::Results::band(RecipeSweep::Output const output) const {
+   return this->bands[index(output)];
+}
+
+RecipeUncertainty::Snapshot::Snapshot(Recipe & recipe) :
+   m_sweepSnapshot{recipe},
+   m_fermentables{},
+   m_hopAlphas_pct{},
+   m_yeastAttenuations_pct{},
+   m_efficiency_pct{recipe.efficiency_pct(), recipe.efficiencyStdDev_pct()},
+   m_hasVariation{recipe.efficiencyStdDev_pct() > 0.0} {
+
+   // Same categories, in the same order, as Recipe::calcTotalPoints, so that, with no variation, we get exactly the
+   // same totals
+   for (Fermentable * ferm : recipe.fermentables()) {
+      SugarType type = SugarType::Mashed;
+      if (ferm->isSugar() || ferm->isExtract()) {
+         type = Recipe::isFermentableSugar(ferm) ? SugarType::IgnoreEfficiency :
+                                                   SugarType::IgnoreEfficiencyNonFermentable;
+      }
+      // Equivalent sucrose is proportional to yield, so we can only vary it if yield is non-zero
+      double const yieldStdDev_pct = ferm->yield_pct() > 0.0 ? ferm->yieldStdDev_pct() : 0.0;
+      this->m_fermentables.push_back(
+         FermentableInput{type, ferm->equivSucrose_kg(), ferm->yield_pct(), yieldStdDev_pct}
+      );
+      this->m_hasVariation |= yieldStdDev_pct > 0.0;
+   }
+
+   // RecipeSweep::Snapshot stores the hops in the order the recipe returns them, so we do the same
+   for (Hop const * hop : recipe.hops()) {
+      this->m_hopAlphas_pct.push_back(NormalInput{hop->alpha_pct(), hop->alphaStdDev_pct()});
+      this->m_hasVariation |= hop->alphaStdDev_pct() > 0.0;
+   }
+
+   for (Yeast const * yeast : recipe.yeasts()) {
+      this->m_yeastAttenuations_pct.push_back(NormalInput{yeast->attenuation_pct(), yeast->attenuationStdDev_pct()});
+      this->m_hasVariation |= yeast->attenuationStdDev_pct() > 0.0;
+   }
+
+   return;
+}
+
+RecipeSweep::Snapshot const & RecipeUncertainty::Snapshot::sweepSnapshot() const {
+   return this->m_sweepSnapshot;
+}
+
+bool RecipeUncertainty::Snapshot::hasVariation() const {
+   return this->m_hasVariation;
+}
+
+void RecipeUncertainty::Snapshot::sample(std::mt19937_64 & randomEngine,
+                                         std::normal_distribution<double> & standardNormal,
+                                         Sample & sample) const {
+   auto draw = [&](NormalInput const & input, double const min, double const max) {
+      if (input.stdDev <= 0.0) {
+         return input.mean;
+      }
+      return std::clamp(input.mean + input.stdDev * standardNormal(randomEngine), min, max);
+   };
+
+   sample.variant[RecipeSweep::Parameter::Efficiency_pct] = draw(this->m_efficiency_pct, 0.0, 100.0);
+
+   sample.inputs.sugar_kg                  = 0.0;
+   sample.inputs.sugar_kg_ignoreEfficiency = 0.0;
+   sample.inputs.nonFermentableSugars_kg   = 0.0;
+   for (FermentableInput const & ferm : this->m_fermentables) {
+      double sucrose_kg = ferm.sucrose_kg;
+      if (ferm.yieldStdDev_pct > 0.0) {
+         sucrose_kg *= draw(NormalInput{ferm.yield_pct, ferm.yieldStdDev_pct}, 0.0, 100.0) / ferm.yield_pct;
+      }
+      switch (ferm.type) {
+         case SugarType::Mashed:
+            sample.inputs.sugar_kg += sucrose_kg;
+            break;
+         case SugarType::IgnoreEfficiencyNonFermentable:
+            sample.inputs.nonFermentableSugars_kg += sucrose_kg;
+            [[fallthrough]];
+         case SugarType::IgnoreEfficiency:
+            sample.inputs.sugar_kg_ignoreEfficiency += sucrose_kg;
+            break;
+      }
+   }
+
+   // Hops with no variation keep the alpha they were initialised with, so we don't need to touch them
+   for (std::size_t ii = 0; ii < this->m_hopAlphas_pct.size(); ++ii) {
+      if (this->m_hopAlphas_pct[ii].stdDev > 0.0) {
+         sample.hops.alpha[ii] = draw(this->m_hopAlphas_pct[ii], 0.0, 100.0) / 100.0;
+      }
+   }
+   sample.inputs.hops = &sample.hops;
+
+   // Same logic as RecipeSweep::Snapshot (and Recipe::recalcOgFg)
+   sample.inputs.attenuation_pct = 0.0;
+   for (NormalInput const & attenuation : this->m_yeastAttenuations_pct) {
+      sample.inputs.attenuation_pct = std::max(sample.inputs.attenuation_pct, draw(attenuation, 0.0, 100.0));
+   }
+   if (!this->m_yeastAttenuations_pct.empty() && sample.inputs.attenuation_pct <= 0.0) {
+      sample.inputs.attenuation_pct = 75.0;
+   }
+   return;
+}
+
+RecipeUncertainty::Results RecipeUncertainty::run(Snapshot const & snapshot,
+                                                  std::size_t numSamples,
+                                                  std::uint64_t seed,
+                                                  unsigned int maxThreads) {
+   Results results;
+   RecipeSweep::Snapshot const & sweepSnapshot = snapshot.sweepSnapshot();
+
+   {
+      std::vector<double> ibusPerHop(sweepSnapshot.numHops());
+      std::array<double, RecipeSweep::numOutputs> nominal;
+      sweepSnapshot.evaluate(sweepSnapshot.baseline(), nominal, ibusPerHop);
+      for (std::size_t ii = 0; ii < RecipeSweep::numOutputs; ++ii) {
+         results.bands[ii].nominal = nominal[ii];
+         results.bands[ii].mean    = nominal[ii];
+         results.bands[ii].values.fill(nominal[ii]);
+      }
+   }
+
+   // With nothing to vary, every sample would be the same as the nominal values, so there's no point drawing any
+   if (!snapshot.hasVariation() || numSamples == 0) {
+      results.numSamples = numSamples;
+      return results;
+   }
+
+   std::array<std::vector<double>, RecipeSweep::numOutputs> columns;
+   for (auto & column : columns) {
+      column.resize(numSamples);
+   }
+
+   std::size_t const numChunks = (numSamples + samplesPerChunk - 1) / samplesPerChunk;
+   std::atomic<std::size_t> nextChunk{0};
+
+   // Each chunk writes to its own rows of the columns, so there is no need for any locking
+   auto evaluateChunks = [&]() {
+      std::vector<double> ibusPerHop(sweepSnapshot.numHops());
+      std::array<double, RecipeSweep::numOutputs> outputs;
+      Snapshot::Sample sample{sweepSnapshot.baseline(), sweepSnapshot.inputs(), sweepSnapshot.hops()};
+      std::normal_distribution<double> standardNormal{0.0, 1.0};
+      for (std::size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++) {
+         std::seed_seq seedSequence{static_cast<std::uint32_t>(seed),
+                                    static_cast<std::uint32_t>(seed >> 32),
+                                    static_cast<std::uint32_t>(chunk),
+                                    static_cast<std::uint32_t>(chunk >> 32)};
+         std::mt19937_64 randomEngine{seedSequence};
+         standardNormal.reset();
+         std::size_t const end = std::min((chunk + 1) * samplesPerChunk, numSamples);
+         for (std::size_t row = chunk * samplesPerChunk; row < end; ++row) {
+            snapshot.sample(randomEngine, standardNormal, sample);
+            sweepSnapshot.evaluate(sample.variant, sample.inputs, outputs, ibusPerHop);
+            for (std::size_t ii = 0; ii < RecipeSweep::numOutputs; ++ii) {
+               columns[ii][row] = outputs[ii];
+            }
+         }
+      }
+   };
+
+   if (maxThreads == 0) {
+      // hardware_concurrency() is allowed to return 0 if it doesn't know
+      maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+   }
+   std::size_t const numThreads = std::clamp<std::size_t>(numChunks, 1, maxThreads);
+   qDebug() << Q_FUNC_INFO << "Drawing" << numSamples << "samples on" << numThreads << "thread(s)";
+   if (numThreads == 1) {
+      evaluateChunks();
+   } else {
+      std::vector<std::thread> threads;
+      threads.reserve(numThreads);
+      for (std::size_t ii = 0; ii < numThreads; ++ii) {
+         threads.emplace_back(evaluateChunks);
+      }
+      for (auto & thread : threads) {
+         thread.join();
+      }
+   }
+
+   //
+   // Extreme samples (eg a sampled efficiency of 0) can give infinite or undefined values, which would upset the
+   // statistics, so we drop them
+   //
+   std::size_t numFinite = 0;
+   for (std::size_t row = 0; row < numSamples; ++row) {
+      bool const allFinite = std::all_of(columns.begin(), columns.end(),
+                                         [row](auto const & column) { return std::isfinite(column[row]); });
+      if (allFinite) {
+         for (auto & column : columns) {
+            column[numFinite] = column[row];
+         }
+         ++numFinite;
+      }
+   }
+   if (numFinite < numSamples) {
+      qDebug() << Q_FUNC_INFO << "Dropped" << numSamples - numFinite << "samples with non-finite results";
+   }
+
+   results.numSamples = numFinite;
+   for (std::size_t ii = 0; ii < RecipeSweep::numOutputs; ++ii) {
+      calculateBand(BtSpan::span<double>{columns[ii].data(), numFinite}, results.bands[ii]);
+   }
+   return results;
+}
@@ -0,0 +1,165 @@
+/*
+ * RecipeUncertainty.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECIPEUNCERTAINTY_H
+#define RECIPEUNCERTAINTY_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "RecipeSweep.h"
+
+class Recipe;
+
+/*!
+ * \namespace RecipeUncertainty
+ *
+ * \brief Monte Carlo estimates of how much OG, FG, ABV, IBU and color might vary from what the recipe predicts, given
+ *        how much hop alpha acid, fermentable yield, yeast attenuation and brewhouse efficiency vary in practice.
+ *
+ *        The variability of each input is stored with the thing it belongs to, as a standard deviation (eg
+ *        \c Hop::alphaStdDev_pct).  Each sample draws every input from a normal distribution with the stored mean and
+ *        standard deviation (clamped to the range of valid values), then evaluates the recipe with those inputs using
+ *        \c RecipeSweep::Snapshot.  An input with a standard deviation of 0 is not varied at all, so a recipe with no
+ *        standard deviations set gives the same answer for every sample.
+ *
+ *        Samples are drawn in fixed-size chunks, each with its own random number generator seeded from the overall
+ *        seed and the chunk number.  Threads take whole chunks, so the results for a given seed are the same however
+ *        many threads are used.
+ */
+namespace RecipeUncertainty {
+
+   //! \brief The percentiles we report for each output
+   std::array<double, 5> constexpr percentiles{5.0, 25.0, 50.0, 75.0, 95.0};
+   std::size_t constexpr numPercentiles = percentiles.size();
+
+   //! \brief Seed used if the caller doesn't supply one, so that re-running on an unchanged recipe gives the same bands
+   std::uint64_t constexpr defaultSeed = 20230611;
+
+   /**
+    * \brief Distribution of one output over all the samples
+    */
+   struct Band {
+      //! \brief Value with every input at its mean -- ie what the recipe itself shows
+      double nominal = 0.0;
+      double mean    = 0.0;
+      double stdDev  = 0.0;
+      //! \brief Indexed the same as \c percentiles
+      std::array<double, numPercentiles> values{};
+   };
+
+   /**
+    * \brief Results of a run
+    */
+   struct Results {
+      //! \brief Number of samples that gave finite values for every output.  (Bands are calculated from these only.)
+      std::size_t numSamples = 0;
+      //! \brief Indexed by \c RecipeSweep::Output
+      std::array<Band, RecipeSweep::numOutputs> bands{};
+
+      Band const & band(RecipeSweep::Output const output) const;
+   };
+
+   /**
+    * \brief Everything from a \c Recipe that sampling needs.  As with \c RecipeSweep::Snapshot, this is immutable once
+    *        constructed, and safe to use from any thread.
+    */
+   class Snapshot {
+   public:
+      /**
+       * \brief One set of sampled inputs, ready to pass to \c RecipeSweep::Snapshot::evaluate.  Reuse the same one for
+       *        successive samples to avoid reallocating the hop additions each time.
+       */
+      struct Sample {
+         RecipeSweep::Variant variant;
+         RecipeSweep::Snapshot::Inputs inputs;
+         IbuMethods::HopAdditions hops;
+      };
+
+      /**
+       * \brief Must be called on the GUI thread, as it reads from \c recipe and the objects it uses
+       */
+      Snapshot(Recipe & recipe);
+
+      RecipeSweep::Snapshot const & sweepSnapshot() const;
+
+      //! \brief \c false if none of the inputs has a non-zero standard deviation
+      bool hasVariation() const;
+
+      /**
+       * \brief Draw one sample of all the inputs
+       *
+       * \param randomEngine
+       * \param standardNormal Normal distribution with mean 0 and standard deviation 1
+       * \param sample Receives the sampled values
+       */
+      void sample(std::mt19937_64 & randomEngine,
+                  std::normal_distribution<double> & standardNormal,
+                  Sample & sample) const;
+
+   private:
+      /**
+       * \brief Which of the sugar totals in \c RecipeSweep::Snapshot::Inputs a fermentable counts towards.  See
+       *        \c Recipe::calcTotalPoints.
+       */
+      enum class SugarType {
+         Mashed,
+         IgnoreEfficiency,
+         IgnoreEfficiencyNonFermentable
+      };
+
+      struct FermentableInput {
+         SugarType type;
+         double sucrose_kg;
+         double yield_pct;
+         double yieldStdDev_pct;
+      };
+
+      struct NormalInput {
+         double mean;
+         double stdDev;
+      };
+
+      RecipeSweep::Snapshot m_sweepSnapshot;
+      std::vector<FermentableInput> m_fermentables;
+      //! \brief Indexed the same as the snapshot's hop additions.  NB: Percent, not fraction.
+      std::vector<NormalInput> m_hopAlphas_pct;
+      std::vector<NormalInput> m_yeastAttenuations_pct;
+      NormalInput m_efficiency_pct;
+      bool m_hasVariation;
+   };
+
+   /**
+    * \brief Draw \c numSamples samples and work out the distribution of each output
+    *
+    * \param snapshot
+    * \param numSamples
+    * \param seed
+    * \param maxThreads Maximum number of threads to use.  0 means as many as the hardware supports.
+    */
+   Results run(Snapshot const & snapshot,
+               std::size_t numSamples,
+               std::uint64_t seed = defaultSeed,
+               unsigned int maxThreads = 0);
+}
+
+#endif
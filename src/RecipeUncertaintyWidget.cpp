@@ -0,0 +1,320 @@
+/*
+ * RecipeUncertaintyWidget.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RecipeUncertaintyWidget.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPointer>
+#include <QShowEvent>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "MainWindow.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+#include "model/Yeast.h"
+#include "RecipeUncertainty.h"
+
+namespace {
+   int constexpr defaultNumSamples = 100000;
+
+   // Columns of the inputs table
+   int constexpr inputNameColumn   = 0;
+   int constexpr inputMeanColumn   = 1;
+   int constexpr inputStdDevColumn = 2;
+
+   //! \brief OG and FG need more decimal places than the other outputs
+   int decimalPlaces(RecipeSweep::Output const output) {
+      return (output == RecipeSweep::Output::Og || output == RecipeSweep::Output::Fg) ? 3 : 1;
+   }
+
+   QTableWidgetItem * readOnlyItem(QString const & text) {
+      QTableWidgetItem * item = new QTableWidgetItem(text);
+      item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+      return item;
+   }
+}
+
+// This private implementation class holds all private non-virtual members of RecipeUncertaintyWidget
+class RecipeUncertaintyWidget::impl {
+public:
+   /**
+    * \brief What a row of the inputs table edits
+    */
+   struct InputRow {
+      QPointer<NamedEntity> entity;
+      BtStringConst const * stdDevProperty;
+      QString undoText;
+   };
+
+   impl(RecipeUncertaintyWidget & self) :
+      self{self},
+      recipe{nullptr},
+      numSamplesSpinBox{new QSpinBox(&self)},
+      bandsTable{new QTableWidget(static_cast<int>(RecipeSweep::numOutputs),
+                                  static_cast<int>(RecipeUncertainty::numPercentiles) + 2,
+                                  &self)},
+      inputsTable{new QTableWidget(0, 3, &self)},
+      statusLabel{new QLabel(&self)},
+      inputRows{},
+      updateTimer{},
+      needsUpdate{false} {
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * \brief Rebuild the inputs table from the recipe's ingredients
+    */
+   void showInputs() {
+      // We don't want to treat filling in the table as the user editing it
+      QSignalBlocker const blockInputs{this->inputsTable};
+      this->inputRows.clear();
+      this->inputsTable->setRowCount(0);
+      if (!this->recipe) {
+         return;
+      }
+
+      auto addRow = [this](QString const & name,
+                           double const mean,
+                           double const stdDev,
+                           NamedEntity * entity,
+                           BtStringConst const & stdDevProperty,
+                           QString const & undoText) {
+         int const row = this->inputsTable->rowCount();
+         this->inputsTable->insertRow(row);
+         this->inputsTable->setItem(row, inputNameColumn, readOnlyItem(name));
+         this->inputsTable->setItem(row, inputMeanColumn, readOnlyItem(QString::number(mean, 'f', 1)));
+         this->inputsTable->setItem(row, inputStdDevColumn, new QTableWidgetItem(QString::number(stdDev, 'f', 2)));
+         this->inputRows.append(InputRow{entity, &stdDevProperty, undoText});
+      };
+
+      addRow(RecipeUncertaintyWidget::tr("Efficiency (%)"),
+             this->recipe->efficiency_pct(),
+             this->recipe->efficiencyStdDev_pct(),
+             this->recipe,
+             PropertyNames::Recipe::efficiencyStdDev_pct,
+             RecipeUncertaintyWidget::tr("Change Efficiency Std Dev"));
+      for (Fermentable * ferm : this->recipe->fermentables()) {
+         addRow(RecipeUncertaintyWidget::tr("%1 yield (%)").arg(ferm->name()),
+                ferm->yield_pct(),
+                ferm->yieldStdDev_pct(),
+                ferm,
+                PropertyNames::Fermentable::yieldStdDev_pct,
+                RecipeUncertaintyWidget::tr("Change Yield Std Dev"));
+      }
+      for (Hop * hop : this->recipe->hops()) {
+         addRow(RecipeUncertaintyWidget::tr("%1 alpha (%)").arg(hop->name()),
+                hop->alpha_pct(),
+                hop->alphaStdDev_pct(),
+                hop,
+                PropertyNames::Hop::alphaStdDev_pct,
+                RecipeUncertaintyWidget::tr("Change Alpha Std Dev"));
+      }
+      for (Yeast * yeast : this->recipe->yeasts()) {
+         addRow(RecipeUncertaintyWidget::tr("%1 attenuation (%)").arg(yeast->name()),
+                yeast->attenuation_pct(),
+                yeast->attenuationStdDev_pct(),
+                yeast,
+                PropertyNames::Yeast::attenuationStdDev_pct,
+                RecipeUncertaintyWidget::tr("Change Attenuation Std Dev"));
+      }
+      return;
+   }
+
+   void showBands(RecipeUncertainty::Results const & results) {
+      for (RecipeSweep::Output const output : RecipeSweep::allOutputs) {
+         int const row = static_cast<int>(output);
+         RecipeUncertainty::Band const & band = results.band(output);
+         int const decimals = decimalPlaces(output);
+         this->bandsTable->setItem(row, 0, readOnlyItem(QString::number(band.nominal, 'f', decimals)));
+         for (std::size_t ii = 0; ii < RecipeUncertainty::numPercentiles; ++ii) {
+            this->bandsTable->setItem(row,
+                                      static_cast<int>(ii) + 1,
+                                      readOnlyItem(QString::number(band.values[ii], 'f', decimals)));
+         }
+         this->bandsTable->setItem(row,
+                                   static_cast<int>(RecipeUncertainty::numPercentiles) + 1,
+                                   readOnlyItem(QString::number(band.stdDev, 'f', decimals + 1)));
+      }
+      return;
+   }
+
+   RecipeUncertaintyWidget & self;
+   Recipe * recipe;
+   QSpinBox * numSamplesSpinBox;
+   QTableWidget * bandsTable;
+   QTableWidget * inputsTable;
+   QLabel * statusLabel;
+   //! \brief Indexed by row of \c inputsTable
+   QVector<InputRow> inputRows;
+
+   // As in RecipeSweepWidget, a zero-length timer means we only re-run once for a burst of changed signals
+   QTimer updateTimer;
+
+   // Set if we need to re-run next time we're shown
+   bool needsUpdate;
+};
+
+RecipeUncertaintyWidget::RecipeUncertaintyWidget(QWidget * parent) :
+   QWidget(parent),
+   pimpl{std::make_unique<impl>(*this)} {
+
+   this->pimpl->numSamplesSpinBox->setRange(1000, 1000000);
+   this->pimpl->numSamplesSpinBox->setSingleStep(10000);
+   this->pimpl->numSamplesSpinBox->setValue(defaultNumSamples);
+   connect(this->pimpl->numSamplesSpinBox,
+           QOverload<int>::of(&QSpinBox::valueChanged),
+           this,
+           &RecipeUncertaintyWidget::updateBands);
+   QHBoxLayout * samplesLayout = new QHBoxLayout();
+   samplesLayout->addWidget(new QLabel(tr("Samples"), this));
+   samplesLayout->addWidget(this->pimpl->numSamplesSpinBox);
+   samplesLayout->addStretch();
+
+   QStringList bandHeaders{tr("Nominal")};
+   for (double const percentile : RecipeUncertainty::percentiles) {
+      bandHeaders << tr("%1%").arg(percentile);
+   }
+   bandHeaders << tr("Std Dev");
+   this->pimpl->bandsTable->setHorizontalHeaderLabels(bandHeaders);
+   QStringList outputNames;
+   for (RecipeSweep::Output const output : RecipeSweep::allOutputs) {
+      outputNames << RecipeSweep::outputName(output);
+   }
+   this->pimpl->bandsTable->setVerticalHeaderLabels(outputNames);
+   this->pimpl->bandsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+   this->pimpl->inputsTable->setHorizontalHeaderLabels({tr("Input"), tr("Mean"), tr("Std Dev")});
+   this->pimpl->inputsTable->horizontalHeader()->setSectionResizeMode(inputNameColumn, QHeaderView::Stretch);
+   this->pimpl->inputsTable->verticalHeader()->hide();
+   connect(this->pimpl->inputsTable, &QTableWidget::cellChanged, this, &RecipeUncertaintyWidget::stdDevEdited);
+
+   QVBoxLayout * mainLayout = new QVBoxLayout(this);
+   mainLayout->addLayout(samplesLayout);
+   mainLayout->addWidget(this->pimpl->bandsTable);
+   mainLayout->addWidget(new QLabel(tr("Variability of inputs"), this));
+   mainLayout->addWidget(this->pimpl->inputsTable, 1);
+   mainLayout->addWidget(this->pimpl->statusLabel);
+
+   this->pimpl->updateTimer.setSingleShot(true);
+   this->pimpl->updateTimer.setInterval(0);
+   connect(&this->pimpl->updateTimer, &QTimer::timeout, this, &RecipeUncertaintyWidget::updateBands);
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+RecipeUncertaintyWidget::~RecipeUncertaintyWidget() = default;
+
+void RecipeUncertaintyWidget::setRecipe(Recipe * recipe) {
+   if (this->pimpl->recipe) {
+      disconnect(this->pimpl->recipe, nullptr, this, nullptr);
+   }
+
+   this->pimpl->recipe = recipe;
+   if (recipe) {
+      connect(recipe, &NamedEntity::changed, this, &RecipeUncertaintyWidget::changed);
+   }
+   this->updateBands();
+   return;
+}
+
+void RecipeUncertaintyWidget::changed(QMetaProperty, QVariant) {
+   if (sender() != this->pimpl->recipe) {
+      return;
+   }
+   this->pimpl->updateTimer.start();
+   return;
+}
+
+void RecipeUncertaintyWidget::stdDevEdited(int row, int column) {
+   if (column != inputStdDevColumn || row < 0 || row >= this->pimpl->inputRows.size()) {
+      return;
+   }
+   impl::InputRow const & inputRow = this->pimpl->inputRows[row];
+   if (!inputRow.entity) {
+      return;
+   }
+
+   bool ok = false;
+   double const stdDev = this->pimpl->inputsTable->item(row, column)->text().toDouble(&ok);
+   if (!ok || stdDev < 0.0) {
+      qDebug() <<
+         Q_FUNC_INFO << "Ignoring invalid standard deviation" << this->pimpl->inputsTable->item(row, column)->text();
+      // Put back what was there before
+      this->pimpl->updateTimer.start();
+      return;
+   }
+   MainWindow::instance().doOrRedoUpdate(*inputRow.entity, *inputRow.stdDevProperty, stdDev, inputRow.undoText);
+
+   // Standard deviations don't change anything the recipe calculates, so we won't get a changed signal from it
+   this->pimpl->updateTimer.start();
+   return;
+}
+
+void RecipeUncertaintyWidget::showEvent(QShowEvent * event) {
+   QWidget::showEvent(event);
+   if (this->pimpl->needsUpdate) {
+      this->updateBands();
+   }
+   return;
+}
+
+void RecipeUncertaintyWidget::updateBands() {
+   // No point doing the work if no-one is going to see it
+   if (!this->isVisible()) {
+      this->pimpl->needsUpdate = true;
+      return;
+   }
+   this->pimpl->needsUpdate = false;
+
+   this->pimpl->showInputs();
+   if (!this->pimpl->recipe) {
+      this->pimpl->bandsTable->clearContents();
+      this->pimpl->statusLabel->clear();
+      return;
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+   RecipeUncertainty::Snapshot const snapshot{*this->pimpl->recipe};
+   RecipeUncertainty::Results const results = RecipeUncertainty::run(
+      snapshot,
+      static_cast<std::size_t>(this->pimpl->numSamplesSpinBox->value())
+   );
+   this->pimpl->showBands(results);
+   if (snapshot.hasVariation()) {
+      this->pimpl->statusLabel->setText(
+         tr("%1 samples calculated in %2 ms").arg(results.numSamples).arg(timer.elapsed())
+      );
+   } else {
+      this->pimpl->statusLabel->setText(tr("Set a standard deviation for at least one input to see how much the "
+                                           "results might vary."));
+   }
+   return;
+}
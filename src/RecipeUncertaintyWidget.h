@@ -0,0 +1,64 @@
+/*
+ * RecipeUncertaintyWidget.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECIPEUNCERTAINTYWIDGET_H
+#define RECIPEUNCERTAINTYWIDGET_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QMetaProperty>
+#include <QVariant>
+#include <QWidget>
+
+class QShowEvent;
+class Recipe;
+
+/*!
+ * \class RecipeUncertaintyWidget
+ *
+ * \brief "Uncertainty" tab of the recipe extras: shows percentile bands for OG, FG, ABV, IBU and color, calculated by
+ *        \c RecipeUncertainty, and lets the user edit the standard deviations of the inputs they are based on.
+ */
+class RecipeUncertaintyWidget : public QWidget {
+   Q_OBJECT
+
+public:
+   RecipeUncertaintyWidget(QWidget * parent = nullptr);
+   virtual ~RecipeUncertaintyWidget();
+
+   void setRecipe(Recipe * recipe);
+
+public slots:
+   //! \brief Re-draw the samples and redisplay.  (Does nothing until we're visible.)
+   void updateBands();
+
+private slots:
+   void changed(QMetaProperty, QVariant);
+   void stdDevEdited(int row, int column);
+
+protected:
+   virtual void showEvent(QShowEvent * event) override;
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * SaltSolver.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SaltSolver.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <QDebug>
+#include <QtGlobal>
+
+#include "LinearAlgebra.h"
+
+namespace {
+   // Indexed the same as SaltSolver::salts.  Ion order is that of Water::Ions: Ca, Cl, HCO3, Mg, Na, SO4.
+   std::array<SaltSolver::Composition, SaltSolver::numSalts> constexpr compositions{{
+      //   Ca     Cl     HCO3   Mg    Na     SO4       CO3
+      {{ 272.0, 483.0,   0.0,  0.0,   0.0,   0.0},   0.0}, // CaCl2
+      {{ 200.0,   0.0,   0.0,  0.0,   0.0,   0.0}, 610.0}, // CaCO3
+      {{ 232.0,   0.0,   0.0,  0.0,   0.0, 558.0},   0.0}, // CaSO4
+      {{   0.0,   0.0,   0.0, 99.0,   0.0, 389.0},   0.0}, // MgSO4
+      {{   0.0, 607.0,   0.0,  0.0, 393.0,   0.0},   0.0}, // NaCl
+      {{   0.0,   0.0, 726.0,  0.0, 274.0,   0.0},   0.0}, // NaHCO3
+   }};
+
+   // Ion errors are scaled by the target concentration, but not by less than this, otherwise ions we want none of
+   // would swamp everything else
+   double constexpr minIonScale_ppm = 10.0;
+
+   // When the pH is out of bounds, we first add a heavily-weighted row to pull it back to the nearest bound.  This
+   // tells us which salts to use, and then solveOnPhBound puts the pH exactly on the bound with those salts.
+   double constexpr phWeight = 1000.0;
+
+   // Allowance for rounding when checking the pH is within bounds
+   double constexpr phTolerance = 1e-6;
+
+   using IonMatrix = LinearAlgebra::Matrix<SaltSolver::numIons + 1, SaltSolver::numSalts>;
+   using IonVector = LinearAlgebra::Vector<SaltSolver::numIons + 1>;
+   using Amounts   = LinearAlgebra::Vector<SaltSolver::numSalts>;
+
+   /**
+    * \brief Minimise the ion error (ie the first \c numIons rows of |Ax - b|) subject to phPerG · x = phChange, using
+    *        only the salts that are non-zero in \c approximate_g.  This is an equality-constrained least squares
+    *        problem, which we solve exactly via its KKT system.
+    *
+    * \return \c std::nullopt if the bound can't be reached with those salts without a negative amount of one of them
+    */
+   std::optional<Amounts> solveOnPhBound(IonMatrix const & a,
+                                         IonVector const & b,
+                                         std::array<double, SaltSolver::numSalts> const & phPerG,
+                                         double const phChange,
+                                         Amounts const & approximate_g) {
+      std::size_t constexpr numSalts = SaltSolver::numSalts;
+      // Rows and columns 0 to numSalts - 1 are the salts, and the last row and column are the Lagrange multiplier
+      LinearAlgebra::Matrix<numSalts + 1, numSalts + 1> kkt;
+      LinearAlgebra::Vector<numSalts + 1> rhs;
+      for (std::size_t jj = 0; jj < numSalts; ++jj) {
+         if (approximate_g[jj] <= 0.0) {
+            // Salt not used, so its amount is fixed at 0
+            kkt(jj, jj) = 1.0;
+            continue;
+         }
+         for (std::size_t kk = 0; kk < numSalts; ++kk) {
+            if (approximate_g[kk] > 0.0) {
+               for (std::size_t ii = 0; ii < SaltSolver::numIons; ++ii) {
+                  kkt(jj, kk) += a(ii, jj) * a(ii, kk);
+               }
+            }
+         }
+         for (std::size_t ii = 0; ii < SaltSolver::numIons; ++ii) {
+            rhs[jj] += a(ii, jj) * b[ii];
+         }
+         kkt(jj, numSalts) = phPerG[jj];
+         kkt(numSalts, jj) = phPerG[jj];
+      }
+      rhs[numSalts] = phChange;
+
+      // If none of the salts used changes the pH, the system is singular
+      std::optional<LinearAlgebra::Vector<numSalts + 1>> const solution = LinearAlgebra::solve(kkt, rhs);
+      if (!solution) {
+         return std::nullopt;
+      }
+      Amounts amounts_g;
+      for (std::size_t jj = 0; jj < numSalts; ++jj) {
+         if ((*solution)[jj] < 0.0) {
+            return std::nullopt;
+         }
+         amounts_g[jj] = (*solution)[jj];
+      }
+      return amounts_g;
+   }
+}
+
+SaltSolver::Composition const & SaltSolver::composition(std::size_t saltIndex) {
+   Q_ASSERT(saltIndex < numSalts);
+   return compositions[saltIndex];
+}
+
+std::size_t SaltSolver::saltIndex(Salt::Types const type) {
+   return std::find(salts.begin(), salts.end(), type) - salts.begin();
+}
+
+SaltSolver::Solution SaltSolver::solve(SaltSolver::Problem const & problem) {
+   Solution solution;
+   solution.result_ppm = problem.base_ppm;
+   solution.ph = problem.ph0;
+   if (problem.water_l <= 0.0) {
+      qWarning() << Q_FUNC_INFO << "No water to add salts to";
+      return solution;
+   }
+
+   //
+   // One row for each ion, plus one for pH.  The pH row stays zero (and so has no effect) unless the unconstrained
+   // solution is outside the pH bounds.
+   //
+   IonMatrix a;
+   IonVector b;
+   for (std::size_t ii = 0; ii < numIons; ++ii) {
+      double const weight = 1.0 / std::max(problem.target_ppm[ii], minIonScale_ppm);
+      b[ii] = weight * (problem.target_ppm[ii] - problem.base_ppm[ii]);
+      for (std::size_t jj = 0; jj < numSalts; ++jj) {
+         if (problem.available[jj]) {
+            a(ii, jj) = weight * compositions[jj].ions_mgPerG[ii] / problem.water_l;
+         }
+      }
+   }
+
+   auto phOf = [&problem](Amounts const & amounts_g) {
+      double ph = problem.ph0;
+      for (std::size_t jj = 0; jj < numSalts; ++jj) {
+         ph += problem.phPerG[jj] * amounts_g[jj];
+      }
+      return ph;
+   };
+
+   Amounts amounts_g = LinearAlgebra::nonNegativeLeastSquares(a, b);
+   if (problem.constrainPh) {
+      solution.ph = phOf(amounts_g);
+      if (solution.ph < problem.minPh || solution.ph > problem.maxPh) {
+         double const bound = solution.ph < problem.minPh ? problem.minPh : problem.maxPh;
+         b[numIons] = phWeight * (bound - problem.ph0);
+         for (std::size_t jj = 0; jj < numSalts; ++jj) {
+            if (problem.available[jj]) {
+               a(numIons, jj) = phWeight * problem.phPerG[jj];
+            }
+         }
+         amounts_g = LinearAlgebra::nonNegativeLeastSquares(a, b);
+         // If we can't get to the bound, the weighted solution is the nearest we can get, and gets flagged below
+         std::optional<Amounts> const onBound_g =
+            solveOnPhBound(a, b, problem.phPerG, bound - problem.ph0, amounts_g);
+         if (onBound_g) {
+            amounts_g = *onBound_g;
+         }
+         solution.ph = phOf(amounts_g);
+      }
+      solution.phInRange = problem.minPh - phTolerance <= solution.ph && solution.ph <= problem.maxPh + phTolerance;
+   }
+
+   for (std::size_t jj = 0; jj < numSalts; ++jj) {
+      solution.amounts_g[jj] = amounts_g[jj];
+   }
+   for (std::size_t ii = 0; ii < numIons; ++ii) {
+      for (std::size_t jj = 0; jj < numSalts; ++jj) {
+         solution.result_ppm[ii] += compositions[jj].ions_mgPerG[ii] * amounts_g[jj] / problem.water_l;
+      }
+   }
+   return solution;
+}
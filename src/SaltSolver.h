@@ -0,0 +1,126 @@
+/*
+ * SaltSolver.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SALTSOLVER_H
+#define SALTSOLVER_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "model/Salt.h"
+#include "model/Water.h"
+
+/*!
+ * \namespace SaltSolver
+ *
+ * \brief Works out how much of each brewing salt to add to a base water to get as close as possible to a target
+ *        profile, whilst keeping the mash pH within bounds.  This is the inverse of what \c WaterDialog::newTotals
+ *        does: there, the user picks the salts and we calculate the resulting ion concentrations and pH.
+ *
+ *        Everything the solver needs is linear in the salt amounts, so it is a (small) non-negative least squares
+ *        problem, with one row per ion and one column per salt.  The dimensions are known at compile time, so all the
+ *        matrices live on the stack and a solve takes microseconds, which means we can re-solve every time the user
+ *        changes something.
+ */
+namespace SaltSolver {
+   //! \brief Number of ions we try to match -- ie rows in the problem
+   std::size_t constexpr numIons = static_cast<std::size_t>(Water::Ions::numIons);
+
+   /**
+    * \brief The salts we can add -- ie columns in the problem.  (Acids only affect pH, not the ions we are trying to
+    *        match, so they are not included.)
+    */
+   std::array<Salt::Types, 6> constexpr salts{
+      Salt::Types::CACL2, Salt::Types::CACO3, Salt::Types::CASO4, Salt::Types::MGSO4, Salt::Types::NACL,
+      Salt::Types::NAHCO3
+   };
+   std::size_t constexpr numSalts = salts.size();
+
+   /**
+    * \brief How many mg of each ion one gram of a salt provides.  These must be the same numbers as \c Salt::Ca() etc
+    *        use (which get them from Bru'n Water).
+    *
+    *        Carbonate is not one of the \c Water::Ions, but we need it for the pH calculation.
+    */
+   struct Composition {
+      std::array<double, numIons> ions_mgPerG;
+      double co3_mgPerG;
+   };
+
+   //! \brief Composition of \c salts[saltIndex]
+   Composition const & composition(std::size_t saltIndex);
+
+   /**
+    * \brief Index of \c type in \c salts, or \c numSalts if it is not one we solve for
+    */
+   std::size_t saltIndex(Salt::Types const type);
+
+   /**
+    * \brief What we're trying to do.  All ion arrays are indexed by \c Water::Ions.
+    */
+   struct Problem {
+      //! \brief Concentrations we start from, after any dilution with RO water
+      std::array<double, numIons> base_ppm{};
+      //! \brief Concentrations we want to end up with
+      std::array<double, numIons> target_ppm{};
+      //! \brief Total water the salts are dissolved in
+      double water_l = 0.0;
+      //! \brief Which of \c salts we are allowed to use
+      std::array<bool, numSalts> available{true, true, true, true, true, true};
+
+      //! \brief If \c false, pH is ignored and the remaining pH fields are not used
+      bool constrainPh = false;
+      //! \brief Mash pH with no salts added
+      double ph0 = 7.0;
+      //! \brief Change in mash pH per gram of each of \c salts
+      std::array<double, numSalts> phPerG{};
+      double minPh = 0.0;
+      double maxPh = 14.0;
+   };
+
+   /**
+    * \brief What we came up with
+    */
+   struct Solution {
+      //! \brief Amount of each of \c salts.  NB grams, whereas \c Salt::amount() is in kilograms.
+      std::array<double, numSalts> amounts_g{};
+      //! \brief Resulting ion concentrations, indexed by \c Water::Ions
+      std::array<double, numIons> result_ppm{};
+      //! \brief Resulting mash pH (only meaningful if \c Problem::constrainPh was set)
+      double ph = 7.0;
+      /**
+       * \brief \c false if no combination of salts gets the pH within bounds.  (Typically this means an acid or more
+       *        alkaline base water is needed.)  We still return the best match we can find at the nearest pH we can
+       *        get to.
+       */
+      bool phInRange = true;
+   };
+
+   /**
+    * \brief Find non-negative salt amounts that minimise the (weighted) sum of squared differences between the
+    *        resulting and target ion concentrations, subject to the pH bounds.  The pH bounds are hard constraints:
+    *        if they can't be met, \c Solution::phInRange is \c false.
+    *
+    *        Each ion error is divided by the larger of its target concentration and 10 ppm, so that (say) being 5 ppm
+    *        out on sulfate at 300 ppm counts for less than being 5 ppm out on magnesium at 10 ppm.
+    */
+   Solution solve(Problem const & problem);
+}
+
+#endif
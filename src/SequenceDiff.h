@@ -0,0 +1,128 @@
+/*
+ * SequenceDiff.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SEQUENCEDIFF_H
+#define SEQUENCEDIFF_H
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * \namespace SequenceDiff
+ *
+ * \brief Works out the smallest set of changes that turn one list of things into another.  This is useful when the
+ *        things are stored objects (eg \c Instruction) and each insert, update or delete costs a database write, so
+ *        it's a lot cheaper to change what's there than to throw it all away and start again.
+ */
+namespace SequenceDiff {
+   //! \brief Value in the result of \c reuseMap() for a new item that has nothing to reuse
+   int constexpr noMatch = -1;
+
+   /**
+    * \brief For each item in a new sequence, decide which (if any) item in an old sequence should be reused for it.
+    *
+    *        Items that are equal in both sequences are matched first, using the longest common subsequence.  Then
+    *        leftover old items are paired in order with leftover new items, so that a changed item becomes one update
+    *        rather than a delete and an insert.  (Callers are assumed to store the order of the new sequence
+    *        separately -- eg as a list of IDs -- so reused items do not need to keep their old positions.)
+    *
+    * \param oldSize Number of items in the old sequence
+    * \param newSize Number of items in the new sequence
+    * \param isEqual Callable taking (old index, new index) and returning \c true if the old item is already exactly
+    *                what is wanted for the new one
+    *
+    * \return Vector of size \c newSize.  Element \c j is the index of the old item to reuse for new item \c j, or
+    *         \c noMatch if a new item needs to be created.  Each old index appears at most once, and old items that
+    *         do not appear at all are no longer needed.
+    */
+   template<class IsEqual>
+   std::vector<int> reuseMap(std::size_t const oldSize, std::size_t const newSize, IsEqual isEqual) {
+      std::vector<int> result(newSize, noMatch);
+
+      //
+      // Usually most of the list is unchanged, so trim off the common start and end before doing anything expensive.
+      //
+      std::size_t prefix = 0;
+      while (prefix < oldSize && prefix < newSize && isEqual(prefix, prefix)) {
+         result[prefix] = static_cast<int>(prefix);
+         ++prefix;
+      }
+      std::size_t suffix = 0;
+      while (suffix < oldSize - prefix && suffix < newSize - prefix &&
+             isEqual(oldSize - 1 - suffix, newSize - 1 - suffix)) {
+         result[newSize - 1 - suffix] = static_cast<int>(oldSize - 1 - suffix);
+         ++suffix;
+      }
+      std::size_t const numOld = oldSize - prefix - suffix;
+      std::size_t const numNew = newSize - prefix - suffix;
+
+      //
+      // Standard dynamic programming longest common subsequence on what's left.  lengths[i * (numNew + 1) + j] is the
+      // length of the LCS of old items [i, numOld) and new items [j, numNew) (relative to prefix).
+      //
+      std::size_t const width = numNew + 1;
+      std::vector<int> lengths((numOld + 1) * width, 0);
+      for (std::size_t ii = numOld; ii-- > 0; ) {
+         for (std::size_t jj = numNew; jj-- > 0; ) {
+            if (isEqual(prefix + ii, prefix + jj)) {
+               lengths[ii * width + jj] = lengths[(ii + 1) * width + jj + 1] + 1;
+            } else {
+               lengths[ii * width + jj] = std::max(lengths[(ii + 1) * width + jj], lengths[ii * width + jj + 1]);
+            }
+         }
+      }
+
+      //
+      // Walk the table to pick out the common subsequence, remembering what we skip on each side.
+      //
+      std::vector<std::size_t> unmatchedOld;
+      std::vector<std::size_t> unmatchedNew;
+      std::size_t ii = 0;
+      std::size_t jj = 0;
+      while (ii < numOld && jj < numNew) {
+         if (isEqual(prefix + ii, prefix + jj)) {
+            result[prefix + jj] = static_cast<int>(prefix + ii);
+            ++ii;
+            ++jj;
+         } else if (lengths[(ii + 1) * width + jj] >= lengths[ii * width + jj + 1]) {
+            unmatchedOld.push_back(prefix + ii);
+            ++ii;
+         } else {
+            unmatchedNew.push_back(prefix + jj);
+            ++jj;
+         }
+      }
+      for (; ii < numOld; ++ii) {
+         unmatchedOld.push_back(prefix + ii);
+      }
+      for (; jj < numNew; ++jj) {
+         unmatchedNew.push_back(prefix + jj);
+      }
+
+      // Everything else is a change
+      for (std::size_t kk = 0; kk < unmatchedOld.size() && kk < unmatchedNew.size(); ++kk) {
+         result[unmatchedNew[kk]] = static_cast<int>(unmatchedOld[kk]);
+      }
+
+      return result;
+   }
+}
+
+#endif
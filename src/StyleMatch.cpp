@@ -0,0 +1,405 @@
+/*
+ * StyleMatch.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StyleMatch.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <QDebug>
+
+#include "database/ObjectStoreWrapper.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
+
+namespace {
+   std::size_t index(StyleMatch::Vital const vital) { return static_cast<std::size_t>(vital); }
+
+   //
+   // Narrowest range we'll divide by for each vital, so that being a tiny bit outside a very narrow range (or a style
+   // that gives a single value rather than a range) isn't a disaster.  Roughly the smallest ranges in the BJCP
+   // guidelines.
+   //
+   StyleMatch::Vitals constexpr minWidths {
+      0.004, // Og
+      0.002, // Fg
+      5.0,   // Ibu
+      2.0,   // Color_srm
+      0.5,   // Abv_pct
+      0.3    // Carbonation_vols
+   };
+
+   bool isDisplayable(NamedEntity const * ne) {
+      return ne->display() && !ne->deleted() && ne->getParentKey() <= 0;
+   }
+
+   /**
+    * \brief Put the best \c maxResults of \c scores (all of them if \c maxResults is 0) in order.  Ties are broken by
+    *        ID so that results don't depend on the order rows happen to be in.
+    */
+   QVector<StyleMatch::Match> rank(std::vector<int> const & ids,
+                                   std::vector<double> const & scores,
+                                   std::size_t maxResults) {
+      std::size_t const numRows = ids.size();
+      if (maxResults == 0 || maxResults > numRows) {
+         maxResults = numRows;
+      }
+      std::vector<std::size_t> rows(numRows);
+      std::iota(rows.begin(), rows.end(), 0);
+      auto const better = [&](std::size_t const lhs, std::size_t const rhs) {
+         return scores[lhs] < scores[rhs] || (scores[lhs] == scores[rhs] && ids[lhs] < ids[rhs]);
+      };
+      std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(maxResults), rows.end(), better);
+
+      QVector<StyleMatch::Match> matches;
+      matches.reserve(static_cast<int>(maxResults));
+      for (std::size_t ii = 0; ii < maxResults; ++ii) {
+         matches.append(StyleMatch::Match{ids[rows[ii]], scores[rows[ii]]});
+      }
+      return matches;
+   }
+
+   //! \brief Remove row \c row from \c column by moving the last row into it
+   void swapRemove(std::vector<double> & column, std::size_t const row) {
+      column[row] = column.back();
+      column.pop_back();
+      return;
+   }
+}
+
+StyleMatch::Vitals StyleMatch::vitalsOf(Recipe & recipe) {
+   Vitals vitals;
+   vitals[index(Vital::Og)]               = recipe.og();
+   vitals[index(Vital::Fg)]               = recipe.fg();
+   vitals[index(Vital::Ibu)]              = recipe.IBU();
+   vitals[index(Vital::Color_srm)]        = recipe.color_srm();
+   vitals[index(Vital::Abv_pct)]          = recipe.ABV_pct();
+   vitals[index(Vital::Carbonation_vols)] = recipe.carbonation_vols();
+   return vitals;
+}
+
+StyleMatch::Ranges StyleMatch::rangesOf(Style const & style) {
+   Ranges ranges;
+   ranges.min[index(Vital::Og)]               = style.ogMin();
+   ranges.max[index(Vital::Og)]               = style.ogMax();
+   ranges.min[index(Vital::Fg)]               = style.fgMin();
+   ranges.max[index(Vital::Fg)]               = style.fgMax();
+   ranges.min[index(Vital::Ibu)]              = style.ibuMin();
+   ranges.max[index(Vital::Ibu)]              = style.ibuMax();
+   ranges.min[index(Vital::Color_srm)]        = style.colorMin_srm();
+   ranges.max[index(Vital::Color_srm)]        = style.colorMax_srm();
+   ranges.min[index(Vital::Abv_pct)]          = style.abvMin_pct();
+   ranges.max[index(Vital::Abv_pct)]          = style.abvMax_pct();
+   ranges.min[index(Vital::Carbonation_vols)] = style.carbMin_vol();
+   ranges.max[index(Vital::Carbonation_vols)] = style.carbMax_vol();
+   return ranges;
+}
+
+std::optional<StyleMatch::Vital> StyleMatch::recipeVital(char const * propertyName) {
+   if (propertyName == PropertyNames::Recipe::og              ) { return Vital::Og;               }
+   if (propertyName == PropertyNames::Recipe::fg              ) { return Vital::Fg;               }
+   if (propertyName == PropertyNames::Recipe::IBU             ) { return Vital::Ibu;              }
+   if (propertyName == PropertyNames::Recipe::color_srm       ) { return Vital::Color_srm;        }
+   if (propertyName == PropertyNames::Recipe::ABV_pct         ) { return Vital::Abv_pct;          }
+   if (propertyName == PropertyNames::Recipe::carbonation_vols) { return Vital::Carbonation_vols; }
+   return std::nullopt;
+}
+
+StyleMatch::Table::Table() :
+   m_recipeIds{},
+   m_recipeVitals{},
+   m_recipeRows{},
+   m_styleIds{},
+   m_styleMin{},
+   m_styleMax{},
+   m_styleInvWidth{},
+   m_styleRows{},
+   m_scores{} {
+   return;
+}
+
+std::size_t StyleMatch::Table::numRecipes() const {
+   return this->m_recipeIds.size();
+}
+
+std::size_t StyleMatch::Table::numStyles() const {
+   return this->m_styleIds.size();
+}
+
+bool StyleMatch::Table::containsRecipe(int const recipeId) const {
+   return this->m_recipeRows.contains(recipeId);
+}
+
+bool StyleMatch::Table::containsStyle(int const styleId) const {
+   return this->m_styleRows.contains(styleId);
+}
+
+void StyleMatch::Table::setRecipe(int const recipeId, Vitals const & vitals) {
+   auto row = this->m_recipeRows.constFind(recipeId);
+   if (row == this->m_recipeRows.constEnd()) {
+      row = this->m_recipeRows.insert(recipeId, this->m_recipeIds.size());
+      this->m_recipeIds.push_back(recipeId);
+      for (auto & column : this->m_recipeVitals) {
+         column.push_back(0.0);
+      }
+   }
+   for (std::size_t vv = 0; vv < numVitals; ++vv) {
+      this->m_recipeVitals[vv][*row] = vitals[vv];
+   }
+   return;
+}
+
+void StyleMatch::Table::setRecipeVital(int const recipeId, Vital const vital, double const value) {
+   auto const row = this->m_recipeRows.constFind(recipeId);
+   if (row != this->m_recipeRows.constEnd()) {
+      this->m_recipeVitals[index(vital)][*row] = value;
+   }
+   return;
+}
+
+void StyleMatch::Table::removeRecipe(int const recipeId) {
+   auto const found = this->m_recipeRows.find(recipeId);
+   if (found == this->m_recipeRows.end()) {
+      return;
+   }
+   std::size_t const row = *found;
+   this->m_recipeRows.erase(found);
+   if (row + 1 < this->m_recipeIds.size()) {
+      this->m_recipeRows[this->m_recipeIds.back()] = row;
+   }
+   this->m_recipeIds[row] = this->m_recipeIds.back();
+   this->m_recipeIds.pop_back();
+   for (auto & column : this->m_recipeVitals) {
+      swapRemove(column, row);
+   }
+   return;
+}
+
+void StyleMatch::Table::setStyle(int const styleId, Ranges const & ranges) {
+   auto row = this->m_styleRows.constFind(styleId);
+   if (row == this->m_styleRows.constEnd()) {
+      row = this->m_styleRows.insert(styleId, this->m_styleIds.size());
+      this->m_styleIds.push_back(styleId);
+      for (std::size_t vv = 0; vv < numVitals; ++vv) {
+         this->m_styleMin[vv].push_back(0.0);
+         this->m_styleMax[vv].push_back(0.0);
+         this->m_styleInvWidth[vv].push_back(0.0);
+      }
+   }
+   for (std::size_t vv = 0; vv < numVitals; ++vv) {
+      double const min = std::min(ranges.min[vv], ranges.max[vv]);
+      double const max = std::max(ranges.min[vv], ranges.max[vv]);
+      this->m_styleMin[vv][*row] = min;
+      this->m_styleMax[vv][*row] = max;
+      this->m_styleInvWidth[vv][*row] = (max <= 0.0) ? 0.0 : 1.0 / std::max(max - min, minWidths[vv]);
+   }
+   return;
+}
+
+void StyleMatch::Table::removeStyle(int const styleId) {
+   auto const found = this->m_styleRows.find(styleId);
+   if (found == this->m_styleRows.end()) {
+      return;
+   }
+   std::size_t const row = *found;
+   this->m_styleRows.erase(found);
+   if (row + 1 < this->m_styleIds.size()) {
+      this->m_styleRows[this->m_styleIds.back()] = row;
+   }
+   this->m_styleIds[row] = this->m_styleIds.back();
+   this->m_styleIds.pop_back();
+   for (std::size_t vv = 0; vv < numVitals; ++vv) {
+      swapRemove(this->m_styleMin[vv], row);
+      swapRemove(this->m_styleMax[vv], row);
+      swapRemove(this->m_styleInvWidth[vv], row);
+   }
+   return;
+}
+
+QVector<StyleMatch::Match> StyleMatch::Table::bestRecipes(Ranges const & ranges, std::size_t const maxResults) const {
+   std::size_t const numRows = this->m_recipeIds.size();
+   this->m_scores.assign(numRows, 0.0);
+   double * const scores = this->m_scores.data();
+
+   // One vital at a time, so each inner loop is over contiguous arrays with no branches
+   for (std::size_t vv = 0; vv < numVitals; ++vv) {
+      double const min = std::min(ranges.min[vv], ranges.max[vv]);
+      double const max = std::max(ranges.min[vv], ranges.max[vv]);
+      if (max <= 0.0) {
+         continue;
+      }
+      double const invWidth = 1.0 / std::max(max - min, minWidths[vv]);
+      double const * const values = this->m_recipeVitals[vv].data();
+      for (std::size_t row = 0; row < numRows; ++row) {
+         double const outside = std::max(std::max(min - values[row], values[row] - max), 0.0) * invWidth;
+         scores[row] += values[row] > 0.0 ? outside * outside : 0.0;
+      }
+   }
+   return rank(this->m_recipeIds, this->m_scores, maxResults);
+}
+
+QVector<StyleMatch::Match> StyleMatch::Table::bestStyles(Vitals const & vitals, std::size_t const maxResults) const {
+   std::size_t const numRows = this->m_styleIds.size();
+   this->m_scores.assign(numRows, 0.0);
+   double * const scores = this->m_scores.data();
+
+   for (std::size_t vv = 0; vv < numVitals; ++vv) {
+      double const value = vitals[vv];
+      if (value <= 0.0) {
+         continue;
+      }
+      double const * const mins      = this->m_styleMin[vv].data();
+      double const * const maxes     = this->m_styleMax[vv].data();
+      double const * const invWidths = this->m_styleInvWidth[vv].data();
+      for (std::size_t row = 0; row < numRows; ++row) {
+         // Unspecified ranges have invWidth = 0, so they add nothing
+         double const outside = std::max(std::max(mins[row] - value, value - maxes[row]), 0.0) * invWidths[row];
+         scores[row] += outside * outside;
+      }
+   }
+   return rank(this->m_styleIds, this->m_scores, maxResults);
+}
+
+StyleMatchIndex & StyleMatchIndex::instance() {
+   static StyleMatchIndex singleton;
+   return singleton;
+}
+
+StyleMatchIndex::StyleMatchIndex() :
+   QObject{},
+   m_populated{false},
+   m_table{} {
+   return;
+}
+
+StyleMatchIndex::~StyleMatchIndex() = default;
+
+StyleMatch::Table const & StyleMatchIndex::table() {
+   if (!this->m_populated) {
+      this->populate();
+   }
+   return this->m_table;
+}
+
+QVector<StyleMatch::Match> StyleMatchIndex::recipesForStyle(Style const & style, std::size_t const maxResults) {
+   return this->table().bestRecipes(StyleMatch::rangesOf(style), maxResults);
+}
+
+QVector<StyleMatch::Match> StyleMatchIndex::stylesForRecipe(Recipe & recipe, std::size_t const maxResults) {
+   return this->table().bestStyles(StyleMatch::vitalsOf(recipe), maxResults);
+}
+
+void StyleMatchIndex::populate() {
+   // We don't connect to the object stores until now, as there's no point tracking changes until someone asks
+   connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalObjectInserted, this, &StyleMatchIndex::recipeInserted);
+   connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalObjectDeleted,  this, &StyleMatchIndex::recipeDeleted );
+   connect(&ObjectStoreTyped<Style >::getInstance(), &ObjectStoreTyped<Style >::signalObjectInserted, this, &StyleMatchIndex::styleInserted );
+   connect(&ObjectStoreTyped<Style >::getInstance(), &ObjectStoreTyped<Style >::signalObjectDeleted,  this, &StyleMatchIndex::styleDeleted  );
+
+   for (Recipe * recipe : ObjectStoreWrapper::getAllDisplayableRaw<Recipe>()) {
+      this->addRecipe(recipe);
+   }
+   for (Style * style : ObjectStoreWrapper::getAllDisplayableRaw<Style>()) {
+      this->addStyle(style);
+   }
+   this->m_populated = true;
+   qDebug() <<
+      Q_FUNC_INFO << "Indexed" << this->m_table.numRecipes() << "recipes and" << this->m_table.numStyles() << "styles";
+   return;
+}
+
+void StyleMatchIndex::addRecipe(Recipe * recipe) {
+   // Recipes can stop (or start) being displayable, so we stay connected whether or not this one is in the table
+   connect(recipe, &NamedEntity::changed, this, &StyleMatchIndex::recipeChanged, Qt::UniqueConnection);
+   if (isDisplayable(recipe)) {
+      this->m_table.setRecipe(recipe->key(), StyleMatch::vitalsOf(*recipe));
+   }
+   return;
+}
+
+void StyleMatchIndex::addStyle(Style * style) {
+   connect(style, &NamedEntity::changed, this, &StyleMatchIndex::styleChanged, Qt::UniqueConnection);
+   if (isDisplayable(style)) {
+      this->m_table.setStyle(style->key(), StyleMatch::rangesOf(*style));
+   }
+   return;
+}
+
+void StyleMatchIndex::recipeInserted(int id) {
+   Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(id);
+   if (recipe) {
+      this->addRecipe(recipe);
+   }
+   return;
+}
+
+void StyleMatchIndex::recipeDeleted(int id, [[maybe_unused]] std::shared_ptr<QObject> object) {
+   this->m_table.removeRecipe(id);
+   return;
+}
+
+void StyleMatchIndex::recipeChanged(QMetaProperty prop, QVariant val) {
+   Recipe * recipe = qobject_cast<Recipe *>(this->sender());
+   if (!recipe) {
+      return;
+   }
+
+   char const * propertyName = prop.name();
+   if (propertyName == PropertyNames::NamedEntity::display || propertyName == PropertyNames::NamedEntity::deleted) {
+      if (isDisplayable(recipe)) {
+         this->m_table.setRecipe(recipe->key(), StyleMatch::vitalsOf(*recipe));
+      } else {
+         this->m_table.removeRecipe(recipe->key());
+      }
+      return;
+   }
+
+   // The usual case: one number has changed, so we only need to update one cell
+   std::optional<StyleMatch::Vital> const vital = StyleMatch::recipeVital(propertyName);
+   if (vital) {
+      this->m_table.setRecipeVital(recipe->key(), *vital, val.toDouble());
+   }
+   return;
+}
+
+void StyleMatchIndex::styleInserted(int id) {
+   Style * style = ObjectStoreWrapper::getByIdRaw<Style>(id);
+   if (style) {
+      this->addStyle(style);
+   }
+   return;
+}
+
+void StyleMatchIndex::styleDeleted(int id, [[maybe_unused]] std::shared_ptr<QObject> object) {
+   this->m_table.removeStyle(id);
+   return;
+}
+
+void StyleMatchIndex::styleChanged([[maybe_unused]] QMetaProperty prop, [[maybe_unused]] QVariant val) {
+   Style * style = qobject_cast<Style *>(this->sender());
+   if (!style) {
+      return;
+   }
+   // Styles rarely change and only have a dozen numbers, so just re-read them all
+   if (isDisplayable(style)) {
+      this->m_table.setStyle(style->key(), StyleMatch::rangesOf(*style));
+   } else {
+      this->m_table.removeStyle(style->key());
+   }
+   return;
+}
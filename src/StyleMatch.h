@@ -0,0 +1,182 @@
+/*
+ * StyleMatch.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef STYLEMATCH_H
+#define STYLEMATCH_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QHash>
+#include <QMetaProperty>
+#include <QObject>
+#include <QVariant>
+#include <QVector>
+
+class Recipe;
+class Style;
+
+/*!
+ * \namespace StyleMatch
+ *
+ * \brief Scores how well recipes fit styles, for "which recipes best fit this style?" and "which style is closest to
+ *        this recipe?" across the whole library.
+ *
+ *        For each of the vitals a style specifies, a recipe scores nothing if it's in range, and otherwise the square of
+ *        how far outside the range it is, measured in range widths.  Lower scores are better and 0 is a perfect fit.
+ *        Vitals the style doesn't specify (ie where min and max are both 0) and ones the recipe doesn't have (ie 0 or
+ *        less, such as a recipe with no carbonation set) are ignored.
+ */
+namespace StyleMatch {
+
+   enum class Vital {
+      Og,
+      Fg,
+      Ibu,
+      Color_srm,
+      Abv_pct,
+      Carbonation_vols
+   };
+   std::size_t constexpr numVitals = 6;
+
+   using Vitals = std::array<double, numVitals>;
+
+   struct Ranges {
+      Vitals min{};
+      Vitals max{};
+   };
+
+   Vitals vitalsOf(Recipe & recipe);
+   Ranges rangesOf(Style const & style);
+
+   //! \brief Which vital, if any, the \c Recipe property \c propertyName is
+   std::optional<Vital> recipeVital(char const * propertyName);
+
+   struct Match {
+      //! \brief ID of the recipe or style
+      int id;
+      double score;
+   };
+
+   /**
+    * \brief Vitals of every recipe and ranges of every style, stored column-wise (one array per vital) so that scoring
+    *        a style against every recipe, or a recipe against every style, is a handful of straight passes over
+    *        contiguous doubles that the compiler can vectorise.
+    *
+    *        Adding, updating and removing a recipe or style is O(1).  (Removal swaps the last row into the gap.)
+    */
+   class Table {
+   public:
+      Table();
+
+      std::size_t numRecipes() const;
+      std::size_t numStyles() const;
+      bool containsRecipe(int recipeId) const;
+      bool containsStyle(int styleId) const;
+
+      //! \brief Add a recipe, or replace its vitals if it's already in the table
+      void setRecipe(int recipeId, Vitals const & vitals);
+      //! \brief Update one vital of a recipe that's in the table.  Does nothing if it's not.
+      void setRecipeVital(int recipeId, Vital vital, double value);
+      void removeRecipe(int recipeId);
+
+      //! \brief Add a style, or replace its ranges if it's already in the table
+      void setStyle(int styleId, Ranges const & ranges);
+      void removeStyle(int styleId);
+
+      /**
+       * \brief Recipes that best fit \c ranges, best first
+       *
+       * \param maxResults 0 means all of them
+       */
+      QVector<Match> bestRecipes(Ranges const & ranges, std::size_t maxResults) const;
+
+      /**
+       * \brief Styles closest to \c vitals, best first
+       *
+       * \param maxResults 0 means all of them
+       */
+      QVector<Match> bestStyles(Vitals const & vitals, std::size_t maxResults) const;
+
+   private:
+      std::vector<int> m_recipeIds;
+      std::array<std::vector<double>, numVitals> m_recipeVitals;
+      QHash<int, std::size_t> m_recipeRows;
+
+      std::vector<int> m_styleIds;
+      std::array<std::vector<double>, numVitals> m_styleMin;
+      std::array<std::vector<double>, numVitals> m_styleMax;
+      //! \brief 1 / range width, or 0 for vitals the style doesn't specify
+      std::array<std::vector<double>, numVitals> m_styleInvWidth;
+      QHash<int, std::size_t> m_styleRows;
+
+      //! \brief Saves allocating a new array of scores for every query
+      mutable std::vector<double> m_scores;
+   };
+}
+
+/*!
+ * \class StyleMatchIndex
+ *
+ * \brief Keeps a \c StyleMatch::Table of every displayable recipe and style in the database up to date.  It is filled
+ *        the first time it's needed, and then updated from \c ObjectStore insert and delete signals and the
+ *        \c NamedEntity::changed signals of individual recipes and styles, so a change to one recipe only updates that
+ *        recipe's row.
+ */
+class StyleMatchIndex : public QObject {
+   Q_OBJECT
+
+public:
+   static StyleMatchIndex & instance();
+
+   //! \brief The table, after filling it if this is the first time we've needed it
+   StyleMatch::Table const & table();
+
+   //! \brief See \c StyleMatch::Table::bestRecipes
+   QVector<StyleMatch::Match> recipesForStyle(Style const & style, std::size_t maxResults);
+
+   //! \brief See \c StyleMatch::Table::bestStyles
+   QVector<StyleMatch::Match> stylesForRecipe(Recipe & recipe, std::size_t maxResults);
+
+private slots:
+   void recipeInserted(int id);
+   void recipeDeleted(int id, std::shared_ptr<QObject> object);
+   void recipeChanged(QMetaProperty prop, QVariant val);
+   void styleInserted(int id);
+   void styleDeleted(int id, std::shared_ptr<QObject> object);
+   void styleChanged(QMetaProperty prop, QVariant val);
+
+private:
+   StyleMatchIndex();
+   ~StyleMatchIndex();
+   StyleMatchIndex(StyleMatchIndex const &) = delete;
+   StyleMatchIndex & operator=(StyleMatchIndex const &) = delete;
+
+   void populate();
+   void addRecipe(Recipe * recipe);
+   void addStyle(Style * style);
+
+   bool m_populated;
+   StyleMatch::Table m_table;
+};
+
+#endif
@@ -0,0 +1,238 @@
+/*
+ * StyleMatchDialog.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StyleMatchDialog.h"
+
+#include <algorithm>
+
+#include <QComboBox>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPointer>
+#include <QShowEvent>
+#include <QSignalBlocker>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "database/ObjectStoreWrapper.h"
+#include "Localization.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
+#include "StyleMatch.h"
+
+namespace {
+   // More than this and the lists stop being useful
+   std::size_t constexpr maxResults = 25;
+
+   QTableWidget * makeResultsTable(QWidget * parent) {
+      auto table = new QTableWidget(0, 2, parent);
+      table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+      table->setSelectionBehavior(QAbstractItemView::SelectRows);
+      table->verticalHeader()->setVisible(false);
+      table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+      table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+      return table;
+   }
+
+   template<class NE>
+   void showMatches(QTableWidget & table, QVector<StyleMatch::Match> const & matches) {
+      table.setRowCount(matches.size());
+      int row = 0;
+      for (StyleMatch::Match const & match : matches) {
+         NE const * ne = ObjectStoreWrapper::getByIdRaw<NE>(match.id);
+         table.setItem(row, 0, new QTableWidgetItem(ne ? ne->name() : QString::number(match.id)));
+         auto scoreItem = new QTableWidgetItem(Localization::getLocale().toString(match.score, 'f', 2));
+         scoreItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+         table.setItem(row, 1, scoreItem);
+         ++row;
+      }
+      return;
+   }
+}
+
+// This private implementation class holds all private non-virtual members of StyleMatchDialog
+class StyleMatchDialog::impl {
+public:
+   impl(StyleMatchDialog & self) :
+      self               {self},
+      recipe             {nullptr},
+      groupBox_recipes   {new QGroupBox   (&self)},
+      label_style        {new QLabel      (&self)},
+      comboBox_style     {new QComboBox   (&self)},
+      table_recipes      {makeResultsTable(&self)},
+      groupBox_styles    {new QGroupBox   (&self)},
+      label_recipe       {new QLabel      (&self)},
+      table_styles       {makeResultsTable(&self)},
+      label_searchTime   {new QLabel      (&self)} {
+      this->doLayout();
+      this->retranslateUi();
+      connect(this->comboBox_style, QOverload<int>::of(&QComboBox::currentIndexChanged), &self, &StyleMatchDialog::search);
+      return;
+   }
+
+   ~impl() = default;
+
+   void doLayout() {
+      auto styleRow = new QHBoxLayout();
+      styleRow->addWidget(this->label_style);
+      styleRow->addWidget(this->comboBox_style, 1);
+      auto recipesLayout = new QVBoxLayout(this->groupBox_recipes);
+      recipesLayout->addLayout(styleRow);
+      recipesLayout->addWidget(this->table_recipes);
+
+      auto stylesLayout = new QVBoxLayout(this->groupBox_styles);
+      stylesLayout->addWidget(this->label_recipe);
+      stylesLayout->addWidget(this->table_styles);
+
+      auto columns = new QHBoxLayout();
+      columns->addWidget(this->groupBox_recipes);
+      columns->addWidget(this->groupBox_styles);
+
+      auto mainLayout = new QVBoxLayout(&self);
+      mainLayout->addLayout(columns);
+      mainLayout->addWidget(this->label_searchTime);
+      return;
+   }
+
+   void retranslateUi() {
+      self.setWindowTitle(tr("Style Match"));
+      this->groupBox_recipes->setTitle(tr("Recipes that best fit a style"));
+      this->label_style->setText(tr("Style"));
+      this->groupBox_styles->setTitle(tr("Styles closest to the current recipe"));
+      this->table_recipes->setHorizontalHeaderLabels({tr("Recipe"), tr("Distance")});
+      this->table_styles ->setHorizontalHeaderLabels({tr("Style"),  tr("Distance")});
+#ifndef QT_NO_TOOLTIP
+      QString const distanceHelp{
+         tr("0 means every vital (OG, FG, IBU, color, ABV, carbonation) is within the style's range.  Otherwise, it is "
+            "the sum of the squares of how far each vital is outside its range, measured in range widths.")
+      };
+      this->table_recipes->setToolTip(distanceHelp);
+      this->table_styles ->setToolTip(distanceHelp);
+#endif
+      this->showRecipeName();
+      return;
+   }
+
+   void showRecipeName() {
+      this->label_recipe->setText(this->recipe ? this->recipe->name() : tr("No recipe selected"));
+      return;
+   }
+
+   //! \brief Refill the list of styles, keeping the current selection if it's still there
+   void loadStyles() {
+      int const selectedId = this->comboBox_style->currentData().toInt();
+      QList<Style *> styles = ObjectStoreWrapper::getAllDisplayableRaw<Style>();
+      std::sort(styles.begin(), styles.end(), [](Style const * lhs, Style const * rhs) {
+         return QString::localeAwareCompare(lhs->name(), rhs->name()) < 0;
+      });
+
+      // Don't search for every style as we add it
+      QSignalBlocker blocker{this->comboBox_style};
+      this->comboBox_style->clear();
+      for (Style const * style : styles) {
+         this->comboBox_style->addItem(style->name(), style->key());
+      }
+      int const selectedIndex = this->comboBox_style->findData(selectedId);
+      if (selectedIndex >= 0) {
+         this->comboBox_style->setCurrentIndex(selectedIndex);
+      } else if (this->recipe && this->recipe->style()) {
+         // Start with the current recipe's style, as that's the most likely question
+         this->comboBox_style->setCurrentIndex(this->comboBox_style->findData(this->recipe->style()->key()));
+      }
+      return;
+   }
+
+   void search() {
+      QElapsedTimer timer;
+      timer.start();
+
+      StyleMatchIndex & index = StyleMatchIndex::instance();
+      Style const * style = ObjectStoreWrapper::getByIdRaw<Style>(this->comboBox_style->currentData().toInt());
+      if (style) {
+         showMatches<Recipe>(*this->table_recipes, index.recipesForStyle(*style, maxResults));
+      } else {
+         this->table_recipes->setRowCount(0);
+      }
+      if (this->recipe) {
+         showMatches<Style>(*this->table_styles, index.stylesForRecipe(*this->recipe, maxResults));
+      } else {
+         this->table_styles->setRowCount(0);
+      }
+
+      this->label_searchTime->setText(
+         tr("Searched %1 recipes and %2 styles in %3 ms").arg(index.table().numRecipes())
+                                                         .arg(index.table().numStyles())
+                                                         .arg(timer.elapsed())
+      );
+      return;
+   }
+
+   StyleMatchDialog & self;
+   QPointer<Recipe>   recipe;
+   QGroupBox        * groupBox_recipes;
+   QLabel           * label_style;
+   QComboBox        * comboBox_style;
+   QTableWidget     * table_recipes;
+   QGroupBox        * groupBox_styles;
+   QLabel           * label_recipe;
+   QTableWidget     * table_styles;
+   QLabel           * label_searchTime;
+};
+
+StyleMatchDialog::StyleMatchDialog(QWidget * parent) : QDialog(parent),
+                                                       pimpl{std::make_unique<impl>(*this)} {
+   return;
+}
+
+StyleMatchDialog::~StyleMatchDialog() = default;
+
+void StyleMatchDialog::setRecipe(Recipe * recipe) {
+   this->pimpl->recipe = recipe;
+   this->pimpl->showRecipeName();
+   if (this->isVisible()) {
+      this->search();
+   }
+   return;
+}
+
+void StyleMatchDialog::search() {
+   this->pimpl->search();
+   return;
+}
+
+void StyleMatchDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->retranslateUi();
+   }
+   // Let base class do its work too
+   this->QDialog::changeEvent(event);
+   return;
+}
+
+void StyleMatchDialog::showEvent(QShowEvent * event) {
+   this->pimpl->loadStyles();
+   this->search();
+   // Let base class do its work too
+   this->QDialog::showEvent(event);
+   return;
+}
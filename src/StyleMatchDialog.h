@@ -0,0 +1,60 @@
+/*
+ * StyleMatchDialog.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef STYLEMATCHDIALOG_H
+#define STYLEMATCHDIALOG_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QDialog>
+
+class QEvent;
+class QShowEvent;
+class QWidget;
+class Recipe;
+
+/*!
+ * \brief Searches the whole library for the recipes that best fit a chosen style, and for the styles closest to the
+ *        current recipe.  See \c StyleMatch for how fit is scored.
+ */
+class StyleMatchDialog : public QDialog {
+   Q_OBJECT
+
+public:
+   StyleMatchDialog(QWidget * parent = nullptr);
+   virtual ~StyleMatchDialog();
+
+   //! \brief Recipe whose closest styles we show.  Can be \c nullptr.
+   void setRecipe(Recipe * recipe);
+
+public slots:
+   //! \brief Rerun both searches
+   void search();
+
+protected:
+   virtual void changeEvent(QEvent * event);
+   virtual void showEvent(QShowEvent * event);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
@@ -0,0 +1,342 @@
+/*
+ * TextSearch.cpp is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TextSearch.h"
+
+#include <algorithm>
+
+#include <QDebug>
+
+#include "database/ObjectStoreTyped.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Misc.h"
+#include "model/Yeast.h"
+
+namespace {
+   int constexpr trigramLength = 3;
+
+   // Fields are joined with a character normalised() never leaves in a query, so no query can match across two fields
+   QChar const fieldSeparator{'\n'};
+
+   quint64 trigramAt(QString const & text, int const position) {
+      return (static_cast<quint64>(text.at(position    ).unicode()) << 32) |
+             (static_cast<quint64>(text.at(position + 1).unicode()) << 16) |
+              static_cast<quint64>(text.at(position + 2).unicode());
+   }
+
+   QSet<quint64> trigramsOf(QString const & text) {
+      QSet<quint64> trigrams;
+      for (int ii = 0; ii + trigramLength <= text.size(); ++ii) {
+         trigrams.insert(trigramAt(text, ii));
+      }
+      return trigrams;
+   }
+
+   QString joinFields(QStringList const & fields) {
+      QStringList normalisedFields;
+      for (QString const & field : fields) {
+         if (!field.isEmpty()) {
+            normalisedFields.append(TextSearch::normalised(field));
+         }
+      }
+      return normalisedFields.join(fieldSeparator);
+   }
+
+   //! \brief Normalise each line separately, so we keep the line breaks between fields
+   QString normalisedLines(QString const & text) {
+      QStringList lines = text.split(fieldSeparator);
+      for (QString & line : lines) {
+         line = TextSearch::normalised(line);
+      }
+      return lines.join(fieldSeparator);
+   }
+
+   //
+   // What we search for each type of object.  Every type gets its name and notes, plus whatever else people would
+   // naturally type to find one (eg "Yakima" for a hop, "Weyermann" for a malt, "WLP001" for a yeast).
+   //
+   template<class NE> QString searchableText(NamedEntity const & namedEntity);
+   template<class NE> QVector<BtStringConst const *> searchableProperties();
+
+   template<> QString searchableText<Fermentable>(NamedEntity const & namedEntity) {
+      auto const & fermentable = static_cast<Fermentable const &>(namedEntity);
+      return joinFields({fermentable.name(), fermentable.origin(), fermentable.supplier(), fermentable.notes()});
+   }
+   template<> QVector<BtStringConst const *> searchableProperties<Fermentable>() {
+      return {&PropertyNames::NamedEntity::name,
+              &PropertyNames::Fermentable::origin,
+              &PropertyNames::Fermentable::supplier,
+              &PropertyNames::Fermentable::notes};
+   }
+
+   template<> QString searchableText<Hop>(NamedEntity const & namedEntity) {
+      auto const & hop = static_cast<Hop const &>(namedEntity);
+      return joinFields({hop.name(), hop.origin(), hop.notes()});
+   }
+   template<> QVector<BtStringConst const *> searchableProperties<Hop>() {
+      return {&PropertyNames::NamedEntity::name, &PropertyNames::Hop::origin, &PropertyNames::Hop::notes};
+   }
+
+   template<> QString searchableText<Misc>(NamedEntity const & namedEntity) {
+      auto const & misc = static_cast<Misc const &>(namedEntity);
+      return joinFields({misc.name(), misc.notes()});
+   }
+   template<> QVector<BtStringConst const *> searchableProperties<Misc>() {
+      return {&PropertyNames::NamedEntity::name, &PropertyNames::Misc::notes};
+   }
+
+   template<> QString searchableText<Yeast>(NamedEntity const & namedEntity) {
+      auto const & yeast = static_cast<Yeast const &>(namedEntity);
+      return joinFields({yeast.name(), yeast.laboratory(), yeast.productID(), yeast.notes()});
+   }
+   template<> QVector<BtStringConst const *> searchableProperties<Yeast>() {
+      return {&PropertyNames::NamedEntity::name,
+              &PropertyNames::Yeast::laboratory,
+              &PropertyNames::Yeast::productID,
+              &PropertyNames::Yeast::notes};
+   }
+}
+
+QString TextSearch::normalised(QString const & text) {
+   return text.simplified().toLower();
+}
+
+TextSearch::Index::Index() : m_texts{}, m_postings{} {
+   return;
+}
+
+int TextSearch::Index::size() const {
+   return this->m_texts.size();
+}
+
+bool TextSearch::Index::contains(int const id) const {
+   return this->m_texts.contains(id);
+}
+
+void TextSearch::Index::set(int const id, QString const & text) {
+   this->remove(id);
+   QString const normalisedText = normalisedLines(text);
+   this->m_texts.insert(id, normalisedText);
+   for (quint64 const trigram : trigramsOf(normalisedText)) {
+      this->m_postings[trigram].insert(id);
+   }
+   return;
+}
+
+void TextSearch::Index::remove(int const id) {
+   auto text = this->m_texts.find(id);
+   if (text == this->m_texts.end()) {
+      return;
+   }
+   for (quint64 const trigram : trigramsOf(text.value())) {
+      auto posting = this->m_postings.find(trigram);
+      if (posting != this->m_postings.end()) {
+         posting.value().remove(id);
+         if (posting.value().isEmpty()) {
+            this->m_postings.erase(posting);
+         }
+      }
+   }
+   this->m_texts.erase(text);
+   return;
+}
+
+QSet<int> TextSearch::Index::matching(QString const & query, QSet<int> const * within) const {
+   QString const normalisedQuery = TextSearch::normalised(query);
+
+   //
+   // Start with the smallest set of candidates we can find cheaply: the previous matches, or the objects with the
+   // query's rarest trigram in them.  For queries too short to have any trigrams we just check everything, but people
+   // rarely stop at two letters.
+   //
+   QSet<quint64> const trigrams = trigramsOf(normalisedQuery);
+   QVector<QSet<int> const *> postings;
+   postings.reserve(trigrams.size());
+   for (quint64 const trigram : trigrams) {
+      auto posting = this->m_postings.constFind(trigram);
+      if (posting == this->m_postings.constEnd()) {
+         // Nothing has this trigram, so nothing can match
+         return {};
+      }
+      postings.append(&posting.value());
+   }
+   std::sort(postings.begin(), postings.end(), [](QSet<int> const * lhs, QSet<int> const * rhs) {
+      return lhs->size() < rhs->size();
+   });
+
+   QSet<int> candidates;
+   if (within && (postings.isEmpty() || within->size() < postings.first()->size())) {
+      candidates = *within;
+   } else if (!postings.isEmpty()) {
+      candidates = *postings.first();
+   } else {
+      candidates.reserve(this->m_texts.size());
+      for (auto text = this->m_texts.constBegin(); text != this->m_texts.constEnd(); ++text) {
+         candidates.insert(text.key());
+      }
+   }
+
+   //
+   // Every trigram being present doesn't guarantee the whole query is (eg "ascade" and "cade" both have "ade"), so each
+   // surviving candidate gets a final check against its text.
+   //
+   QSet<int> result;
+   for (int const id : candidates) {
+      if (within && !within->contains(id)) {
+         continue;
+      }
+      bool inAllPostings = true;
+      for (QSet<int> const * posting : postings) {
+         if (!posting->contains(id)) {
+            inAllPostings = false;
+            break;
+         }
+      }
+      if (!inAllPostings) {
+         continue;
+      }
+      auto text = this->m_texts.constFind(id);
+      if (text != this->m_texts.constEnd() && text.value().contains(normalisedQuery)) {
+         result.insert(id);
+      }
+   }
+   return result;
+}
+
+TextSearch::Filter::Filter(TextSearchIndex & index) :
+   m_index{index},
+   m_lastQuery{},
+   m_lastGeneration{-1},
+   m_lastMatches{} {
+   return;
+}
+
+bool TextSearch::Filter::accepts(NamedEntity const & namedEntity, QRegExp const & filterRegExp) {
+   if (filterRegExp.isEmpty()) {
+      return true;
+   }
+   if (filterRegExp.patternSyntax() != QRegExp::FixedString) {
+      return namedEntity.name().contains(filterRegExp);
+   }
+
+   QString const query = TextSearch::normalised(filterRegExp.pattern());
+   if (namedEntity.key() <= 0) {
+      // Not in the database (eg still being created in an editor), so not in the index either
+      return normalisedLines(this->m_index.textOf(namedEntity)).contains(query);
+   }
+
+   if (query != this->m_lastQuery || this->m_index.generation() != this->m_lastGeneration) {
+      bool const refine = !this->m_lastQuery.isEmpty() &&
+                          query.contains(this->m_lastQuery) &&
+                          this->m_index.generation() == this->m_lastGeneration;
+      this->m_lastMatches = this->m_index.matching(query, refine ? &this->m_lastMatches : nullptr);
+      this->m_lastQuery = query;
+      this->m_lastGeneration = this->m_index.generation();
+   }
+   return this->m_lastMatches.contains(namedEntity.key());
+}
+
+template<class NE> TextSearchIndex & TextSearchIndex::instance() {
+   static TextSearchIndex singleton{ObjectStoreTyped<NE>::getInstance(),
+                                    &searchableText<NE>,
+                                    searchableProperties<NE>()};
+   return singleton;
+}
+template TextSearchIndex & TextSearchIndex::instance<Fermentable>();
+template TextSearchIndex & TextSearchIndex::instance<Hop        >();
+template TextSearchIndex & TextSearchIndex::instance<Misc       >();
+template TextSearchIndex & TextSearchIndex::instance<Yeast      >();
+
+TextSearchIndex::TextSearchIndex(ObjectStore & objectStore,
+                                 TextFunction textFunction,
+                                 QVector<BtStringConst const *> indexedProperties) :
+   QObject{},
+   m_objectStore{objectStore},
+   m_textFunction{textFunction},
+   m_indexedProperties{indexedProperties},
+   m_populated{false},
+   m_generation{0},
+   m_index{} {
+   return;
+}
+
+TextSearchIndex::~TextSearchIndex() = default;
+
+QSet<int> TextSearchIndex::matching(QString const & query, QSet<int> const * within) {
+   this->populate();
+   return this->m_index.matching(query, within);
+}
+
+QString TextSearchIndex::textOf(NamedEntity const & namedEntity) const {
+   return this->m_textFunction(namedEntity);
+}
+
+int TextSearchIndex::generation() const {
+   return this->m_generation;
+}
+
+void TextSearchIndex::populate() {
+   if (this->m_populated) {
+      return;
+   }
+   connect(&this->m_objectStore, &ObjectStore::signalObjectInserted,  this, &TextSearchIndex::objectInserted );
+   connect(&this->m_objectStore, &ObjectStore::signalObjectDeleted,   this, &TextSearchIndex::objectDeleted  );
+   connect(&this->m_objectStore, &ObjectStore::signalPropertyChanged, this, &TextSearchIndex::propertyChanged);
+   for (QObject * object : this->m_objectStore.getAllRaw()) {
+      auto namedEntity = static_cast<NamedEntity const *>(object);
+      this->m_index.set(namedEntity->key(), this->m_textFunction(*namedEntity));
+   }
+   this->m_populated = true;
+   ++this->m_generation;
+   qDebug() << Q_FUNC_INFO << "Indexed" << this->m_index.size() << "objects";
+   return;
+}
+
+void TextSearchIndex::reindex(int const id) {
+   std::shared_ptr<QObject> object = this->m_objectStore.getById(id);
+   if (object) {
+      this->m_index.set(id, this->m_textFunction(*static_cast<NamedEntity const *>(object.get())));
+   } else {
+      this->m_index.remove(id);
+   }
+   ++this->m_generation;
+   return;
+}
+
+void TextSearchIndex::objectInserted(int id) {
+   this->reindex(id);
+   return;
+}
+
+void TextSearchIndex::objectDeleted(int id, [[maybe_unused]] std::shared_ptr<QObject> object) {
+   this->m_index.remove(id);
+   ++this->m_generation;
+   return;
+}
+
+void TextSearchIndex::propertyChanged(int id, BtStringConst const & propertyName) {
+   // Most property changes (amounts, alpha acids, etc) don't touch the text we index
+   for (BtStringConst const * indexedProperty : this->m_indexedProperties) {
+      if (*indexedProperty == propertyName) {
+         this->reindex(id);
+         return;
+      }
+   }
+   return;
+}
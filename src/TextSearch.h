@@ -0,0 +1,158 @@
+/*
+ * TextSearch.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEXTSEARCH_H
+#define TEXTSEARCH_H
+#pragma once
+
+#include <memory>
+
+#include <QHash>
+#include <QObject>
+#include <QRegExp>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class BtStringConst;
+class NamedEntity;
+class ObjectStore;
+class TextSearchIndex;
+
+/*!
+ * \namespace TextSearch
+ *
+ * \brief Substring search over the text of lots of objects -- eg the names, notes, origins and suppliers of every hop
+ *        in the database -- fast enough to redo on every keystroke in a search box.
+ *
+ *        \c Index keeps, for every three-character sequence (trigram), the set of objects whose text contains it.  To
+ *        find the objects containing "citra", we only need to look at those in the sets for "cit", "itr" and "tra",
+ *        starting with the smallest, and then check each of those candidates really does contain the whole string.
+ *        Searches are case-insensitive and treat any run of whitespace as a single space.
+ */
+namespace TextSearch {
+
+   //! \brief Text as we index and search it: lower case, with runs of whitespace collapsed to single spaces
+   QString normalised(QString const & text);
+
+   class Index {
+   public:
+      Index();
+
+      int size() const;
+      bool contains(int id) const;
+
+      /**
+       * \brief Add an object, or replace its text if it's already in the index.  Separate fields (eg name and notes)
+       *        should be on separate lines, so that no search matches part of one and part of the next.
+       */
+      void set(int id, QString const & text);
+      void remove(int id);
+
+      /**
+       * \brief IDs of all the objects whose text contains \c query.  An empty query matches everything.
+       *
+       * \param within If not \c nullptr, only look among these IDs.  Eg when the user types another letter into a
+       *               search box, everything that matches now must have matched before, so we only need to look among
+       *               the previous matches.
+       */
+      QSet<int> matching(QString const & query, QSet<int> const * within = nullptr) const;
+
+   private:
+      QHash<int, QString> m_texts;
+      QHash<quint64, QSet<int>> m_postings;
+   };
+
+   /**
+    * \brief Filtering for a sort/filter proxy model over one type of \c NamedEntity.  Holds the results of the last
+    *        search so that, while the search string stays the same, each row is a single hash lookup, and, when the
+    *        user adds to the search string, the new search only looks among the last one's matches.
+    */
+   class Filter {
+   public:
+      Filter(TextSearchIndex & index);
+
+      /**
+       * \brief Whether \c namedEntity matches the proxy's filter.  Fixed-string filters (as set by
+       *        \c QSortFilterProxyModel::setFilterFixedString) use the index, and match the same fields it does.  Other
+       *        filters fall back to matching the regular expression against the name.
+       */
+      bool accepts(NamedEntity const & namedEntity, QRegExp const & filterRegExp);
+
+   private:
+      TextSearchIndex & m_index;
+      QString m_lastQuery;
+      int m_lastGeneration;
+      QSet<int> m_lastMatches;
+   };
+}
+
+/*!
+ * \class TextSearchIndex
+ *
+ * \brief Keeps a \c TextSearch::Index of the searchable text of every object of one type in the database.  It is
+ *        filled the first time it's searched, and then kept up to date from the \c ObjectStore's signals, so each
+ *        search only costs the lookup.
+ *
+ *        There is one per type: \c TextSearchIndex::instance<Hop>(), etc.
+ */
+class TextSearchIndex : public QObject {
+   Q_OBJECT
+
+public:
+   template<class NE> static TextSearchIndex & instance();
+
+   //! \brief See \c TextSearch::Index::matching
+   QSet<int> matching(QString const & query, QSet<int> const * within = nullptr);
+
+   //! \brief The text we index for \c namedEntity (which needn't be in the database)
+   QString textOf(NamedEntity const & namedEntity) const;
+
+   /**
+    * \brief Goes up by one every time the index changes, so that anything holding on to search results can tell when
+    *        they might be out of date
+    */
+   int generation() const;
+
+private slots:
+   void objectInserted(int id);
+   void objectDeleted(int id, std::shared_ptr<QObject> object);
+   void propertyChanged(int id, BtStringConst const & propertyName);
+
+private:
+   using TextFunction = QString (*)(NamedEntity const & namedEntity);
+
+   TextSearchIndex(ObjectStore & objectStore,
+                   TextFunction textFunction,
+                   QVector<BtStringConst const *> indexedProperties);
+   ~TextSearchIndex();
+   TextSearchIndex(TextSearchIndex const &) = delete;
+   TextSearchIndex & operator=(TextSearchIndex const &) = delete;
+
+   void populate();
+   void reindex(int id);
+
+   ObjectStore & m_objectStore;
+   TextFunction const m_textFunction;
+   QVector<BtStringConst const *> const m_indexedProperties;
+   bool m_populated;
+   int m_generation;
+   TextSearch::Index m_index;
+};
+
+#endif
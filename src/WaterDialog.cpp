@@ -20,6 +20,7 @@
  */
 #include "WaterDialog.h"
 
+#include <array>
 #include <limits>
 
 #include <Algorithms.h>
@@ -34,6 +35,7 @@
 #include "model/MashStep.h"
 #include "model/Recipe.h"
 #include "model/Salt.h"
+#include "SaltSolver.h"
 #include "tableModels/SaltTableModel.h"
 #include "tableModels/WaterTableModel.h"
 #include "WaterButton.h"
@@ -66,6 +68,28 @@ namespace {
    // Magic constants Kai derives in the document above.
    double constexpr pHSlopeLight = 0.21;
    double constexpr pHSlopeDark  = 0.06;
+
+   // The mash pH range we show as OK, and which we aim for when calculating salt additions
+   double constexpr minMashpH = 5.0;
+   double constexpr maxMashpH = 5.5;
+
+   //! \brief pH delta caused by adding salts providing the given masses of ions
+   double saltpHDelta(double const ca_mg,
+                      double const mg_mg,
+                      double const hco3_mg,
+                      double const co3_mg,
+                      double const thickness) {
+      double ca   = ca_mg/Cagpm * 2;
+      double mg   = mg_mg/Mggpm * 2;
+      double hco3 = hco3_mg/HCO3gpm;
+      double co3  = co3_mg/CO3gpm;
+
+      // The 61 is another magic number from Kai. Sigh
+      // unlike previous calculations, I am getting a mass here so I do not
+      // need to convert from mg/L
+      double totalDelta = 0.0 - ca/3.5 - mg/7 + (hco3+co3)/61;
+      return totalDelta/thickness/mEq;
+   }
 }
 
 WaterDialog::WaterDialog(QWidget* parent) :
@@ -137,8 +161,8 @@ WaterDialog::WaterDialog(QWidget* parent) :
                                    tr("Too high for target profile."));
    }
    // we can be a bit more specific with pH
-   btDigit_ph->setLowLim(5.0);
-   btDigit_ph->setHighLim(5.5);
+   btDigit_ph->setLowLim(minMashpH);
+   btDigit_ph->setHighLim(maxMashpH);
    btDigit_ph->setAmount(7.0);
 
    // since all the things are now digits, lets get the totals configured
@@ -165,6 +189,8 @@ WaterDialog::WaterDialog(QWidget* parent) :
    connect(m_salt_table_model,    &SaltTableModel::newTotals, this,               &WaterDialog::newTotals   );
    connect(pushButton_addSalt,    &QAbstractButton::clicked,  m_salt_table_model, &SaltTableModel::catchSalt);
    connect(pushButton_removeSalt, &QAbstractButton::clicked,  this,               &WaterDialog::removeSalts );
+   connect(pushButton_matchTarget, &QAbstractButton::clicked, this,               &WaterDialog::matchTarget );
+   connect(checkBox_autoMatch,     &QAbstractButton::toggled, this,               &WaterDialog::autoMatch   );
 
    connect(spinBox_mashRO,   QOverload<int>::of(&QSpinBox::valueChanged), this, &WaterDialog::setMashRO  );
    connect(spinBox_spargeRO, QOverload<int>::of(&QSpinBox::valueChanged), this, &WaterDialog::setSpargeRO);
@@ -181,6 +207,7 @@ void WaterDialog::setMashRO(int val) {
    m_mashRO = val/100.0;
    if ( m_base ) m_base->setMashRO(m_mashRO);
    newTotals();
+   this->autoMatch();
    return;
 }
 
@@ -188,6 +215,7 @@ void WaterDialog::setSpargeRO(int val) {
    m_spargeRO = val/100.0;
    if ( m_base ) m_base->setSpargeRO(m_spargeRO);
    newTotals();
+   this->autoMatch();
    return;
 }
 
@@ -235,7 +263,7 @@ void WaterDialog::setRecipe(Recipe *rec) {
          this->m_base = water;
       } else if (water->type() == Water::Types::TARGET) {
          qDebug() << Q_FUNC_INFO << "Target Water" << *water;
-         this->m_target = water;
+         this->setTarget(water);
       }
    }
 
@@ -293,6 +321,7 @@ void WaterDialog::update_baseProfile(int selected) {
       baseProfileButton->setWater(this->m_base.get());
       m_base_editor->setWater(this->m_base);
       newTotals();
+      this->autoMatch();
    }
    return;
 }
@@ -309,19 +338,45 @@ void WaterDialog::update_targetProfile(int selected) {
 
    if (parent) {
       // Comment above for copy of m_base applies equally here
-      this->m_target = std::make_shared<Water>(*parent);
-      this->m_target->makeChild(*parent);
-      this->m_target->setType(Water::Types::TARGET);
-      qDebug() << Q_FUNC_INFO << "Made target child" << *this->m_target << "from parent" << parent;
+      auto target = std::make_shared<Water>(*parent);
+      target->makeChild(*parent);
+      target->setType(Water::Types::TARGET);
+      qDebug() << Q_FUNC_INFO << "Made target child" << *target << "from parent" << parent;
+      this->setTarget(target);
 
       targetProfileButton->setWater(this->m_target.get());
       m_target_editor->setWater(this->m_target);
 
       this->setDigits();
+      this->autoMatch();
    }
    return;
 }
 
+void WaterDialog::setTarget(std::shared_ptr<Water> target) {
+   if (this->m_target) {
+      disconnect(this->m_target.get(), &NamedEntity::changed, this, &WaterDialog::autoMatch);
+   }
+   this->m_target = target;
+   if (this->m_target) {
+      // So we can re-match if the target is edited in m_target_editor
+      connect(this->m_target.get(), &NamedEntity::changed, this, &WaterDialog::autoMatch);
+   }
+   return;
+}
+
+double WaterDialog::baseWaterModifier() const {
+   Mash* mash = m_rec->mash();
+   double allTheWaters = mash->totalMashWater_l();
+
+   // 'd' means 'diluted'. They make calculating the modifier readable
+   double dInfuse = m_mashRO * mash->totalInfusionAmount_l();
+   double dSparge = m_spargeRO * mash->totalSpargeAmount_l();
+
+   // I hope this is right. All this 'rithmetic is making me head hurt.
+   return 1.0 - (dInfuse + dSparge) / allTheWaters;
+}
+
 void WaterDialog::newTotals() {
    if ( ! m_rec || ! m_rec->mash() )
       return;
@@ -347,12 +402,7 @@ void WaterDialog::newTotals() {
    // for the base water that depends the %RO in the mash and sparge water
 
    if (this->m_base) {
-      // 'd' means 'diluted'. They make calculating the modifier readable
-      double dInfuse = m_mashRO * mash->totalInfusionAmount_l();
-      double dSparge = m_spargeRO * mash->totalSpargeAmount_l();
-
-      // I hope this is right. All this 'rithmetic is making me head hurt.
-      double modifier = 1.0 - (dInfuse + dSparge) / allTheWaters;
+      double modifier = this->baseWaterModifier();
 
       for (int i = 0; i < static_cast<int>(Water::Ions::numIons); ++i ) {
          Water::Ions ion = static_cast<Water::Ions>(i);
@@ -405,10 +455,7 @@ double WaterDialog::calculateSaltpH() {
       return 0.0;
    }
 
-   Mash* mash = m_rec->mash();
-   double allTheWaters = mash->totalMashWater_l();
-
-   double modifier = 1 - ( (m_mashRO * mash->totalInfusionAmount_l()) + (m_spargeRO * mash->totalSpargeAmount_l())) / allTheWaters;
+   double modifier = this->baseWaterModifier();
 
    // I have no idea where the 2 comes from, but Kai did it. I wish I knew why
    // we get the initial numbers from the base water
@@ -430,16 +477,11 @@ double WaterDialog::calculateAddedSaltpH() {
 
    // We need the value from the salt table model, because we need all the
    // added salts, but not the base.
-   double ca   = this->m_salt_table_model->total_Ca()/Cagpm * 2;
-   double mg   = this->m_salt_table_model->total_Mg()/Mggpm * 2;
-   double hco3 = this->m_salt_table_model->total_HCO3()/HCO3gpm;
-   double co3  = this->m_salt_table_model->total_CO3()/CO3gpm;
-
-   // The 61 is another magic number from Kai. Sigh
-   // unlike previous calculations, I am getting a mass here so I do not
-   // need to convert from mg/L
-   double totalDelta = 0.0 - ca/3.5 - mg/7 + (hco3+co3)/61;
-   return totalDelta/m_thickness/mEq;
+   return saltpHDelta(this->m_salt_table_model->total_Ca(),
+                      this->m_salt_table_model->total_Mg(),
+                      this->m_salt_table_model->total_HCO3(),
+                      this->m_salt_table_model->total_CO3(),
+                      this->m_thickness);
 }
 
 //! \brief Calculates the pH adjustment caused by lactic acid, H3PO4 and/or acid
@@ -516,6 +558,77 @@ double WaterDialog::calculateMashpH() {
    return mashpH;
 }
 
+void WaterDialog::matchTarget() {
+   if (!this->m_rec || !this->m_rec->mash() || !this->m_target) {
+      return;
+   }
+
+   Mash* mash = m_rec->mash();
+   SaltSolver::Problem problem;
+   problem.water_l = mash->totalMashWater_l();
+   if (qFuzzyCompare(problem.water_l, 0.0)) {
+      qWarning() << Q_FUNC_INFO << "Can not match target water chemistry without a mash";
+      return;
+   }
+
+   double const modifier = this->m_base ? this->baseWaterModifier() : 0.0;
+   for (std::size_t ii = 0; ii < SaltSolver::numIons; ++ii) {
+      Water::Ions ion = static_cast<Water::Ions>(ii);
+      problem.base_ppm[ii]   = this->m_base ? modifier * this->m_base->ppm(ion) : 0.0;
+      problem.target_ppm[ii] = this->m_target->ppm(ion);
+   }
+
+   // If the user has already picked some salts, stick to those.  Otherwise, use whatever we need.
+   bool anyChosen = false;
+   std::array<bool, SaltSolver::numSalts> chosen{};
+   for (int row = 0; row < m_salt_table_model->rowCount(); ++row) {
+      std::size_t const saltIndex = SaltSolver::saltIndex(m_salt_table_model->getRow(row)->type());
+      if (saltIndex < SaltSolver::numSalts) {
+         chosen[saltIndex] = true;
+         anyChosen = true;
+      }
+   }
+   if (anyChosen) {
+      problem.available = chosen;
+   }
+
+   // We can only estimate pH in the same circumstances as newTotals() does
+   if (this->m_base && m_rec->fermentables().size() && m_thickness > 0.0) {
+      problem.constrainPh = true;
+      problem.ph0 = this->calculateMashpH() - this->calculateAddedSaltpH();
+      for (std::size_t jj = 0; jj < SaltSolver::numSalts; ++jj) {
+         SaltSolver::Composition const & composition = SaltSolver::composition(jj);
+         problem.phPerG[jj] = saltpHDelta(composition.ions_mgPerG[static_cast<int>(Water::Ions::Ca)],
+                                          composition.ions_mgPerG[static_cast<int>(Water::Ions::Mg)],
+                                          composition.ions_mgPerG[static_cast<int>(Water::Ions::HCO3)],
+                                          composition.co3_mgPerG,
+                                          m_thickness);
+      }
+      problem.minPh = minMashpH;
+      problem.maxPh = maxMashpH;
+   }
+
+   SaltSolver::Solution const solution = SaltSolver::solve(problem);
+   if (!solution.phInRange) {
+      qInfo() << Q_FUNC_INFO << "Salts alone cannot bring mash pH into range.  Best is" << solution.ph;
+   }
+
+   // Salt amounts are stored in kilograms
+   QList<QPair<Salt::Types, double>> totals;
+   for (std::size_t jj = 0; jj < SaltSolver::numSalts; ++jj) {
+      totals.append(qMakePair(SaltSolver::salts[jj], solution.amounts_g[jj] / 1000.0));
+   }
+   m_salt_table_model->setTotals(totals);
+   return;
+}
+
+void WaterDialog::autoMatch() {
+   if (this->checkBox_autoMatch->isChecked()) {
+      this->matchTarget();
+   }
+   return;
+}
+
 void WaterDialog::saveAndClose() {
    this->m_salt_table_model->saveAndClose();
    if (this->m_base && this->m_base->key() < 0) {
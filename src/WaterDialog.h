@@ -66,6 +66,11 @@ public slots:
    void setSpargeRO(int val);
    void saveAndClose();
    void clearAndClose();
+   //! \brief Replace the salt additions with ones calculated to match the target profile -- see \c SaltSolver
+   void matchTarget();
+
+private slots:
+   void autoMatch();
 
 signals:
    void newSalt(Salt* drop);
@@ -76,6 +81,10 @@ private:
    void setDigits();
    void calculateGrainEquivalent();
 
+   //! \brief Fraction of the base water ion concentrations left after diluting with RO water
+   double baseWaterModifier() const;
+   void setTarget(std::shared_ptr<Water> target);
+
    double calculateRA() const;
    double calculateGristpH();
    double calculateMashpH();
@@ -22,52 +22,49 @@
 
 #include <iostream>
 
-#include "Localization.h"
-#include "measurement/Measurement.h"
 #include "model/Yeast.h"
 #include "tableModels/YeastTableModel.h"
 
 YeastSortFilterProxyModel::YeastSortFilterProxyModel(QObject *parent, bool filt) :
    QSortFilterProxyModel(parent),
-   filter{filt} {
+   filter{filt},
+   searchFilter{TextSearchIndex::instance<Yeast>()} {
    return;
 }
 
 bool YeastSortFilterProxyModel::lessThan(const QModelIndex &left,
                                          const QModelIndex &right) const {
-    QVariant leftYeast = sourceModel()->data(left);
-    QVariant rightYeast = sourceModel()->data(right);
-    double lAmt, rAmt;
+   QVariant leftYeast  = this->sourceModel()->data(left,  BtTableModel::SortRole);
+   QVariant rightYeast = this->sourceModel()->data(right, BtTableModel::SortRole);
 
    auto const columnIndex = static_cast<YeastTableModel::ColumnIndex>(left.column());
-    switch (columnIndex) {
+   switch (columnIndex) {
       case YeastTableModel::ColumnIndex::Inventory:
-         if (Measurement::qStringToSI(leftYeast.toString(), Measurement::PhysicalQuantity::Volume).quantity() == 0.0 &&
-            this->sortOrder() == Qt::AscendingOrder) {
+         if (leftYeast.toDouble() == 0.0 && this->sortOrder() == Qt::AscendingOrder) {
             return false;
          }
+         return leftYeast.toDouble() < rightYeast.toDouble();
 
-         return Measurement::qStringToSI(leftYeast.toString(), Measurement::PhysicalQuantity::Volume) <
-                Measurement::qStringToSI(rightYeast.toString(), Measurement::PhysicalQuantity::Volume);
-         // This is a lie. I need to figure out if they are weights or volumes.
-         // and then figure some reasonable way to compare weights to volumes.
-         // Maybe lying isn't such a bad idea
+      // Amounts can be weights or volumes, and there is no sensible way to compare one with the other, so we just
+      // compare the numbers
       case YeastTableModel::ColumnIndex::Amount:
-         return Measurement::qStringToSI(leftYeast.toString(), Measurement::PhysicalQuantity::Volume) <
-                Measurement::qStringToSI(rightYeast.toString(), Measurement::PhysicalQuantity::Volume);
-      case YeastTableModel::ColumnIndex::ProdId:
-         lAmt = Localization::toDouble(leftYeast.toString(), Q_FUNC_INFO);
-         rAmt = Localization::toDouble(rightYeast.toString(), Q_FUNC_INFO);
-         return lAmt < rAmt;
+         return leftYeast.toDouble() < rightYeast.toDouble();
+
+      case YeastTableModel::ColumnIndex::Type:
+      case YeastTableModel::ColumnIndex::Form:
+         return leftYeast.toInt() < rightYeast.toInt();
+
       default:
          return leftYeast.toString() < rightYeast.toString();
-    }
+   }
 }
 
-bool YeastSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const {
-   YeastTableModel* model = qobject_cast<YeastTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
-
-   return !filter ||
-          (sourceModel()->data(index).toString().contains(filterRegExp()) && model->getRow(source_row)->display());
+bool YeastSortFilterProxyModel::filterAcceptsRow(int source_row,
+                                                 [[maybe_unused]] QModelIndex const & source_parent) const {
+   if (!this->filter) {
+      return true;
+   }
+   YeastTableModel * model = qobject_cast<YeastTableModel *>(this->sourceModel());
+   auto row = model->getRow(source_row);
+   return row->display() && this->searchFilter.accepts(*row, this->filterRegExp());
 }
@@ -23,6 +23,8 @@
 
 #include <QSortFilterProxyModel>
 
+#include "TextSearch.h"
+
 /*!
  * \class YeastSortFilterProxyModel
  *
@@ -41,6 +43,8 @@ protected:
 
 private:
    bool filter;
+   //! Filtering is const in QSortFilterProxyModel, but remembering the last search is what makes it fast
+   mutable TextSearch::Filter searchFilter;
 };
 
 #endif
@@ -43,7 +43,7 @@
 #include "model/Water.h"
 #include "xml/BeerXml.h"
 
-int const DatabaseSchemaHelper::dbVersion = 10;
+int const DatabaseSchemaHelper::dbVersion = 12;
 
 namespace {
    char const * const FOLDER_FOR_SUPPLIED_RECIPES = "brewtarget";
@@ -530,6 +530,44 @@ namespace {
       return executeSqlQueries(q, migrationQueries);
    }
 
+   // Standard deviations for Monte Carlo uncertainty estimates (see RecipeUncertainty).  0 means "no variation", which
+   // gives the same results as before.
+   bool migrate_to_11(Database & db, BtSqlQuery q) {
+      QVector<QueryAndParameters> const migrationQueries{
+         {QString("ALTER TABLE hop         ADD COLUMN alpha_stddev       %1").arg(db.getDbNativeTypeName<double>())},
+         {QString("ALTER TABLE fermentable ADD COLUMN yield_stddev       %1").arg(db.getDbNativeTypeName<double>())},
+         {QString("ALTER TABLE yeast       ADD COLUMN attenuation_stddev %1").arg(db.getDbNativeTypeName<double>())},
+         {QString("ALTER TABLE recipe      ADD COLUMN efficiency_stddev  %1").arg(db.getDbNativeTypeName<double>())},
+         {QString("UPDATE hop         SET alpha_stddev       = ?"), {QVariant{0.0}}},
+         {QString("UPDATE fermentable SET yield_stddev       = ?"), {QVariant{0.0}}},
+         {QString("UPDATE yeast       SET attenuation_stddev = ?"), {QVariant{0.0}}},
+         {QString("UPDATE recipe      SET efficiency_stddev  = ?"), {QVariant{0.0}}}
+      };
+      return executeSqlQueries(q, migrationQueries);
+   }
+
+   // Gravity readings taken during fermentation (see FermentationCurve), one row per reading so that adding one doesn't
+   // rewrite the others
+   bool migrate_to_12(Database & db, BtSqlQuery q) {
+      QString createGravityReadingSql;
+      QTextStream createGravityReadingSqlStream(&createGravityReadingSql);
+      createGravityReadingSqlStream <<
+         "CREATE TABLE gravity_reading ( "
+            "id          " << db.getDbNativePrimaryKeyDeclaration() << ", "
+            "display     " << db.getDbNativeTypeName<bool>()        << ", "
+            "deleted     " << db.getDbNativeTypeName<bool>()        << ", "
+            "brewnote_id " << db.getDbNativeTypeName<int>()         << ", "
+            "time        " << db.getDbNativeTypeName<double>()      << ", "
+            "gravity     " << db.getDbNativeTypeName<double>()      << ", "
+            "temperature " << db.getDbNativeTypeName<double>()      << ", "
+            "FOREIGN KEY(brewnote_id) REFERENCES brewnote(id)"
+         ");";
+      QVector<QueryAndParameters> const migrationQueries{
+         {createGravityReadingSql}
+      };
+      return executeSqlQueries(q, migrationQueries);
+   }
+
    /*!
     * \brief Migrate from version \c oldVersion to \c oldVersion+1
     */
@@ -567,6 +605,12 @@ namespace {
          case 9:
             ret &= migrate_to_10(database, sqlQuery);
             break;
+         case 10:
+            ret &= migrate_to_11(database, sqlQuery);
+            break;
+         case 11:
+            ret &= migrate_to_12(database, sqlQuery);
+            break;
          default:
             qCritical() << QString("Unknown version %1").arg(oldVersion);
             return false;
@@ -18,6 +18,7 @@
  */
 #include "database/ObjectStore.h"
 
+#include <atomic>
 #include <cstring>
 #include <tuple>
 
@@ -28,6 +29,7 @@
 #include <QSqlError>
 #include <QSqlField>
 #include <QSqlRecord>
+#include <QThread>
 #include <QVector>
 
 #include "database/BtSqlQuery.h"
@@ -527,6 +529,72 @@ namespace {
       {{"yeast",       "amount_is_weight", ObjectStore::FieldType::Bool}, {QMetaType::QString}},
    };
 
+   //
+   // While ObjectStore::doInTransaction is running, inserts, updates and deletes that it makes (ie on the same thread
+   // and database) join its transaction rather than starting their own.  Other threads only ever look at
+   // batchThread, to see that the batch isn't theirs.
+   //
+   std::atomic<QThread *> batchThread{nullptr};
+   Database * batchDatabase = nullptr;
+   //! Set if one of the operations in the batch failed, so that the batch must not be committed
+   bool batchFailed = false;
+
+   bool isInBatch(Database const & database) {
+      return batchThread.load() == QThread::currentThread() && batchDatabase == &database;
+   }
+
+   /**
+    * \brief Sets up and tears down the batch state for \c ObjectStore::doInTransaction
+    */
+   class BatchScope {
+   public:
+      BatchScope(Database & database) {
+         batchDatabase = &database;
+         batchFailed = false;
+         batchThread.store(QThread::currentThread());
+         return;
+      }
+      ~BatchScope() {
+         batchThread.store(nullptr);
+         batchDatabase = nullptr;
+         return;
+      }
+   };
+
+   /**
+    * \brief The transaction for a single insert, update or delete.  This is a \c DbTransaction of its own unless the
+    *        operation is part of an \c ObjectStore::doInTransaction batch, in which case it's already in a transaction,
+    *        and not committing just marks the batch as failed.
+    */
+   class OperationTransaction {
+   public:
+      OperationTransaction(Database & database, QSqlDatabase & connection) :
+         dbTransaction{},
+         committed{false} {
+         if (!isInBatch(database)) {
+            this->dbTransaction.emplace(database, connection);
+         }
+         return;
+      }
+
+      ~OperationTransaction() {
+         if (!this->dbTransaction && !this->committed) {
+            qWarning() << Q_FUNC_INFO << "Operation failed, so the transaction it is part of will be rolled back";
+            batchFailed = true;
+         }
+         return;
+      }
+
+      bool commit() {
+         this->committed = this->dbTransaction ? this->dbTransaction->commit() : true;
+         return this->committed;
+      }
+
+   private:
+      std::optional<DbTransaction> dbTransaction;
+      bool committed;
+   };
+
 }
 
 // This private implementation class holds all private non-virtual members of ObjectStore
@@ -1208,6 +1276,27 @@ bool ObjectStore::addTableConstraints(Database & database, QSqlDatabase & connec
    return true;
 }
 
+bool ObjectStore::doInTransaction(std::function<void()> const & work) {
+   if (batchThread.load() == QThread::currentThread()) {
+      // Already inside a batch, which will take care of committing
+      work();
+      return !batchFailed;
+   }
+
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{database, connection};
+   {
+      BatchScope batchScope{database};
+      work();
+      if (batchFailed) {
+         qCritical() << Q_FUNC_INFO << "Not committing database transaction as part of it failed";
+         return false;
+      }
+   }
+   return dbTransaction.commit();
+}
+
 void ObjectStore::loadAll(Database * database) {
    if (database) {
       this->pimpl->database = database;
@@ -1510,7 +1599,7 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+   OperationTransaction dbTransaction{*this->pimpl->database, connection};
 
    int primaryKey = this->pimpl->insertObjectInDb(connection, *object, false);
 
@@ -1549,7 +1638,7 @@ void ObjectStore::update(std::shared_ptr<QObject> object) {
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+   OperationTransaction dbTransaction{*this->pimpl->database, connection};
 
    //
    // Construct the SQL, which will be of the form
@@ -1675,7 +1764,7 @@ void ObjectStore::updateProperty(QObject const & object, BtStringConst const & p
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+   OperationTransaction dbTransaction{*this->pimpl->database, connection};
 
    if (!this->pimpl->updatePropertyInDb(connection, object, propertyName)) {
       // Something went wrong.  Bailing out here will abort the transaction and avoid sending the signal.
@@ -1718,7 +1807,7 @@ std::shared_ptr<QObject>  ObjectStore::defaultHardDelete(int id) {
    qDebug() << Q_FUNC_INFO << "Hard delete item #" << id;
    auto object = this->pimpl->allObjects.value(id);
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+   OperationTransaction dbTransaction{*this->pimpl->database, connection};
 
    //
    // Construct the SQL, which will be of the form
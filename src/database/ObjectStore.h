@@ -227,6 +227,16 @@ public:
     */
    bool addTableConstraints(Database & database, QSqlDatabase & connection) const;
 
+   /**
+    * \brief Run \c work in one database transaction, so that all the inserts, updates and deletes it does (via any
+    *        \c ObjectStore) are written together or not at all.  Without this, each of them is its own transaction.
+    *
+    *        Note that, if the transaction is rolled back, in-memory objects are not.
+    *
+    * \return \c true if the transaction was committed
+    */
+   static bool doInTransaction(std::function<void()> const & work);
+
    /**
     * \brief Load from database all objects handled by this store
     *
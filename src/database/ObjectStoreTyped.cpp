@@ -24,6 +24,7 @@
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
+#include "model/GravityReading.h"
 #include "model/Hop.h"
 #include "model/Instruction.h"
 #include "model/Inventory.h"
@@ -140,7 +141,8 @@ namespace {
          {ObjectStore::FieldType::String, "supplier"        , PropertyNames::Fermentable::supplier                      },
          {ObjectStore::FieldType::Double, "protein"         , PropertyNames::Fermentable::protein_pct                   },
          {ObjectStore::FieldType::Bool,   "recommend_mash"  , PropertyNames::Fermentable::recommendMash                 },
-         {ObjectStore::FieldType::Double, "yield",            PropertyNames::Fermentable::yield_pct}
+         {ObjectStore::FieldType::Double, "yield",            PropertyNames::Fermentable::yield_pct},
+         {ObjectStore::FieldType::Double, "yield_stddev",     PropertyNames::Fermentable::yieldStdDev_pct               }
       }
    };
    template<> ObjectStore::JunctionTableDefinitions const JUNCTION_TABLES<Fermentable> {
@@ -180,6 +182,7 @@ namespace {
          {ObjectStore::FieldType::String, "folder",                PropertyNames::NamedEntity::folder                    },
          {ObjectStore::FieldType::Int,    "inventory_id",          PropertyNames::NamedEntityWithInventory::inventoryId, nullptr,           &PRIMARY_TABLE<InventoryHop>},
          {ObjectStore::FieldType::Double, "alpha",                 PropertyNames::Hop::alpha_pct                         },
+         {ObjectStore::FieldType::Double, "alpha_stddev",          PropertyNames::Hop::alphaStdDev_pct                   },
          {ObjectStore::FieldType::Double, "amount",                PropertyNames::Hop::amount_kg                         },
          {ObjectStore::FieldType::Double, "beta",                  PropertyNames::Hop::beta_pct                          },
          {ObjectStore::FieldType::Double, "caryophyllene",         PropertyNames::Hop::caryophyllene_pct                 },
@@ -510,6 +513,7 @@ namespace {
          {ObjectStore::FieldType::Bool,   "amount_is_weight", PropertyNames::Yeast::amountIsWeight                },
          {ObjectStore::FieldType::Double, "amount",           PropertyNames::Yeast::amount                        },
          {ObjectStore::FieldType::Double, "attenuation",      PropertyNames::Yeast::attenuation_pct               },
+         {ObjectStore::FieldType::Double, "attenuation_stddev", PropertyNames::Yeast::attenuationStdDev_pct       },
          {ObjectStore::FieldType::Double, "max_temperature",  PropertyNames::Yeast::maxTemperature_c              },
          {ObjectStore::FieldType::Double, "min_temperature",  PropertyNames::Yeast::minTemperature_c              },
          {ObjectStore::FieldType::Enum,   "flocculation",     PropertyNames::Yeast::flocculation,                   &DB_YEAST_FLOCCULATION_ENUM},
@@ -562,6 +566,7 @@ namespace {
          {ObjectStore::FieldType::Double, "carbonationtemp_c",   PropertyNames::Recipe::carbonationTemp_c   },
          {ObjectStore::FieldType::Date,   "date",                PropertyNames::Recipe::date                },
          {ObjectStore::FieldType::Double, "efficiency",          PropertyNames::Recipe::efficiency_pct      },
+         {ObjectStore::FieldType::Double, "efficiency_stddev",   PropertyNames::Recipe::efficiencyStdDev_pct},
          {ObjectStore::FieldType::Int,    "equipment_id",        PropertyNames::Recipe::equipmentId,          nullptr,                &PRIMARY_TABLE<Equipment>},
          {ObjectStore::FieldType::UInt,   "fermentation_stages", PropertyNames::Recipe::fermentationStages  },
          {ObjectStore::FieldType::Double, "fg",                  PropertyNames::Recipe::fg                  },
@@ -697,6 +702,25 @@ namespace {
    // BrewNotes don't have children
    template<> ObjectStore::JunctionTableDefinitions const JUNCTION_TABLES<BrewNote> {};
 
+   ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+   // Database field mappings for GravityReading
+   ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+   template<> ObjectStore::TableDefinition const PRIMARY_TABLE<GravityReading> {
+      "gravity_reading",
+      {
+         {ObjectStore::FieldType::Int,    "id",          PropertyNames::NamedEntity::key          },
+         // NB: GravityReadings don't have names or folders, as each one is owned by a BrewNote
+         {ObjectStore::FieldType::Bool,   "display",     PropertyNames::NamedEntity::display      },
+         {ObjectStore::FieldType::Bool,   "deleted",     PropertyNames::NamedEntity::deleted      },
+         {ObjectStore::FieldType::Int,    "brewnote_id", PropertyNames::GravityReading::brewNoteId, nullptr, &PRIMARY_TABLE<BrewNote>},
+         {ObjectStore::FieldType::Double, "time",        PropertyNames::GravityReading::time_h    },
+         {ObjectStore::FieldType::Double, "gravity",     PropertyNames::GravityReading::sg        },
+         {ObjectStore::FieldType::Double, "temperature", PropertyNames::GravityReading::temp_c    }
+      }
+   };
+   // GravityReadings don't have children
+   template<> ObjectStore::JunctionTableDefinitions const JUNCTION_TABLES<GravityReading> {};
+
 
    //
    // This should give us all the singleton instances
@@ -722,6 +746,7 @@ ObjectStoreTyped<NE> & ObjectStoreTyped<NE>::getInstance() {
 template ObjectStoreTyped<BrewNote> &             ObjectStoreTyped<BrewNote>::getInstance();
 template ObjectStoreTyped<Equipment> &            ObjectStoreTyped<Equipment>::getInstance();
 template ObjectStoreTyped<Fermentable> &          ObjectStoreTyped<Fermentable>::getInstance();
+template ObjectStoreTyped<GravityReading> &       ObjectStoreTyped<GravityReading>::getInstance();
 template ObjectStoreTyped<Hop> &                  ObjectStoreTyped<Hop>::getInstance();
 template ObjectStoreTyped<Instruction> &          ObjectStoreTyped<Instruction>::getInstance();
 template ObjectStoreTyped<InventoryFermentable> & ObjectStoreTyped<InventoryFermentable>::getInstance();
@@ -742,6 +767,7 @@ namespace {
       &ostSingleton<BrewNote>,
       &ostSingleton<Equipment>,
       &ostSingleton<Fermentable>,
+      &ostSingleton<GravityReading>,
       &ostSingleton<Hop>,
       &ostSingleton<Instruction>,
       &ostSingleton<InventoryFermentable>,
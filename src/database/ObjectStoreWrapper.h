@@ -223,6 +223,10 @@ namespace ObjectStoreWrapper {
       return ObjectStoreTyped<NE>::getInstance().findAllMatching(matchFunction);
    }
 
+   inline bool doInTransaction(std::function<void()> const & work) {
+      return ObjectStore::doInTransaction(work);
+   }
+
    /**
     * \brief Given two IDs of some subclass of \c NamedEntity, return \c true if the corresponding objects are equal (or
     *        if both IDs are invalid), and \c false otherwise
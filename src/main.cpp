@@ -20,6 +20,9 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <utility> // For std::pair
+
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xalanc/Include/PlatformDefinitions.hpp>
 
@@ -29,13 +32,22 @@
 #include <QDebug>
 #include <QMessageBox>
 #include <QSharedMemory>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
 
 #include "Application.h"
 #include "config.h"
 #include "database/Database.h"
+#include "database/ObjectStoreWrapper.h"
 #include "Localization.h"
 #include "Logging.h"
+#include "model/BrewNote.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
 #include "PersistentSettings.h"
+#include "RecipeSweep.h"
+#include "StyleMatch.h"
 #include "xml/BeerXml.h"
 
 namespace {
@@ -62,6 +74,160 @@ namespace {
       Database::instance().createBlank(filename);
       exit(0);
    }
+
+   /*!
+    * \brief Parses a range for a "what if" sweep.  This is either "from:to:steps" or a single value.
+    *
+    * \return \c false if \c text could not be parsed
+    */
+   bool parseSweepRange(QString const & text, RecipeSweep::Parameter const parameter, RecipeSweep::Range & range) {
+      QStringList const parts = text.split(':');
+      bool okFrom = false, okTo = true, okSteps = true;
+      range.parameter = parameter;
+      range.min = parts[0].toDouble(&okFrom);
+      range.max = range.min;
+      range.numSteps = 1;
+      if (parts.size() == 3) {
+         range.max = parts[1].toDouble(&okTo);
+         range.numSteps = parts[2].toInt(&okSteps);
+      } else if (parts.size() != 1) {
+         return false;
+      }
+      return okFrom && okTo && okSteps && range.numSteps > 0;
+   }
+
+   /*!
+    * \brief Loads the database and finds a recipe for one of the command-line reports.  Exits if either fails.
+    *
+    * \param recipeNameOrId Name or ID of the recipe.  If more than one recipe has the name, the first one we find is
+    *                       used.
+    */
+   Recipe * loadRecipe(QString const & recipeNameOrId) {
+      if (!Application::initialize()) {
+         qCritical() << "Unable to load database";
+         exit(1);
+      }
+
+      Recipe * recipe = ObjectStoreWrapper::findFirstMatching<Recipe>(
+         [&recipeNameOrId](Recipe * rec) { return rec->name() == recipeNameOrId; }
+      );
+      bool isId = false;
+      int const id = recipeNameOrId.toInt(&isId);
+      if (!recipe && isId) {
+         recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(id);
+      }
+      if (!recipe) {
+         qCritical() << "Unable to find recipe" << recipeNameOrId;
+         Database::instance().unload();
+         exit(1);
+      }
+      return recipe;
+   }
+
+   /*!
+    * \brief As \c loadRecipe, but for a style.  Only styles in the style list (ie not the copies held by individual
+    *        recipes) are considered.
+    */
+   Style * loadStyle(QString const & styleNameOrId) {
+      if (!Application::initialize()) {
+         qCritical() << "Unable to load database";
+         exit(1);
+      }
+
+      bool isId = false;
+      int const id = styleNameOrId.toInt(&isId);
+      QList<Style *> const styles = ObjectStoreWrapper::getAllDisplayableRaw<Style>();
+      auto found = std::find_if(styles.cbegin(), styles.cend(), [&styleNameOrId](Style const * style) {
+         return style->name() == styleNameOrId;
+      });
+      if (found == styles.cend() && isId) {
+         found = std::find_if(styles.cbegin(), styles.cend(), [id](Style const * style) { return style->key() == id; });
+      }
+      if (found == styles.cend()) {
+         qCritical() << "Unable to find style" << styleNameOrId;
+         Database::instance().unload();
+         exit(1);
+      }
+      return *found;
+   }
+
+   //! \brief Quotes a name for CSV output, as names can contain commas and quotes
+   QString csvQuoted(QString name) {
+      return QString{"\"%1\""}.arg(name.replace('"', "\"\""));
+   }
+
+   /*!
+    * \brief Writes style match results to standard output as CSV, then exits
+    */
+   template<class NE>
+   void printStyleMatches(QVector<StyleMatch::Match> const & matches) {
+      QTextStream out{stdout};
+      out << "Rank,ID,Name,Distance\n";
+      int rank = 0;
+      for (StyleMatch::Match const & match : matches) {
+         NE const * ne = ObjectStoreWrapper::getByIdRaw<NE>(match.id);
+         out << ++rank << "," << match.id << "," << csvQuoted(ne ? ne->name() : QString{}) << "," <<
+                QString::number(match.score, 'f', 4) << "\n";
+      }
+      out.flush();
+
+      Database::instance().unload();
+      exit(0);
+   }
+
+   /*!
+    * \brief Writes the results of a "what if" sweep over a recipe to standard output as CSV, then exits.
+    *
+    * \param recipeNameOrId Name or ID of the recipe
+    * \param ranges Ranges of parameters to sweep.  Parameters not mentioned stay at their values in the recipe.
+    */
+   void printRecipeSweep(QString const & recipeNameOrId, QVector<RecipeSweep::Range> const & ranges) {
+      Recipe * recipe = loadRecipe(recipeNameOrId);
+
+      RecipeSweep::Snapshot const snapshot{*recipe};
+      RecipeSweep::Results const results = RecipeSweep::run(snapshot, RecipeSweep::makeGrid(snapshot.baseline(), ranges));
+      QTextStream out{stdout};
+      results.writeCsv(out);
+      out.flush();
+
+      Database::instance().unload();
+      exit(0);
+   }
+
+   /*!
+    * \brief Writes, for each brew of a recipe, what its gravity readings predict about how fermentation will finish to
+    *        standard output as CSV, then exits.
+    *
+    * \param recipeNameOrId Name or ID of the recipe
+    */
+   void printFermentationReport(QString const & recipeNameOrId) {
+      Recipe * recipe = loadRecipe(recipeNameOrId);
+
+      QTextStream out{stdout};
+      out << "Brew Date,Readings,OG,Latest SG,Predicted FG,Predicted Attenuation (%),Finished,Hours Remaining\n";
+      for (BrewNote const * brewNote : recipe->brewNotes()) {
+         QVector<FermentationCurve::Reading> const & readings = brewNote->gravityReadingsList();
+         FermentationCurve::Prediction const prediction = brewNote->fermentationPrediction();
+         out << brewNote->brewDate().toString(Qt::ISODate) << "," << readings.size() << ",";
+         if (!prediction.valid) {
+            // We don't know much, but we can at least say where the readings have got to
+            out << (readings.isEmpty() ? QString{} : QString::number(prediction.og, 'f', 3)) << "," <<
+                   (readings.isEmpty() ? QString{} : QString::number(readings.last().sg, 'f', 3)) << ",,,,\n";
+            continue;
+         }
+         double const hoursRemaining = prediction.terminalTime_h() - prediction.anchorTime_h;
+         out << QString::number(prediction.og, 'f', 3) << "," <<
+                QString::number(readings.last().sg, 'f', 3) << "," <<
+                QString::number(prediction.fg, 'f', 3) << "," <<
+                QString::number(prediction.apparentAttenuation_pct, 'f', 1) << "," <<
+                BrewNote::readingTime(prediction.terminalTime_h()).toString(Qt::ISODate) << "," <<
+                QString::number(hoursRemaining, 'f', 1) << "\n";
+      }
+      out.flush();
+
+      Database::instance().unload();
+      exit(0);
+   }
 }
 
 int main(int argc, char **argv) {
@@ -115,6 +281,65 @@ int main(int argc, char **argv) {
       QString()
    };
    parser.addOption(userDirectoryOption);
+   /*!
+    * \brief "What if" calculations for a recipe.  Eg
+    *
+    *    brewtarget --what-if "Recipe Name" --efficiency 68:78:11 --boil-time 60:90:4 --batch-size 19:25:7
+    *
+    * prints OG, FG, ABV, IBU and color for all 308 combinations of the given efficiencies, boil times and batch sizes.
+    */
+   QCommandLineOption const whatIfOption{
+      "what-if",
+      "Writes OG, FG, ABV, IBU and color for variants of <recipe> (name or ID) to standard output as CSV, then exits",
+      "recipe"
+   };
+   parser.addOption(whatIfOption);
+   QCommandLineOption const efficiencyOption{
+      "efficiency", "Efficiency (%) for --what-if, as <from:to:steps> or a single value", "range"
+   };
+   parser.addOption(efficiencyOption);
+   QCommandLineOption const boilTimeOption{
+      "boil-time", "Boil time (minutes) for --what-if, as <from:to:steps> or a single value", "range"
+   };
+   parser.addOption(boilTimeOption);
+   QCommandLineOption const batchSizeOption{
+      "batch-size", "Batch size (liters) for --what-if, as <from:to:steps> or a single value", "range"
+   };
+   parser.addOption(batchSizeOption);
+   /*!
+    * \brief Fermentation predictions from the gravity readings on a recipe's brew notes.  Eg
+    *
+    *    brewtarget --fermentation "Recipe Name"
+    */
+   QCommandLineOption const fermentationOption{
+      "fermentation",
+      "Writes predicted FG, attenuation and finish time for each brew of <recipe> (name or ID) to standard output as "
+      "CSV, then exits",
+      "recipe"
+   };
+   parser.addOption(fermentationOption);
+   /*!
+    * \brief Searches the whole library by style.  Eg
+    *
+    *    brewtarget --recipes-for-style "American IPA" --max-results 10
+    *    brewtarget --styles-for-recipe "Recipe Name"
+    */
+   QCommandLineOption const recipesForStyleOption{
+      "recipes-for-style",
+      "Writes the recipes that best fit <style> (name or ID) to standard output as CSV, then exits",
+      "style"
+   };
+   parser.addOption(recipesForStyleOption);
+   QCommandLineOption const stylesForRecipeOption{
+      "styles-for-recipe",
+      "Writes the styles closest to <recipe> (name or ID) to standard output as CSV, then exits",
+      "recipe"
+   };
+   parser.addOption(stylesForRecipeOption);
+   QCommandLineOption const maxResultsOption{
+      "max-results", "Number of results for --recipes-for-style and --styles-for-recipe (default all)", "number"
+   };
+   parser.addOption(maxResultsOption);
    parser.addHelpOption();
    parser.addVersionOption();
    parser.process(app);
@@ -190,6 +415,39 @@ int main(int argc, char **argv) {
 
    if (parser.isSet(importFromXmlOption)) importFromXml(parser.value(importFromXmlOption));
    if (parser.isSet(createBlankDBOption)) createBlankDb(parser.value(createBlankDBOption));
+   if (parser.isSet(whatIfOption)) {
+      QVector<RecipeSweep::Range> ranges;
+      for (auto const & [option, parameter] : {std::pair{&efficiencyOption, RecipeSweep::Parameter::Efficiency_pct},
+                                               std::pair{&boilTimeOption,   RecipeSweep::Parameter::BoilTime_min},
+                                               std::pair{&batchSizeOption,  RecipeSweep::Parameter::BatchSize_l}}) {
+         if (parser.isSet(*option)) {
+            RecipeSweep::Range range;
+            if (!parseSweepRange(parser.value(*option), parameter, range)) {
+               qCritical() << "Invalid range for" << option->names().first() << ":" << parser.value(*option);
+               return EXIT_FAILURE;
+            }
+            ranges.append(range);
+         }
+      }
+      printRecipeSweep(parser.value(whatIfOption), ranges);
+   }
+   if (parser.isSet(fermentationOption)) {
+      printFermentationReport(parser.value(fermentationOption));
+   }
+   if (parser.isSet(recipesForStyleOption) || parser.isSet(stylesForRecipeOption)) {
+      bool ok = true;
+      int const maxResults = parser.isSet(maxResultsOption) ? parser.value(maxResultsOption).toInt(&ok) : 0;
+      if (!ok || maxResults < 0) {
+         qCritical() << "Invalid number of results:" << parser.value(maxResultsOption);
+         return EXIT_FAILURE;
+      }
+      if (parser.isSet(recipesForStyleOption)) {
+         Style const * style = loadStyle(parser.value(recipesForStyleOption));
+         printStyleMatches<Recipe>(StyleMatchIndex::instance().recipesForStyle(*style, maxResults));
+      }
+      Recipe * recipe = loadRecipe(parser.value(stylesForRecipeOption));
+      printStyleMatches<Style>(StyleMatchIndex::instance().stylesForRecipe(*recipe, maxResults));
+   }
 
    try {
       qInfo() <<
@@ -1,6 +1,7 @@
 /*
  * matrix.cpp is part of Brewtarget, and is Copyright the following
- * authors 2009-2014
+ * authors 2009-2023
+ * - Matt Young <mfsy@yahoo.com>
  * - Philip Greggory Lee <rocketman768@gmail.com>
  *
  * Brewtarget is free software: you can redistribute it and/or modify
@@ -17,449 +18,255 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <iostream>
-#include <QVector>
-#include <cmath>
 #include "matrix.h"
 
-Matrix::~Matrix()
-{
-   delete [] _data;
-}
-
-Matrix::Matrix( unsigned int rows, unsigned int cols )
-{
-   _rows = rows;
-   _cols = cols;
-   _data = new double[ rows * cols ];
-}
+#include <algorithm>
 
-Matrix::Matrix( const QVector<Matrix> &colVec )
-{
-   unsigned int i, j;
-
-   _cols = colVec.size();
-   if( _cols == 0 )
-   {
-      _rows = 0;
-      return;
-   }
+Matrix::~Matrix() = default;
 
-   _rows =  colVec[0]._rows;
-
-   _data = new double[ _cols * _rows ];
+Matrix::Matrix( unsigned int rows, unsigned int cols ) :
+   m_matrix{rows, cols} {
+   return;
+}
 
-   for( j = 0; static_cast<int>(j) < colVec.size(); ++j )
-   {
-      if( colVec[j]._rows != _rows )
-      {
+Matrix::Matrix( const QVector<Matrix> &colVec ) :
+   m_matrix{colVec.isEmpty() ? 0 : colVec[0].getRows(), static_cast<std::size_t>(colVec.size())} {
+   for (unsigned int j = 0; j < m_matrix.cols(); ++j) {
+      if (colVec[j].getRows() != m_matrix.rows()) {
          std::cerr << "Matrix: dimension error in initialization\n";
-         throw DimensionException( colVec[j]._rows, 0, true, false );
+         throw DimensionException( colVec[j].getRows(), 0, true, false );
       }
 
-      for( i = 0; i < _rows; ++i )
-         setVal( i, j, colVec[j].getVal(i, 0) );
+      for (unsigned int i = 0; i < m_matrix.rows(); ++i) {
+         m_matrix(i, j) = colVec[j].m_matrix(i, 0);
+      }
    }
+   return;
 }
 
-Matrix::Matrix( const Matrix &m, unsigned int colStart, unsigned int colEnd )
-{
-   unsigned int i, j, k;
-
-   _rows = m._rows;
-   _cols = colEnd - colStart + 1;
-   _data = new double[ _rows * _cols ];
+Matrix::Matrix( const Matrix &m, unsigned int colStart, unsigned int colEnd ) :
+   m_matrix{m.getRows(), colEnd - colStart + 1} {
+   if (colEnd >= m.getCols() || colStart > colEnd) {
+      std::cerr << "Matrix: dimension error in initialization\n";
+      throw DimensionException( 0, m.getCols(), false, true );
+   }
 
-   for( i = 0; i < _rows; ++i )
-      for( j=0, k=colStart; k <= colEnd; ++j,++k )
-         setVal( i, j, m.getVal(i, k) );
+   for (unsigned int i = 0; i < m_matrix.rows(); ++i) {
+      std::copy_n(m.m_matrix.row(i).begin() + colStart, m_matrix.cols(), m_matrix.row(i).begin());
+   }
+   return;
 }
 
-Matrix::Matrix( const Matrix &rhs )
-{
-   _rows = rhs._rows;
-   _cols = rhs._cols;
-
-   unsigned int numElts = _rows*_cols;
-   unsigned int i;
-
-   _data = new double[ _rows*_cols ];
-   for( i = 0; i < numElts; ++i )
-      _data[i] = rhs._data[i];
+Matrix::Matrix( const Matrix &rhs ) :
+   m_matrix{rhs.m_matrix} {
+   return;
 }
 
-Matrix& Matrix::operator=( const Matrix &rhs )
-{
-   if( this == &rhs )
-      return *this;
-
-   _rows = rhs._rows;
-   _cols = rhs._cols;
-
-   unsigned int numElts = _rows*_cols;
-   unsigned int i;
-
-   if( ! _data )
-      delete [] _data;
-   _data = new double[ _rows*_cols ];
-   for( i = 0; i < numElts; ++i )
-      _data[i] = rhs._data[i];
-
+Matrix& Matrix::operator=( const Matrix &rhs ) {
+   m_matrix = rhs.m_matrix;
    return *this;
 }
 
-std::ostream& operator<<( std::ostream &os, const Matrix &rhs )
-{
-   unsigned int i;
-   unsigned int j;
-   double *ptr = rhs._data;
-
-   for( i = 0; i < rhs._rows; ++i )
-   {
+std::ostream& operator<<( std::ostream &os, const Matrix &rhs ) {
+   for (unsigned int i = 0; i < rhs.getRows(); ++i) {
       os << "[ ";
-      for( j = 0; j < rhs._cols - 1; ++j )
-      {
-         os << *ptr << ", ";
-         ptr++;
+      for (unsigned int j = 0; j < rhs.getCols(); ++j) {
+         os << rhs.m_matrix(i, j) << (j + 1 < rhs.getCols() ? ", " : "");
       }
-
-      os << *ptr << "]\n";
-      ptr++;
+      os << "]\n";
    }
 
    return os;
 }
 
-Matrix& Matrix::operator+=( const Matrix &rhs )
-{
-   unsigned int numElts = _rows * _cols;
-   unsigned int i;
-
-   if( !(_rows == rhs._rows && _cols == rhs._cols) )
-   {
+Matrix& Matrix::operator+=( const Matrix &rhs ) {
+   if (!(getRows() == rhs.getRows() && getCols() == rhs.getCols())) {
       std::cerr << "Matrix: dimension error with +=\n";
-      throw DimensionException( rhs._rows, rhs._cols, true, true);
+      throw DimensionException( rhs.getRows(), rhs.getCols(), true, true);
    }
 
-   for( i = 0; i < numElts; ++i )
-      _data[i] += rhs._data[i];
-
+   m_matrix += rhs.m_matrix;
    return *this;
 }
 
-Matrix& Matrix::operator-=( const Matrix &rhs )
-{
-   unsigned int numElts = _rows * _cols;
-   unsigned int i;
-
-   if( !(_rows == rhs._rows && _cols == rhs._cols) )
-   {
+Matrix& Matrix::operator-=( const Matrix &rhs ) {
+   if (!(getRows() == rhs.getRows() && getCols() == rhs.getCols())) {
       std::cerr << "Matrix: dimension error with -=\n";
-      throw DimensionException( rhs._rows, rhs._cols, true, true);
+      throw DimensionException( rhs.getRows(), rhs.getCols(), true, true);
    }
 
-   for( i = 0; i < numElts; ++i )
-      _data[i] -= rhs._data[i];
-
+   m_matrix -= rhs.m_matrix;
    return *this;
 }
 
-const Matrix Matrix::operator*( const Matrix &rhs ) const
-{
-   unsigned int i, j, k;
-   double tmp;
-
-   if( rhs._rows != _cols )
-   {
+const Matrix Matrix::operator*( const Matrix &rhs ) const {
+   if (rhs.getRows() != getCols()) {
       std::cerr << "Matrix: dimension error with *\n";
-      throw DimensionException( rhs._rows, 0, true, false );
-   }
-
-   Matrix ret( _rows, rhs._cols );
-
-   for( i = 0; i < ret._rows; ++i )
-   {
-      for( j = 0; j < ret._cols; ++j )
-      {
-         tmp = 0.0;
-         for( k = 0; k < _cols; ++k )
-            tmp += getVal( i, k ) * rhs.getVal( k, j );
-
-         ret.setVal( i, j, tmp );
-      }
+      throw DimensionException( rhs.getRows(), 0, true, false );
    }
 
+   Matrix ret( getRows(), rhs.getCols() );
+   LinearAlgebra::multiply(m_matrix, rhs.m_matrix, ret.m_matrix);
    return ret;
 }
 
-const Matrix Matrix::operator+( const Matrix &other ) const
-{
+const Matrix Matrix::operator+( const Matrix &other ) const {
    Matrix result( *this );
    result += other;
    return result;
 }
 
-const Matrix Matrix::operator-( const Matrix &other ) const
-{
+const Matrix Matrix::operator-( const Matrix &other ) const {
    Matrix result( *this );
    result -= other;
    return result;
 }
 
-Matrix Matrix::getRow( unsigned int row ) const
-{
-   unsigned int i;
-
-   if( row >= _rows )
-   {
+Matrix Matrix::getRow( unsigned int row ) const {
+   if (row >= getRows()) {
       std::cerr << "Matrix: dimension error in getRow()\n";
-      throw DimensionException( _rows, 0, true, false );
+      throw DimensionException( getRows(), 0, true, false );
    }
 
-   Matrix ret( 1, _cols );
-
-   for( i = 0; i < _cols; ++i )
-      ret.setVal( 0, i, getVal( row, i) );
-
+   Matrix ret( 1, getCols() );
+   BtSpan::span<double const> const source = m_matrix.row(row);
+   std::copy(source.begin(), source.end(), ret.m_matrix.row(0).begin());
    return ret;
 }
 
-Matrix Matrix::getCol( unsigned int col ) const
-{
-   unsigned int i;
-
-   if( col >= _cols )
-   {
+Matrix Matrix::getCol( unsigned int col ) const {
+   if (col >= getCols()) {
       std::cerr << "Matrix: dimension error in getCol()\n";
-      throw DimensionException( 0, _cols, false, true );
+      throw DimensionException( 0, getCols(), false, true );
    }
 
-   Matrix ret( _rows, 1 );
-
-   for( i = 0; i < _rows; ++i )
-      ret.setVal( i, 0, getVal(i, col) );
-
+   Matrix ret( getRows(), 1 );
+   for (unsigned int i = 0; i < getRows(); ++i) {
+      ret.m_matrix(i, 0) = m_matrix(i, col);
+   }
    return ret;
 }
 
-inline double Matrix::getVal( unsigned int row, unsigned int col ) const
-{
-   if( _cols*row + col < _rows*_cols )
-      return _data[ _cols*row + col ];
-   else
-   {
+double Matrix::getVal( unsigned int row, unsigned int col ) const {
+   if (row >= getRows() || col >= getCols()) {
       std::cerr << "Matrix: invalid access at _data[" << row << "][" << col << "]\n";
-      throw DimensionException( _rows, _cols, true, true );
+      throw DimensionException( getRows(), getCols(), true, true );
    }
+   return m_matrix(row, col);
 }
 
-inline void Matrix::setVal( unsigned int row, unsigned int col, double val )
-{
-   if( _cols*row + col < _rows*_cols )
-      _data[ _cols*row + col ] = val;
-   else
-   {
+void Matrix::setVal( unsigned int row, unsigned int col, double val ) {
+   if (row >= getRows() || col >= getCols()) {
       std::cerr << "Matrix: invalid access at _data[" << row << "][" << col << "]\n";
-      throw DimensionException( _rows, _cols, true, true );
+      throw DimensionException( getRows(), getCols(), true, true );
    }
-
+   m_matrix(row, col) = val;
    return;
 }
 
-void Matrix::swapRows( unsigned int row1, unsigned int row2 )
-{
-   unsigned int j;
-   double tmp;
-
-   if( row1 >= _rows || row2 >= _rows )
-   {
+void Matrix::swapRows( unsigned int row1, unsigned int row2 ) {
+   if (row1 >= getRows() || row2 >= getRows()) {
       std::cerr << "Matrix: swapRows(): can't swap row " << row1 << " and row " << row2;
-      throw DimensionException( _rows, 0, true, false );
+      throw DimensionException( getRows(), 0, true, false );
    }
 
-   for( j = 0; j < _cols; ++j )
-   {
-      tmp = getVal( row1, j );
-      setVal( row1, j, getVal( row2, j ) );
-      setVal( row2, j, tmp );
-   }
+   m_matrix.swapRows(row1, row2);
+   return;
 }
 
-void Matrix::rref()
-{
-   unsigned int i,j,k,l,m;
-   double pivot, mult;
-
-   k = 0;
-   for( i = 0; i < _rows && k < _cols; ++i )
-   {
-      // If this row's kth column is zero...
-      if( qAbs( getVal( i, k ) ) < EPSILON )
-      {
-         // Search for nonzero entry in this column (after the ith row).
-         for( l = i+1; l < _rows; ++l )
-            if( qAbs( getVal( l, k ) ) >= EPSILON )
-               break;
-
-         // Make sure we didn't fall off the edge
-         if( l == _rows )
-         {
-            ++k; // Give up on this k and try the next one.
-            --i; // Need to subtract so next iteration continues on this row.
-            continue;
-         }
-
-         // Otherwise, swap rows.
-         swapRows( i, l );
-      }
-
-      // Normalize the row so that a[i][k] = 1.
-      pivot = getVal( i, k );
-      for( j = k; j < _cols; ++j )
-         setVal( i, j, getVal(i, j) / pivot );
-
-      // Search for rows to add to.
-      for( l = 0; l < _rows; ++l )
-      {
-         // Don't want to do this to our own row.
-         if( l == i )
-            continue;
-
-         if( qAbs( getVal( l, k ) ) >= EPSILON )
-         {
-            mult = getVal(l,k);
-            for( m = 0; m < _cols; ++m )
-               setVal( l, m, getVal(l,m) - mult*getVal(i,m) );
-         }
-      }
-
-      ++k;
-   }
+void Matrix::rref() {
+   m_matrix.rref(EPSILON);
+   return;
 }
 
 // Returns true if the matrix has non-zero
 // entries on the diagonals.
-bool Matrix::hasNonZeroDiags() const
-{
-   unsigned int i;
-   bool ret = true;
-
-   for( i = 0; i < _rows && i < _cols; ++i )
-      ret = ret & ( qAbs(getVal(i,i)) >= EPSILON );
-
-   return ret;
+bool Matrix::hasNonZeroDiags() const {
+   for (unsigned int i = 0; i < getRows() && i < getCols(); ++i) {
+      if (qAbs(m_matrix(i, i)) < EPSILON) {
+         return false;
+      }
+   }
+   return true;
 }
 
-unsigned int Matrix::getRows() const
-{
-   return _rows;
+unsigned int Matrix::getRows() const {
+   return static_cast<unsigned int>(m_matrix.rows());
 }
 
-unsigned int Matrix::getCols() const
-{
-   return _cols;
+unsigned int Matrix::getCols() const {
+   return static_cast<unsigned int>(m_matrix.cols());
 }
 
-void Matrix::setRow( unsigned int row, QVector<double> vec )
-{
-   unsigned int j;
-
-   if( vec.size() != static_cast<int>(_cols) )
-   {
+void Matrix::setRow( unsigned int row, QVector<double> vec ) {
+   if (vec.size() != static_cast<int>(getCols())) {
       std::cerr << "Matrix: setRow(): dimension error\n";
-      throw DimensionException( 0, _cols, false, true );
+      throw DimensionException( 0, getCols(), false, true );
    }
 
-   for( j = 0; j < _cols; ++j )
+   for (unsigned int j = 0; j < getCols(); ++j) {
       setVal( row, j, vec[j] );
+   }
+   return;
 }
 
-void Matrix::setCol( unsigned int col, QVector<double> vec )
-{
-   unsigned int i;
-
-   if( vec.size() != static_cast<int>(_rows) )
-   {
+void Matrix::setCol( unsigned int col, QVector<double> vec ) {
+   if (vec.size() != static_cast<int>(getRows())) {
       std::cerr << "Matrix: setCol(): dimension error\n";
-      throw DimensionException( _rows, 0, true, false );
+      throw DimensionException( getRows(), 0, true, false );
    }
 
-   for( i = 0; i < _rows; ++i )
+   for (unsigned int i = 0; i < getRows(); ++i) {
       setVal( i, col, vec[i] );
+   }
+   return;
 }
 
-bool Matrix::hasInverse() const
-{
-   if( _rows != _cols )
+bool Matrix::hasInverse() const {
+   if (getRows() != getCols()) {
       return false;
+   }
 
-   Matrix m( *this );
-   m.rref();
-   return m.hasNonZeroDiags();
+   LinearAlgebra::DynamicMatrix a{m_matrix};
+   LinearAlgebra::DynamicMatrix b{getRows(), 1};
+   return LinearAlgebra::solveInPlace(a, b);
 }
 
-Matrix Matrix::getIdentity( unsigned int n )
-{
-   unsigned int i;
+Matrix Matrix::getIdentity( unsigned int n ) {
    Matrix m( n, n );
-
-   for( i = 0; i < n; ++i )
-      m.setVal( i, i, 1.0 );
-
+   m.m_matrix = LinearAlgebra::DynamicMatrix::identity(n);
    return m;
 }
 
-void Matrix::appendCols( const Matrix& other )
-{
-   unsigned int i, j, k;
-   double *oldData = _data;
-   unsigned int oldCols;
-
-   if( _rows != other._rows )
-   {
+void Matrix::appendCols( const Matrix& other ) {
+   if (getRows() != other.getRows()) {
       std::cerr << "Matrix: appendCols(): dimension error\n";
-      throw DimensionException( other._rows, 0, true, false );
+      throw DimensionException( other.getRows(), 0, true, false );
    }
 
-   _data = new double[ _rows * (_cols + other._cols) ];
-   oldCols = _cols;
-   _cols += other._cols;
-
-
-   // Put in the old values, and copy in the new
-   for( i = 0; i < _rows; ++i )
-   {
-      // Old values
-      for( j = 0; j < oldCols; ++j )
-         setVal(i, j, oldData[oldCols*i + j]);
-      // Appended values
-      for( j = oldCols, k=0; j < _cols; ++j, ++k )
-         setVal( i, j, other.getVal(i, k) );
+   LinearAlgebra::DynamicMatrix appended{m_matrix.rows(), m_matrix.cols() + other.m_matrix.cols()};
+   for (unsigned int i = 0; i < getRows(); ++i) {
+      BtSpan::span<double const> const left  = m_matrix.row(i);
+      BtSpan::span<double const> const right = other.m_matrix.row(i);
+      BtSpan::span<double> const destination = appended.row(i);
+      std::copy(right.begin(), right.end(), std::copy(left.begin(), left.end(), destination.begin()));
    }
-
-   if( ! oldData )
-      delete [] oldData;
+   m_matrix = std::move(appended);
+   return;
 }
 
-Matrix Matrix::inverse() const
-{
-   if( _rows != _cols )
-   {
+Matrix Matrix::inverse() const {
+   if (getRows() != getCols()) {
       std::cerr << "Matrix: inverse(): must be square";
-      throw DimensionException( _rows, _cols, true, true );
+      throw DimensionException( getRows(), getCols(), true, true );
    }
 
-   Matrix m( *this );
-
-   m.appendCols(getIdentity(_rows));
-   m.rref();
-
-   if( ! m.hasNonZeroDiags() )
-   {
+   LinearAlgebra::DynamicMatrix a{m_matrix};
+   Matrix inv = getIdentity(getRows());
+   if (!LinearAlgebra::solveInPlace(a, inv.m_matrix)) {
       std::cerr << "Matrix: inverse(): did not have an inverse";
       throw IncomputableException();
    }
 
-   Matrix inv( m, _cols, m._cols - 1);
    return inv;
 }
@@ -25,6 +25,8 @@
 #include <cmath>
 #include <exception>
 
+#include "LinearAlgebra.h"
+
 #define EPSILON 0.00001
 
 //======================Class Defns.=============================
@@ -35,6 +37,13 @@ class IncomputableException;
 std::ostream& operator<<( std::ostream &os, const Matrix &rhs );
 
 //======================Class: Matrix=============================
+/*!
+ * \class Matrix
+ *
+ * \brief Legacy interface, kept for compatibility.  This is now a thin wrapper around \c LinearAlgebra::DynamicMatrix,
+ *        which does the work.  New code should use \c LinearAlgebra::Matrix (or \c LinearAlgebra::DynamicMatrix if the
+ *        dimensions aren't known at compile time) directly, which avoid the allocations and exceptions here.
+ */
 class Matrix
 {
    friend std::ostream& operator<<( std::ostream &os, const Matrix &rhs );
@@ -58,8 +67,8 @@ class Matrix
       Matrix getCol( unsigned int col ) const;
       unsigned int getRows() const;
       unsigned int getCols() const;
-      inline double getVal( unsigned int row, unsigned int col ) const;
-      inline void setVal( unsigned int row, unsigned int col, double val );
+      double getVal( unsigned int row, unsigned int col ) const;
+      void setVal( unsigned int row, unsigned int col, double val );
       void setRow( unsigned int row, QVector<double> vec );
       void setCol( unsigned int col, QVector<double> vec );
       Matrix inverse() const;
@@ -71,9 +80,7 @@ class Matrix
       void appendCols( const Matrix& other );
 
    private:
-      unsigned int _rows;
-      unsigned int _cols;
-      double *_data;
+      LinearAlgebra::DynamicMatrix m_matrix;
 };
 
 //======================Class: DimensionException=============================
@@ -21,29 +21,55 @@
  */
 #include "measurement/IbuMethods.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <mutex>
 
 #include <QDebug>
 #include <QObject>
 #include <QString>
 
-#include "Algorithms.h"
-#include "measurement/Unit.h"
+#include "Localization.h"
+#include "measurement/Quantity.h"
+#include "PhysicalConstants.h"
 #include "PersistentSettings.h"
 
 
 namespace {
    // The Tinseth, Rager and Garetz methods are explained and discussed at http://www.realbeer.com/hops/FAQ.html
+   //
+   // Each of the formulae we support gives IBUs as
+   //    alpha acid rating × grams of hops × (something that depends only on the recipe) × (something that depends only
+   //                                                                                        on the time in the boil)
+   // so we split the formulae along those lines.  This allows the batch version of IbuMethods::getIbus to calculate
+   // the recipe-dependent part once for all hops.
+
+   double tinsethRecipeFactor(double finalVolume_liters, double wort_grav) {
+      // 1000 converts grams to milligrams; the rest is Tinseth's "bigness factor"
+      return (1000.0 / finalVolume_liters) * 1.65 * pow(0.000125, (wort_grav - 1));
+   }
+
+   double tinsethTimeFactor(double minutes) {
+      return (1.0 - exp(-0.04 * minutes)) / 4.15;
+   }
 
    double tinseth(double AArating,
                   double hops_grams,
                   double finalVolume_liters,
                   double wort_grav,
                   double minutes) {
-      return (
-         (AArating * hops_grams * 1000) /
-         finalVolume_liters) * ((1.0 - exp(-0.04 * minutes)) / 4.15) * (1.65 * pow(0.000125, (wort_grav - 1))
-      );
+      return AArating * hops_grams * tinsethRecipeFactor(finalVolume_liters, wort_grav) * tinsethTimeFactor(minutes);
+   }
+
+   double ragerRecipeFactor(double finalVolume_liters, double wort_grav) {
+      double gravityFactor = (wort_grav > 1.050) ? (wort_grav - 1.050)/0.2 : 0.0;
+      return 1000.0 / (finalVolume_liters * (1 + gravityFactor));
+   }
+
+   double ragerTimeFactor(double minutes) {
+      // This is the utilization
+      return (18.11 + 13.86 * tanh((minutes - 31.32) / 18.17)) / 100.0;
    }
 
    double rager(double AArating,
@@ -51,24 +77,20 @@ namespace {
                 double finalVolume_liters,
                 double wort_grav,
                 double minutes) {
-      double utilization = (18.11 + 13.86 * tanh((minutes - 31.32) / 18.17)) / 100.0;
-
-      double gravityFactor = (wort_grav > 1.050) ? (wort_grav - 1.050)/0.2 : 0.0;
-
-      return (hops_grams * utilization * AArating * 1000) / (finalVolume_liters * (1 + gravityFactor));
+      return AArating * hops_grams * ragerRecipeFactor(finalVolume_liters, wort_grav) * ragerTimeFactor(minutes);
    }
 
-   /*!
-    * \brief Calculates the IBU by Greg Noonans formula
-    */
-   double noonan(double AArating,
-                 double hops_grams,
-                 double finalVolume_liters,
-                 double wort_grav,
-                 double minutes) {
-      double volumeFactor = (Measurement::Units::us_gallons.toCanonical(5.0).quantity())/ finalVolume_liters;
-      double hopsFactor = hops_grams/ (Measurement::Units::ounces.toCanonical(1.0).quantity() * 1000.0);
-      static Polynomial p(Polynomial() << 0.7000029428 << -0.08868853463 << 0.02720809386 << -0.002340415323 << 0.00009925450081 << -0.000002102006144 << 0.00000002132644293 << -0.00000000008229488217);
+   double noonanRecipeFactor(double finalVolume_liters, double wort_grav) {
+      // Noonan's figures are for 5 US gallons of wort and hops in ounces
+      Measurement::Quantity<Measurement::StaticUnits::Liters> constexpr fiveGallons{
+         Measurement::Quantity<Measurement::StaticUnits::UsGallons>{5.0}
+      };
+      Measurement::Quantity<Measurement::StaticUnits::Grams> constexpr oneOunce{
+         Measurement::Quantity<Measurement::StaticUnits::Ounces>{1.0}
+      };
+      double volumeFactor = fiveGallons.value() / finalVolume_liters;
+      // Per-gram version of the hops factor, multiplied by 100 to convert the alpha acid rating to a percentage
+      double hopsFactor = 100.0 / oneOunce.value();
 
       //using 60 minutes as a general table
       double utilizationFactorTable[4][2] =  {
@@ -90,7 +112,230 @@ namespace {
          utilizationFactor = utilizationFactorTable[3][1];
       }
 
-      return(volumeFactor * ( hopsFactor * (100 * AArating) * p.eval(minutes) ) * utilizationFactor);
+      return volumeFactor * hopsFactor * utilizationFactor;
+   }
+
+   double noonanTimeFactor(double minutes) {
+      // Polynomial in minutes, lowest order coefficient first, evaluated by Horner's method
+      double constexpr coeffs[] = {
+         0.7000029428, -0.08868853463, 0.02720809386, -0.002340415323, 0.00009925450081, -0.000002102006144,
+         0.00000002132644293, -0.00000000008229488217
+      };
+      double ret = 0.0;
+      for (int ii = std::size(coeffs) - 1; ii >= 0; --ii) {
+         ret = ret * minutes + coeffs[ii];
+      }
+      return ret;
+   }
+
+   /*!
+    * \brief Calculates the IBU by Greg Noonans formula
+    */
+   double noonan(double AArating,
+                 double hops_grams,
+                 double finalVolume_liters,
+                 double wort_grav,
+                 double minutes) {
+      return AArating * hops_grams * noonanRecipeFactor(finalVolume_liters, wort_grav) * noonanTimeFactor(minutes);
+   }
+
+   //
+   // Time-resolved model -- see comment on IbuMethods::UtilisationCurve
+   //
+   // Resolution of the utilisation curves
+   int constexpr stepsPerMinute = 4;
+   // Natural cooling after flameout, from Mark Hansen's measurements of a 19L (5 US gallon) batch
+   double constexpr hopStandFloor_c           = 45.6;
+   double constexpr hopStandCoolingRate_perMin = 0.0362;
+   double constexpr hopStandReferenceVolume_l  = 19.0;
+   // Chilling gets to within 5% of this by the end of the chill time
+   double constexpr chilledTemp_c = 20.0;
+   double constexpr chillTimeConstants = 3.0;
+   // How many curves we keep.  Each is a few KB, and there's usually only one recipe being looked at.
+   std::size_t constexpr maxCachedCurves = 16;
+   // Boil time for the curves used by the scalar version of getIbus, which doesn't know the recipe's boil time.  (See
+   // comment in timeResolved.)
+   double constexpr scalarBoilTime_min = 120.0;
+
+   double kelvin(double const temp_c) {
+      return temp_c - PhysicalConstants::absoluteZero;
+   }
+
+   //! Malowicki & Shellhammer rate constant for alpha acids isomerising, per minute
+   double isomerisationRate(double const temp_c) {
+      return 7.9e11 * std::exp(-11858.0 / kelvin(temp_c));
+   }
+
+   //! Malowicki & Shellhammer rate constant for iso-alpha acids degrading, per minute
+   double degradationRate(double const temp_c) {
+      return 4.1e12 * std::exp(-12994.0 / kelvin(temp_c));
+   }
+
+   double profileLength_min(IbuMethods::KettleProfile const & profile) {
+      return profile.boilTime_min + profile.hopStandTime_min + profile.chillTime_min;
+   }
+
+   double profileTemp_c(IbuMethods::KettleProfile const & profile, double time_min) {
+      if (time_min <= profile.boilTime_min) {
+         return profile.boilingPoint_c;
+      }
+      time_min -= profile.boilTime_min;
+
+      // Surface area to volume ratio, and therefore rate of cooling, goes as the inverse cube root of volume
+      double const coolingRate_perMin = profile.volume_l > 0.0 ?
+         hopStandCoolingRate_perMin * std::cbrt(hopStandReferenceVolume_l / profile.volume_l) :
+         hopStandCoolingRate_perMin;
+      double const standTime_min = std::min(time_min, profile.hopStandTime_min);
+      double const standTemp_c =
+         hopStandFloor_c + (profile.boilingPoint_c - hopStandFloor_c) * std::exp(-coolingRate_perMin * standTime_min);
+      time_min -= standTime_min;
+      if (time_min <= 0.0 || profile.chillTime_min <= 0.0) {
+         return standTemp_c;
+      }
+
+      double const chillTime_min = std::min(time_min, profile.chillTime_min);
+      return chilledTemp_c +
+             (standTemp_c - chilledTemp_c) * std::exp(-chillTimeConstants * chillTime_min / profile.chillTime_min);
+   }
+
+   /**
+    * \brief Fraction of alpha acids added at each grid point that are iso-alpha acids at the end of the profile
+    *
+    *        Rather than integrating forwards once for each addition time, we integrate the adjoint equations backwards
+    *        once.  For constant temperature over a step of length h, alpha acids A and iso-alpha acids I go
+    *           A' = e1 A
+    *           I' = e2 I + c A
+    *        where e1 = exp(-k1 h), e2 = exp(-k2 h) and c = k1 (e1 - e2) / (k2 - k1).  So, if pA and pI are how much
+    *        iso-alpha acid we end up with per unit of A and I at the end of a step, then at the start of it they are
+    *           pA = e1 pA' + c pI'
+    *           pI = e2 pI'
+    *        and, at the end of the profile, pA = 0 and pI = 1.  pA at each point is the answer we want.
+    */
+   std::vector<double> isomerisedFractions(IbuMethods::KettleProfile const & profile) {
+      double const length_min = profileLength_min(profile);
+      std::size_t const numSteps = static_cast<std::size_t>(std::ceil(std::max(length_min, 0.0) * stepsPerMinute));
+      std::vector<double> fractions(numSteps + 1, 0.0);
+      if (numSteps == 0) {
+         return fractions;
+      }
+
+      double const step_min = length_min / numSteps;
+      double pIso = 1.0;
+      for (std::size_t ii = numSteps; ii-- > 0; ) {
+         double const temp_c = profileTemp_c(profile, (ii + 0.5) * step_min);
+         double const k1 = isomerisationRate(temp_c);
+         double const k2 = degradationRate(temp_c);
+         double const e1 = std::exp(-k1 * step_min);
+         double const e2 = std::exp(-k2 * step_min);
+         // Limit as k2 -> k1 is k1 h e1
+         double const c = std::abs(k2 - k1) > 1e-12 ? k1 * (e1 - e2) / (k2 - k1) : k1 * step_min * e1;
+         fractions[ii] = e1 * fractions[ii + 1] + c * pIso;
+         pIso *= e2;
+      }
+      return fractions;
+   }
+
+   /**
+    * \brief Multiplier that makes a 60 minute boil at 100°C, with no hop stand or chill, give the same utilisation as
+    *        Tinseth
+    */
+   double timeResolvedCalibration() {
+      static double const calibration = [](){
+         IbuMethods::KettleProfile const reference{60.0, 100.0, 0.0, 0.0, hopStandReferenceVolume_l};
+         return tinsethTimeFactor(60.0) / isomerisedFractions(reference).front();
+      }();
+      return calibration;
+   }
+
+   /**
+    * \brief The loop at the heart of the batch version of \c IbuMethods::getIbus.  Templated on the time factor so
+    *        that the compiler can inline it, and so there is no per-hop switch on the formula.
+    *
+    * \tparam hopStandAdditions \c true if the formula gives IBUs for "aroma" hops, ie those added after flameout
+    * \param timeFactor Callable taking (HopTiming, minutes) and returning the time-dependent part of the utilisation
+    */
+   template<bool hopStandAdditions, class TimeFactor>
+   double ibuKernel(IbuMethods::HopAdditions const & hops,
+                    IbuMethods::RecipeIbuConstants const & constants,
+                    double const recipeFactor,
+                    TimeFactor const & timeFactor,
+                    BtSpan::span<double> ibusPerHop) {
+      double const mashHopAdjustment = constants.mashHopAdjustment > 0.0 ? constants.mashHopAdjustment : 0.0;
+      double total = 0.0;
+      std::size_t const numHops = hops.size();
+      for (std::size_t ii = 0; ii < numHops; ++ii) {
+         IbuMethods::HopTiming const timing = hops.timing[ii];
+         // Only boil (and, where supported, hop stand) additions use their own time.  First wort and mash hops are
+         // treated as being in for the whole boil.  Anything else (eg dry hops) doesn't contribute any IBUs.
+         double const timingAdjustment =
+            timing == IbuMethods::HopTiming::Boil      ? 1.0                              :
+            timing == IbuMethods::HopTiming::FirstWort ? constants.firstWortHopAdjustment :
+            timing == IbuMethods::HopTiming::Mash      ? mashHopAdjustment                :
+            timing == IbuMethods::HopTiming::HopStand && hopStandAdditions ? 1.0          : 0.0;
+         bool const ownTime = timing == IbuMethods::HopTiming::Boil || timing == IbuMethods::HopTiming::HopStand;
+         double const minutes = ownTime ? hops.minutes[ii] : constants.boilTime_min;
+
+         // Hops that contribute nothing are zeroed explicitly rather than multiplied by zero, so that, as in the
+         // scalar code, they don't turn into NaN when the recipe factor is infinite (eg final volume not yet set).
+         double const ibus = timingAdjustment == 0.0 ? 0.0 :
+                             timingAdjustment * hops.formFactor[ii] * constants.hopUtilization *
+                             hops.alpha[ii] * hops.grams[ii] * recipeFactor * timeFactor(timing, minutes);
+         ibusPerHop[ii] = ibus;
+         total += ibus;
+      }
+      return total;
+   }
+
+   template<double (*timeFactor)(double)>
+   double empiricalIbuKernel(IbuMethods::HopAdditions const & hops,
+                             IbuMethods::RecipeIbuConstants const & constants,
+                             double const recipeFactor,
+                             BtSpan::span<double> ibusPerHop) {
+      return ibuKernel<false>(
+         hops,
+         constants,
+         recipeFactor,
+         [](IbuMethods::HopTiming, double minutes) { return timeFactor(minutes); },
+         ibusPerHop
+      );
+   }
+
+   double timeResolvedIbuKernel(IbuMethods::HopAdditions const & hops,
+                                IbuMethods::RecipeIbuConstants const & constants,
+                                BtSpan::span<double> ibusPerHop) {
+      auto const curve = IbuMethods::utilisationCurve(IbuMethods::KettleProfile{constants.boilTime_min,
+                                                                                constants.boilingPoint_c,
+                                                                                constants.hopStandTime_min,
+                                                                                constants.chillTime_min,
+                                                                                constants.finalVolume_l});
+      return ibuKernel<true>(
+         hops,
+         constants,
+         tinsethRecipeFactor(constants.finalVolume_l, constants.og),
+         [&curve](IbuMethods::HopTiming timing, double minutes) {
+            return timing == IbuMethods::HopTiming::HopStand ? curve->hopStand(minutes) : curve->boil(minutes);
+         },
+         ibusPerHop
+      );
+   }
+
+   double timeResolved(double AArating,
+                       double hops_grams,
+                       double finalVolume_liters,
+                       double wort_grav,
+                       double minutes) {
+      // We don't know the boil time, but utilisation only depends on what happens after the hop goes in, so any boil
+      // at least as long as the addition gives the same answer.  Using the same boil time for all normal additions
+      // means the curve (and so the cache entry) only changes when the settings or volume do.
+      double const boilTime_min = scalarBoilTime_min * std::max(std::ceil(minutes / scalarBoilTime_min), 1.0);
+      IbuMethods::RecipeIbuConstants settings{};
+      IbuMethods::loadHopStandAndChillTimes(settings);
+      auto const curve = IbuMethods::utilisationCurve(IbuMethods::KettleProfile{boilTime_min,
+                                                                                100.0,
+                                                                                settings.hopStandTime_min,
+                                                                                settings.chillTime_min,
+                                                                                finalVolume_liters});
+      return AArating * hops_grams * tinsethRecipeFactor(finalVolume_liters, wort_grav) * curve->boil(minutes);
    }
 }
 
@@ -104,6 +349,8 @@ void IbuMethods::loadIbuFormula() {
       IbuMethods::ibuFormula = IbuMethods::RAGER;
    } else if (text == "noonan") {
        IbuMethods::ibuFormula = IbuMethods::NOONAN;
+   } else if (text == "timeresolved") {
+      IbuMethods::ibuFormula = IbuMethods::TIME_RESOLVED;
    } else {
       qCritical() << Q_FUNC_INFO << "Bad ibu_formula type:" << text;
    }
@@ -121,6 +368,9 @@ void IbuMethods::saveIbuFormula() {
       case IbuMethods::NOONAN:
          PersistentSettings::insert(PersistentSettings::Names::ibu_formula, "noonan");
          break;
+      case IbuMethods::TIME_RESOLVED:
+         PersistentSettings::insert(PersistentSettings::Names::ibu_formula, "timeresolved");
+         break;
    }
    return;
 }
@@ -130,6 +380,7 @@ QString IbuMethods::ibuFormulaName() {
       case IbuMethods::TINSETH: return "Tinseth";
       case IbuMethods::RAGER:   return "Rager";
       case IbuMethods::NOONAN:  return "Noonan";
+      case IbuMethods::TIME_RESOLVED: return QObject::tr("Time-resolved");
    }
    return QObject::tr("Unknown");
 }
@@ -143,7 +394,150 @@ double IbuMethods::getIbus(double AArating,
       case IbuMethods::TINSETH: return tinseth(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
       case IbuMethods::RAGER:   return rager(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
       case IbuMethods::NOONAN:  return noonan(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
+      case IbuMethods::TIME_RESOLVED:
+         return timeResolved(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
    }
    qCritical() << Q_FUNC_INFO << QObject::tr("Unrecognized IBU formula type. %1").arg(IbuMethods::ibuFormula);
    return tinseth(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
 }
+
+void IbuMethods::loadHopStandAndChillTimes(RecipeIbuConstants & constants) {
+   constants.hopStandTime_min = Localization::toDouble(
+      PersistentSettings::value(PersistentSettings::Names::hopStandTime_min, defaultHopStandTime_min).toString(),
+      Q_FUNC_INFO
+   );
+   constants.chillTime_min = Localization::toDouble(
+      PersistentSettings::value(PersistentSettings::Names::chillTime_min, defaultChillTime_min).toString(),
+      Q_FUNC_INFO
+   );
+   return;
+}
+
+std::size_t IbuMethods::HopAdditions::size() const {
+   return this->alpha.size();
+}
+
+void IbuMethods::HopAdditions::clear() {
+   this->alpha.clear();
+   this->grams.clear();
+   this->minutes.clear();
+   this->timing.clear();
+   this->formFactor.clear();
+   return;
+}
+
+void IbuMethods::HopAdditions::reserve(std::size_t numHops) {
+   this->alpha.reserve(numHops);
+   this->grams.reserve(numHops);
+   this->minutes.reserve(numHops);
+   this->timing.reserve(numHops);
+   this->formFactor.reserve(numHops);
+   return;
+}
+
+void IbuMethods::HopAdditions::append(double alpha,
+                                      double grams,
+                                      double minutes,
+                                      HopTiming timing,
+                                      double formFactor) {
+   this->alpha.push_back(alpha);
+   this->grams.push_back(grams);
+   this->minutes.push_back(minutes);
+   this->timing.push_back(timing);
+   this->formFactor.push_back(formFactor);
+   return;
+}
+
+double IbuMethods::getIbus(HopAdditions const & hops,
+                           RecipeIbuConstants const & constants,
+                           BtSpan::span<double> ibusPerHop,
+                           IbuType formula) {
+   Q_ASSERT(ibusPerHop.size() >= hops.size());
+   switch (formula) {
+      case IbuMethods::TINSETH:
+         return empiricalIbuKernel<tinsethTimeFactor>(
+            hops, constants, tinsethRecipeFactor(constants.finalVolume_l, constants.og), ibusPerHop
+         );
+      case IbuMethods::RAGER:
+         return empiricalIbuKernel<ragerTimeFactor>(
+            hops, constants, ragerRecipeFactor(constants.finalVolume_l, constants.og), ibusPerHop
+         );
+      case IbuMethods::NOONAN:
+         return empiricalIbuKernel<noonanTimeFactor>(
+            hops, constants, noonanRecipeFactor(constants.finalVolume_l, constants.og), ibusPerHop
+         );
+      case IbuMethods::TIME_RESOLVED:
+         return timeResolvedIbuKernel(hops, constants, ibusPerHop);
+   }
+   qCritical() << Q_FUNC_INFO << QObject::tr("Unrecognized IBU formula type. %1").arg(formula);
+   return empiricalIbuKernel<tinsethTimeFactor>(
+      hops, constants, tinsethRecipeFactor(constants.finalVolume_l, constants.og), ibusPerHop
+   );
+}
+
+IbuMethods::UtilisationCurve::UtilisationCurve(KettleProfile const & profile) :
+   m_profile{profile},
+   m_utilisation{isomerisedFractions(profile)} {
+   double const calibration = timeResolvedCalibration();
+   for (double & utilisation : this->m_utilisation) {
+      utilisation *= calibration;
+   }
+   return;
+}
+
+IbuMethods::KettleProfile const & IbuMethods::UtilisationCurve::profile() const {
+   return this->m_profile;
+}
+
+double IbuMethods::UtilisationCurve::temp_c(double const time_min) const {
+   return profileTemp_c(this->m_profile, time_min);
+}
+
+double IbuMethods::UtilisationCurve::boil(double const minutes) const {
+   // A hop can't be in for longer than the boil, or less than no time at all
+   return this->atTime(this->m_profile.boilTime_min - std::clamp(minutes, 0.0, this->m_profile.boilTime_min));
+}
+
+double IbuMethods::UtilisationCurve::hopStand(double const minutes) const {
+   double const standTime_min = std::max(this->m_profile.hopStandTime_min, 0.0);
+   return this->atTime(this->m_profile.boilTime_min + standTime_min - std::clamp(minutes, 0.0, standTime_min));
+}
+
+double IbuMethods::UtilisationCurve::atTime(double const time_min) const {
+   std::size_t const numSteps = this->m_utilisation.size() - 1;
+   double const length_min = profileLength_min(this->m_profile);
+   if (numSteps == 0 || length_min <= 0.0) {
+      return this->m_utilisation.front();
+   }
+   double const position = std::clamp(time_min / length_min, 0.0, 1.0) * numSteps;
+   std::size_t const index = std::min(static_cast<std::size_t>(position), numSteps - 1);
+   double const fraction = position - index;
+   return this->m_utilisation[index] + fraction * (this->m_utilisation[index + 1] - this->m_utilisation[index]);
+}
+
+std::shared_ptr<IbuMethods::UtilisationCurve const> IbuMethods::utilisationCurve(KettleProfile const & profile) {
+   // Each thread remembers the last curve it used, so that repeatedly evaluating the same recipe (eg in a sweep or
+   // Monte Carlo run) doesn't need to take the lock
+   thread_local std::shared_ptr<UtilisationCurve const> lastUsed;
+   if (lastUsed && lastUsed->profile() == profile) {
+      return lastUsed;
+   }
+
+   static std::mutex cacheMutex;
+   // Most recently used first
+   static std::vector<std::shared_ptr<UtilisationCurve const>> cache;
+   std::lock_guard<std::mutex> lock{cacheMutex};
+   auto match = std::find_if(cache.begin(),
+                             cache.end(),
+                             [&profile](auto const & curve) { return curve->profile() == profile; });
+   if (match == cache.end()) {
+      if (cache.size() >= maxCachedCurves) {
+         cache.pop_back();
+      }
+      cache.insert(cache.begin(), std::make_shared<UtilisationCurve const>(profile));
+   } else {
+      std::rotate(cache.begin(), match, match + 1);
+   }
+   lastUsed = cache.front();
+   return lastUsed;
+}
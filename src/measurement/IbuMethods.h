@@ -1,6 +1,6 @@
 /*
  * measurement/IbuMethods.h is part of Brewtarget, and is copyright the following
- * authors 2009-2021:
+ * authors 2009-2023:
  * - Daniel Pettersson <pettson81@gmail.com>
  * - Matt Young <mfsy@yahoo.com>
  * - Philip Greggory Lee <rocketman768@gmail.com>
@@ -22,6 +22,12 @@
 #define MEASUREMENT_IBUMETHODS_H
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "utils/Span.h"
+
 class QString;
 
 /*!
@@ -30,8 +36,9 @@ class QString;
  * \brief Make IBU calculations.
  */
 namespace IbuMethods {
-   //! \brief The formula used to get IBUs.
-   enum IbuType {TINSETH, RAGER, NOONAN};
+   //! \brief The formula used to get IBUs.  (NB: Values are stored in the option dialog's combo box, so only ever add
+   //!        to the end.)
+   enum IbuType {TINSETH, RAGER, NOONAN, TIME_RESOLVED};
 
    extern IbuType ibuFormula;
 
@@ -57,6 +64,177 @@ namespace IbuMethods {
     * \param minutes - minutes that the hops are in the boil
     */
    double getIbus(double AArating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes);
+
+   /**
+    * \brief The inputs to the IBU calculation that are the same for every hop addition in a recipe.  See
+    *        \c Recipe::ibuConstants.
+    */
+   struct RecipeIbuConstants {
+      //! \brief Gravity used for all hop additions (we use OG rather than average boil gravity -- see comment in
+      //         \c Recipe::ibuFromHop)
+      double og;
+      double finalVolume_l;
+      //! \brief First wort and mash hops are treated as if boiled for this long
+      double boilTime_min;
+      //! \brief Equipment hop utilization as a fraction (so 1.0 means 100%)
+      double hopUtilization;
+      //! \brief Multiplier for first wort hops
+      double firstWortHopAdjustment;
+      //! \brief Multiplier for mash hops.  If this is zero (the default), mash hops contribute no IBUs.
+      double mashHopAdjustment;
+
+      //
+      // The rest is only used by the TIME_RESOLVED formula
+      //
+      double boilingPoint_c   = 100.0;
+      //! \brief Time between flameout and starting to chill, during which the wort cools naturally
+      double hopStandTime_min = 0.0;
+      //! \brief Time taken to chill the wort to pitching temperature
+      double chillTime_min    = 0.0;
+   };
+
+   /**
+    * \brief Defaults for the hop stand and chill time settings.  With both at 0, \c TIME_RESOLVED gives the same as
+    *        Tinseth for a 60 minute boil, which is what it is calibrated against.
+    */
+   double constexpr defaultHopStandTime_min = 0.0;
+   double constexpr defaultChillTime_min    = 0.0;
+
+   /**
+    * \brief Set \c constants.hopStandTime_min and \c constants.chillTime_min from the user's settings
+    */
+   void loadHopStandAndChillTimes(RecipeIbuConstants & constants);
+
+   /**
+    * \brief What happens to the temperature of the wort from the start of the boil until it's chilled.  See
+    *        \c UtilisationCurve.
+    */
+   struct KettleProfile {
+      double boilTime_min;
+      double boilingPoint_c;
+      double hopStandTime_min;
+      double chillTime_min;
+      //! \brief Bigger volumes cool more slowly during the hop stand
+      double volume_l;
+
+      bool operator==(KettleProfile const & other) const {
+         return this->boilTime_min     == other.boilTime_min     &&
+                this->boilingPoint_c   == other.boilingPoint_c   &&
+                this->hopStandTime_min == other.hopStandTime_min &&
+                this->chillTime_min    == other.chillTime_min    &&
+                this->volume_l         == other.volume_l;
+      }
+   };
+
+   /**
+    * \brief Fraction of a hop addition's alpha acids that end up as iso-alpha acids in the chilled wort, for every
+    *        possible addition time in a \c KettleProfile.
+    *
+    *        Isomerisation of alpha acids, and degradation of the iso-alpha acids, are modelled as first order
+    *        reactions with the temperature-dependent rate constants from Malowicki & Shellhammer (2005), integrated
+    *        over the whole boil, hop stand and chill.  The wort cools exponentially towards about 46°C during the hop
+    *        stand (after Mark Hansen's measurements of a 19L kettle, scaled for volume) and then towards 20°C while
+    *        being chilled.
+    *
+    *        The raw fractions are a lot higher than the utilisations that the empirical formulas give, because they
+    *        don't include losses in fermentation, so we scale them to give the same as Tinseth for a 60 minute boil at
+    *        100°C with no hop stand or chill.  Other addition times and profiles then vary from Tinseth according to
+    *        the kinetics.
+    *
+    *        Building one means integrating over the whole profile, so use \c utilisationCurve() to get a cached one.
+    *        Once built, looking up any addition time is just a linear interpolation.
+    */
+   class UtilisationCurve {
+   public:
+      UtilisationCurve(KettleProfile const & profile);
+
+      KettleProfile const & profile() const;
+
+      //! \brief Temperature of the wort \c time_min minutes after the start of the boil
+      double temp_c(double time_min) const;
+
+      //! \brief Scaled utilisation for a hop in the boil for \c minutes before flameout
+      double boil(double minutes) const;
+
+      /**
+       * \brief Scaled utilisation for a hop added after flameout (eg a whirlpool or "aroma" addition) that stays in
+       *        for the last \c minutes of the hop stand.  Hops added at flameout still pick up some bitterness while
+       *        the wort is being chilled.
+       */
+      double hopStand(double minutes) const;
+
+   private:
+      double atTime(double time_min) const;
+
+      KettleProfile m_profile;
+      //! \brief m_utilisation[i] is the scaled utilisation for a hop added i / stepsPerMinute minutes after the start
+      //!        of the boil
+      std::vector<double> m_utilisation;
+   };
+
+   /**
+    * \brief Get the utilisation curve for \c profile, building it if we haven't already got it cached.  Safe to call
+    *        from any thread.
+    */
+   std::shared_ptr<UtilisationCurve const> utilisationCurve(KettleProfile const & profile);
+
+   /**
+    * \brief When a hop addition goes in, which is all the IBU formulas need to know about its use.  (\c Recipe maps
+    *        \c Hop::Use on to this, so that this part of the code doesn't depend on the model classes.)
+    */
+   enum class HopTiming {
+      //! \brief In the boil for the addition's own time
+      Boil,
+      //! \brief Treated as in for the whole boil, and scaled by \c RecipeIbuConstants::firstWortHopAdjustment
+      FirstWort,
+      //! \brief Treated as in for the whole boil, and scaled by \c RecipeIbuConstants::mashHopAdjustment
+      Mash,
+      //! \brief Added after flameout, for the addition's own time in the hop stand.  Only \c TIME_RESOLVED gives IBUs.
+      HopStand,
+      //! \brief Contributes no IBUs (eg dry hops)
+      None
+   };
+
+   /**
+    * \brief A list of hop additions in struct-of-arrays form, ie the i-th hop addition is
+    *        { alpha[i], grams[i], minutes[i], timing[i], formFactor[i] }.  This is what the batch version of
+    *        \c getIbus works on, and is cheap enough to build that it can be refilled on every recalculation.  See
+    *        \c Recipe::hopAdditions.
+    */
+   struct HopAdditions {
+      //! \brief Alpha acid rating as a fraction (so 0.04 means 4% AA)
+      std::vector<double>    alpha;
+      std::vector<double>    grams;
+      std::vector<double>    minutes;
+      std::vector<HopTiming> timing;
+      //! \brief Multiplier for the hop's form, eg 1.10 for pellets (see comment in \c Recipe::hopAdditions)
+      std::vector<double>    formFactor;
+
+      std::size_t size() const;
+      void clear();
+      void reserve(std::size_t numHops);
+      void append(double alpha, double grams, double minutes, HopTiming timing, double formFactor = 1.0);
+   };
+
+   /*!
+    * \brief Batch version of \c getIbus, which also takes account of hop timing (boil, first wort, etc), form and
+    *        equipment utilization in the same way as \c Recipe::ibuFromHop.
+    *
+    *        Only \c TIME_RESOLVED gives any IBUs for hop stand additions.
+    *
+    *        Everything that depends only on the recipe (eg the gravity factor shared by Tinseth, Rager and Noonan) is
+    *        calculated once, and the formula is selected once, before looping over the hops.
+    *
+    * \param hops
+    * \param constants
+    * \param ibusPerHop Receives the IBUs for each hop in \c hops.  Must be at least \c hops.size() long.
+    * \param formula Which formula to use.  Defaults to the one the user has selected.
+    * \return Total IBUs from all the hops
+    */
+   double getIbus(HopAdditions const & hops,
+                  RecipeIbuConstants const & constants,
+                  BtSpan::span<double> ibusPerHop,
+                  IbuType formula = ibuFormula);
 }
 
 #endif
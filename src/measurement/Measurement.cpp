@@ -21,6 +21,11 @@
  */
 #include "measurement/Measurement.h"
 
+#include <array>
+#include <cstring>
+
+#include <QByteArray>
+#include <QCache>
 #include <QDebug>
 #include <QMap>
 #include <QString>
@@ -47,6 +52,87 @@ namespace {
     */
    QMap<Measurement::PhysicalQuantity, Measurement::UnitSystem const *> physicalQuantityToDisplayUnitSystem;
 
+   //! \brief See \c Measurement::displayUnitSystemGeneration
+   unsigned int displayUnitSystemChanges = 0;
+
+   /**
+    * \brief Everything that decides how \c Measurement::displayAmount or \c Measurement::displayQuantity formats a
+    *        number, except the display unit systems and the language, changes to which empty the whole cache.  For
+    *        \c displayQuantity, \c unit is \c nullptr.  Missing forced systems and scales are -1.
+    */
+   struct DisplayCacheKey {
+      quint64 quantityBits;
+      Measurement::Unit const * unit;
+      int precision;
+      int forcedSystemOfMeasurement;
+      int forcedScale;
+
+      bool operator==(DisplayCacheKey const & other) const {
+         return this->quantityBits              == other.quantityBits              &&
+                this->unit                      == other.unit                      &&
+                this->precision                 == other.precision                 &&
+                this->forcedSystemOfMeasurement == other.forcedSystemOfMeasurement &&
+                this->forcedScale               == other.forcedScale;
+      }
+   };
+
+   /**
+    * \brief The bits of \c quantity, for \c DisplayCacheKey.  We key on these rather than the \c double itself so
+    *        that, eg, 0.0 and -0.0, which display differently, get separate entries.
+    */
+   quint64 cacheKeyFor(double const quantity) {
+      static_assert(sizeof(quint64) == sizeof(double));
+      quint64 bits;
+      std::memcpy(&bits, &quantity, sizeof(bits));
+      return bits;
+   }
+
+   uint qHash(DisplayCacheKey const & key, uint seed = 0) {
+      return ::qHash(key.quantityBits, seed) ^
+             ::qHash(key.unit, seed) ^
+             ::qHash((key.precision << 16) ^ (key.forcedSystemOfMeasurement << 8) ^ key.forcedScale, seed);
+   }
+
+   // Comfortably more than the number of different amounts on screen at once, even with several large tables open
+   int constexpr displayCacheSize = 20000;
+
+   struct DisplayCache {
+      QCache<DisplayCacheKey, QString> strings{displayCacheSize};
+      unsigned int displayUnitSystemGeneration = 0;
+      unsigned int languageGeneration = 0;
+      Measurement::DisplayCacheStatistics statistics{};
+   };
+
+   DisplayCache & displayCache() {
+      thread_local DisplayCache cache;
+      if (cache.displayUnitSystemGeneration != displayUnitSystemChanges ||
+          cache.languageGeneration          != Localization::languageGeneration()) {
+         cache.strings.clear();
+         cache.displayUnitSystemGeneration = displayUnitSystemChanges;
+         cache.languageGeneration          = Localization::languageGeneration();
+      }
+      return cache;
+   }
+
+   template<typename Formatter>
+   QString cachedDisplay(DisplayCacheKey const & key, Formatter formatter) {
+      DisplayCache & cache = displayCache();
+      QString const * cached = cache.strings.object(key);
+      if (cached) {
+         ++cache.statistics.hits;
+         return *cached;
+      }
+      ++cache.statistics.misses;
+      QString result = formatter();
+      cache.strings.insert(key, new QString{result});
+      return result;
+   }
+
+   template<typename E>
+   int cacheKeyFor(std::optional<E> const & value) {
+      return value ? static_cast<int>(*value) : -1;
+   }
+
    //
    // Load the previous stored setting for which UnitSystem we use for a particular physical quantity
    //
@@ -67,26 +153,48 @@ namespace {
    }
 
    /**
-    * \brief Given a string of number plus, optionally, some units or pseudo-units, extract the number (and ignore the
-    *        units or pseudo-units)
+    * \brief Longest number, in characters, that \c Measurement::parseAmount will read.  A double only holds 17 or so
+    *        significant digits, so we can drop any fractional digits beyond this without changing the result.  An
+    *        integer part this long isn't something anyone is going to type in.
     */
-   double extractRawDoubleFromString(QString const & input, bool * ok) {
-      if (ok) {
-         *ok = true;
-      }
+   int constexpr maxNumberLength = 64;
+
+   //! \brief Room for a number of \c maxNumberLength characters
+   using NumberBuffer = std::array<char, maxNumberLength>;
 
-      // Make sure we get the right decimal point (. or ,) and the right grouping
-      // separator (, or .). Some locales write 1.000,10 and other write
-      // 1,000.10. We need to catch both
-      QString const decimal  = QRegExp::escape(Localization::getLocale().decimalPoint());
-      QString const grouping = QRegExp::escape(Localization::getLocale().groupSeparator());
+   //! \brief Same as what \c \\w matches in \c QRegExp, ie a letter, digit, mark or underscore
+   bool isWordCharacter(QChar const character) {
+      return character.isLetterOrNumber() || character.isMark() || character == QChar('_');
+   }
 
-      QRegExp amtUnit;
-      amtUnit.setPattern("((?:\\d+" + grouping + ")?\\d+(?:" + decimal + "\\d+)?|" + decimal + "\\d+)\\s*(\\w+)?");
-      amtUnit.setCaseSensitivity(Qt::CaseInsensitive);
+   /**
+    * \brief Copy the run of digits at \c position in \c text to the end of \c number, as the ASCII characters that
+    *        \c QByteArray::toDouble wants, and move \c position past them.
+    *
+    * \return \c false if some of the digits didn't fit in \c number
+    */
+   bool appendDigits(QString const & text,
+                     int & position,
+                     NumberBuffer & number,
+                     int & length) {
+      bool allFitted = true;
+      for (; position < text.size() && text.at(position).isDigit(); ++position) {
+         if (length < maxNumberLength) {
+            number[length++] = static_cast<char>('0' + text.at(position).digitValue());
+         } else {
+            allFitted = false;
+         }
+      }
+      return allFitted;
+   }
 
-      // If the regex dies, return 0.0
-      if (amtUnit.indexIn(input) == -1) {
+   /**
+    * \brief Given a string of number plus, optionally, some units or pseudo-units, extract the number (and ignore the
+    *        units or pseudo-units)
+    */
+   double extractRawDoubleFromString(QString const & input, bool * ok) {
+      std::optional<Measurement::ParsedAmount> const parsedAmount = Measurement::parseAmount(input);
+      if (!parsedAmount) {
          if (ok) {
             *ok = false;
             qWarning() << Q_FUNC_INFO << "Error parsing" << input << "as number";
@@ -94,17 +202,10 @@ namespace {
          return 0.0;
       }
 
-      QString numericPartOfInput = amtUnit.cap(1);
-      double returnValue = 0.0;
-      try {
-         returnValue = Localization::toDouble(numericPartOfInput, ok);
-      } catch (std::invalid_argument const & ex) {
-         qWarning() << Q_FUNC_INFO << "Could not parse" << numericPartOfInput << "as number:" << ex.what();
-      } catch(std::out_of_range const & ex) {
-         qWarning() << Q_FUNC_INFO << "Out of range parsing" << numericPartOfInput << "as number:" << ex.what();
+      if (ok) {
+         *ok = true;
       }
-
-      return returnValue;
+      return parsedAmount->quantity;
    }
 }
 
@@ -125,6 +226,73 @@ template<> int          Measurement::extractRawFromString<int>         (QString
 template<> unsigned int Measurement::extractRawFromString<unsigned int>(QString const & input, bool * ok) { return static_cast<unsigned int>(extractRawDoubleFromString(input, ok)); }
 template<> double       Measurement::extractRawFromString<double>      (QString const & input, bool * ok) { return                           extractRawDoubleFromString(input, ok);  }
 
+std::optional<Measurement::ParsedAmount> Measurement::parseAmount(QString const & text,
+                                                                   std::optional<QChar> decimalPoint,
+                                                                   std::optional<QChar> groupSeparator) {
+   QChar const decimal  = decimalPoint   ? *decimalPoint   : Localization::getLocale().decimalPoint();
+   QChar const grouping = groupSeparator ? *groupSeparator : Localization::getLocale().groupSeparator();
+
+   int const size = text.size();
+   auto digitAt = [&text, size](int const position) { return position < size && text.at(position).isDigit(); };
+
+   //
+   // This accepts the same numbers as the regexp we used to use, ie ((?:\d+G)?\d+(?:D\d+)?|D\d+) where G is the group
+   // separator and D the decimal point.  The number goes into a buffer on the stack without the group separator and
+   // with '.' as the decimal point, ready for QByteArray::toDouble, which, unlike std::strtod, doesn't depend on the C
+   // locale.  (Reading the C locale's decimal point with std::localeconv on every call wouldn't be thread-safe.)
+   //
+   for (int start = 0; start < size; ++start) {
+      bool const startsWithDigit = digitAt(start);
+      if (!startsWithDigit && !(text.at(start) == decimal && digitAt(start + 1))) {
+         continue;
+      }
+
+      NumberBuffer number;
+      int length = 0;
+      int position = start;
+      if (!startsWithDigit) {
+         // So we don't rely on the conversion accepting a number that starts with the decimal point
+         number[length++] = '0';
+      } else {
+         bool integerFitted = appendDigits(text, position, number, length);
+         if (position < size && text.at(position) == grouping && digitAt(position + 1)) {
+            ++position;
+            integerFitted = appendDigits(text, position, number, length) && integerFitted;
+         }
+         if (!integerFitted) {
+            qWarning() << Q_FUNC_INFO << "Number in" << text << "is too long";
+            return std::nullopt;
+         }
+      }
+      if (position < size && text.at(position) == decimal && digitAt(position + 1)) {
+         if (length < maxNumberLength) {
+            number[length++] = '.';
+         }
+         ++position;
+         // Any fractional digits that don't fit are too small to make a difference
+         appendDigits(text, position, number, length);
+      }
+
+      bool ok = false;
+      double const quantity = QByteArray::fromRawData(number.data(), length).toDouble(&ok);
+      if (!ok) {
+         qWarning() << Q_FUNC_INFO << "Could not convert number in" << text;
+         return std::nullopt;
+      }
+
+      while (position < size && text.at(position).isSpace()) {
+         ++position;
+      }
+      int const unitNameStart = position;
+      while (position < size && isWordCharacter(text.at(position))) {
+         ++position;
+      }
+      return Measurement::ParsedAmount{quantity, text.midRef(unitNameStart, position - unitNameStart)};
+   }
+
+   return std::nullopt;
+}
+
 void Measurement::loadDisplayScales() {
    for (Measurement::PhysicalQuantity const physicalQuantity : Measurement::allPhysicalQuantites) {
       loadDisplayScale(physicalQuantity,
@@ -150,6 +318,7 @@ void Measurement::setDisplayUnitSystem(Measurement::PhysicalQuantity physicalQua
       Q_FUNC_INFO << "Setting UnitSystem for" << Measurement::getDisplayName(physicalQuantity) << "to" <<
       unitSystem.uniqueName;
    physicalQuantityToDisplayUnitSystem.insert(physicalQuantity, &unitSystem);
+   ++displayUnitSystemChanges;
    return;
 }
 
@@ -176,8 +345,31 @@ Measurement::UnitSystem const & Measurement::getDisplayUnitSystem(Measurement::P
    return *unitSystem;
 }
 
+unsigned int Measurement::displayUnitSystemGeneration() {
+   return displayUnitSystemChanges;
+}
+
+double Measurement::DisplayCacheStatistics::hitRate() const {
+   unsigned long long const lookups = this->hits + this->misses;
+   return lookups ? static_cast<double>(this->hits) / static_cast<double>(lookups) : 0.0;
+}
+
+Measurement::DisplayCacheStatistics Measurement::displayCacheStatistics() {
+   return displayCache().statistics;
+}
+
+void Measurement::clearDisplayCache() {
+   DisplayCache & cache = displayCache();
+   cache.strings.clear();
+   cache.statistics = Measurement::DisplayCacheStatistics{};
+   return;
+}
+
 QString Measurement::displayQuantity(double quantity, int precision) {
-   return QString("%L1").arg(quantity, fieldWidth, format, precision);
+   return cachedDisplay(
+      DisplayCacheKey{cacheKeyFor(quantity), nullptr, precision, -1, -1},
+      [&]() { return QString("%L1").arg(quantity, fieldWidth, format, precision); }
+   );
 }
 
 QString Measurement::displayAmount(Measurement::Amount const & amount,
@@ -189,14 +381,21 @@ QString Measurement::displayAmount(Measurement::Amount const & amount,
       return "-";
    }
 
-   // If the caller told us (via forced system of measurement) what UnitSystem to use, use that, otherwise get whatever
-   // one we're using generally for related physical property.
-   PhysicalQuantity const physicalQuantity = amount.unit()->getPhysicalQuantity();
-   Measurement::UnitSystem const & displayUnitSystem =
-      forcedSystemOfMeasurement ? UnitSystem::getInstance(*forcedSystemOfMeasurement, physicalQuantity) :
-                                  Measurement::getDisplayUnitSystem(physicalQuantity);
-
-   return displayUnitSystem.displayAmount(amount, precision, forcedScale);
+   DisplayCacheKey const key{cacheKeyFor(amount.quantity()),
+                             amount.unit(),
+                             precision,
+                             cacheKeyFor(forcedSystemOfMeasurement),
+                             cacheKeyFor(forcedScale)};
+   return cachedDisplay(key, [&]() {
+      // If the caller told us (via forced system of measurement) what UnitSystem to use, use that, otherwise get
+      // whatever one we're using generally for related physical property.
+      PhysicalQuantity const physicalQuantity = amount.unit()->getPhysicalQuantity();
+      Measurement::UnitSystem const & displayUnitSystem =
+         forcedSystemOfMeasurement ? UnitSystem::getInstance(*forcedSystemOfMeasurement, physicalQuantity) :
+                                     Measurement::getDisplayUnitSystem(physicalQuantity);
+
+      return displayUnitSystem.displayAmount(amount, precision, forcedScale);
+   });
 }
 
 double Measurement::amountDisplay(Measurement::Amount const & amount,
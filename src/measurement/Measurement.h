@@ -43,6 +43,35 @@ namespace Measurement {
     */
    template<typename T> T extractRawFromString(QString const & input, bool * ok = nullptr);
 
+   /**
+    * \brief The number, and the word after it (if any), found in an amount typed in by the user -- eg 5.5 and "gal" in
+    *        "about 5.5 gal or so".
+    */
+   struct ParsedAmount {
+      double quantity;
+      //! Refers into the string that was parsed, so is only valid as long as that string is.  Empty if no units.
+      QStringRef unitName;
+   };
+
+   /**
+    * \brief Find the first number in \c text, and the word (typically a unit name) following it.  The number may have a
+    *        decimal point and a single group separator (eg "1,083.5" in the US or "1 083,5" in France), or just a
+    *        decimal point and digits (eg ".5").  Anything before the number is skipped.
+    *
+    *        This is what \c UnitSystem::qstringToSI uses to read what the user typed into an amount field, so it gets
+    *        called a lot.  It works directly on the characters of \c text, so it does not allocate any memory, and,
+    *        since it holds no state of its own, is safe to call from any thread.
+    *
+    * \param text
+    * \param decimalPoint Defaults to the decimal point of the current locale (see \c Localization::getLocale)
+    * \param groupSeparator Defaults to the digit group separator of the current locale
+    *
+    * \return \c std::nullopt if there is no number in \c text
+    */
+   std::optional<ParsedAmount> parseAmount(QString const & text,
+                                           std::optional<QChar> decimalPoint = std::nullopt,
+                                           std::optional<QChar> groupSeparator = std::nullopt);
+
    void loadDisplayScales();
    void saveDisplayScales();
 
@@ -62,6 +91,12 @@ namespace Measurement {
     */
    UnitSystem const & getDisplayUnitSystem(PhysicalQuantity physicalQuantity);
 
+   /**
+    * \brief Goes up by one every time a display \c UnitSystem is set, so that anything holding on to formatted amounts
+    *        can tell when they might need redoing
+    */
+   unsigned int displayUnitSystemGeneration();
+
    /*!
     * \brief Converts a quantity without units to a displayable string
     *
@@ -84,6 +119,24 @@ namespace Measurement {
                          std::optional<Measurement::SystemOfMeasurement> forcedSystemOfMeasurement = std::nullopt,
                          std::optional<Measurement::UnitSystem::RelativeScale> forcedScale = std::nullopt);
 
+   /**
+    * \brief \c displayQuantity and \c displayAmount remember what they returned for the last few thousand
+    *        different inputs, because table models and smart fields ask for the same few strings over and over (every
+    *        time a row is repainted).  The cache is per thread, and is emptied whenever a display \c UnitSystem or the
+    *        language changes.  These are its hit counts for the current thread.
+    */
+   struct DisplayCacheStatistics {
+      unsigned long long hits = 0;
+      unsigned long long misses = 0;
+
+      //! \brief Fraction of lookups that were hits, or 0 if there haven't been any
+      double hitRate() const;
+   };
+   DisplayCacheStatistics displayCacheStatistics();
+
+   //! \brief Empty the current thread's display cache and reset its statistics
+   void clearDisplayCache();
+
    /*!
     * \brief Converts a measurement (aka amount) to its numerical equivalent in the specified or default units.
     *
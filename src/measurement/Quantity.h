@@ -0,0 +1,230 @@
+/*
+ * measurement/Quantity.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MEASUREMENT_QUANTITY_H
+#define MEASUREMENT_QUANTITY_H
+#pragma once
+
+#include <type_traits>
+
+/*!
+ * \brief Quantities whose units are known at compile time, for the calculations in the model classes (IBUs, colour,
+ *        gravity, etc).
+ *
+ *        \c Measurement::Amount and \c Measurement::Unit are for amounts whose units we only find out at run time, eg
+ *        because the user typed "5 gal" into a field.  Each conversion there is a call through a \c std::function.
+ *        But the formulae in the model classes almost always know their units up front -- eg the MCU colour formula
+ *        wants pounds per US gallon -- and have traditionally done the conversions with hard-coded factors such as
+ *        8.34538.
+ *
+ *        With \c Quantity, a formula says what units it wants and the conversion factor is worked out at compile time:
+ *        \code
+ *           Measurement::Quantity<Measurement::StaticUnits::Pounds> const grain{
+ *              Measurement::Quantity<Measurement::StaticUnits::Kilograms>{fermentable.amount_kg()}
+ *           };
+ *        \endcode
+ *        compiles down to one multiplication by a constant.  Converting between quantities of different dimensions (eg
+ *        kilograms to liters) does not compile.
+ *
+ *        Each unit here is a linear function of the canonical unit of its dimension (the same canonical units
+ *        \c Measurement::Unit uses), ie canonical = (value + offset) * scale / scaleDenominator.  Units that aren't (eg
+ *        Plato) are only available through \c Measurement::Unit and \c Algorithms.
+ */
+namespace Measurement {
+
+   /**
+    * \brief Tags for what a quantity measures.  These correspond to some of the values of \c PhysicalQuantity, but
+    *        are types rather than values so that mixing them up is a compile error.
+    */
+   namespace Dimensions {
+      struct Mass        {};
+      struct Volume      {};
+      struct Temperature {};
+      struct Gravity     {};
+      struct Color       {};
+   }
+
+   /**
+    * \brief A unit known at compile time: its dimension, and how to get from it to the canonical unit.  The scale is a
+    *        fraction so that, eg, Celsius to Fahrenheit is exactly * 9 / 5 rather than * 1 / (5 / 9), and the offset is
+    *        in the unit itself (eg -32 for Fahrenheit) so that it is exact too.
+    */
+   template<class U, class = void> struct IsStaticUnit : std::false_type {};
+   template<class U> struct IsStaticUnit<U, std::void_t<typename U::Dimension,
+                                                        decltype(static_cast<double>(U::scale)),
+                                                        decltype(static_cast<double>(U::scaleDenominator)),
+                                                        decltype(static_cast<double>(U::offset))>> : std::true_type {};
+
+   //
+   // Older versions of GCC (eg as shipped with Ubuntu 20.04 LTS) have a sort of pre-release support for concepts so we
+   // have to use non-standard syntax there (and they don't have the <concepts> header either)
+   //
+#if defined(__linux__ ) && defined(__GNUC__) && (__GNUC__ < 10)
+   template<class U> concept bool StaticUnit = IsStaticUnit<U>::value;
+   template<class U1, class U2> concept bool SameDimension =
+      std::is_same_v<typename U1::Dimension, typename U2::Dimension>;
+#else
+   template<class U> concept StaticUnit = IsStaticUnit<U>::value;
+   template<class U1, class U2> concept SameDimension =
+      std::is_same_v<typename U1::Dimension, typename U2::Dimension>;
+#endif
+
+   /**
+    * \brief Units for \c Quantity.  Factors are the same as those of the corresponding \c Measurement::Units so that
+    *        the two give identical results.
+    */
+   namespace StaticUnits {
+      //! Most units are just a multiple of the canonical one for their dimension
+      template<class D, int Denominator = 1> struct Linear {
+         using Dimension = D;
+         static constexpr double scaleDenominator = Denominator;
+         static constexpr double offset = 0.0;
+      };
+
+      // == Mass ==  (Canonical unit is kilograms)
+      struct Kilograms       : Linear<Dimensions::Mass>           { static constexpr double scale = 1.0;             };
+      struct Grams           : Linear<Dimensions::Mass, 1000>     { static constexpr double scale = 1.0;             };
+      struct Milligrams      : Linear<Dimensions::Mass, 1000000>  { static constexpr double scale = 1.0;             };
+      struct Pounds          : Linear<Dimensions::Mass>           { static constexpr double scale = 0.45359237;      };
+      struct Ounces          : Linear<Dimensions::Mass>           { static constexpr double scale = 0.0283495231;    };
+
+      // == Volume ==  (Canonical unit is liters)
+      struct Liters          : Linear<Dimensions::Volume>         { static constexpr double scale = 1.0;             };
+      struct Milliliters     : Linear<Dimensions::Volume, 1000>   { static constexpr double scale = 1.0;             };
+      struct UsGallons       : Linear<Dimensions::Volume>         { static constexpr double scale = 3.7854117840007; };
+      struct ImperialGallons : Linear<Dimensions::Volume>         { static constexpr double scale = 4.5460899999997; };
+
+      // == Temperature ==  (Canonical unit is Celsius)
+      struct Celsius         : Linear<Dimensions::Temperature>    { static constexpr double scale = 1.0;             };
+      struct Fahrenheit {
+         using Dimension = Dimensions::Temperature;
+         static constexpr double scale            = 5.0;
+         static constexpr double scaleDenominator = 9.0;
+         static constexpr double offset           = -32.0;
+      };
+
+      // == Gravity ==  (Canonical unit is specific gravity)
+      struct SpecificGravity : Linear<Dimensions::Gravity>        { static constexpr double scale = 1.0;             };
+      //! Thousandths above 1, eg 1.050 is 50 points
+      struct GravityPoints {
+         using Dimension = Dimensions::Gravity;
+         static constexpr double scale            = 1.0;
+         static constexpr double scaleDenominator = 1000.0;
+         static constexpr double offset           = 1000.0;
+      };
+
+      // == Color ==  (Canonical unit is SRM.  As in Measurement::Units, we treat Lovibond as the same as SRM.)
+      struct Srm             : Linear<Dimensions::Color>          { static constexpr double scale = 1.0;             };
+      struct Ebc             : Linear<Dimensions::Color, 25>      { static constexpr double scale = 12.7;            };
+      struct Lovibond        : Linear<Dimensions::Color>          { static constexpr double scale = 1.0;             };
+   }
+
+   /**
+    * \brief How to get from a value in \c From to a value in \c To.  The factor is worked out at compile time, so a
+    *        conversion is one multiplication, plus an addition or two for units with an offset (ie temperatures).
+    */
+   template<StaticUnit From, StaticUnit To> requires SameDimension<From, To>
+   struct StaticConversion {
+      static constexpr double factor = (From::scale * To::scaleDenominator) / (From::scaleDenominator * To::scale);
+
+      static constexpr double convert(double const value) {
+         double result = value;
+         if constexpr (From::offset != 0.0) {
+            result += From::offset;
+         }
+         result *= factor;
+         if constexpr (To::offset != 0.0) {
+            result -= To::offset;
+         }
+         return result;
+      }
+   };
+
+   /**
+    * \brief Factor to convert a ratio of two quantities from one pair of units to another, eg kilograms per liter to
+    *        pounds per US gallon.  (Only makes sense for units without an offset.)
+    */
+   template<StaticUnit FromNumerator, StaticUnit FromDenominator, StaticUnit ToNumerator, StaticUnit ToDenominator>
+   requires (FromNumerator::offset == 0.0 && FromDenominator::offset == 0.0 &&
+             ToNumerator::offset   == 0.0 && ToDenominator::offset   == 0.0)
+   inline constexpr double ratioConversionFactor = StaticConversion<FromNumerator,   ToNumerator  >::factor /
+                                                   StaticConversion<FromDenominator, ToDenominator>::factor;
+
+   /**
+    * \brief An amount of something in unit \c U, eg \c Quantity<StaticUnits::Pounds>.  It's just a \c double, so
+    *        costs nothing to pass around.
+    *
+    *        A quantity in another unit of the same dimension converts implicitly (eg you can pass kilograms where
+    *        pounds are wanted), but raw numbers have to be wrapped explicitly, which is where we say what units they
+    *        are in.
+    */
+   template<StaticUnit U> class Quantity {
+   public:
+      using Unit = U;
+
+      constexpr explicit Quantity(double const value) : m_value{value} {
+         return;
+      }
+
+      template<StaticUnit Other> requires SameDimension<U, Other>
+      constexpr Quantity(Quantity<Other> const other) : m_value{StaticConversion<Other, U>::convert(other.value())} {
+         return;
+      }
+
+      //! \brief The number of \c U
+      constexpr double value() const {
+         return this->m_value;
+      }
+
+      //! \brief The same quantity in the canonical unit of its dimension, ie what we would store in the database
+      constexpr double canonical() const {
+         return (this->m_value + U::offset) * (U::scale / U::scaleDenominator);
+      }
+
+      constexpr bool operator==(Quantity const other) const { return this->m_value == other.m_value; }
+      constexpr bool operator!=(Quantity const other) const { return this->m_value != other.m_value; }
+      constexpr bool operator< (Quantity const other) const { return this->m_value <  other.m_value; }
+      constexpr bool operator<=(Quantity const other) const { return this->m_value <= other.m_value; }
+      constexpr bool operator> (Quantity const other) const { return this->m_value >  other.m_value; }
+      constexpr bool operator>=(Quantity const other) const { return this->m_value >= other.m_value; }
+
+      constexpr Quantity operator+(Quantity const other) const {
+         return Quantity{this->m_value + other.m_value};
+      }
+      constexpr Quantity operator-(Quantity const other) const {
+         return Quantity{this->m_value - other.m_value};
+      }
+      constexpr Quantity operator*(double const multiplier) const {
+         return Quantity{this->m_value * multiplier};
+      }
+      constexpr Quantity operator/(double const divisor) const {
+         return Quantity{this->m_value / divisor};
+      }
+
+      //! \brief Ratio of two quantities of the same dimension, eg how many times bigger one volume is than another
+      constexpr double operator/(Quantity const other) const {
+         return this->m_value / other.m_value;
+      }
+
+   private:
+      double m_value;
+   };
+
+}
+
+#endif
@@ -18,6 +18,7 @@
  */
 #include "measurement/SucroseConversion.h"
 
+#include <algorithm>
 #include <array>
 
 //
@@ -44,7 +45,7 @@
 //         I found to avoid copying this data on to the heap (which would be unnecessary since it's const and known at
 //         compile time).
 //
-Measurement::SucroseConversion const Measurement::sucroseConversions[] = {
+Measurement::SucroseConversion constexpr Measurement::sucroseConversions[] = {
    // Refractive Index at 20°C  ||  % sucrose or degree Brix  ||  Apparent specific gravity @ 20/20 °C
    {  1.3330,                       0.0,                          1.00000  },
    {  1.3331,                       0.1,                          1.00039  }, // The PDF has this as 0.0 Brix, but I think that's clearly a typo
@@ -850,3 +851,64 @@ Measurement::SucroseConversion const Measurement::sucroseConversions[] = {
 };
 
 size_t constexpr Measurement::sucroseConversions_size = std::size(Measurement::sucroseConversions);
+
+namespace {
+   std::size_t constexpr numSgBuckets = static_cast<std::size_t>(
+      (Measurement::sucroseConversions[Measurement::sucroseConversions_size - 1].apparentSgAt2020C -
+       Measurement::sucroseSgBuckets_minSg) / Measurement::sucroseSgBuckets_width
+   ) + 1;
+
+   template<double Measurement::SucroseConversion::* member>
+   constexpr std::array<double, Measurement::sucroseConversions_size> makeColumn() {
+      std::array<double, Measurement::sucroseConversions_size> column{};
+      for (std::size_t ii = 0; ii < Measurement::sucroseConversions_size; ++ii) {
+         column[ii] = Measurement::sucroseConversions[ii].*member;
+      }
+      return column;
+   }
+
+   constexpr std::array<std::uint16_t, numSgBuckets> makeRowBySgBucket() {
+      std::array<std::uint16_t, numSgBuckets> rowBySgBucket{};
+      std::size_t row = 0;
+      for (std::size_t bucket = 0; bucket < numSgBuckets; ++bucket) {
+         double const bucketStart = Measurement::sucroseSgBuckets_minSg + bucket * Measurement::sucroseSgBuckets_width;
+         while (row + 1 < Measurement::sucroseConversions_size &&
+                Measurement::sucroseConversions[row + 1].apparentSgAt2020C <= bucketStart) {
+            ++row;
+         }
+         // We always want there to be a next row to interpolate towards
+         rowBySgBucket[bucket] = static_cast<std::uint16_t>(std::min(row, Measurement::sucroseConversions_size - 2));
+      }
+      return rowBySgBucket;
+   }
+
+   //! \brief Checks the assumptions we make about the data in the lookups
+   constexpr bool tableIsSuitableForLookups() {
+      for (std::size_t ii = 0; ii < Measurement::sucroseConversions_size; ++ii) {
+         // Allow a little leeway for the fact that 0.1 is not exactly representable in binary floating point
+         double const brixError =
+            Measurement::sucroseConversions[ii].degreesBrix - ii * Measurement::sucroseConversions_brixStep;
+         if (brixError > 1e-9 || brixError < -1e-9) {
+            return false;
+         }
+         if (ii > 0 &&
+             Measurement::sucroseConversions[ii].apparentSgAt2020C -
+             Measurement::sucroseConversions[ii - 1].apparentSgAt2020C <= Measurement::sucroseSgBuckets_width) {
+            return false;
+         }
+      }
+      return Measurement::sucroseConversions[0].apparentSgAt2020C == Measurement::sucroseSgBuckets_minSg;
+   }
+   static_assert(tableIsSuitableForLookups(),
+                 "Sucrose conversion table must have evenly-spaced Brix and SG gaps wider than the lookup buckets");
+
+   std::array<double, Measurement::sucroseConversions_size> constexpr sgColumn =
+      makeColumn<&Measurement::SucroseConversion::apparentSgAt2020C>();
+   std::array<double, Measurement::sucroseConversions_size> constexpr brixColumn =
+      makeColumn<&Measurement::SucroseConversion::degreesBrix>();
+   std::array<std::uint16_t, numSgBuckets> constexpr rowBySgBucket = makeRowBySgBucket();
+}
+
+BtSpan::span<double const>        const Measurement::sucroseSgColumn     {sgColumn};
+BtSpan::span<double const>        const Measurement::sucroseBrixColumn   {brixColumn};
+BtSpan::span<std::uint16_t const> const Measurement::sucroseRowBySgBucket{rowBySgBucket};
@@ -1,6 +1,6 @@
 /*
  * measurement/SucroseConversion.h is part of Brewtarget, and is copyright the following
- * authors 2022:
+ * authors 2022-2023:
  * - Matt Young <mfsy@yahoo.com>
  *
  * Brewtarget is free software: you can redistribute it and/or modify
@@ -21,6 +21,9 @@
 #pragma once
 
 #include <cstddef> // For size_t
+#include <cstdint>
+
+#include "utils/Span.h"
 
 namespace Measurement {
 
@@ -33,6 +36,30 @@ namespace Measurement {
    extern SucroseConversion const sucroseConversions[];
 
    extern size_t const sucroseConversions_size;
+
+   //
+   // The remaining declarations are derived (at compile time) from sucroseConversions and are laid out for fast lookup
+   // rather than readability.  See Algorithms::SgAt20CToBrix and Algorithms::BrixToSgAt20C for how they are used.
+   //
+
+   //! \brief The Brix column of \c sucroseConversions is at these exact intervals, starting from 0°Bx
+   double constexpr sucroseConversions_brixStep = 0.1;
+
+   //! \brief The apparent SG column of \c sucroseConversions, so element \c i is the SG at \c i × 0.1°Bx
+   extern BtSpan::span<double const> const sucroseSgColumn;
+
+   //! \brief The Brix column of \c sucroseConversions
+   extern BtSpan::span<double const> const sucroseBrixColumn;
+
+   //
+   // The SG column isn't evenly spaced, so, to find where an SG lies in it without searching, we divide the SG range
+   // into equal-width buckets, starting at SG 1.000.  Element \c b of \c sucroseRowBySgBucket is the last row of
+   // \c sucroseConversions whose SG is at or below the start of bucket \c b.  Buckets are narrower than the smallest
+   // SG gap between rows, so any SG in bucket \c b lies in that row's interval or the next one.
+   //
+   double constexpr sucroseSgBuckets_minSg = 1.000;
+   double constexpr sucroseSgBuckets_width = 0.00025;
+   extern BtSpan::span<std::uint16_t const> const sucroseRowBySgBucket;
 }
 
 #endif
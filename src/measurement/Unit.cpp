@@ -27,52 +27,35 @@
 #include <string>
 
 #include <QStringList>
-#include <QRegExp>
+#include <QVector>
 #include <QDebug>
 
 #include "Algorithms.h"
-#include "Localization.h"
 #include "measurement/Measurement.h"
 #include "measurement/UnitSystem.h"
 
 namespace {
 
-   QRegExp getRegExpToMatchAmountPlusUnits() {
-      QRegExp amtUnit;
-
-      // Make sure we get the right decimal point (. or ,) and the right grouping
-      // separator (, or .). Some locales write 1.000,10 and other write
-      // 1,000.10. We need to catch both
-      QString const decimal =  QRegExp::escape(Localization::getLocale().decimalPoint());
-      QString const grouping = QRegExp::escape(Localization::getLocale().groupSeparator());
-
-      amtUnit.setPattern("((?:\\d+" + grouping + ")?\\d+(?:" + decimal + "\\d+)?|" + decimal + "\\d+)\\s*(\\w+)?");
-      amtUnit.setCaseSensitivity(Qt::CaseInsensitive);
-
-      return amtUnit;
-   }
-
    QString unitNameFromAmountString(QString const & qstr) {
-      QRegExp amtUnit = getRegExpToMatchAmountPlusUnits();
+      std::optional<Measurement::ParsedAmount> const parsedAmount = Measurement::parseAmount(qstr);
 
-      // if the regex dies, return ?
-      if (amtUnit.indexIn(qstr) == -1) {
+      // if the parse fails, return ?
+      if (!parsedAmount) {
          return QString("?");
       }
 
-      // Get the unit from the second capture
-      return amtUnit.cap(2);
+      return parsedAmount->unitName.toString();
    }
 
    double quantityFromAmountString(QString const & qstr) {
-      QRegExp amtUnit = getRegExpToMatchAmountPlusUnits();
+      std::optional<Measurement::ParsedAmount> const parsedAmount = Measurement::parseAmount(qstr);
 
-      // if the regex dies, return 0.0
-      if (amtUnit.indexIn(qstr) == -1) {
+      // if the parse fails, return 0.0
+      if (!parsedAmount) {
          return 0.0;
       }
 
-      return Localization::toDouble(amtUnit.cap(1), Q_FUNC_INFO);
+      return parsedAmount->quantity;
    }
 
    /**
@@ -119,6 +102,94 @@ namespace {
 
    QMap<Measurement::PhysicalQuantity, Measurement::Unit const *> physicalQuantityToCanonicalUnit;
 
+   /**
+    * \brief Case-insensitive look-up of the unit names for one \c PhysicalQuantity, for \c Unit::findUnit.
+    *
+    *        When we build the table, we try hash seeds (and, if need be, bigger tables) until we find one where no two
+    *        names land in the same slot -- ie a perfect hash.  There are only a dozen or so names per table, so this
+    *        is quick, and it means a look-up is one pass over the name to hash it and one comparison, without having to
+    *        make a lower-case copy of the name first.
+    */
+   class UnitNameTable {
+   public:
+      UnitNameTable() : m_seed{0}, m_slots{} {
+         return;
+      }
+
+      /**
+       * \param unitsByLowerCaseName For each lower-case name, the units with that name, in the order \c getUnit would
+       *                             consider them.
+       */
+      void build(QMap<QString, QList<Measurement::Unit const *>> const & unitsByLowerCaseName) {
+         int numSlots = 4;
+         while (numSlots < 2 * unitsByLowerCaseName.size()) {
+            numSlots *= 2;
+         }
+         for (;; numSlots *= 2) {
+            for (uint seed = 0; seed < maxSeedsPerSize; ++seed) {
+               QVector<Slot> slots(numSlots);
+               bool collision = false;
+               for (auto ii = unitsByLowerCaseName.cbegin(); ii != unitsByLowerCaseName.cend(); ++ii) {
+                  Slot & slot = slots[slotFor(ii.key().constData(), ii.key().size(), seed, numSlots)];
+                  if (!slot.units.isEmpty()) {
+                     collision = true;
+                     break;
+                  }
+                  slot = Slot{ii.key(), ii.value()};
+               }
+               if (!collision) {
+                  this->m_seed = seed;
+                  this->m_slots = slots;
+                  return;
+               }
+            }
+         }
+      }
+
+      //! \return \c nullptr if there are no units called \c name
+      QList<Measurement::Unit const *> const * find(QStringRef const & name) const {
+         if (name.isEmpty() || this->m_slots.isEmpty()) {
+            return nullptr;
+         }
+         int const slotIndex = slotFor(name.constData(), name.size(), this->m_seed, this->m_slots.size());
+         Slot const & slot = this->m_slots.at(slotIndex);
+         if (slot.lowerCaseName.size() != name.size()) {
+            return nullptr;
+         }
+         for (int ii = 0; ii < name.size(); ++ii) {
+            if (name.at(ii).toLower() != slot.lowerCaseName.at(ii)) {
+               return nullptr;
+            }
+         }
+         return &slot.units;
+      }
+
+   private:
+      struct Slot {
+         QString lowerCaseName;
+         QList<Measurement::Unit const *> units;
+      };
+
+      static constexpr uint maxSeedsPerSize = 1000;
+
+      //! \brief FNV-1a hash of the lower-case version of \c name, mixed with \c seed
+      static int slotFor(QChar const * name, int const length, uint const seed, int const numSlots) {
+         uint hash = 2166136261u ^ (seed * 0x9E3779B9u);
+         for (int ii = 0; ii < length; ++ii) {
+            hash ^= name[ii].toLower().unicode();
+            hash *= 16777619u;
+         }
+         hash ^= hash >> 16;
+         // numSlots is always a power of two
+         return static_cast<int>(hash & static_cast<uint>(numSlots - 1));
+      }
+
+      uint m_seed;
+      QVector<Slot> m_slots;
+   };
+
+   QMap<Measurement::PhysicalQuantity, UnitNameTable> unitNameTables;
+
    /**
     * \brief Get all units matching a given name and physical quantity
     *
@@ -251,6 +322,15 @@ void Measurement::Unit::initialiseLookups() {
          physicalQuantityToCanonicalUnit.insert(physicalQuantity, unit);
       }
    }
+
+   QMap<Measurement::PhysicalQuantity, QMap<QString, QList<Measurement::Unit const *>>> unitsByPhysicalQuantity;
+   for (auto const & key : unitNameLookup.uniqueKeys()) {
+      // Same list, in the same order, as getUnitsByNameAndPhysicalQuantity() would give
+      unitsByPhysicalQuantity[key.physicalQuantity].insert(key.lowerCaseUnitName, unitNameLookup.values(key));
+   }
+   for (auto ii = unitsByPhysicalQuantity.cbegin(); ii != unitsByPhysicalQuantity.cend(); ++ii) {
+      unitNameTables[ii.key()].build(ii.value());
+   }
    return;
 }
 
@@ -413,6 +493,29 @@ Measurement::Unit const * Measurement::Unit::getUnit(QString const & name,
    return matches.at(0);
 }
 
+Measurement::Unit const * Measurement::Unit::findUnit(QStringRef const & name,
+                                                      Measurement::UnitSystem const & unitSystem) {
+   // Need this before we reference unitNameTables
+   std::call_once(initFlag_Lookups, &Measurement::Unit::initialiseLookups);
+
+   auto const table = unitNameTables.constFind(unitSystem.getPhysicalQuantity());
+   if (table == unitNameTables.constEnd()) {
+      return nullptr;
+   }
+   QList<Measurement::Unit const *> const * matches = table->find(name);
+   if (!matches) {
+      return nullptr;
+   }
+
+   // As in getUnit(), we prefer a match in the supplied UnitSystem, otherwise the first in the list will have to do
+   for (auto const match : *matches) {
+      if (match->getUnitSystem() == unitSystem) {
+         return match;
+      }
+   }
+   return matches->at(0);
+}
+
 // This is where we actually define all the different units and how to convert them to/from their canonical equivalents
 // Previously this was done with a huge number of subclasses, but lambdas mean that's no longer necessary
 // Note that we always need to define the canonical Unit for a given PhysicalQuantity before any others
@@ -179,6 +179,18 @@ namespace Measurement {
                                   Measurement::UnitSystem const & unitSystem,
                                   bool const caseInensitiveMatching = true);
 
+      /**
+       * \brief Gives the same result as \c getUnit(name, unitSystem, true), but is quicker and does not allocate any
+       *        memory, as it looks \c name up in a perfect hash table of the unit names for the \c PhysicalQuantity of
+       *        \c unitSystem.  This is for parsing amounts typed in by the user -- see \c UnitSystem::qstringToSI.
+       *
+       * \param name Typically the \c unitName from \c Measurement::parseAmount
+       * \param unitSystem
+       *
+       * \return \c nullptr if no sane match could be found
+       */
+      static Unit const * findUnit(QStringRef const & name, Measurement::UnitSystem const & unitSystem);
+
       /**
        * \brief Get the canonical \c Unit for a given \c PhysicalQuantity.  This will be the unit we use for storing
        *        amounts of this type in the database - eg we always store volumes in liters and mass in kilograms.
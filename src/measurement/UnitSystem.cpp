@@ -24,9 +24,8 @@
 
 #include <QApplication>
 #include <QDebug>
-#include <QRegExp>
 
-#include "Localization.h"
+#include "measurement/Measurement.h"
 #include "measurement/Unit.h"
 #include "utils/EnumStringMapping.h"
 
@@ -184,26 +183,18 @@ bool Measurement::UnitSystem::operator==(UnitSystem const & other) const {
 }
 
 Measurement::Amount Measurement::UnitSystem::qstringToSI(QString qstr, Unit const & defUnit) const {
-   // All functions in QRegExp are reentrant, so it should be safe to use as a shared const in multi-threaded code.
-   static QRegExp const amtUnit {
-      // Make sure we get the right decimal point (. or ,) and the right grouping separator (, or .).  Some locales
-      // write 1.000,10 and others write 1,000.10.  We need to catch both.
-      "((?:\\d+" + QRegExp::escape(Localization::getLocale().groupSeparator()) + ")?\\d+(?:" +
-      QRegExp::escape(Localization::getLocale().decimalPoint()) + "\\d+)?|" +
-      QRegExp::escape(Localization::getLocale().decimalPoint()) + "\\d+)\\s*(\\w+)?",
-      Qt::CaseInsensitive
-   };
+   //
+   // This gets called a lot (eg for every amount the user types in), so, on the normal path, we don't log anything,
+   // and neither parsing the string nor looking up the unit name allocates any memory.
+   //
+   std::optional<Measurement::ParsedAmount> const parsedAmount = Measurement::parseAmount(qstr);
 
    // make sure we can parse the string
-   if (amtUnit.indexIn(qstr) == -1) {
+   if (!parsedAmount) {
       qDebug() << Q_FUNC_INFO << "Unable to parse" << qstr;
       return Amount{0.0, Measurement::Unit::getCanonicalUnit(this->pimpl->physicalQuantity)};
    }
 
-   double const amt = Localization::toDouble(amtUnit.cap(1), Q_FUNC_INFO);
-
-   QString const unitName = amtUnit.cap(2);
-
    // Look first in this unit system. If you can't find it here, find it
    // globally. I *think* this finally has all the weird magic right. If the
    // field is marked as "Imperial" and you enter "3 qt" you get 3 imperial
@@ -212,30 +203,23 @@ Measurement::Amount Measurement::UnitSystem::qstringToSI(QString qstr, Unit cons
    // as US Customary.
 
    Unit const * unitToUse = nullptr;
-   if (!unitName.isEmpty()) {
-      // Unit::getUnit() will, by preference, match to a unit in the current UnitSystem if possible.  If not, it will
+   if (!parsedAmount->unitName.isEmpty()) {
+      // Unit::findUnit() will, by preference, match to a unit in the current UnitSystem if possible.  If not, it will
       // match to a unit in another UnitSystem for the same PhysicalQuantity.  If there are no matches that way, it will
       // return nullptr;
-      unitToUse = Unit::getUnit(unitName, *this, true);
-      if (unitToUse) {
-         qDebug() << Q_FUNC_INFO << this->uniqueName << ":" << unitName << "interpreted as" << unitToUse->name;
-      } else {
+      unitToUse = Unit::findUnit(parsedAmount->unitName, *this);
+      if (!unitToUse) {
          qDebug() <<
-            Q_FUNC_INFO << this->uniqueName << ":" << unitName << "not recognised for" << this->pimpl->physicalQuantity;
+            Q_FUNC_INFO << this->uniqueName << ":" << parsedAmount->unitName << "not recognised for" <<
+            this->pimpl->physicalQuantity << "; defaulting to" << defUnit;
       }
    }
 
    if (!unitToUse) {
-      qDebug() << Q_FUNC_INFO << "Defaulting to" << defUnit;
       unitToUse = &defUnit;
    }
 
-   Measurement::Amount siAmount = unitToUse->toCanonical(amt);
-   qDebug() <<
-      Q_FUNC_INFO << this->uniqueName << ": " << qstr << "is" << amt << " " << unitToUse->name << "=" <<
-      siAmount.quantity() << "in" << siAmount.unit()->name;
-
-   return siAmount;
+   return unitToUse->toCanonical(parsedAmount->quantity);
 }
 
 QString Measurement::UnitSystem::displayAmount(Measurement::Amount const & amount,
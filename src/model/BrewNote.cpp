@@ -21,6 +21,7 @@
 #include "model/BrewNote.h"
 
 #include <algorithm>
+#include <cmath>
 #include <QDebug>
 #include <QObject>
 #include <QRegExp>
@@ -29,6 +30,7 @@
 #include "Algorithms.h"
 #include "database/ObjectStoreWrapper.h"
 #include "Localization.h"
+#include "measurement/Quantity.h"
 #include "model/Equipment.h"
 #include "model/Mash.h"
 #include "model/MashStep.h"
@@ -41,6 +43,11 @@
 static const QString kSugarKg("sugar_kg");
 static const QString kSugarKg_IgnoreEff("sugar_kg_ignoreEfficiency");
 
+namespace {
+   using Points          = Measurement::Quantity<Measurement::StaticUnits::GravityPoints>;
+   using SpecificGravity = Measurement::Quantity<Measurement::StaticUnits::SpecificGravity>;
+}
+
 
 // BrewNote doesn't use its name field, so we sort by brew date
 // TBD: Could consider copying date into name field and leaving the default ordering
@@ -155,7 +162,9 @@ BrewNote::BrewNote(QDate dateNow, QString const & name) :
    m_projPoints       {0.0    },
    m_projFermPoints   {0.0    },
    m_projAtten        {0.0    },
-   m_recipeId         {-1     } {
+   m_recipeId         {-1     },
+   m_unstoredGravityReadings{},
+   m_fermentation     {       } {
    return;
 }
 
@@ -192,7 +201,9 @@ BrewNote::BrewNote(NamedParameterBundle const & namedParameterBundle) :
    m_projPoints       {namedParameterBundle.val<double >(PropertyNames::BrewNote::projPoints       )},
    m_projFermPoints   {namedParameterBundle.val<double >(PropertyNames::BrewNote::projFermPoints   )},
    m_projAtten        {namedParameterBundle.val<double >(PropertyNames::BrewNote::projAtten        )},
-   m_recipeId         {namedParameterBundle.val<int    >(PropertyNames::BrewNote::recipeId         )} {
+   m_recipeId         {namedParameterBundle.val<int    >(PropertyNames::BrewNote::recipeId         )},
+   m_unstoredGravityReadings{},
+   m_fermentation     {} {
    return;
 }
 
@@ -332,7 +343,15 @@ BrewNote::BrewNote(BrewNote const& other) :
    m_projABV_pct      {other.m_projABV_pct      },
    m_projPoints       {other.m_projPoints       },
    m_projFermPoints   {other.m_projFermPoints   },
-   m_projAtten        {other.m_projAtten        } {
+   m_projAtten        {other.m_projAtten        },
+   m_unstoredGravityReadings{},
+   m_fermentation     {other.fermentation()     } {
+   // The copy isn't in the DB yet, so its readings wait until it is
+   for (auto gravityReading : other.gravityReadings()) {
+      auto copiedReading = std::make_shared<GravityReading>(*gravityReading);
+      copiedReading->setBrewNoteId(-1);
+      this->m_unstoredGravityReadings.append(copiedReading);
+   }
    return;
 }
 
@@ -381,6 +400,9 @@ void BrewNote::setVolumeIntoBK_l(double var) {
 
 void BrewNote::setOg(double var) {
    this->setAndNotify(PropertyNames::BrewNote::og, this->m_og, var);
+   if (this->m_fermentation) {
+      this->m_fermentation->setOg(this->m_og);
+   }
 
    if ( ! loading ) {
       calculateBrewHouseEff_pct();
@@ -416,7 +438,7 @@ void BrewNote::setProjPoints(double var) {
    } else {
       double plato = Algorithms::getPlato(var, m_projVolIntoBK_l);
       double total_g = Algorithms::PlatoToSG_20C20C( plato );
-      double convertPnts = (total_g - 1.0 ) * 1000;
+      double convertPnts = Points{SpecificGravity{total_g}}.value();
 
       this->setAndNotify(PropertyNames::BrewNote::projPoints, this->m_projPoints, convertPnts);
    }
@@ -428,7 +450,7 @@ void BrewNote::setProjFermPoints(double var) {
    } else {
       double plato = Algorithms::getPlato(var, m_projVolIntoFerm_l);
       double total_g = Algorithms::PlatoToSG_20C20C( plato );
-      double convertPnts = (total_g - 1.0 ) * 1000;
+      double convertPnts = Points{SpecificGravity{total_g}}.value();
 
       this->setAndNotify(PropertyNames::BrewNote::projFermPoints, this->m_projFermPoints, convertPnts);
    }
@@ -514,6 +536,132 @@ void BrewNote::setBoilOff_l(double var) {
    this->setAndNotify(PropertyNames::BrewNote::boilOff_l, this->m_boilOff_l, var);
 }
 
+void BrewNote::addGravityReading(QDateTime const & when, double sg, double temp_c) {
+   FermentationCurve::Reading const reading{when.toMSecsSinceEpoch() / 3'600'000.0, sg};
+   FermentationCurve::Series & fermentation = this->fermentation();
+
+   // A second reading at the same time is a correction (see FermentationCurve::Series::add), so it updates the
+   // existing row rather than adding one.  The readings are in time order, so we only have to look at all of them if
+   // the new one isn't the latest.
+   QVector<FermentationCurve::Reading> const & readings = fermentation.readings();
+   bool const isCorrection = !readings.isEmpty() && reading.time_h <= readings.last().time_h && std::binary_search(
+      readings.begin(),
+      readings.end(),
+      reading,
+      [](FermentationCurve::Reading const & lhs, FermentationCurve::Reading const & rhs) {
+         return lhs.time_h < rhs.time_h;
+      }
+   );
+   std::shared_ptr<GravityReading> gravityReading;
+   if (isCorrection) {
+      for (auto existing : this->gravityReadings()) {
+         if (existing->time_h() == reading.time_h) {
+            gravityReading = existing;
+            break;
+         }
+      }
+   }
+
+   if (gravityReading) {
+      gravityReading->setSg(sg);
+      gravityReading->setTemp_c(temp_c);
+   } else {
+      gravityReading = std::make_shared<GravityReading>();
+      gravityReading->setTime_h(reading.time_h);
+      gravityReading->setSg(sg);
+      gravityReading->setTemp_c(temp_c);
+      if (this->key() > 0) {
+         gravityReading->setBrewNoteId(this->key());
+         ObjectStoreWrapper::insert(gravityReading);
+      } else {
+         this->m_unstoredGravityReadings.append(gravityReading);
+      }
+   }
+
+   fermentation.add(reading);
+   return;
+}
+
+void BrewNote::removeGravityReading(int index) {
+   FermentationCurve::Series & fermentation = this->fermentation();
+   if (index < 0 || index >= fermentation.readings().size()) {
+      qWarning() << Q_FUNC_INFO << "No gravity reading #" << index << "on BrewNote #" << this->key();
+      return;
+   }
+   double const time_h = fermentation.readings()[index].time_h;
+   fermentation.remove(index);
+
+   for (auto gravityReading : this->gravityReadings()) {
+      if (gravityReading->time_h() == time_h) {
+         if (this->key() > 0) {
+            ObjectStoreWrapper::hardDelete<GravityReading>(gravityReading);
+         } else {
+            this->m_unstoredGravityReadings.removeOne(gravityReading);
+         }
+         break;
+      }
+   }
+   return;
+}
+
+QList<std::shared_ptr<GravityReading>> BrewNote::gravityReadings() const {
+   //
+   // As with Mash and MashStep, it's the GravityReading that knows which BrewNote it belongs to, so we have to ask,
+   // unless we're not yet in the DB.
+   //
+   int const brewNoteId = this->key();
+   if (brewNoteId <= 0) {
+      return this->m_unstoredGravityReadings;
+   }
+   return ObjectStoreWrapper::findAllMatching<GravityReading>(
+      [brewNoteId](std::shared_ptr<GravityReading> gravityReading) {
+         return gravityReading->brewNoteId() == brewNoteId && !gravityReading->deleted();
+      }
+   );
+}
+
+FermentationCurve::Series & BrewNote::fermentation() const {
+   if (!this->m_fermentation) {
+      // Adding the readings in time order means the fit is only done once
+      QList<std::shared_ptr<GravityReading>> gravityReadings = this->gravityReadings();
+      std::sort(gravityReadings.begin(),
+                gravityReadings.end(),
+                [](std::shared_ptr<GravityReading> const & lhs, std::shared_ptr<GravityReading> const & rhs) {
+                   return lhs->time_h() < rhs->time_h();
+                });
+      FermentationCurve::Series series{this->m_og};
+      for (auto const & gravityReading : gravityReadings) {
+         series.add(gravityReading->reading());
+      }
+      this->m_fermentation = std::move(series);
+   }
+   return *this->m_fermentation;
+}
+
+void BrewNote::setKey(int key) {
+   // First call the base class function
+   this->NamedEntity::setKey(key);
+   if (key <= 0) {
+      return;
+   }
+   // Now give our ID (key) to any readings that were waiting for it
+   for (auto gravityReading : this->m_unstoredGravityReadings) {
+      gravityReading->setBrewNoteId(key);
+      ObjectStoreWrapper::insert(gravityReading);
+   }
+   this->m_unstoredGravityReadings.clear();
+   return;
+}
+
+void BrewNote::hardDeleteOwnedEntities() {
+   // It's the GravityReading that stores its BrewNote ID, so all we need to do is delete our GravityReadings then the
+   // subsequent database delete of this BrewNote won't hit any foreign key problems.
+   for (auto gravityReading : this->gravityReadings()) {
+      ObjectStoreWrapper::hardDelete<GravityReading>(*gravityReading);
+   }
+   return;
+}
+
 void BrewNote::setRecipeId(int recipeId) { this->m_recipeId = recipeId; }
 void BrewNote::setRecipe(Recipe * recipe) {
    Q_ASSERT(nullptr != recipe);
@@ -566,6 +714,12 @@ double BrewNote::projFermPoints() const { return m_projFermPoints; }
 double BrewNote::projAtten() const { return m_projAtten; }
 double BrewNote::boilOff_l() const { return m_boilOff_l; }
 int    BrewNote::getRecipeId() const { return this->m_recipeId; }
+QVector<FermentationCurve::Reading> const & BrewNote::gravityReadingsList() const { return this->fermentation().readings(); }
+FermentationCurve::Prediction BrewNote::fermentationPrediction() const { return this->fermentation().prediction(); }
+
+QDateTime BrewNote::readingTime(double time_h) {
+   return QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(std::llround(time_h * 3'600'000.0)));
+}
 
 // calculators -- these kind of act as both setters and getters.  Likely bad
 // form
@@ -578,7 +732,7 @@ double BrewNote::calculateEffIntoBK_pct()
    // translated from SG into pure glucose points
    maxPoints = m_projPoints * m_projVolIntoBK_l;
 
-   actualPoints = (m_sg - 1) * 1000 * m_volumeIntoBK_l;
+   actualPoints = Points{SpecificGravity{m_sg}}.value() * m_volumeIntoBK_l;
 
    // this can happen under normal circumstances (eg, load)
    if (maxPoints <= 0.0)
@@ -597,14 +751,14 @@ double BrewNote::calculateOg()
    double cOG;
    double points, expectedVol, actualVol;
 
-   points = (m_sg-1) * 1000;
+   points = Points{SpecificGravity{m_sg}}.value();
    expectedVol = m_projVolIntoBK_l - m_boilOff_l;
    actualVol   = m_volumeIntoBK_l;
 
    if ( expectedVol <= 0.0 )
       return 0.0;
 
-   cOG = 1+ ((points * actualVol / expectedVol) / 1000);
+   cOG = SpecificGravity{Points{points * actualVol / expectedVol}}.value();
    setProjOg(cOG);
 
    return cOG;
@@ -616,7 +770,7 @@ double BrewNote::calculateBrewHouseEff_pct()
    double brewhouseEff;
 
    expectedPoints = m_projFermPoints * m_projVolIntoFerm_l;
-   actualPoints = (m_og-1.0) * 1000.0 * m_volumeIntoFerm_l;
+   actualPoints = Points{SpecificGravity{m_og}}.value() * m_volumeIntoFerm_l;
 
    brewhouseEff = actualPoints/expectedPoints * 100.0;
    setBrewhouseEff_pct(brewhouseEff);
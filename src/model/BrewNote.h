@@ -23,13 +23,19 @@
 #define MODEL_BREWNOTE_H
 #pragma once
 
+#include <memory>
+#include <optional>
+
 #include <QDate>
+#include <QDateTime>
 #include <QDomDocument>
 #include <QDomNode>
 #include <QSqlRecord>
 #include <QString>
 #include <QStringList>
 
+#include "FermentationCurve.h"
+#include "model/GravityReading.h"
 #include "model/NamedEntity.h"
 
 //======================================================================================================================
@@ -151,6 +157,14 @@ public:
    void setFg(double var);
    void setFinalVolume_l(double var);
    void setBoilOff_l(double var);
+   /**
+    * \brief Record a gravity reading taken at \c when.  Readings can be added in any order, but adding them as they are
+    *        taken (ie each one later than the last) is cheapest, as the fermentation prediction is then updated in
+    *        constant time.  Either way, only the new reading is written to the DB.
+    */
+   void addGravityReading(QDateTime const & when, double sg, double temp_c = GravityReading::defaultTemp_c);
+   //! \brief Remove reading \c index, in the order of \c gravityReadingsList()
+   void removeGravityReading(int index);
    // Metasetter
    void populateNote(Recipe* parent);
    void recalculateEff(Recipe* parent);
@@ -186,6 +200,14 @@ public:
    double boilOff_l() const;
    QString notes() const;
    int getRecipeId() const;
+   //! \brief Gravity readings, in no particular order
+   QList<std::shared_ptr<GravityReading>> gravityReadings() const;
+   //! \brief Gravity readings in time order.  Times are hours since the epoch -- see \c readingTime().
+   QVector<FermentationCurve::Reading> const & gravityReadingsList() const;
+   //! \brief Predicted FG, attenuation and time to terminal gravity from the gravity readings so far
+   FermentationCurve::Prediction fermentationPrediction() const;
+   //! \brief Convert a \c FermentationCurve time to a date and time
+   static QDateTime readingTime(double time_h);
 
    // Calculations
    double calculateEffIntoBK_pct();
@@ -227,6 +249,16 @@ public:
 
    virtual Recipe * getOwningRecipe();
 
+   /**
+    * \brief Readings added before we were stored in the DB are stored when we are
+    */
+   virtual void setKey(int key);
+
+   /**
+    * \brief A BrewNote owns its GravityReadings so needs to delete those if it itself is being deleted
+    */
+   virtual void hardDeleteOwnedEntities();
+
 signals:
    void brewDateChanged(const QDate &);
 
@@ -269,6 +301,12 @@ private:
    double m_projFermPoints;
    double m_projAtten;
    int  m_recipeId;
+   //! \brief Readings added while we are not yet in the DB, and so have no ID to give them
+   QList<std::shared_ptr<GravityReading>> m_unstoredGravityReadings;
+   //! \brief Time-ordered \c gravityReadings() with their fit.  Loaded on first use -- see \c fermentation().
+   mutable std::optional<FermentationCurve::Series> m_fermentation;
+
+   FermentationCurve::Series & fermentation() const;
 
 };
 
@@ -290,7 +290,7 @@ double Equipment::boilTime_min() const { return m_boilTime_min; }
 double Equipment::lauterDeadspace_l() const { return m_lauterDeadspace_l; }
 double Equipment::topUpKettle_l() const { return m_topUpKettle_l; }
 double Equipment::hopUtilization_pct() const { return m_hopUtilization_pct; }
-double Equipment::grainAbsorption_LKg() { return m_grainAbsorption_LKg; }
+double Equipment::grainAbsorption_LKg() const { return m_grainAbsorption_LKg; }
 double Equipment::boilingPoint_c() const { return m_boilingPoint_c; }
 
 void Equipment::doCalculations() {
@@ -146,7 +146,7 @@ public:
    double  topUpKettle_l        () const;
    double  hopUtilization_pct   () const;
    QString notes                () const;
-   double  grainAbsorption_LKg  ();
+   double  grainAbsorption_LKg  () const;
    double  boilingPoint_c       () const;
 
    //! \brief Calculate how much wort is left immediately at knockout.
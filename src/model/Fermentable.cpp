@@ -83,6 +83,7 @@ TypeLookup const Fermentable::typeLookup {
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Fermentable::type                  , Fermentable::m_type                  ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Fermentable::amount_kg             , Fermentable::m_amount_kg             , Measurement::PhysicalQuantity::Mass          ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Fermentable::yield_pct             , Fermentable::m_yield_pct             ,           NonPhysicalQuantity::Percentage    ),
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Fermentable::yieldStdDev_pct       , Fermentable::m_yieldStdDev_pct       ,           NonPhysicalQuantity::Percentage    ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Fermentable::color_srm             , Fermentable::m_color_srm             , Measurement::PhysicalQuantity::Color         ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Fermentable::addAfterBoil          , Fermentable::m_addAfterBoil          ,           NonPhysicalQuantity::Bool          ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Fermentable::origin                , Fermentable::m_origin                ,           NonPhysicalQuantity::String        ),
@@ -108,6 +109,7 @@ Fermentable::Fermentable(QString name) :
    m_type                  {Fermentable::Type::Grain},
    m_amount_kg             {0.0               },
    m_yield_pct             {0.0               },
+   m_yieldStdDev_pct       {0.0               },
    m_color_srm             {0.0               },
    m_addAfterBoil           {false             },
    m_origin                {QString()         },
@@ -130,6 +132,7 @@ Fermentable::Fermentable(NamedParameterBundle const & namedParameterBundle) :
    m_type                  {namedParameterBundle.val<Fermentable::Type>(PropertyNames::Fermentable::type                             )},
    m_amount_kg             {namedParameterBundle.val<double           >(PropertyNames::Fermentable::amount_kg                        )},
    m_yield_pct             {namedParameterBundle.val<double           >(PropertyNames::Fermentable::yield_pct                        )},
+   m_yieldStdDev_pct       {namedParameterBundle.val<double           >(PropertyNames::Fermentable::yieldStdDev_pct       , 0.0      )},
    m_color_srm             {namedParameterBundle.val<double           >(PropertyNames::Fermentable::color_srm                        )},
    m_addAfterBoil          {namedParameterBundle.val<bool             >(PropertyNames::Fermentable::addAfterBoil                     )},
    m_origin                {namedParameterBundle.val<QString          >(PropertyNames::Fermentable::origin                , QString())},
@@ -152,6 +155,7 @@ Fermentable::Fermentable(Fermentable const & other) :
    m_type                  {other.m_type                  },
    m_amount_kg             {other.m_amount_kg             },
    m_yield_pct             {other.m_yield_pct             },
+   m_yieldStdDev_pct       {other.m_yieldStdDev_pct       },
    m_color_srm             {other.m_color_srm             },
    m_addAfterBoil          {other.m_addAfterBoil          },
    m_origin                {other.m_origin                },
@@ -175,6 +179,7 @@ Fermentable::~Fermentable() = default;
 Fermentable::Type Fermentable::type() const { return m_type; }
 double Fermentable::amount_kg() const { return m_amount_kg; }
 double Fermentable::yield_pct() const { return m_yield_pct; }
+double Fermentable::yieldStdDev_pct() const { return m_yieldStdDev_pct; }
 double Fermentable::color_srm() const { return m_color_srm; }
 bool Fermentable::addAfterBoil() const { return m_addAfterBoil; }
 const QString Fermentable::origin() const { return m_origin; }
@@ -305,6 +310,10 @@ void Fermentable::setYield_pct(double var) {
    this->setAndNotify(PropertyNames::Fermentable::yield_pct, this->m_yield_pct, this->enforceMinAndMax(var, "amount", 0.0, 100.0));
 }
 
+void Fermentable::setYieldStdDev_pct(double var) {
+   this->setAndNotify(PropertyNames::Fermentable::yieldStdDev_pct, this->m_yieldStdDev_pct, this->enforceMinAndMax(var, "yield std dev", 0.0, 100.0));
+}
+
 void Fermentable::setColor_srm(double var) {
    this->setAndNotify(PropertyNames::Fermentable::color_srm, this->m_color_srm, this->enforceMin(var, "color"));
 }
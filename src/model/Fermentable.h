@@ -58,6 +58,7 @@ AddPropertyName(supplier              )
 AddPropertyName(typeString            )
 AddPropertyName(type                  )
 AddPropertyName(yield_pct             )
+AddPropertyName(yieldStdDev_pct       )
 #undef AddPropertyName
 //=========================================== End of property name constants ===========================================
 //======================================================================================================================
@@ -137,6 +138,8 @@ public:
    Q_PROPERTY( double amount_kg              READ amount_kg              WRITE setAmount_kg              /*NOTIFY changed*/ /*changedAmount_kg*/ )
    //! \brief The yield (when finely milled) as a percentage of equivalent glucose.
    Q_PROPERTY( double yield_pct              READ yield_pct              WRITE setYield_pct              /*NOTIFY changed*/ /*changedYield_pct*/ )
+   //! \brief Standard deviation of the yield between lots, for uncertainty estimates.  0 means yield is exact.
+   Q_PROPERTY( double yieldStdDev_pct        READ yieldStdDev_pct        WRITE setYieldStdDev_pct        /*NOTIFY changed*/ /*changedYieldStdDev_pct*/ )
    //! \brief The color in SRM.
    Q_PROPERTY( double color_srm              READ color_srm              WRITE setColor_srm              /*NOTIFY changed*/ /*changedColor_srm*/ )
    //! \brief Whether to add after the boil.
@@ -174,6 +177,7 @@ public:
    double amount_kg() const;
    virtual double inventory() const;
    double  yield_pct                               () const;
+   double  yieldStdDev_pct                         () const;
    double  color_srm                               () const;
    bool    addAfterBoil                            () const;
    const QString origin() const;
@@ -206,6 +210,7 @@ public:
    void setAmount_kg( double num );
    virtual void setInventoryAmount(double amount);
    void setYield_pct( double num );
+   void setYieldStdDev_pct( double num );
    void setColor_srm( double num );
    void setAddAfterBoil( bool b );
    void setOrigin( const QString& str );
@@ -235,6 +240,7 @@ private:
    Type    m_type                  ;
    double  m_amount_kg             ;
    double  m_yield_pct             ;
+   double  m_yieldStdDev_pct       ;
    double  m_color_srm             ;
    bool    m_addAfterBoil          ;
    QString m_origin                ;
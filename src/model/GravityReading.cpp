@@ -0,0 +1,106 @@
+/*
+ * model/GravityReading.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2023
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "model/GravityReading.h"
+
+#include "database/ObjectStoreWrapper.h"
+#include "model/BrewNote.h"
+#include "model/NamedParameterBundle.h"
+
+bool GravityReading::isEqualTo(NamedEntity const & other) const {
+   // Base class (NamedEntity) will have ensured this cast is valid
+   GravityReading const & rhs = static_cast<GravityReading const &>(other);
+   // Base class will already have ensured names are equal
+   return (
+      this->m_time_h == rhs.m_time_h &&
+      this->m_sg     == rhs.m_sg     &&
+      this->m_temp_c == rhs.m_temp_c
+   );
+}
+
+ObjectStore & GravityReading::getObjectStoreTypedInstance() const {
+   return ObjectStoreTyped<GravityReading>::getInstance();
+}
+
+TypeLookup const GravityReading::typeLookup {
+   "GravityReading",
+   {
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::GravityReading::brewNoteId, GravityReading::m_brewNoteId                                             ),
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::GravityReading::sg        , GravityReading::m_sg        , Measurement::PhysicalQuantity::Density    ),
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::GravityReading::temp_c    , GravityReading::m_temp_c    , Measurement::PhysicalQuantity::Temperature),
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::GravityReading::time_h    , GravityReading::m_time_h                                                 ),
+   },
+   // Parent class lookup
+   &NamedEntity::typeLookup
+};
+
+GravityReading::GravityReading(QString name) :
+   NamedEntity {name, true},
+   m_time_h    {0.0                           },
+   m_sg        {0.0                           },
+   m_temp_c    {GravityReading::defaultTemp_c },
+   m_brewNoteId{-1                            } {
+   return;
+}
+
+GravityReading::GravityReading(NamedParameterBundle const & namedParameterBundle) :
+   NamedEntity (namedParameterBundle                                                      ),
+   m_time_h    (namedParameterBundle.val<double>(PropertyNames::GravityReading::time_h    )),
+   m_sg        (namedParameterBundle.val<double>(PropertyNames::GravityReading::sg        )),
+   m_temp_c    (namedParameterBundle.val<double>(PropertyNames::GravityReading::temp_c    )),
+   m_brewNoteId(namedParameterBundle.val<int   >(PropertyNames::GravityReading::brewNoteId)) {
+   return;
+}
+
+GravityReading::GravityReading(GravityReading const & other) :
+   NamedEntity {other             },
+   m_time_h    {other.m_time_h    },
+   m_sg        {other.m_sg        },
+   m_temp_c    {other.m_temp_c    },
+   m_brewNoteId{other.m_brewNoteId} {
+   return;
+}
+
+GravityReading::~GravityReading() = default;
+
+void GravityReading::setTime_h(double val) { this->setAndNotify(PropertyNames::GravityReading::time_h, this->m_time_h, val); }
+void GravityReading::setSg    (double val) { this->setAndNotify(PropertyNames::GravityReading::sg    , this->m_sg    , val); }
+void GravityReading::setTemp_c(double val) { this->setAndNotify(PropertyNames::GravityReading::temp_c, this->m_temp_c, val); }
+
+void GravityReading::setBrewNoteId(int val) {
+   this->m_brewNoteId = val;
+   this->propagatePropertyChange(PropertyNames::GravityReading::brewNoteId, false);
+   return;
+}
+
+double GravityReading::time_h    () const { return this->m_time_h    ; }
+double GravityReading::sg        () const { return this->m_sg        ; }
+double GravityReading::temp_c    () const { return this->m_temp_c    ; }
+int    GravityReading::brewNoteId() const { return this->m_brewNoteId; }
+
+FermentationCurve::Reading GravityReading::reading() const {
+   return FermentationCurve::Reading{this->m_time_h, this->m_sg};
+}
+
+Recipe * GravityReading::getOwningRecipe() {
+   BrewNote * brewNote = ObjectStoreWrapper::getByIdRaw<BrewNote>(this->m_brewNoteId);
+   if (!brewNote) {
+      return nullptr;
+   }
+   return brewNote->getOwningRecipe();
+}
@@ -0,0 +1,100 @@
+/*
+ * model/GravityReading.h is part of Brewtarget, and is Copyright the following
+ * authors 2023
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MODEL_GRAVITYREADING_H
+#define MODEL_GRAVITYREADING_H
+#pragma once
+
+#include "FermentationCurve.h"
+#include "model/NamedEntity.h"
+
+//======================================================================================================================
+//========================================== Start of property name constants ==========================================
+// See comment in model/NamedEntity.h
+#define AddPropertyName(property) namespace PropertyNames::GravityReading { BtStringConst const property{#property}; }
+AddPropertyName(brewNoteId)
+AddPropertyName(sg        )
+AddPropertyName(temp_c    )
+AddPropertyName(time_h    )
+#undef AddPropertyName
+//=========================================== End of property name constants ===========================================
+//======================================================================================================================
+
+
+/*!
+ * \class GravityReading
+ *
+ * \brief One gravity reading taken during fermentation.  Each is owned by a \c BrewNote, and has its own row in the DB
+ *        so that recording a reading doesn't mean rewriting all the ones before it.
+ */
+class GravityReading : public NamedEntity {
+   Q_OBJECT
+   Q_CLASSINFO("signal", "gravityReadings")
+
+public:
+   //! \brief Temperature we assume a reading was taken at if we aren't told otherwise
+   static double constexpr defaultTemp_c = 20.0;
+
+   /**
+    * \brief Mapping of names to types for the Qt properties of this class.  See \c NamedEntity::typeLookup for more
+    *        info.
+    */
+   static TypeLookup const typeLookup;
+
+   GravityReading(QString name = "");
+   GravityReading(NamedParameterBundle const & namedParameterBundle);
+   GravityReading(GravityReading const & other);
+
+   virtual ~GravityReading();
+
+   //! \brief When the reading was taken, in hours since the epoch.  See \c BrewNote::readingTime().
+   Q_PROPERTY(double time_h     READ time_h      WRITE setTime_h     )
+   //! \brief The specific gravity, already corrected for the temperature of the sample
+   Q_PROPERTY(double sg         READ sg          WRITE setSg         )
+   //! \brief The temperature of the sample, in C
+   Q_PROPERTY(double temp_c     READ temp_c      WRITE setTemp_c     )
+   //! \brief The BrewNote to which this GravityReading belongs
+   Q_PROPERTY(int    brewNoteId READ brewNoteId  WRITE setBrewNoteId )
+
+   void setTime_h    (double val);
+   void setSg        (double val);
+   void setTemp_c    (double val);
+   void setBrewNoteId(int    val);
+
+   double time_h    () const;
+   double sg        () const;
+   double temp_c    () const;
+   int    brewNoteId() const;
+
+   //! \brief The reading in the form \c FermentationCurve uses
+   FermentationCurve::Reading reading() const;
+
+   virtual Recipe * getOwningRecipe();
+
+protected:
+   virtual bool isEqualTo(NamedEntity const & other) const;
+   virtual ObjectStore & getObjectStoreTypedInstance() const;
+
+private:
+   double m_time_h;
+   double m_sg;
+   double m_temp_c;
+   int    m_brewNoteId;
+};
+
+#endif
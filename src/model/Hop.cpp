@@ -100,6 +100,7 @@ TypeLookup const Hop::typeLookup {
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Hop::type                 , Hop::m_type                 ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Hop::form                 , Hop::m_form                 ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Hop::alpha_pct            , Hop::m_alpha_pct            ,           NonPhysicalQuantity::Percentage   ),
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Hop::alphaStdDev_pct      , Hop::m_alphaStdDev_pct      ,           NonPhysicalQuantity::Percentage   ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Hop::amount_kg            , Hop::m_amount_kg            , Measurement::PhysicalQuantity::Mass         ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Hop::time_min             , Hop::m_time_min             , Measurement::PhysicalQuantity::Time         ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Hop::notes                , Hop::m_notes                ),
@@ -123,6 +124,7 @@ Hop::Hop(QString name) :
    m_type                 {Hop::Type::Bittering},
    m_form                 {Hop::Form::Leaf},
    m_alpha_pct            {0.0},
+   m_alphaStdDev_pct      {0.0},
    m_amount_kg            {0.0},
    m_time_min             {0.0},
    m_notes                {"" },
@@ -143,6 +145,7 @@ Hop::Hop(NamedParameterBundle const & namedParameterBundle) :
    m_type                 {namedParameterBundle.val<Hop::Type            >(PropertyNames::Hop::type                 )},
    m_form                 {namedParameterBundle.val<Hop::Form            >(PropertyNames::Hop::form                 )},
    m_alpha_pct            {namedParameterBundle.val<double               >(PropertyNames::Hop::alpha_pct            )},
+   m_alphaStdDev_pct      {namedParameterBundle.val<double               >(PropertyNames::Hop::alphaStdDev_pct      , 0.0)},
    m_amount_kg            {namedParameterBundle.val<double               >(PropertyNames::Hop::amount_kg            )},
    m_time_min             {namedParameterBundle.val<double               >(PropertyNames::Hop::time_min             )},
    m_notes                {namedParameterBundle.val<QString              >(PropertyNames::Hop::notes                )},
@@ -163,6 +166,7 @@ Hop::Hop(Hop const & other) :
    m_type                  {other.m_type                 },
    m_form                  {other.m_form                 },
    m_alpha_pct             {other.m_alpha_pct            },
+   m_alphaStdDev_pct       {other.m_alphaStdDev_pct      },
    m_amount_kg             {other.m_amount_kg            },
    m_time_min              {other.m_time_min             },
    m_notes                 {other.m_notes                },
@@ -187,6 +191,7 @@ Hop::Form             Hop::form()                  const { return this->m_form;
 QString               Hop::origin()                const { return this->m_origin;                }
 QString               Hop::substitutes()           const { return this->m_substitutes;           }
 double                Hop::alpha_pct()             const { return this->m_alpha_pct;             }
+double                Hop::alphaStdDev_pct()       const { return this->m_alphaStdDev_pct;       }
 double                Hop::amount_kg()             const { return this->m_amount_kg;             }
 double                Hop::time_min()              const { return this->m_time_min;              }
 double                Hop::beta_pct()              const { return this->m_beta_pct;              }
@@ -202,6 +207,7 @@ double Hop::inventory() const {
 
 //============================="SET" METHODS====================================
 void Hop::setAlpha_pct            (double                      const   val) { this->setAndNotify(PropertyNames::Hop::alpha_pct,             this->m_alpha_pct,             this->enforceMinAndMax(val, "alpha",                 0.0, 100.0)); }
+void Hop::setAlphaStdDev_pct      (double                      const   val) { this->setAndNotify(PropertyNames::Hop::alphaStdDev_pct,       this->m_alphaStdDev_pct,       this->enforceMinAndMax(val, "alpha std dev",         0.0, 100.0)); }
 void Hop::setAmount_kg            (double                      const   val) { this->setAndNotify(PropertyNames::Hop::amount_kg,             this->m_amount_kg,             this->enforceMin      (val, "amount")                           ); }
 void Hop::setUse                  (Hop::Use                    const   val) { this->setAndNotify(PropertyNames::Hop::use,                   this->m_use,                   val                                                             ); }
 void Hop::setTime_min             (double                      const   val) { this->setAndNotify(PropertyNames::Hop::time_min,              this->m_time_min,              this->enforceMin      (val, "time")                             ); }
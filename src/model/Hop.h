@@ -36,6 +36,7 @@
 // See comment in model/NamedEntity.h
 #define AddPropertyName(property) namespace PropertyNames::Hop { BtStringConst const property{#property}; }
 AddPropertyName(alpha_pct            )
+AddPropertyName(alphaStdDev_pct      )
 AddPropertyName(amount_kg            )
 AddPropertyName(beta_pct             )
 AddPropertyName(caryophyllene_pct    )
@@ -134,6 +135,11 @@ public:
 
    //! \brief The percent alpha acid
    Q_PROPERTY(double alpha_pct READ alpha_pct WRITE setAlpha_pct /*NOTIFY changed*/ /*changedAlpha_pct*/ )
+   /**
+    * \brief Standard deviation of the percent alpha acid -- ie how much it varies from one lot to the next.  Used only
+    *        for uncertainty estimates (see \c RecipeUncertainty).  0 means we treat \c alpha_pct as exact.
+    */
+   Q_PROPERTY(double alphaStdDev_pct READ alphaStdDev_pct WRITE setAlphaStdDev_pct /*NOTIFY changed*/ /*changedAlphaStdDev_pct*/ )
    //! \brief The amount in kg.
    Q_PROPERTY(double amount_kg READ amount_kg WRITE setAmount_kg /*NOTIFY changed*/ /*changedAmount_kg*/ )
    //! \brief The \c Use.
@@ -166,6 +172,7 @@ public:
 
    //============================="GET" METHODS====================================
    double  alpha_pct            () const;
+   double  alphaStdDev_pct      () const;
    double  amount_kg            () const;
    Use     use                  () const;
    double  time_min             () const;
@@ -185,6 +192,7 @@ public:
 
    //============================="SET" METHODS====================================
    void setAlpha_pct            (double  const   val);
+   void setAlphaStdDev_pct      (double  const   val);
    void setAmount_kg            (double  const   val);
    void setUse                  (Use     const   val);
    void setTime_min             (double  const   val);
@@ -215,6 +223,7 @@ private:
    Type    m_type;
    Form    m_form;
    double  m_alpha_pct;
+   double  m_alphaStdDev_pct;
    double  m_amount_kg;
    double  m_time_min;
    QString m_notes;
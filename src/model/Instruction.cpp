@@ -167,6 +167,11 @@ void Instruction::addReagent(QString const & reagent) {
    m_reagents.append(reagent);
 }
 
+void Instruction::setReagents(QList<QString> const & reagents) {
+   // As above, reagents aren't stored in the DB
+   m_reagents = reagents;
+}
+
 // Accessors ==================================================================
 QString Instruction::directions() { return m_directions; }
 
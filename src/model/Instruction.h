@@ -86,6 +86,7 @@ public:
    void setCompleted(bool comp);
    void setInterval(double interval);
    void addReagent(const QString& reagent);
+   void setReagents(QList<QString> const & reagents);
 
    // "get" methods.
    QString directions();
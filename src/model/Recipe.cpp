@@ -22,6 +22,7 @@
 #include "model/Recipe.h"
 
 #include <cmath> // For pow/log
+#include <vector>
 
 #include <QDate>
 #include <QDebug>
@@ -33,7 +34,6 @@
 #include "database/ObjectStoreWrapper.h"
 #include "HeatCalculations.h"
 #include "Localization.h"
-#include "measurement/ColorMethods.h"
 #include "measurement/IbuMethods.h"
 #include "measurement/Measurement.h"
 #include "model/Equipment.h"
@@ -51,6 +51,8 @@
 #include "PersistentSettings.h"
 #include "PhysicalConstants.h"
 #include "PreInstruction.h"
+#include "RecipeCalculations.h"
+#include "SequenceDiff.h"
 
 namespace {
    /**
@@ -178,6 +180,28 @@ namespace {
       {"Partial Mash", Recipe::Type::PartialMash},
       {"All Grain",    Recipe::Type::AllGrain}
    };
+
+   /**
+    * \brief Add \c hop to \c hopAdditions, turning its use and form into what the IBU formulas work with.
+    *
+    *        Tinseth's table was created from whole cone data, so utilization is adjusted up for plugs and pellets.
+    *        - http://www.realbeer.com/hops/FAQ.html
+    *        - https://groups.google.com/forum/#!topic"brewtarget.h"lp/mv2qvWBC4sU
+    */
+   void appendHopAddition(IbuMethods::HopAdditions & hopAdditions, Hop const & hop) {
+      IbuMethods::HopTiming timing = IbuMethods::HopTiming::None;
+      switch (hop.use()) {
+         case Hop::Use::Mash      : timing = IbuMethods::HopTiming::Mash;      break;
+         case Hop::Use::First_Wort: timing = IbuMethods::HopTiming::FirstWort; break;
+         case Hop::Use::Boil      : timing = IbuMethods::HopTiming::Boil;      break;
+         case Hop::Use::Aroma     : timing = IbuMethods::HopTiming::HopStand;  break;
+         case Hop::Use::Dry_Hop   : timing = IbuMethods::HopTiming::None;      break;
+      }
+      double const formFactor = hop.form() == Hop::Form::Plug   ? 1.02 :
+                                hop.form() == Hop::Form::Pellet ? 1.10 : 1.0;
+      hopAdditions.append(hop.alpha_pct() / 100.0, hop.amount_kg() * 1000.0, hop.time_min(), timing, formFactor);
+      return;
+   }
 }
 
 
@@ -374,6 +398,7 @@ TypeLookup const Recipe::typeLookup {
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Recipe::batchSize_l       , Recipe::m_batchSize_l       , Measurement::PhysicalQuantity::Volume        ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Recipe::boilTime_min      , Recipe::m_boilTime_min      , Measurement::PhysicalQuantity::Time          ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Recipe::efficiency_pct    , Recipe::m_efficiency_pct    ,           NonPhysicalQuantity::Percentage    ),
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Recipe::efficiencyStdDev_pct, Recipe::m_efficiencyStdDev_pct,         NonPhysicalQuantity::Percentage    ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Recipe::fermentationStages, Recipe::m_fermentationStages,           NonPhysicalQuantity::Count         ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Recipe::primaryAge_days   , Recipe::m_primaryAge_days   ,           NonPhysicalQuantity::Dimensionless ), // See comment above for why Dimensionless, not Time
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Recipe::primaryTemp_c     , Recipe::m_primaryTemp_c     , Measurement::PhysicalQuantity::Temperature   ),
@@ -449,6 +474,7 @@ Recipe::Recipe(QString name) :
    m_boilSize_l        {0.0                          },
    m_boilTime_min      {0.0                          },
    m_efficiency_pct    {0.0                          },
+   m_efficiencyStdDev_pct{0.0                        },
    m_fermentationStages{1                            },
    m_primaryAge_days   {0.0                          },
    m_primaryTemp_c     {0.0                          },
@@ -490,6 +516,7 @@ Recipe::Recipe(NamedParameterBundle const & namedParameterBundle) :
    m_boilSize_l        {namedParameterBundle.val<double      >(PropertyNames::Recipe::boilSize_l        )},
    m_boilTime_min      {namedParameterBundle.val<double      >(PropertyNames::Recipe::boilTime_min      )},
    m_efficiency_pct    {namedParameterBundle.val<double      >(PropertyNames::Recipe::efficiency_pct    )},
+   m_efficiencyStdDev_pct{namedParameterBundle.val<double    >(PropertyNames::Recipe::efficiencyStdDev_pct, 0.0)},
    m_fermentationStages{namedParameterBundle.val<int         >(PropertyNames::Recipe::fermentationStages)},
    m_primaryAge_days   {namedParameterBundle.val<double      >(PropertyNames::Recipe::primaryAge_days   )},
    m_primaryTemp_c     {namedParameterBundle.val<double      >(PropertyNames::Recipe::primaryTemp_c     )},
@@ -535,6 +562,7 @@ Recipe::Recipe(Recipe const & other) :
    m_boilSize_l        {other.m_boilSize_l        },
    m_boilTime_min      {other.m_boilTime_min      },
    m_efficiency_pct    {other.m_efficiency_pct    },
+   m_efficiencyStdDev_pct{other.m_efficiencyStdDev_pct},
    m_fermentationStages{other.m_fermentationStages},
    m_primaryAge_days   {other.m_primaryAge_days   },
    m_primaryTemp_c     {other.m_primaryTemp_c     },
@@ -652,10 +680,8 @@ void Recipe::connectSignalsForAllRecipes() {
 }
 
 
-void Recipe::mashFermentableIns() {
+void Recipe::mashFermentableIns(QVector<PreInstruction> & instructions) {
    /*** Add grains ***/
-   auto ins = std::make_shared<Instruction>();
-   ins->setName(tr("Add grains"));
    QString str = tr("Add ");
    QList<QString> reagents = this->getReagents(this->fermentables());
 
@@ -664,14 +690,13 @@ void Recipe::mashFermentableIns() {
    }
 
    str += tr("to the mash tun.");
-   ins->setDirections(str);
 
-   this->add(ins);
+   instructions.append(PreInstruction(str, tr("Add grains"), 0.0));
 
    return;
 }
 
-void Recipe::saltWater(Salt::WhenToAdd when) {
+void Recipe::saltWater(QVector<PreInstruction> & instructions, Salt::WhenToAdd when) {
 
    if (this->mash() == nullptr || this->salts().size() == 0) {
       return;
@@ -682,9 +707,7 @@ void Recipe::saltWater(Salt::WhenToAdd when) {
       return;
    }
 
-   auto ins = std::make_shared<Instruction>();
    QString tmp = when == Salt::WhenToAdd::MASH ? tr("mash") : tr("sparge");
-   ins->setName(tr("Modify %1 water").arg(tmp));
    QString str = tr("Dissolve ");
 
    for (int ii = 0; ii < reagents.size(); ++ii) {
@@ -692,21 +715,18 @@ void Recipe::saltWater(Salt::WhenToAdd when) {
    }
 
    str += QString(tr(" into the %1 water").arg(tmp));
-   ins->setDirections(str);
 
-   this->add(ins);
+   instructions.append(PreInstruction(str, tr("Modify %1 water").arg(tmp), 0.0));
 
    return;
 }
 
-void Recipe::mashWaterIns() {
+void Recipe::mashWaterIns(QVector<PreInstruction> & instructions) {
 
    if (this->mash() == nullptr) {
       return;
    }
 
-   auto ins = std::make_shared<Instruction>();
-   ins->setName(tr("Heat water"));
    QString str = tr("Bring ");
    QList<QString> reagents = getReagents(mash()->mashSteps());
 
@@ -715,9 +735,8 @@ void Recipe::mashWaterIns() {
    }
 
    str += tr("for upcoming infusions.");
-   ins->setDirections(str);
 
-   this->add(ins);
+   instructions.append(PreInstruction(str, tr("Heat water"), 0.0));
 
    return;
 }
@@ -831,7 +850,7 @@ QVector<PreInstruction> Recipe::miscSteps(Misc::Use type) {
    return preins;
 }
 
-void Recipe::firstWortHopsIns() {
+void Recipe::firstWortHopsIns(QVector<PreInstruction> & instructions) {
    QList<QString> reagents = getReagents(hops(), true);
    if (reagents.size() == 0) {
       return;
@@ -844,16 +863,12 @@ void Recipe::firstWortHopsIns() {
    }
    str += ".";
 
-   auto ins = std::make_shared<Instruction>();
-   ins->setName(tr("First wort hopping"));
-   ins->setDirections(str);
-
-   this->add(ins);
+   instructions.append(PreInstruction(str, tr("First wort hopping"), 0.0));
 
    return;
 }
 
-void Recipe::topOffIns() {
+void Recipe::topOffIns(QVector<PreInstruction> & instructions) {
    Equipment * e = this->equipment();
    if (e == nullptr) {
       return;
@@ -873,12 +888,7 @@ void Recipe::topOffIns() {
 
    str += tmp;
 
-   auto ins = std::make_shared<Instruction>();
-   ins->setName(tr("Pre-boil"));
-   ins->setDirections(str);
-   ins->addReagent(tmp);
-
-   this->add(ins);
+   instructions.append(PreInstruction(str, tr("Pre-boil"), 0.0, {tmp}));
 
    return;
 }
@@ -953,7 +963,7 @@ PreInstruction Recipe::addExtracts(double timeRemaining) const {
    return PreInstruction(str, tr("Add Extracts to water"), timeRemaining);
 }
 
-void Recipe::postboilFermentablesIns() {
+void Recipe::postboilFermentablesIns(QVector<PreInstruction> & instructions) {
    QString tmp;
    bool hasFerms = false;
 
@@ -978,17 +988,12 @@ void Recipe::postboilFermentablesIns() {
       return;
    }
 
-   auto ins = std::make_shared<Instruction>();
-   ins->setName(tr("Knockout additions"));
-   ins->setDirections(str);
-   ins->addReagent(tmp);
-
-   this->add(ins);
+   instructions.append(PreInstruction(str, tr("Knockout additions"), 0.0, {tmp}));
 
    return;
 }
 
-void Recipe::postboilIns() {
+void Recipe::postboilIns(QVector<PreInstruction> & instructions) {
    Equipment * e = equipment();
    if (e == nullptr) {
       return;
@@ -1012,38 +1017,23 @@ void Recipe::postboilIns() {
    str += tr("\nThe final volume in the primary is %1.")
           .arg(Measurement::displayAmount(Measurement::Amount{wort_l, Measurement::Units::liters}));
 
-   auto ins = std::make_shared<Instruction>();
-   ins->setName(tr("Post boil"));
-   ins->setDirections(str);
-   this->add(ins);
+   instructions.append(PreInstruction(str, tr("Post boil"), 0.0));
 
    return;
 }
 
-void Recipe::addPreinstructions(QVector<PreInstruction> preins) {
+void Recipe::addPreinstructions(QVector<PreInstruction> & instructions, QVector<PreInstruction> preins) {
    // Add instructions in descending mash time order.
    std::sort(preins.begin(), preins.end(), std::greater<PreInstruction>());
-   for (int ii = 0; ii < preins.size(); ++ii) {
-      PreInstruction pi = preins[ii];
-
-      auto ins = std::make_shared<Instruction>();
-      ins->setName(pi.getTitle());
-      ins->setDirections(pi.getText());
-      ins->setInterval(pi.getTime());
-
-      this->add(ins);
-   }
+   instructions += preins;
    return;
 }
 
-void Recipe::generateInstructions() {
+QVector<PreInstruction> Recipe::computeInstructions() {
    double timeRemaining;
    double totalWaterAdded_l = 0.0;
 
-   if (!this->instructions().empty()) {
-      this->clearInstructions();
-   }
-
+   QVector<PreInstruction> instructions;
    QVector<PreInstruction> preinstructions;
 
    // Mash instructions
@@ -1051,14 +1041,14 @@ void Recipe::generateInstructions() {
    int size = (mash() == nullptr) ? 0 : mash()->mashSteps().size();
    if (size > 0) {
       /*** prepare mashed fermentables ***/
-      this->mashFermentableIns();
+      this->mashFermentableIns(instructions);
 
       /*** salt the water ***/
-      saltWater(Salt::WhenToAdd::MASH);
-      saltWater(Salt::WhenToAdd::SPARGE);
+      saltWater(instructions, Salt::WhenToAdd::MASH);
+      saltWater(instructions, Salt::WhenToAdd::SPARGE);
 
       /*** Prepare water additions ***/
-      this->mashWaterIns();
+      this->mashWaterIns(instructions);
 
       timeRemaining = mash()->totalTime();
 
@@ -1072,15 +1062,15 @@ void Recipe::generateInstructions() {
       preinstructions += miscSteps(Misc::Use::Mash);
 
       /*** Add the preinstructions into the instructions ***/
-      addPreinstructions(preinstructions);
+      addPreinstructions(instructions, preinstructions);
 
    } // END mash instructions.
 
    // First wort hopping
-   this->firstWortHopsIns();
+   this->firstWortHopsIns(instructions);
 
    // Need to top up the kettle before boil?
-   topOffIns();
+   topOffIns(instructions);
 
    // Boil instructions
    preinstructions.clear();
@@ -1099,12 +1089,7 @@ void Recipe::generateInstructions() {
    QString str = tr("Bring the wort to a boil and hold for %1.").arg(
       Measurement::displayAmount(Measurement::Amount{timeRemaining, Measurement::Units::minutes})
    );
-
-   auto startBoilIns = std::make_shared<Instruction>();
-   startBoilIns->setName(tr("Start boil"));
-   startBoilIns->setInterval(timeRemaining);
-   startBoilIns->setDirections(str);
-   this->add(startBoilIns);
+   instructions.append(PreInstruction(str, tr("Start boil"), timeRemaining));
 
    /*** Get fermentables unless we haven't added yet ***/
    if (hasBoilFermentable()) {
@@ -1125,27 +1110,21 @@ void Recipe::generateInstructions() {
    // END boil instructions.
 
    // Add instructions in descending mash time order.
-   addPreinstructions(preinstructions);
+   addPreinstructions(instructions, preinstructions);
 
    // FLAMEOUT
-   auto flameoutIns = std::make_shared<Instruction>();
-   flameoutIns->setName(tr("Flameout"));
-   flameoutIns->setDirections(tr("Stop boiling the wort."));
-   this->add(flameoutIns);
+   instructions.append(PreInstruction(tr("Stop boiling the wort."), tr("Flameout"), 0.0));
 
    // Steeped aroma hops
-   preinstructions.clear();
-   preinstructions += hopSteps(Hop::Use::Aroma);
-   addPreinstructions(preinstructions);
+   addPreinstructions(instructions, hopSteps(Hop::Use::Aroma));
 
    // Fermentation instructions
-   preinstructions.clear();
 
    /*** Fermentables added after boil ***/
-   postboilFermentablesIns();
+   postboilFermentablesIns(instructions);
 
    /*** post boil ***/
-   postboilIns();
+   postboilIns(instructions);
 
    /*** Primary yeast ***/
    str = tr("Cool wort and pitch ");
@@ -1157,39 +1136,116 @@ void Recipe::generateInstructions() {
       }
    }
    str += tr("to the primary.");
-
-   auto pitchIns = std::make_shared<Instruction>();
-   pitchIns->setName(tr("Pitch yeast"));
-   pitchIns->setDirections(str);
-   this->add(pitchIns);
+   instructions.append(PreInstruction(str, tr("Pitch yeast"), 0.0));
    /*** End primary yeast ***/
 
    /*** Primary misc ***/
-   addPreinstructions(miscSteps(Misc::Use::Primary));
+   addPreinstructions(instructions, miscSteps(Misc::Use::Primary));
 
    str = tr("Let ferment until FG is %1.").arg(
       Measurement::displayAmount(Measurement::Amount{fg(), Measurement::Units::specificGravity}, 3)
    );
+   instructions.append(PreInstruction(str, tr("Ferment"), 0.0));
 
-   auto fermentIns = std::make_shared<Instruction>();
-   fermentIns->setName(tr("Ferment"));
-   fermentIns->setDirections(str);
-   this->add(fermentIns);
-
-   str = tr("Transfer beer to secondary.");
-   auto transferIns = std::make_shared<Instruction>();
-   transferIns->setName(tr("Transfer to secondary"));
-   transferIns->setDirections(str);
-   this->add(transferIns);
+   instructions.append(PreInstruction(tr("Transfer beer to secondary."), tr("Transfer to secondary"), 0.0));
 
    /*** Secondary misc ***/
-   addPreinstructions(miscSteps(Misc::Use::Secondary));
+   addPreinstructions(instructions, miscSteps(Misc::Use::Secondary));
 
    /*** Dry hopping ***/
-   addPreinstructions(hopSteps(Hop::Use::Dry_Hop));
+   addPreinstructions(instructions, hopSteps(Hop::Use::Dry_Hop));
+
+   // END fermentation instructions.
+   return instructions;
+}
+
+void Recipe::applyInstructions(QVector<PreInstruction> const & wanted) {
+   QList<Instruction *> const existing = this->instructions();
+
+   //
+   // Work out which of the existing instructions we can keep as they are, which we can reuse by changing their text,
+   // and which we need to delete.  Regenerating after a small change to the recipe (eg one hop addition) then only
+   // touches the instructions that actually changed rather than rewriting the whole list.
+   //
+   std::vector<int> const reuse = SequenceDiff::reuseMap(
+      existing.size(),
+      wanted.size(),
+      [&existing, &wanted](std::size_t oldIndex, std::size_t newIndex) {
+         Instruction * ins = existing[static_cast<int>(oldIndex)];
+         PreInstruction const & pi = wanted[static_cast<int>(newIndex)];
+         return ins->name() == pi.getTitle() && ins->directions() == pi.getText() && ins->interval() == pi.getTime();
+      }
+   );
 
-   // END fermentation instructions. Let everybody know that now is the time
-   // to update instructions
+   //
+   // Do all the database work in one transaction, so that, however many instructions change, it's one write.  Marking
+   // ourselves as being modified means changes to the instructions will not trigger automatic versioning of the recipe
+   // (as was the case when we deleted and re-created all the instructions).
+   //
+   NamedEntityModifyingMarker modifyingMarker(*this);
+
+   int numInserted = 0;
+   int numUpdated  = 0;
+   int numDeleted  = 0;
+   ObjectStoreWrapper::doInTransaction([&]() {
+      QVector<int> newInstructionIds;
+      newInstructionIds.reserve(wanted.size());
+      std::vector<bool> reused(existing.size(), false);
+      for (int ii = 0; ii < wanted.size(); ++ii) {
+         PreInstruction const & pi = wanted[ii];
+         int const oldIndex = reuse[ii];
+         if (oldIndex != SequenceDiff::noMatch) {
+            Instruction * ins = existing[oldIndex];
+            reused[oldIndex] = true;
+            // Setters do nothing (including not touching the DB) if the value is unchanged
+            if (ins->name() != pi.getTitle() || ins->directions() != pi.getText() || ins->interval() != pi.getTime()) {
+               ins->setName(pi.getTitle());
+               ins->setDirections(pi.getText());
+               ins->setInterval(pi.getTime());
+               // It's a different step now, so it can't have been done yet
+               ins->setCompleted(false);
+               ++numUpdated;
+            }
+            ins->setReagents(pi.getReagents());
+            newInstructionIds.append(ins->key());
+            continue;
+         }
+
+         auto ins = std::make_shared<Instruction>();
+         ins->setName(pi.getTitle());
+         ins->setDirections(pi.getText());
+         ins->setInterval(pi.getTime());
+         ins->setReagents(pi.getReagents());
+         ObjectStoreWrapper::insert(ins);
+         connect(ins.get(), &NamedEntity::changed, this, &Recipe::acceptChangeToContainedObject);
+         newInstructionIds.append(ins->key());
+         ++numInserted;
+      }
+
+      for (int ii = 0; ii < existing.size(); ++ii) {
+         if (!reused[ii]) {
+            ObjectStoreTyped<Instruction>::getInstance().softDelete(existing[ii]->key());
+            ++numDeleted;
+         }
+      }
+
+      // Finally, write the new list of IDs, which is one update to the junction table however many instructions changed
+      if (newInstructionIds != this->pimpl->instructionIds) {
+         this->pimpl->instructionIds = newInstructionIds;
+         this->propagatePropertyChange(propertyToPropertyName<Instruction>());
+      }
+   });
+
+   qDebug() <<
+      Q_FUNC_INFO << "Recipe #" << this->key() << "instructions:" << numInserted << "inserted," << numUpdated <<
+      "updated," << numDeleted << "deleted," << (wanted.size() - numInserted - numUpdated) << "unchanged";
+   return;
+}
+
+void Recipe::generateInstructions() {
+   this->applyInstructions(this->computeInstructions());
+
+   // Let everybody know that now is the time to update instructions
    emit changed(metaProperty(*PropertyNames::Recipe::instructions), this->instructions().size());
 
    return;
@@ -1580,6 +1636,14 @@ void Recipe::setEfficiency_pct(double var) {
    recalcAll();
 }
 
+void Recipe::setEfficiencyStdDev_pct(double var) {
+   // Only used for uncertainty estimates, so nothing to recalculate
+   this->setAndNotify(PropertyNames::Recipe::efficiencyStdDev_pct,
+                      this->m_efficiencyStdDev_pct,
+                      this->enforceMinAndMax(var, "efficiency std dev", 0.0, 100.0, 0.0));
+   return;
+}
+
 void Recipe::setAsstBrewer(const QString & var) {
    this->setAndNotify(
                                    PropertyNames::Recipe::asstBrewer,
@@ -2019,6 +2083,7 @@ double  Recipe::batchSize_l()        const { return m_batchSize_l;        }
 double  Recipe::boilSize_l()         const { return m_boilSize_l;         }
 double  Recipe::boilTime_min()       const { return m_boilTime_min;       }
 double  Recipe::efficiency_pct()     const { return m_efficiency_pct;     }
+double  Recipe::efficiencyStdDev_pct() const { return m_efficiencyStdDev_pct; }
 double  Recipe::tasteRating()        const { return m_tasteRating;        }
 double  Recipe::primaryAge_days()    const { return m_primaryAge_days;    }
 double  Recipe::primaryTemp_c()      const { return m_primaryTemp_c;      }
@@ -2108,11 +2173,7 @@ void Recipe::recalcAll() {
 }
 
 void Recipe::recalcABV_pct() {
-   double ret;
-
-   // The complex formula, and variations comes from Ritchie Products Ltd, (Zymurgy, Summer 1995, vol. 18, no. 2)
-   // Michael L. Hall’s article Brew by the Numbers: Add Up What’s in Your Beer, and Designing Great Beers by Daniels.
-   ret = (76.08 * (m_og_fermentable - m_fg_fermentable) / (1.775 - m_og_fermentable)) * (m_fg_fermentable / 0.794);
+   double const ret = RecipeCalculations::abv_pct(m_og_fermentable, m_fg_fermentable);
 
    if (! qFuzzyCompare(ret, m_ABV_pct)) {
       m_ABV_pct = ret;
@@ -2123,19 +2184,12 @@ void Recipe::recalcABV_pct() {
 }
 
 void Recipe::recalcColor_srm() {
-   Fermentable * ferm;
-   double mcu = 0.0;
-   double ret;
-   int i;
-
-   QList<Fermentable *> ferms = fermentables();
-   for (i = 0; static_cast<int>(i) < ferms.size(); ++i) {
-      ferm = ferms[i];
-         // Conversion factor for lb/gal to kg/l = 8.34538.
-      mcu += ferm->color_srm() * 8.34538 * ferm->amount_kg() / m_finalVolumeNoLosses_l;
+   double colorAmount_srmKg = 0.0;
+   for (Fermentable const * ferm : this->fermentables()) {
+      colorAmount_srmKg += ferm->color_srm() * ferm->amount_kg();
    }
 
-   ret = ColorMethods::mcuToSrm(mcu);
+   double const ret = RecipeCalculations::color_srm(colorAmount_srmKg, m_finalVolumeNoLosses_l);
 
    if (! qFuzzyCompare(m_color_srm, ret)) {
       m_color_srm = ret;
@@ -2148,27 +2202,28 @@ void Recipe::recalcColor_srm() {
 }
 
 void Recipe::recalcIBU() {
-   int i;
    double ibus = 0.0;
-   double tmp = 0.0;
 
    // Bitterness due to hops...
+   //
+   // All the hops are done in one go so that the recipe-wide inputs (settings, equipment, gravity) are only looked up
+   // once.
+   IbuMethods::HopAdditions const hopAdditions = this->hopAdditions();
+   std::vector<double> ibusPerHop(hopAdditions.size());
+   ibus += IbuMethods::getIbus(hopAdditions, this->ibuConstants(), ibusPerHop);
+
    m_ibus.clear();
-   QList<Hop *> hhops = hops();
-   for (i = 0; i < hhops.size(); ++i) {
-      tmp = ibuFromHop(hhops[i]);
-      m_ibus.append(tmp);
-      ibus += tmp;
+   m_ibus.reserve(static_cast<int>(ibusPerHop.size()));
+   for (double const hopIbus : ibusPerHop) {
+      m_ibus.append(hopIbus);
    }
 
    // Bitterness due to hopped extracts...
-   QList<Fermentable *> ferms = fermentables();
-   for (i = 0; static_cast<int>(i) < ferms.size(); ++i) {
-         // Conversion factor for lb/gal to kg/l = 8.34538.
-      ibus +=
-         ferms[i]->ibuGalPerLb() *
-         (ferms[i]->amount_kg() / batchSize_l()) / 8.34538;
+   double extractIbuAmount_kg = 0.0;
+   for (Fermentable const * ferm : this->fermentables()) {
+      extractIbuAmount_kg += ferm->ibuGalPerLb() * ferm->amount_kg();
    }
+   ibus += RecipeCalculations::extractIbus(extractIbuAmount_kg, batchSize_l());
 
    if (! qFuzzyCompare(ibus, m_IBU)) {
       m_IBU = ibus;
@@ -2450,19 +2505,6 @@ void Recipe::recalcBoilGrav() {
 }
 
 void Recipe::recalcOgFg() {
-   int i;
-   double plato;
-   double sugar_kg = 0;
-   double sugar_kg_ignoreEfficiency = 0.0;
-   double nonFermentableSugars_kg = 0.0;
-   double kettleWort_l = 0.0;
-   double postBoilWort_l = 0.0;
-   double ratio = 0.0;
-   double ferm_kg = 0.0;
-   double attenuation_pct = 0.0;
-   double tmp_og, tmp_fg, tmp_pnts, tmp_ferm_pnts, tmp_nonferm_pnts;
-   Yeast * yeast;
-
    m_og_fermentable = m_fg_fermentable = 0.0;
 
    // The first time through really has to get the _og and _fg from the
@@ -2480,75 +2522,35 @@ void Recipe::recalcOgFg() {
 
    // Find out how much sugar we have.
    QHash<QString, double> sugars = calcTotalPoints();
-   sugar_kg                  = sugars.value("sugar_kg");  // Mass of sugar that *is* affected by mash efficiency
-   sugar_kg_ignoreEfficiency =
-      sugars.value("sugar_kg_ignoreEfficiency");  // Mass of sugar that *is not* affected by mash efficiency
-   nonFermentableSugars_kg    =
-      sugars.value("nonFermentableSugars_kg");  // Mass of sugar that is not fermentable (also counted in sugar_kg_ignoreEfficiency)
 
-   // We might lose some sugar in the form of Trub/Chiller loss and lauter deadspace.
+   // We might lose some sugar in the form of Trub/Chiller loss.
+   double postBoilSugarRatio = 1.0;
    if (equipment() != nullptr) {
-
-      kettleWort_l = (m_wortFromMash_l - equipment()->lauterDeadspace_l()) + equipment()->topUpKettle_l();
-      postBoilWort_l = equipment()->wortEndOfBoil_l(kettleWort_l);
-      ratio = (postBoilWort_l - equipment()->trubChillerLoss_l()) / postBoilWort_l;
-      if (ratio > 1.0) { // Usually happens when we don't have a mash yet.
-         ratio = 1.0;
-      } else if (ratio < 0.0) {
-         ratio = 0.0;
-      } else if (Algorithms::isNan(ratio)) {
-         ratio = 1.0;
-      }
-      // Ignore this again since it should be included in efficiency.
-      //sugar_kg *= ratio;
-      sugar_kg_ignoreEfficiency *= ratio;
-      if (nonFermentableSugars_kg != 0.0) {
-         nonFermentableSugars_kg *= ratio;
-      }
-   }
-
-   // Total sugars after accounting for efficiency and mash losses. Implicitly includes non-fermentable sugars
-   sugar_kg = sugar_kg * efficiency_pct() / 100.0 + sugar_kg_ignoreEfficiency;
-   plato = Algorithms::getPlato(sugar_kg, m_finalVolumeNoLosses_l);
-
-   tmp_og = Algorithms::PlatoToSG_20C20C(plato);    // og from all sugars
-   tmp_pnts = (tmp_og - 1) * 1000.0; // points from all sugars
-   if (nonFermentableSugars_kg != 0.0) {
-      ferm_kg = sugar_kg - nonFermentableSugars_kg;  // Mass of only fermentable sugars
-      plato = Algorithms::getPlato(ferm_kg, m_finalVolumeNoLosses_l);   // Plato from fermentable sugars
-      m_og_fermentable = Algorithms::PlatoToSG_20C20C(plato);    // og from only fermentable sugars
-      plato = Algorithms::getPlato(nonFermentableSugars_kg, m_finalVolumeNoLosses_l);   // Plate from non-fermentable sugars
-      tmp_nonferm_pnts = ((Algorithms::PlatoToSG_20C20C(plato)) - 1) * 1000.0; // og points from non-fermentable sugars
-   } else {
-      m_og_fermentable = tmp_og;
-      tmp_nonferm_pnts = 0;
-   }
-
-   // Calculage FG
-   QList<Yeast *> yeasties = yeasts();
-   for (i = 0; static_cast<int>(i) < yeasties.size(); ++i) {
-      yeast = yeasties[i];
-      // Get the yeast with the greatest attenuation.
-      if (yeast->attenuation_pct() > attenuation_pct) {
-         attenuation_pct = yeast->attenuation_pct();
-      }
-   }
-   // This means we have yeast, but they neglected to provide attenuation percentages.
-   if (yeasties.size() > 0 && attenuation_pct <= 0.0)  {
-      attenuation_pct = 75.0; // 75% is an average attenuation.
-   }
-
-   if (nonFermentableSugars_kg != 0.0) {
-      tmp_ferm_pnts = (tmp_pnts - tmp_nonferm_pnts) * (1.0 - attenuation_pct / 100.0); // fg points from fermentable sugars
-      tmp_pnts = tmp_ferm_pnts + tmp_nonferm_pnts;  // FG points from both fermentable and non-fermentable sugars
-      //tmp_pnts *= (1.0 - attenuation_pct/100.0);  // WTF, this completely ignores all the calculations about non-fermentable sugars and just converts everything!
-      tmp_fg =  1 + tmp_pnts / 1000.0; // new FG value
-      m_fg_fermentable =  1 + tmp_ferm_pnts / 1000.0; // FG from fermentables only
-   } else {
-      tmp_pnts *= (1.0 - attenuation_pct / 100.0);
-      tmp_fg =  1 + tmp_pnts / 1000.0;
-      m_fg_fermentable = tmp_fg;
-   }
+      double const kettleWort_l =
+         (m_wortFromMash_l - equipment()->lauterDeadspace_l()) + equipment()->topUpKettle_l();
+      postBoilSugarRatio = RecipeCalculations::postBoilSugarRatio(equipment()->wortEndOfBoil_l(kettleWort_l),
+                                                                  equipment()->trubChillerLoss_l());
+   }
+
+   // Calculate FG from the yeast with the greatest attenuation
+   std::vector<double> yeastAttenuations_pct;
+   for (Yeast const * yeast : this->yeasts()) {
+      yeastAttenuations_pct.push_back(yeast->attenuation_pct());
+   }
+
+   RecipeCalculations::Gravities const gravities = RecipeCalculations::gravities(
+      sugars.value("sugar_kg"),
+      sugars.value("sugar_kg_ignoreEfficiency"),
+      sugars.value("nonFermentableSugars_kg"),
+      postBoilSugarRatio,
+      efficiency_pct(),
+      RecipeCalculations::attenuation_pct(yeastAttenuations_pct),
+      m_finalVolumeNoLosses_l
+   );
+   double const tmp_og = gravities.og;
+   double const tmp_fg = gravities.fg;
+   m_og_fermentable = gravities.og_fermentable;
+   m_fg_fermentable = gravities.fg_fermentable;
 
    if (! qFuzzyCompare(m_og, tmp_og)) {
       m_og     = tmp_og;
@@ -2578,71 +2580,63 @@ void Recipe::recalcOgFg() {
 
 //====================================Helpers===========================================
 
-double Recipe::ibuFromHop(Hop const * hop) {
-   Equipment * equip = equipment();
-   double ibus = 0.0;
-   double fwhAdjust = Localization::toDouble(
+IbuMethods::RecipeIbuConstants Recipe::ibuConstants() const {
+   IbuMethods::RecipeIbuConstants constants;
+
+   // NOTE: we used to carefully calculate the average boil gravity and use it in the
+   // IBU calculations. However, due to John Palmer
+   // (http://homebrew.stackexchange.com/questions/7343/does-wort-gravity-affect-hop-utilization),
+   // it seems more appropriate to just use the OG directly, since it is the total
+   // amount of break material that truly affects the IBUs.
+   constants.og = m_og;
+   constants.finalVolume_l = m_finalVolumeNoLosses_l;
+
+   // Assume 100% utilization and 60 min boil until further notice
+   constants.hopUtilization = 1.0;
+   constants.boilTime_min = 60;
+   constants.boilingPoint_c = 100.0;
+   Equipment const * equip = equipment();
+   if (equip) {
+      constants.hopUtilization = equip->hopUtilization_pct() / 100.0;
+      // Whole minutes only, as always
+      constants.boilTime_min = static_cast<int>(equip->boilTime_min());
+      constants.boilingPoint_c = equip->boilingPoint_c();
+   }
+
+   constants.firstWortHopAdjustment = Localization::toDouble(
       PersistentSettings::value(PersistentSettings::Names::firstWortHopAdjustment, 1.1).toString(),
       Q_FUNC_INFO
    );
-   double mashHopAdjust = Localization::toDouble(
+   constants.mashHopAdjustment = Localization::toDouble(
       PersistentSettings::value(PersistentSettings::Names::mashHopAdjustment, 0).toString(),
       Q_FUNC_INFO
    );
+   IbuMethods::loadHopStandAndChillTimes(constants);
 
-   if (hop == nullptr) {
-      return 0.0;
-   }
-
-   double AArating = hop->alpha_pct() / 100.0;
-   double grams = hop->amount_kg() * 1000.0;
-   double minutes = hop->time_min();
-   // Assume 100% utilization until further notice
-   double hopUtilization = 1.0;
-   // Assume 60 min boil until further notice
-   int boilTime = 60;
-
-   // NOTE: we used to carefully calculate the average boil gravity and use it in the
-   // IBU calculations. However, due to John Palmer
-   // (http://homebrew.stackexchange.com/questions/7343/does-wort-gravity-affect-hop-utilization),
-   // it seems more appropriate to just use the OG directly, since it is the total
-   // amount of break material that truly affects the IBUs.
+   return constants;
+}
 
-   if (equip) {
-      hopUtilization = equip->hopUtilization_pct() / 100.0;
-      boilTime = static_cast<int>(equip->boilTime_min());
+IbuMethods::HopAdditions Recipe::hopAdditions() const {
+   QList<Hop *> const recipeHops = this->hops();
+   IbuMethods::HopAdditions hopAdditions;
+   hopAdditions.reserve(recipeHops.size());
+   for (Hop const * hop : recipeHops) {
+      appendHopAddition(hopAdditions, *hop);
    }
+   return hopAdditions;
+}
 
-   if (hop->use() == Hop::Use::Boil) {
-      ibus = IbuMethods::getIbus(AArating, grams, m_finalVolumeNoLosses_l, m_og, minutes);
-   } else if (hop->use() == Hop::Use::First_Wort) {
-      ibus = fwhAdjust * IbuMethods::getIbus(AArating, grams, m_finalVolumeNoLosses_l, m_og, boilTime);
-   } else if (hop->use() == Hop::Use::Mash && mashHopAdjust > 0.0) {
-      ibus = mashHopAdjust * IbuMethods::getIbus(AArating, grams, m_finalVolumeNoLosses_l, m_og, boilTime);
+double Recipe::ibuFromHop(Hop const * hop) {
+   if (hop == nullptr) {
+      return 0.0;
    }
 
-   // Adjust for hop form. Tinseth's table was created from whole cone data,
-   // and it seems other formulae are optimized that way as well. So, the
-   // utilization is considered unadjusted for whole cones, and adjusted
-   // up for plugs and pellets.
-   //
-   // - http://www.realbeer.com/hops/FAQ.html
-   // - https://groups.google.com/forum/#!topic"brewtarget.h"lp/mv2qvWBC4sU
-   switch (hop->form()) {
-      case Hop::Form::Plug:
-         hopUtilization *= 1.02;
-         break;
-      case Hop::Form::Pellet:
-         hopUtilization *= 1.10;
-         break;
-      default:
-         break;
-   }
-
-   // Adjust for hop utilization.
-   ibus *= hopUtilization;
-
-   return ibus;
+   // Adjustments for hop use, hop form (see appendHopAddition) and equipment hop utilization are all handled in
+   // IbuMethods::getIbus.
+   IbuMethods::HopAdditions hopAdditions;
+   appendHopAddition(hopAdditions, *hop);
+   double ibus = 0.0;
+   return IbuMethods::getIbus(hopAdditions, this->ibuConstants(), BtSpan::span<double>{&ibus, 1});
 }
 
 // this was fixed, but not with an at
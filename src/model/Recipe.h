@@ -35,6 +35,7 @@
 #include <QVariant>
 #include <QVector>
 
+#include "measurement/IbuMethods.h"
 #include "model/BrewNote.h"
 #include "model/NamedEntity.h"
 #include "model/Hop.h" // Dammit! Have to include these for Hop::Use (see hopSteps()) and Misc::Use (see miscSteps()).
@@ -63,6 +64,7 @@ AddPropertyName(carbonation_vols  )
 AddPropertyName(color_srm         )
 AddPropertyName(date              )
 AddPropertyName(efficiency_pct    )
+AddPropertyName(efficiencyStdDev_pct)
 AddPropertyName(equipment         )
 AddPropertyName(equipmentId       )
 AddPropertyName(fermentableIds    )
@@ -174,6 +176,8 @@ public:
    Q_PROPERTY(double boilTime_min READ boilTime_min WRITE setBoilTime_min /*NOTIFY changed*/ /*changedBoilTime_min*/)
    //! \brief The overall efficiency in percent.
    Q_PROPERTY(double efficiency_pct READ efficiency_pct WRITE setEfficiency_pct /*NOTIFY changed*/ /*changedEfficiency_pct*/)
+   //! \brief Standard deviation of the efficiency from one brew day to the next, for uncertainty estimates.
+   Q_PROPERTY(double efficiencyStdDev_pct READ efficiencyStdDev_pct WRITE setEfficiencyStdDev_pct /*NOTIFY changed*/ /*changedEfficiencyStdDev_pct*/)
    //! \brief The assistant brewer.
    Q_PROPERTY(QString asstBrewer READ asstBrewer WRITE setAsstBrewer /*NOTIFY changed*/ /*changedAsstBrewer*/)
    //! \brief The notes.
@@ -370,8 +374,17 @@ public:
    void clearInstructions();
    //! \brief Insert instruction ins into slot pos.
    void insertInstruction(Instruction const & ins, int pos);
-   //! \brief Automagically generate a list of instructions.
+   /**
+    * \brief Automagically generate a list of instructions.  Existing instructions that are still correct are kept, so
+    *        regenerating after a small change only rewrites what actually changed.
+    */
    void generateInstructions();
+   /**
+    * \brief Make our stored instructions match \c wanted, with as few inserts, updates and deletes as possible, all in
+    *        one database transaction.  Instructions whose text is unchanged are left alone (so, eg, they stay marked as
+    *        completed if they were).
+    */
+   void applyInstructions(QVector<PreInstruction> const & wanted);
    /*!
     * Finds the next ingredient to add that has a time
     * less than time. Changes time to be the time of the found
@@ -397,6 +410,7 @@ public:
    double  boilSize_l()         const;
    double  boilTime_min()       const;
    double  efficiency_pct()     const;
+   double  efficiencyStdDev_pct() const;
    QString asstBrewer()         const;
    QString notes()              const;
    QString tasteNotes()         const;
@@ -507,6 +521,16 @@ public:
    // Helpers
    //! \brief Get the ibus from a given \c hop.
    double ibuFromHop(Hop const * hop);
+   /**
+    * \brief Get the inputs to the IBU calculation that are the same for all hops in this recipe (gravity, volume,
+    *        equipment settings and the user's first wort/mash hop adjustments).
+    */
+   IbuMethods::RecipeIbuConstants ibuConstants() const;
+   /**
+    * \brief Get this recipe's hops in the form the batch IBU calculation wants, ie with each hop's use and form turned
+    *        into the timings and multipliers that \c IbuMethods works with.
+    */
+   IbuMethods::HopAdditions hopAdditions() const;
    //! \brief Formats the fermentables for instructions
    QList<QString> getReagents(QList<Fermentable *> ferms);
    //! \brief Formats the mashsteps for instructions
@@ -524,6 +548,7 @@ public:
    void setBoilSize_l        (double  const   val);
    void setBoilTime_min      (double  const   val);
    void setEfficiency_pct    (double  const   val);
+   void setEfficiencyStdDev_pct(double const   val);
    void setAsstBrewer        (QString const & val);
    void setNotes             (QString const & val);
    void setTasteNotes        (QString const & val);
@@ -585,6 +610,7 @@ private:
    double m_boilSize_l;
    double m_boilTime_min;
    double m_efficiency_pct;
+   double m_efficiencyStdDev_pct;
    int m_fermentationStages;
    double m_primaryAge_days;
    double m_primaryTemp_c;
@@ -677,17 +703,22 @@ private:
    // Emits changed(og), changed(fg). Depends on: _wortFromMash_l, _finalVolume_l
    Q_INVOKABLE void recalcOgFg();
 
-   // Adds instructions to the recipe.
-   void postboilFermentablesIns();
-   void postboilIns();
-   void mashFermentableIns();
-   void mashWaterIns();
-   void firstWortHopsIns();
-   void topOffIns();
-   void saltWater(Salt::WhenToAdd when);
+   // Append instructions to the supplied list.  (None of these modify the recipe.)
+   void postboilFermentablesIns(QVector<PreInstruction> & instructions);
+   void postboilIns(QVector<PreInstruction> & instructions);
+   void mashFermentableIns(QVector<PreInstruction> & instructions);
+   void mashWaterIns(QVector<PreInstruction> & instructions);
+   void firstWortHopsIns(QVector<PreInstruction> & instructions);
+   void topOffIns(QVector<PreInstruction> & instructions);
+   void saltWater(QVector<PreInstruction> & instructions, Salt::WhenToAdd when);
 
    //void setDefaults();
-   void addPreinstructions(QVector<PreInstruction> preins);
+   void addPreinstructions(QVector<PreInstruction> & instructions, QVector<PreInstruction> preins);
+
+   /**
+    * \brief Work out, but do not store, the full list of brew day instructions for this recipe, in order
+    */
+   QVector<PreInstruction> computeInstructions();
    bool isValidType(const QString & str);
 };
 
@@ -71,6 +71,7 @@ TypeLookup const Yeast::typeLookup {
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Yeast::amount            , Yeast::m_amount            ,           NonPhysicalQuantity::Dimensionless), // Not really Dimensionless
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Yeast::amountIsWeight    , Yeast::m_amountIsWeight    ,           NonPhysicalQuantity::Bool         ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Yeast::attenuation_pct   , Yeast::m_attenuation_pct   ,           NonPhysicalQuantity::Percentage   ),
+      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Yeast::attenuationStdDev_pct, Yeast::m_attenuationStdDev_pct,        NonPhysicalQuantity::Percentage   ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Yeast::bestFor           , Yeast::m_bestFor           ,           NonPhysicalQuantity::String       ),
       PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Yeast::flocculation      , Yeast::m_flocculation      ),
 //      PROPERTY_TYPE_LOOKUP_ENTRY(PropertyNames::Yeast::flocculationString, Yeast::m_flocculationString),
@@ -106,6 +107,7 @@ Yeast::Yeast(QString name) :
    m_minTemperature_c      {0.0},
    m_maxTemperature_c      {0.0},
    m_attenuation_pct       {0.0},
+   m_attenuationStdDev_pct {0.0},
    m_notes                 {""},
    m_bestFor               {""},
    m_timesCultured         {0},
@@ -126,6 +128,7 @@ Yeast::Yeast(NamedParameterBundle const & namedParameterBundle) :
    m_minTemperature_c      {namedParameterBundle.val<double             >(PropertyNames::Yeast::minTemperature_c)},
    m_maxTemperature_c      {namedParameterBundle.val<double             >(PropertyNames::Yeast::maxTemperature_c)},
    m_attenuation_pct       {namedParameterBundle.val<double             >(PropertyNames::Yeast::attenuation_pct )},
+   m_attenuationStdDev_pct {namedParameterBundle.val<double             >(PropertyNames::Yeast::attenuationStdDev_pct, 0.0)},
    m_notes                 {namedParameterBundle.val<QString            >(PropertyNames::Yeast::notes           )},
    m_bestFor               {namedParameterBundle.val<QString            >(PropertyNames::Yeast::bestFor         )},
    m_timesCultured         {namedParameterBundle.val<int                >(PropertyNames::Yeast::timesCultured   )},
@@ -146,6 +149,7 @@ Yeast::Yeast(Yeast const & other) :
    m_minTemperature_c      {other.m_minTemperature_c  },
    m_maxTemperature_c      {other.m_maxTemperature_c  },
    m_attenuation_pct       {other.m_attenuation_pct   },
+   m_attenuationStdDev_pct {other.m_attenuationStdDev_pct},
    m_notes                 {other.m_notes             },
    m_bestFor               {other.m_bestFor           },
    m_timesCultured         {other.m_timesCultured     },
@@ -179,6 +183,8 @@ double Yeast::maxTemperature_c() const { return m_maxTemperature_c; }
 
 double Yeast::attenuation_pct() const { return m_attenuation_pct; }
 
+double Yeast::attenuationStdDev_pct() const { return m_attenuationStdDev_pct; }
+
 double Yeast::inventory() const {
    return InventoryUtils::getAmount(*this);
 }
@@ -285,6 +291,12 @@ void Yeast::setAttenuation_pct(double var) {
                       this->enforceMinAndMax(var, "pct attenuation", 0.0, 100.0, 0.0));
 }
 
+void Yeast::setAttenuationStdDev_pct(double var) {
+   this->setAndNotify(PropertyNames::Yeast::attenuationStdDev_pct,
+                      this->m_attenuationStdDev_pct,
+                      this->enforceMinAndMax(var, "attenuation std dev", 0.0, 100.0, 0.0));
+}
+
 void Yeast::setNotes(QString const & var) {
    this->setAndNotify(PropertyNames::Yeast::notes, this->m_notes, var);
 }
@@ -38,6 +38,7 @@ AddPropertyName(addToSecondary    )
 AddPropertyName(amount            )
 AddPropertyName(amountIsWeight    )
 AddPropertyName(attenuation_pct   )
+AddPropertyName(attenuationStdDev_pct)
 AddPropertyName(bestFor           )
 AddPropertyName(flocculation      )
 AddPropertyName(flocculationString)
@@ -126,6 +127,8 @@ public:
    Q_PROPERTY( QString flocculationStringTr READ flocculationStringTr )
    //! \brief The apparent attenuation in percent.
    Q_PROPERTY( double attenuation_pct READ attenuation_pct WRITE setAttenuation_pct /*NOTIFY changed*/ /*changedAttenuation_pct*/ )
+   //! \brief Standard deviation of the apparent attenuation between batches, for uncertainty estimates.  0 means exact.
+   Q_PROPERTY( double attenuationStdDev_pct READ attenuationStdDev_pct WRITE setAttenuationStdDev_pct /*NOTIFY changed*/ /*changedAttenuationStdDev_pct*/ )
    //! \brief The notes.
    Q_PROPERTY( QString notes READ notes WRITE setNotes /*NOTIFY changed*/ /*changedNotes*/ )
    //! \brief What styles the strain is best for.
@@ -150,6 +153,7 @@ public:
    void setMaxTemperature_c( double var);
    void setFlocculation( Flocculation f);
    void setAttenuation_pct( double var);
+   void setAttenuationStdDev_pct( double var);
    void setNotes( const QString& var);
    void setBestFor( const QString& var);
    void setTimesCultured( int var);
@@ -174,6 +178,7 @@ public:
    const QString flocculationString() const;
    const QString flocculationStringTr() const;
    double attenuation_pct() const;
+   double attenuationStdDev_pct() const;
    QString notes() const;
    QString bestFor() const;
    int timesCultured() const;
@@ -199,6 +204,7 @@ private:
    double m_minTemperature_c;
    double m_maxTemperature_c;
    double m_attenuation_pct;
+   double m_attenuationStdDev_pct;
    QString m_notes;
    QString m_bestFor;
    int m_timesCultured;
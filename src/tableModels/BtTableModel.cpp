@@ -19,10 +19,14 @@
  */
 #include "tableModels/BtTableModel.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <QAction>
 #include <QDebug>
 #include <QHeaderView>
 #include <QMenu>
+#include <QTimer>
 
 #include "measurement/Measurement.h"
 #include "measurement/Unit.h"
@@ -69,12 +73,67 @@ BtTableModel::BtTableModel(QTableView * parent,
    QAbstractTableModel{parent},
    parentTableWidget{parent},
    editable{editable},
-   m_columnInfos{columnInfos} {
+   m_columnInfos{columnInfos},
+   m_dataChangedQueued{false},
+   m_queuedFirstRow{0},
+   m_queuedLastRow{0},
+   m_queuedFirstColumn{0},
+   m_queuedLastColumn{0} {
+   // A queued change could refer to rows that have since moved, so, if the rows change, we redraw them all instead
+   connect(this, &QAbstractItemModel::rowsInserted,  this, &BtTableModel::queuedRowsMoved);
+   connect(this, &QAbstractItemModel::rowsRemoved,   this, &BtTableModel::queuedRowsMoved);
+   connect(this, &QAbstractItemModel::rowsMoved,     this, &BtTableModel::queuedRowsMoved);
+   connect(this, &QAbstractItemModel::modelReset,    this, &BtTableModel::queuedRowsMoved);
+   connect(this, &QAbstractItemModel::layoutChanged, this, &BtTableModel::queuedRowsMoved);
    return;
 }
 
 BtTableModel::~BtTableModel() = default;
 
+void BtTableModel::queueDataChanged(int const firstRow,
+                                    int const lastRow,
+                                    int const firstColumn,
+                                    int const lastColumn) {
+   if (!this->m_dataChangedQueued) {
+      this->m_dataChangedQueued = true;
+      this->m_queuedFirstRow    = firstRow;
+      this->m_queuedLastRow     = lastRow;
+      this->m_queuedFirstColumn = firstColumn;
+      this->m_queuedLastColumn  = lastColumn;
+      QTimer::singleShot(0, this, &BtTableModel::emitQueuedDataChanged);
+      return;
+   }
+   this->m_queuedFirstRow    = std::min(this->m_queuedFirstRow,    firstRow);
+   this->m_queuedLastRow     = std::max(this->m_queuedLastRow,     lastRow);
+   this->m_queuedFirstColumn = std::min(this->m_queuedFirstColumn, firstColumn);
+   this->m_queuedLastColumn  = std::max(this->m_queuedLastColumn,  lastColumn);
+   return;
+}
+
+void BtTableModel::emitQueuedDataChanged() {
+   if (!this->m_dataChangedQueued) {
+      return;
+   }
+   this->m_dataChangedQueued = false;
+
+   int const lastRow    = std::min(this->m_queuedLastRow,    this->rowCount()    - 1);
+   int const lastColumn = std::min(this->m_queuedLastColumn, this->columnCount() - 1);
+   if (this->m_queuedFirstRow > lastRow || this->m_queuedFirstColumn > lastColumn) {
+      return;
+   }
+   emit dataChanged(this->index(this->m_queuedFirstRow, this->m_queuedFirstColumn),
+                    this->index(lastRow,                lastColumn));
+   return;
+}
+
+void BtTableModel::queuedRowsMoved() {
+   if (this->m_dataChangedQueued) {
+      this->m_queuedFirstRow = 0;
+      this->m_queuedLastRow  = std::numeric_limits<int>::max();
+   }
+   return;
+}
+
 BtTableModel::ColumnInfo const & BtTableModel::getColumnInfo(size_t const columnIndex) const {
    // It's a coding error to call this for a non-existent column
    Q_ASSERT(columnIndex < this->m_columnInfos.size());
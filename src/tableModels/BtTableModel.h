@@ -28,8 +28,11 @@
 #include <QHeaderView>
 #include <QMap>
 #include <QMenu>
+#include <QMetaProperty>
 #include <QPoint>
+#include <QSet>
 #include <QTableView>
+#include <QVariant>
 
 #include "BtFieldType.h"
 #include "measurement/UnitSystem.h"
@@ -181,6 +184,13 @@ protected:
 class BtTableModel : public QAbstractTableModel {
    Q_OBJECT
 public:
+   /**
+    * \brief Role for which \c data() returns the underlying value of a cell rather than its display text: amounts as
+    *        \c double in canonical (SI) units, enums as their \c int value, bools as \c bool, and text as \c QString.
+    *        Proxy models sort on this so they don't have to parse what we display back into numbers.
+    */
+   static int constexpr SortRole = Qt::UserRole + 1;
+
    /**
     * \brief This per-column struct / mini-class holds basic info about each column in the table.  It also plays a
     *        slightly similar role as \c SmartLabel.  However, there are several important differences, including that
@@ -268,7 +278,87 @@ public slots:
    // for changing units and scales
    void contextMenu(QPoint const & point);
 
+private slots:
+   void emitQueuedDataChanged();
+   void queuedRowsMoved();
+
 protected:
+   /**
+    * \brief Make \c rows match \c newRows using as few row removals, moves and insertions as we can, rather than
+    *        removing everything and adding it all back.  Views then keep their selection and scroll position, and only
+    *        the objects that actually arrive or leave get connected to or disconnected from \c changedSlot.
+    *
+    *        Rows are first removed (in contiguous runs) if their object is not in \c newRows, then we walk \c newRows
+    *        in order, moving up any row that is further down and inserting (again in runs) any object we don't have.
+    *        So adding or removing one hop from a recipe is one insert or one remove, whatever the size of the table.
+    */
+   template<class NE, class Derived>
+   void updateRows(QList<std::shared_ptr<NE>> & rows,
+                   QList<std::shared_ptr<NE>> const & newRows,
+                   void (Derived::*changedSlot)(QMetaProperty, QVariant)) {
+      QSet<NE const *> wanted;
+      QList<std::shared_ptr<NE>> targetRows;
+      for (auto const & ne : newRows) {
+         if (!wanted.contains(ne.get())) {
+            wanted.insert(ne.get());
+            targetRows.append(ne);
+         }
+      }
+
+      for (int lastRow = rows.size() - 1; lastRow >= 0; --lastRow) {
+         if (wanted.contains(rows.at(lastRow).get())) {
+            continue;
+         }
+         int firstRow = lastRow;
+         while (firstRow > 0 && !wanted.contains(rows.at(firstRow - 1).get())) {
+            --firstRow;
+         }
+         this->beginRemoveRows(QModelIndex(), firstRow, lastRow);
+         for (int row = lastRow; row >= firstRow; --row) {
+            disconnect(rows.takeAt(row).get(), nullptr, this, nullptr);
+         }
+         this->endRemoveRows();
+         lastRow = firstRow;
+      }
+
+      QSet<NE const *> present;
+      for (auto const & ne : rows) {
+         present.insert(ne.get());
+      }
+
+      for (int row = 0; row < targetRows.size(); ++row) {
+         if (row < rows.size() && rows.at(row) == targetRows.at(row)) {
+            continue;
+         }
+         if (present.contains(targetRows.at(row).get())) {
+            int const from = rows.indexOf(targetRows.at(row), row + 1);
+            this->beginMoveRows(QModelIndex(), from, from, QModelIndex(), row);
+            rows.move(from, row);
+            this->endMoveRows();
+            continue;
+         }
+         int lastRow = row;
+         while (lastRow + 1 < targetRows.size() && !present.contains(targetRows.at(lastRow + 1).get())) {
+            ++lastRow;
+         }
+         this->beginInsertRows(QModelIndex(), row, lastRow);
+         for (int newRow = row; newRow <= lastRow; ++newRow) {
+            rows.insert(newRow, targetRows.at(newRow));
+            connect(targetRows.at(newRow).get(), &NamedEntity::changed, static_cast<Derived *>(this), changedSlot);
+         }
+         this->endInsertRows();
+         row = lastRow;
+      }
+      return;
+   }
+
+   /**
+    * \brief Ask for \c dataChanged to be emitted for a block of cells.  Requests are merged into one range, which is
+    *        emitted on the next pass through the event loop, so that, eg, a recipe recalculation that touches every row
+    *        costs the views one repaint rather than one per row.
+    */
+   void queueDataChanged(int firstRow, int lastRow, int firstColumn, int lastColumn);
+
    QTableView* parentTableWidget;
    bool editable;
 private:
@@ -276,6 +366,12 @@ private:
     * \brief The order of
     */
    std::vector<ColumnInfo> const m_columnInfos;
+
+   bool m_dataChangedQueued;
+   int m_queuedFirstRow;
+   int m_queuedLastRow;
+   int m_queuedFirstColumn;
+   int m_queuedLastColumn;
 };
 
 class BtTableModelRecipeObserver : public BtTableModel {
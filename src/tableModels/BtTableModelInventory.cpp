@@ -22,12 +22,25 @@ BtTableModelInventory::BtTableModelInventory(QTableView * parent,
                                              bool editable,
                                              std::initializer_list<BtTableModel::ColumnInfo> columnInfos) :
    BtTableModelRecipeObserver{parent, editable, columnInfos},
-   inventoryEditable{false} {
+   inventoryEditable{false},
+   m_rowsByInventoryId{},
+   m_rowsByInventoryIdValid{false} {
+   auto invalidate = [this]() { this->invalidateInventoryRows(); };
+   connect(this, &QAbstractItemModel::rowsInserted,  this, invalidate);
+   connect(this, &QAbstractItemModel::rowsRemoved,   this, invalidate);
+   connect(this, &QAbstractItemModel::rowsMoved,     this, invalidate);
+   connect(this, &QAbstractItemModel::modelReset,    this, invalidate);
+   connect(this, &QAbstractItemModel::layoutChanged, this, invalidate);
    return;
 }
 
 BtTableModelInventory::~BtTableModelInventory() = default;
 
+void BtTableModelInventory::invalidateInventoryRows() {
+   this->m_rowsByInventoryIdValid = false;
+   return;
+}
+
 void BtTableModelInventory::setInventoryEditable(bool var) {
    this->inventoryEditable = var;
    return;
@@ -20,6 +20,9 @@
 #define TABLEMODELS_BTTABLEMODELINVENTORY_H
 #pragma once
 
+#include <QList>
+#include <QMultiHash>
+
 #include "tableModels/BtTableModel.h"
 
 /**
@@ -42,8 +45,33 @@ public:
    void setInventoryEditable(bool var);
    bool isInventoryEditable() const;
 
+protected:
+   /**
+    * \brief The rows showing an ingredient with the given inventory ID -- usually one, but a recipe can use the same
+    *        ingredient twice, and copies of an ingredient share its inventory.
+    *
+    *        The lookup table is rebuilt after rows are added, removed or moved (or \c invalidateInventoryRows is
+    *        called), so a change to one inventory amount doesn't mean looking through every row.
+    */
+   template<class NE>
+   QList<int> rowsWithInventoryId(QList<std::shared_ptr<NE>> const & rows, int const inventoryId) const {
+      if (!this->m_rowsByInventoryIdValid) {
+         this->m_rowsByInventoryId.clear();
+         for (int row = 0; row < rows.size(); ++row) {
+            this->m_rowsByInventoryId.insert(rows.at(row)->inventoryId(), row);
+         }
+         this->m_rowsByInventoryIdValid = true;
+      }
+      return this->m_rowsByInventoryId.values(inventoryId);
+   }
+
+   //! \brief Subclasses should call this when the inventory ID of one of their rows changes
+   void invalidateInventoryRows();
+
 private:
    bool inventoryEditable;
+   mutable QMultiHash<int, int> m_rowsByInventoryId;
+   mutable bool m_rowsByInventoryIdValid;
 };
 
 #endif
@@ -260,13 +260,10 @@ void FermentableTableModel::setDisplayPercentages(bool var) {
 }
 
 void FermentableTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
-
    if (propertyName == PropertyNames::Inventory::amount) {
-      for (int ii = 0; ii < this->rows.size(); ++ii) {
-         if (invKey == this->rows.at(ii)->inventoryId()) {
-            emit dataChanged(QAbstractItemModel::createIndex(ii, static_cast<int>(FermentableTableModel::ColumnIndex::Inventory)),
-                             QAbstractItemModel::createIndex(ii, static_cast<int>(FermentableTableModel::ColumnIndex::Inventory)));
-         }
+      int const column = static_cast<int>(FermentableTableModel::ColumnIndex::Inventory);
+      for (int const row : this->rowsWithInventoryId(this->rows, invKey)) {
+         this->queueDataChanged(row, row, column, column);
       }
    }
    return;
@@ -283,9 +280,11 @@ void FermentableTableModel::changed(QMetaProperty prop, [[maybe_unused]] QVarian
          return;
       }
 
+      if (prop.name() == PropertyNames::NamedEntityWithInventory::inventoryId) {
+         this->invalidateInventoryRows();
+      }
       this->updateTotalGrains();
-      emit dataChanged(QAbstractItemModel::createIndex(ii, 0),
-                       QAbstractItemModel::createIndex(ii, this->columnCount() - 1));
+      this->queueDataChanged(ii, ii, 0, this->columnCount() - 1);
       if (displayPercentages && rowCount() > 0) {
          emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
       }
@@ -295,8 +294,8 @@ void FermentableTableModel::changed(QMetaProperty prop, [[maybe_unused]] QVarian
    // See if our recipe gained or lost fermentables.
    Recipe* recSender = qobject_cast<Recipe*>(sender());
    if (recSender && recSender == recObs && prop.name() == PropertyNames::Recipe::fermentableIds) {
-      this->removeAll();
-      this->addFermentables(this->recObs->getAll<Fermentable>());
+      this->updateRows(this->rows, this->recObs->getAll<Fermentable>(), &FermentableTableModel::changed);
+      this->updateTotalGrains();
    }
 
    return;
@@ -323,7 +322,7 @@ QVariant FermentableTableModel::data(QModelIndex const & index, int role) const
    auto const columnIndex = static_cast<FermentableTableModel::ColumnIndex>(index.column());
    switch (columnIndex) {
       case FermentableTableModel::ColumnIndex::Name:
-         if (role == Qt::DisplayRole) {
+         if (role == Qt::DisplayRole || role == BtTableModel::SortRole) {
             return QVariant(row->name());
          }
          break;
@@ -331,7 +330,7 @@ QVariant FermentableTableModel::data(QModelIndex const & index, int role) const
          if (role == Qt::DisplayRole) {
             return QVariant(Fermentable::typeDisplayNames[row->type()]);
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->type()));
          }
          break;
@@ -344,6 +343,9 @@ QVariant FermentableTableModel::data(QModelIndex const & index, int role) const
                                           std::nullopt)
             );
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->inventory());
+         }
          break;
       case FermentableTableModel::ColumnIndex::Amount:
          if (role == Qt::DisplayRole) {
@@ -354,12 +356,15 @@ QVariant FermentableTableModel::data(QModelIndex const & index, int role) const
                                           std::nullopt)
             );
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->amount_kg());
+         }
          break;
       case FermentableTableModel::ColumnIndex::IsMashed:
          if (role == Qt::DisplayRole) {
             return QVariant(descIsMashed[static_cast<int>(row->isMashed())]);
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(row->isMashed());
          }
          break;
@@ -367,7 +372,7 @@ QVariant FermentableTableModel::data(QModelIndex const & index, int role) const
          if (role == Qt::DisplayRole) {
             return QVariant(descAddAfterBoil[static_cast<int>(row->addAfterBoil())]);
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(row->addAfterBoil());
          }
          break;
@@ -375,6 +380,9 @@ QVariant FermentableTableModel::data(QModelIndex const & index, int role) const
          if (role == Qt::DisplayRole) {
             return QVariant(Measurement::displayQuantity(row->yield_pct(), 3));
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->yield_pct());
+         }
          break;
       case FermentableTableModel::ColumnIndex::Color:
          if (role == Qt::DisplayRole) {
@@ -385,6 +393,9 @@ QVariant FermentableTableModel::data(QModelIndex const & index, int role) const
                                           std::nullopt)
             );
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->color_srm());
+         }
          break;
       default :
          qCritical() << Q_FUNC_INFO << "Bad column: " << index.column();
@@ -217,11 +217,9 @@ void HopTableModel::removeAll() {
 
 void HopTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
    if (propertyName == PropertyNames::Inventory::amount) {
-      for (int ii = 0; ii < this->rows.size(); ++ii) {
-         if (invKey == this->rows.at(ii)->inventoryId()) {
-            emit dataChanged(QAbstractItemModel::createIndex(ii, static_cast<int>(HopTableModel::ColumnIndex::Inventory)),
-                             QAbstractItemModel::createIndex(ii, static_cast<int>(HopTableModel::ColumnIndex::Inventory)));
-         }
+      int const column = static_cast<int>(HopTableModel::ColumnIndex::Inventory);
+      for (int const row : this->rowsWithInventoryId(this->rows, invKey)) {
+         this->queueDataChanged(row, row, column, column);
       }
    }
    return;
@@ -237,8 +235,10 @@ void HopTableModel::changed(QMetaProperty prop, [[maybe_unused]] QVariant val) {
          return;
       }
 
-      emit dataChanged(QAbstractItemModel::createIndex(ii, 0),
-                       QAbstractItemModel::createIndex(ii, this->columnCount() - 1));
+      if (prop.name() == PropertyNames::NamedEntityWithInventory::inventoryId) {
+         this->invalidateInventoryRows();
+      }
+      this->queueDataChanged(ii, ii, 0, this->columnCount() - 1);
       emit headerDataChanged(Qt::Vertical, ii, ii);
       return;
    }
@@ -247,8 +247,7 @@ void HopTableModel::changed(QMetaProperty prop, [[maybe_unused]] QVariant val) {
    Recipe * recSender = qobject_cast<Recipe *>(sender());
    if (recSender && recSender == recObs) {
       if (QString(prop.name()) == PropertyNames::Recipe::hopIds) {
-         removeAll();
-         this->addHops(recObs->getAll<Hop>());
+         this->updateRows(this->rows, this->recObs->getAll<Hop>(), &HopTableModel::changed);
       }
       if (rowCount() > 0) {
          emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
@@ -275,7 +274,7 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
    auto const columnIndex = static_cast<HopTableModel::ColumnIndex>(index.column());
    switch (columnIndex) {
       case HopTableModel::ColumnIndex::Name:
-         if (role == Qt::DisplayRole) {
+         if (role == Qt::DisplayRole || role == BtTableModel::SortRole) {
             return QVariant(row->name());
          }
          break;
@@ -283,6 +282,9 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
          if (role == Qt::DisplayRole) {
             return QVariant(Measurement::displayQuantity(row->alpha_pct(), 3));
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->alpha_pct());
+         }
          break;
       case HopTableModel::ColumnIndex::Inventory:
          if (role == Qt::DisplayRole) {
@@ -291,6 +293,9 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
                                                        this->getColumnInfo(columnIndex).getForcedSystemOfMeasurement(),
                                                        this->getColumnInfo(columnIndex).getForcedRelativeScale()));
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->inventory());
+         }
          break;
       case HopTableModel::ColumnIndex::Amount:
          if (role == Qt::DisplayRole) {
@@ -299,12 +304,15 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
                                                        this->getColumnInfo(columnIndex).getForcedSystemOfMeasurement(),
                                                        this->getColumnInfo(columnIndex).getForcedRelativeScale()));
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->amount_kg());
+         }
          break;
       case HopTableModel::ColumnIndex::Use:
          if (role == Qt::DisplayRole) {
             return QVariant(Hop::useDisplayNames[row->use()]);
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->use()));
          }
          break;
@@ -315,11 +323,14 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
                                                        std::nullopt,
                                                        this->getColumnInfo(columnIndex).getForcedRelativeScale()));
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->time_min());
+         }
          break;
       case HopTableModel::ColumnIndex::Form:
          if (role == Qt::DisplayRole) {
             return QVariant(Hop::formDisplayNames[row->form()]);
-         } else if (role == Qt::UserRole) {
+         } else if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->form()));
          }
          break;
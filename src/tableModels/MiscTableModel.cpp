@@ -205,7 +205,7 @@ QVariant MiscTableModel::data(QModelIndex const & index, int role) const {
    auto const columnIndex = static_cast<MiscTableModel::ColumnIndex>(index.column());
    switch (columnIndex) {
       case MiscTableModel::ColumnIndex::Name:
-         if (role == Qt::DisplayRole) {
+         if (role == Qt::DisplayRole || role == BtTableModel::SortRole) {
             return QVariant(row->name());
          }
          break;
@@ -213,7 +213,7 @@ QVariant MiscTableModel::data(QModelIndex const & index, int role) const {
          if (role == Qt::DisplayRole) {
             return QVariant(row->typeStringTr());
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->type()));
          }
          break;
@@ -221,7 +221,7 @@ QVariant MiscTableModel::data(QModelIndex const & index, int role) const {
          if (role == Qt::DisplayRole) {
             return QVariant(row->useStringTr());
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->use()));
          }
          return QVariant();
@@ -232,6 +232,9 @@ QVariant MiscTableModel::data(QModelIndex const & index, int role) const {
                                                        std::nullopt,
                                                        this->getColumnInfo(columnIndex).getForcedRelativeScale()));
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->time());
+         }
          break;
       case MiscTableModel::ColumnIndex::Inventory:
          if (role == Qt::DisplayRole) {
@@ -246,6 +249,9 @@ QVariant MiscTableModel::data(QModelIndex const & index, int role) const {
                                           std::nullopt)
             );
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->inventory());
+         }
          break;
       case MiscTableModel::ColumnIndex::Amount:
          if (role == Qt::DisplayRole) {
@@ -260,12 +266,15 @@ QVariant MiscTableModel::data(QModelIndex const & index, int role) const {
                                           std::nullopt)
             );
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->amount());
+         }
          break;
       case MiscTableModel::ColumnIndex::IsWeight:
          if (role == Qt::DisplayRole) {
             return QVariant(row->amountTypeStringTr());
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->amountType()));
          }
          break;
@@ -399,11 +408,9 @@ bool MiscTableModel::setData(QModelIndex const & index,
 
 void MiscTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
    if (propertyName == PropertyNames::Inventory::amount) {
-      for (int ii = 0; ii < this->rows.size(); ++ii) {
-         if (invKey == this->rows.at(ii)->inventoryId()) {
-            emit dataChanged(QAbstractItemModel::createIndex(ii, static_cast<int>(MiscTableModel::ColumnIndex::Inventory)),
-                             QAbstractItemModel::createIndex(ii, static_cast<int>(MiscTableModel::ColumnIndex::Inventory)));
-         }
+      int const column = static_cast<int>(MiscTableModel::ColumnIndex::Inventory);
+      for (int const row : this->rowsWithInventoryId(this->rows, invKey)) {
+         this->queueDataChanged(row, row, column, column);
       }
    }
    return;
@@ -414,8 +421,10 @@ void MiscTableModel::changed(QMetaProperty prop, [[maybe_unused]] QVariant val)
    if (miscSender) {
       int ii = this->findIndexOf(miscSender);
       if (ii >= 0) {
-         emit dataChanged(QAbstractItemModel::createIndex(ii, 0),
-                          QAbstractItemModel::createIndex(ii, this->columnCount() - 1) );
+         if (prop.name() == PropertyNames::NamedEntityWithInventory::inventoryId) {
+            this->invalidateInventoryRows();
+         }
+         this->queueDataChanged(ii, ii, 0, this->columnCount() - 1);
       }
       return;
    }
@@ -424,8 +433,7 @@ void MiscTableModel::changed(QMetaProperty prop, [[maybe_unused]] QVariant val)
    Recipe* recSender = qobject_cast<Recipe*>(sender());
    if (recSender && recSender == this->recObs) {
       if (QString(prop.name()) == PropertyNames::Recipe::miscIds) {
-         this->removeAll();
-         this->addMiscs(this->recObs->getAll<Misc>());
+         this->updateRows(this->rows, this->recObs->getAll<Misc>(), &MiscTableModel::changed);
       }
       if (rowCount() > 0) {
          emit headerDataChanged( Qt::Vertical, 0, rowCount()-1 );
@@ -300,6 +300,40 @@ double SaltTableModel::totalAcidWeight(Salt::Types type) const
    return ret;
 }
 
+void SaltTableModel::setTotals(QList<QPair<Salt::Types, double>> const & totals) {
+   for (auto const & typeAndTotal : totals) {
+      this->setTotal(typeAndTotal.first, typeAndTotal.second);
+   }
+   emit newTotals();
+   return;
+}
+
+void SaltTableModel::setTotal(Salt::Types type, double total) {
+   std::shared_ptr<Salt> first = nullptr;
+   for (auto salt : this->rows) {
+      if (salt->type() == type && salt->whenToAdd() != Salt::WhenToAdd::NEVER) {
+         if (!first) {
+            first = salt;
+         } else {
+            salt->setAmount(0.0);
+         }
+      }
+   }
+
+   if (!first) {
+      if (total <= 0.0) {
+         return;
+      }
+      // As in catchSalt(), this gets stored in the DB in saveAndClose()
+      first = std::make_shared<Salt>("");
+      first->setType(type);
+      first->setWhenToAdd(Salt::WhenToAdd::MASH);
+      this->addSalt(first);
+   }
+   first->setAmount(total / this->multiplier(*first));
+   return;
+}
+
 void SaltTableModel::remove(std::shared_ptr<Salt> salt) {
    int i = this->rows.indexOf(salt);
 
@@ -26,6 +26,7 @@
 #include <QList>
 #include <QMetaProperty>
 #include <QModelIndex>
+#include <QPair>
 #include <QStyleOptionViewItem>
 #include <QVariant>
 #include <QWidget>
@@ -93,6 +94,16 @@ public:
    double total( Salt::Types type ) const;
    double totalAcidWeight(Salt::Types type) const;
 
+   /**
+    * \brief For each (type, total) pair, set the salts of that type so that \c total(type) returns \c total.  The
+    *        whole amount goes on the first salt of that type that is being added (with a new mash addition created if
+    *        there isn't one) and any others are zeroed.
+    *
+    *        \c newTotals is emitted once at the end, rather than once per salt type, as each emission makes the water
+    *        dialog recalculate and redraw everything.
+    */
+   void setTotals(QList<QPair<Salt::Types, double>> const & totals);
+
    void removeSalts(QList<int>deadSalts);
    void saveAndClose();
 
@@ -107,6 +118,8 @@ signals:
 private:
    double spargePct;
    double multiplier(Salt & salt) const;
+   //! \brief Does the work of \c setTotals for one salt type, without emitting \c newTotals
+   void setTotal(Salt::Types type, double total);
 };
 
 /*!
@@ -196,11 +196,9 @@ void YeastTableModel::removeAll() {
 
 void YeastTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
    if (propertyName == PropertyNames::Inventory::amount) {
-      for (int ii = 0; ii < this->rows.size(); ++ii) {
-         if (invKey == this->rows.at(ii)->inventoryId()) {
-            emit dataChanged(QAbstractItemModel::createIndex(ii, static_cast<int>(YeastTableModel::ColumnIndex::Inventory)),
-                             QAbstractItemModel::createIndex(ii, static_cast<int>(YeastTableModel::ColumnIndex::Inventory)));
-         }
+      int const column = static_cast<int>(YeastTableModel::ColumnIndex::Inventory);
+      for (int const row : this->rowsWithInventoryId(this->rows, invKey)) {
+         this->queueDataChanged(row, row, column, column);
       }
    }
    return;
@@ -212,8 +210,10 @@ void YeastTableModel::changed(QMetaProperty prop, QVariant /*val*/) {
    if (yeastSender) {
       int ii = this->findIndexOf(yeastSender);
       if (ii >= 0) {
-         emit dataChanged(QAbstractItemModel::createIndex(ii, 0),
-                          QAbstractItemModel::createIndex(ii, this->columnCount() - 1));
+         if (prop.name() == PropertyNames::NamedEntityWithInventory::inventoryId) {
+            this->invalidateInventoryRows();
+         }
+         this->queueDataChanged(ii, ii, 0, this->columnCount() - 1);
       }
       return;
    }
@@ -222,8 +222,7 @@ void YeastTableModel::changed(QMetaProperty prop, QVariant /*val*/) {
    Recipe * recSender = qobject_cast<Recipe *>(sender());
    if (recSender && recSender == recObs) {
       if (QString(prop.name()) == PropertyNames::Recipe::yeastIds) {
-         removeAll();
-         this->addYeasts(this->recObs->getAll<Yeast>());
+         this->updateRows(this->rows, this->recObs->getAll<Yeast>(), &YeastTableModel::changed);
       }
       if (rowCount() > 0) {
          emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
@@ -248,7 +247,7 @@ QVariant YeastTableModel::data(QModelIndex const & index, int role) const {
    auto const columnIndex = static_cast<YeastTableModel::ColumnIndex>(index.column());
    switch (columnIndex) {
       case YeastTableModel::ColumnIndex::Name:
-         if (role == Qt::DisplayRole) {
+         if (role == Qt::DisplayRole || role == BtTableModel::SortRole) {
             return QVariant(row->name());
          }
          break;
@@ -256,17 +255,17 @@ QVariant YeastTableModel::data(QModelIndex const & index, int role) const {
          if (role == Qt::DisplayRole) {
             return QVariant(row->typeStringTr());
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->type()));
          }
          break;
       case YeastTableModel::ColumnIndex::Lab:
-         if (role == Qt::DisplayRole) {
+         if (role == Qt::DisplayRole || role == BtTableModel::SortRole) {
             return QVariant(row->laboratory());
          }
          break;
       case YeastTableModel::ColumnIndex::ProdId:
-         if (role == Qt::DisplayRole) {
+         if (role == Qt::DisplayRole || role == BtTableModel::SortRole) {
             return QVariant(row->productID());
          }
          break;
@@ -274,12 +273,12 @@ QVariant YeastTableModel::data(QModelIndex const & index, int role) const {
          if (role == Qt::DisplayRole) {
             return QVariant(row->formStringTr());
          }
-         if (role == Qt::UserRole) {
+         if (role == Qt::UserRole || role == BtTableModel::SortRole) {
             return QVariant(static_cast<int>(row->form()));
          }
          break;
       case YeastTableModel::ColumnIndex::Inventory:
-         if (role == Qt::DisplayRole) {
+         if (role == Qt::DisplayRole || role == BtTableModel::SortRole) {
             return QVariant(row->inventory());
          }
          break;
@@ -297,6 +296,9 @@ QVariant YeastTableModel::data(QModelIndex const & index, int role) const {
                )
             );
          }
+         if (role == BtTableModel::SortRole) {
+            return QVariant(row->amount());
+         }
          break;
       default :
          qWarning() << Q_FUNC_INFO << "Bad column: " << index.column();
@@ -23,16 +23,26 @@
  */
 #include "unitTests/Testing.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <exception>
 #include <iostream> // For std::cout
+#include <limits>
 #include <math.h>
 #include <memory>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <vector>
 
 #include <xercesc/util/PlatformUtils.hpp>
 
 #include <QDebug>
+#include <QRegExp>
+#include <QSortFilterProxyModel>
 #include <QString>
+#include <QTableView>
 #include <QtTest/QtTest>
 #if QT_VERSION < QT_VERSION_CHECK(5,10,0)
 #include <QtGlobal> // For qrand() -- which is superseded by QRandomGenerator in later versions of Qt
@@ -42,21 +52,46 @@
 #include <QVector>
 
 #include "Algorithms.h"
+#include "BatchPlanning.h"
+#include "BtTreeModel.h"
 #include "config.h"
+#include "FermentationCurve.h"
+#include "HopSortFilterProxyModel.h"
+#include "LinearAlgebra.h"
+#include "MashSimulation.h"
 #include "database/ObjectStoreWrapper.h"
 #include "Localization.h"
 #include "Logging.h"
+#include "matrix.h"
+#include "measurement/IbuMethods.h"
 #include "measurement/Measurement.h"
+#include "measurement/Quantity.h"
+#include "measurement/SucroseConversion.h"
 #include "measurement/Unit.h"
 #include "measurement/UnitSystem.h"
+#include "model/BrewNote.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Hop.h"
+#include "model/Instruction.h"
 #include "model/Mash.h"
 #include "model/MashStep.h"
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
+#include "model/Salt.h"
+#include "model/Style.h"
 #include "PersistentSettings.h"
+#include "PhysicalConstants.h"
+#include "PreInstruction.h"
+#include "RecipeDisplayQueue.h"
+#include "RecipeSimilarity.h"
+#include "RecipeSweep.h"
+#include "RecipeUncertainty.h"
+#include "SaltSolver.h"
+#include "SequenceDiff.h"
+#include "StyleMatch.h"
+#include "tableModels/HopTableModel.h"
+#include "TextSearch.h"
 
 namespace {
 
@@ -244,6 +279,33 @@ namespace {
       return ret;
    }
 
+   /**
+    * \brief Reference implementation of interpolating \c Measurement::sucroseConversions by binary search, against
+    *        which to check the direct lookups used in \c Algorithms::SgAt20CToBrix and \c Algorithms::BrixToSgAt20C.
+    *        Like them, it clamps to the ends of the table.
+    */
+   double referenceSucroseInterpolation(double const value,
+                                        double Measurement::SucroseConversion::* from,
+                                        double Measurement::SucroseConversion::* to) {
+      auto const first = &Measurement::sucroseConversions[0];
+      auto const last  = &Measurement::sucroseConversions[Measurement::sucroseConversions_size - 1];
+      auto const firstLarger = std::lower_bound(
+         first,
+         last + 1,
+         value,
+         [from](Measurement::SucroseConversion const & lhs, double const rhs) { return lhs.*from < rhs; }
+      );
+      if (firstLarger == last + 1) {
+         return (*last).*to;
+      }
+      if (firstLarger == first) {
+         return (*first).*to;
+      }
+      auto const lastSmaller = firstLarger - 1;
+      double const positionInRange = (value - (*lastSmaller).*from) / ((*firstLarger).*from - (*lastSmaller).*from);
+      return (*lastSmaller).*to + positionInRange * ((*firstLarger).*to - (*lastSmaller).*to);
+   }
+
    // method to fill dummy logs with content to build size
    QString randomStringGenerator() {
       QString const posChars = "ABCDEFGHIJKLMNOPQRSTUVWXYabcdefghijklmnopqrstuvwwxyz";
@@ -262,6 +324,35 @@ namespace {
       return randSTR;
    }
 
+   /**
+    * \brief Seeded source of pseudo-random test data, so benchmarks see the same data on every run.  Has the bits of
+    *        the QRandomGenerator interface we need, but QRandomGenerator itself is only in Qt 5.10 and later.
+    */
+   class TestRandom {
+   public:
+      TestRandom(std::uint32_t const seed) : m_engine{seed} {
+         return;
+      }
+
+      //! \brief Uniform in [0, 1)
+      double generateDouble() {
+         return std::uniform_real_distribution<double>{0.0, 1.0}(this->m_engine);
+      }
+
+      //! \brief Uniform in [lowest, highest)
+      int bounded(int const lowest, int const highest) {
+         return std::uniform_int_distribution<int>{lowest, highest - 1}(this->m_engine);
+      }
+
+      //! \brief Uniform in [0, highest)
+      int bounded(int const highest) {
+         return this->bounded(0, highest);
+      }
+
+   private:
+      std::mt19937 m_engine;
+   };
+
 }
 
 Testing::Testing() :
@@ -744,6 +835,2370 @@ void Testing::testAlgorithms() {
          "Error converting Specific Gravity to Brix"
       );
    }
+
+   //
+   // SgAt20CToBrix and BrixToSgAt20C go straight to the right rows of the USDA data rather than searching for them, so
+   // check they give the same answers as searching would, including exactly at, and just either side of, each row
+   //
+   for (std::size_t ii = 0; ii < Measurement::sucroseConversions_size; ++ii) {
+      Measurement::SucroseConversion const & row = Measurement::sucroseConversions[ii];
+      for (double const delta : {-0.00001, 0.0, 0.00001, 0.0001}) {
+         double const sg = row.apparentSgAt2020C + delta;
+         if (sg > 1.0) {
+            QVERIFY(fuzzyComp(Algorithms::SgAt20CToBrix(sg),
+                              referenceSucroseInterpolation(sg,
+                                                            &Measurement::SucroseConversion::apparentSgAt2020C,
+                                                            &Measurement::SucroseConversion::degreesBrix),
+                              1e-9));
+         }
+         double const brix = row.degreesBrix + 100.0 * delta;
+         QVERIFY(fuzzyComp(Algorithms::BrixToSgAt20C(brix),
+                           referenceSucroseInterpolation(brix,
+                                                         &Measurement::SucroseConversion::degreesBrix,
+                                                         &Measurement::SucroseConversion::apparentSgAt2020C),
+                           1e-9));
+      }
+   }
+
+   //
+   // PlatoToSG_20C20C uses a lookup table rather than root-finding, so check it agrees with the latter across (and a
+   // bit beyond) the range of plausible gravities
+   //
+   for (double plato = -35.0; plato <= 45.0; plato += 0.0625) {
+      QVERIFY2(
+         fuzzyComp(Algorithms::PlatoToSG_20C20C(plato), Algorithms::PlatoToSG_20C20C_byRootFinding(plato), 1e-7),
+         "Error converting Plato to Specific Gravity"
+      );
+      QVERIFY2(
+         fuzzyComp(Algorithms::SG_20C20C_toPlato(Algorithms::PlatoToSG_20C20C(plato)), plato, 1e-5),
+         "Error round-tripping Plato -> Specific Gravity -> Plato"
+      );
+   }
+   return;
+}
+
+void Testing::testBatchAlgorithms() {
+   //
+   // Inputs deliberately go a bit beyond the ends of the ranges of the underlying tables/fits so that we check the
+   // batch versions clamp/fall back the same way as the scalar ones
+   //
+   int constexpr numReadings = 2000;
+   std::vector<double> gravities(numReadings);
+   std::vector<double> degrees(numReadings);
+   std::vector<double> temperatures(numReadings);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      gravities[ii]    =   0.950 + ii * 0.250 / numReadings;
+      degrees[ii]      = -35.0   + ii * 80.0  / numReadings;
+      temperatures[ii] =   0.0   + ii * 40.0  / numReadings;
+   }
+   std::vector<double> results(numReadings);
+
+   Algorithms::SG_20C20C_toPlato(gravities, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::SG_20C20C_toPlato(gravities[ii]), 1e-9));
+   }
+   Algorithms::PlatoToSG_20C20C(degrees, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::PlatoToSG_20C20C(degrees[ii]), 1e-9));
+   }
+   Algorithms::SgAt20CToBrix(gravities, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::SgAt20CToBrix(gravities[ii]), 1e-9));
+   }
+   Algorithms::BrixToSgAt20C(degrees, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::BrixToSgAt20C(degrees[ii]), 1e-9));
+   }
+   Algorithms::refractiveIndex(degrees, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::refractiveIndex(degrees[ii]), 1e-9));
+   }
+   Algorithms::getWaterDensity_kgL(temperatures, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::getWaterDensity_kgL(temperatures[ii]), 1e-9));
+   }
+   Algorithms::hydrometer15CCorrection(temperatures, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::hydrometer15CCorrection(temperatures[ii]), 1e-9));
+   }
+   Algorithms::correctSgForTemperature(gravities, temperatures, 20.0, results);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      QVERIFY(fuzzyComp(results[ii], Algorithms::correctSgForTemperature(gravities[ii], temperatures[ii], 20.0), 1e-9));
+   }
+
+   //
+   // Nonsense inputs (eg the NaN we get from a gravity calculation with zero volume) must not be used to index lookup
+   // tables, and should give the same result as the scalar versions
+   //
+   std::vector<double> const nonsense{std::numeric_limits<double>::quiet_NaN(),
+                                      std::numeric_limits<double>::infinity(),
+                                      -std::numeric_limits<double>::infinity(),
+                                      12.0};
+   std::vector<double> nonsenseResults(nonsense.size());
+   Algorithms::PlatoToSG_20C20C(nonsense, nonsenseResults);
+   for (std::size_t ii = 0; ii < nonsense.size(); ++ii) {
+      double const expected = Algorithms::PlatoToSG_20C20C(nonsense[ii]);
+      qDebug() << Q_FUNC_INFO << nonsense[ii] << "Plato ->" << nonsenseResults[ii] << "SG (expected" << expected << ")";
+      QVERIFY(std::isnan(expected) ? std::isnan(nonsenseResults[ii]) : fuzzyComp(nonsenseResults[ii], expected, 1e-9));
+   }
+   // The sucrose tables clamp rather than extrapolate, so NaN gets the bottom of the table and infinities the ends
+   Algorithms::BrixToSgAt20C(nonsense, nonsenseResults);
+   for (std::size_t ii = 0; ii < nonsense.size(); ++ii) {
+      QVERIFY(fuzzyComp(nonsenseResults[ii], Algorithms::BrixToSgAt20C(nonsense[ii]), 1e-9));
+   }
+   QVERIFY(fuzzyComp(nonsenseResults[0], Algorithms::BrixToSgAt20C(0.0), 1e-9));
+   std::vector<double> const nonsenseGravities{std::numeric_limits<double>::quiet_NaN(),
+                                               std::numeric_limits<double>::infinity(),
+                                               -std::numeric_limits<double>::infinity(),
+                                               1.050};
+   Algorithms::SgAt20CToBrix(nonsenseGravities, nonsenseResults);
+   for (std::size_t ii = 0; ii < nonsenseGravities.size(); ++ii) {
+      QVERIFY(fuzzyComp(nonsenseResults[ii], Algorithms::SgAt20CToBrix(nonsenseGravities[ii]), 1e-9));
+   }
+   QVERIFY(fuzzyComp(nonsenseResults[0], 0.0, 1e-9));
+   return;
+}
+
+void Testing::benchmarkBatchAlgorithms_data() {
+   QTest::addColumn<QString>("conversion");
+   QTest::addColumn<bool>("useBatch");
+   for (QString const conversion : {"SG->Plato", "Plato->SG", "SG->Brix", "Brix->SG", "Temperature correction"}) {
+      QTest::newRow(qPrintable(conversion + " scalar")) << conversion << false;
+      QTest::newRow(qPrintable(conversion + " batch" )) << conversion << true;
+   }
+   return;
+}
+
+void Testing::benchmarkBatchAlgorithms() {
+   QFETCH(QString, conversion);
+   QFETCH(bool, useBatch);
+
+   // 10,000 hydrometer/refractometer readings
+   int constexpr numReadings = 10000;
+   std::vector<double> gravities(numReadings);
+   std::vector<double> degrees(numReadings);
+   std::vector<double> temperatures(numReadings);
+   for (int ii = 0; ii < numReadings; ++ii) {
+      gravities[ii]    = 1.000 + ii * 0.100 / numReadings;
+      degrees[ii]      = ii * 25.0 / numReadings;
+      temperatures[ii] = 10.0 + ii * 20.0 / numReadings;
+   }
+   std::vector<double> results(numReadings);
+
+   QBENCHMARK {
+      if (conversion == "SG->Plato") {
+         if (useBatch) { Algorithms::SG_20C20C_toPlato(gravities, results); }
+         else { for (int ii = 0; ii < numReadings; ++ii) { results[ii] = Algorithms::SG_20C20C_toPlato(gravities[ii]); } }
+      } else if (conversion == "Plato->SG") {
+         if (useBatch) { Algorithms::PlatoToSG_20C20C(degrees, results); }
+         else { for (int ii = 0; ii < numReadings; ++ii) { results[ii] = Algorithms::PlatoToSG_20C20C(degrees[ii]); } }
+      } else if (conversion == "SG->Brix") {
+         if (useBatch) { Algorithms::SgAt20CToBrix(gravities, results); }
+         else { for (int ii = 0; ii < numReadings; ++ii) { results[ii] = Algorithms::SgAt20CToBrix(gravities[ii]); } }
+      } else if (conversion == "Brix->SG") {
+         if (useBatch) { Algorithms::BrixToSgAt20C(degrees, results); }
+         else { for (int ii = 0; ii < numReadings; ++ii) { results[ii] = Algorithms::BrixToSgAt20C(degrees[ii]); } }
+      } else {
+         if (useBatch) { Algorithms::correctSgForTemperature(gravities, temperatures, 20.0, results); }
+         else {
+            for (int ii = 0; ii < numReadings; ++ii) {
+               results[ii] = Algorithms::correctSgForTemperature(gravities[ii], temperatures[ii], 20.0);
+            }
+         }
+      }
+   }
+   QVERIFY(results[numReadings - 1] > 0.0);
+   return;
+}
+
+void Testing::benchmarkRefractometerConversions_data() {
+   QTest::addColumn<int>("whatToRun");
+   QTest::newRow("Brix->SG")               << 0;
+   QTest::newRow("SG->Brix")               << 1;
+   QTest::newRow("Refractometer readings") << 2;
+   return;
+}
+
+void Testing::benchmarkRefractometerConversions() {
+   QFETCH(int, whatToRun);
+   int constexpr numReadings = 2000;
+   double total = 0.0;
+   QBENCHMARK {
+      for (int ii = 0; ii < numReadings; ++ii) {
+         double const reading = ii * 25.0 / numReadings;
+         switch (whatToRun) {
+            case 0: total += Algorithms::BrixToSgAt20C(reading); break;
+            case 1: total += Algorithms::SgAt20CToBrix(1.0 + reading / 250.0); break;
+            default:
+               {
+                  //
+                  // This is the sequence of conversions RefractoDialog::calculate does for one reading, preceded by
+                  // converting the original and current readings from Brix (as read off the refractometer) to Plato
+                  //
+                  double const originalPlato = Measurement::Units::plato.fromCanonical(
+                     Measurement::Units::brix.toCanonical(reading + 5.0).quantity()
+                  );
+                  double const currentPlato = Measurement::Units::plato.fromCanonical(
+                     Measurement::Units::brix.toCanonical(reading).quantity()
+                  );
+                  double const og = Algorithms::PlatoToSG_20C20C(originalPlato);
+                  double const sg = Algorithms::sgByStartingPlato(originalPlato, currentPlato);
+                  double const re = Algorithms::realExtract(sg, currentPlato);
+                  total += Algorithms::refractiveIndex(currentPlato) + og + Algorithms::PlatoToSG_20C20C(re) +
+                           Algorithms::getABVBySGPlato(sg, currentPlato) +
+                           Algorithms::getABWBySGPlato(sg, currentPlato) +
+                           Measurement::Units::brix.fromCanonical(sg);
+               }
+               break;
+         }
+      }
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+void Testing::benchmarkPlatoToSg_data() {
+   QTest::addColumn<bool>("useLookup");
+   QTest::newRow("lookup table") << true;
+   QTest::newRow("root finding") << false;
+   return;
+}
+
+void Testing::benchmarkPlatoToSg() {
+   QFETCH(bool, useLookup);
+   // Sum the results so the compiler can't optimise the calls away
+   double total = 0.0;
+   QBENCHMARK {
+      for (double plato = 0.0; plato < 30.0; plato += 0.01) {
+         total += useLookup ? Algorithms::PlatoToSG_20C20C(plato) : Algorithms::PlatoToSG_20C20C_byRootFinding(plato);
+      }
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+void Testing::testIbuKernel() {
+   IbuMethods::IbuType const savedIbuFormula = IbuMethods::ibuFormula;
+
+   IbuMethods::HopAdditions hops;
+   for (IbuMethods::HopTiming timing : {IbuMethods::HopTiming::Mash,
+                                        IbuMethods::HopTiming::FirstWort,
+                                        IbuMethods::HopTiming::Boil,
+                                        IbuMethods::HopTiming::HopStand,
+                                        IbuMethods::HopTiming::None}) {
+      for (double formFactor : {1.0, 1.10, 1.02}) {
+         for (double minutes : {0.0, 5.0, 15.0, 30.0, 60.0, 90.0}) {
+            hops.append(0.045 + minutes / 2000.0, 20.0 + minutes / 3.0, minutes, timing, formFactor);
+         }
+      }
+   }
+   std::vector<double> ibusPerHop(hops.size());
+
+   for (IbuMethods::IbuType formula : {IbuMethods::TINSETH, IbuMethods::RAGER, IbuMethods::NOONAN}) {
+      IbuMethods::ibuFormula = formula;
+      for (double og : {1.040, 1.060, 1.080, 1.095}) {
+         // Run with mash hops turned off (the default) and on
+         for (double mashHopAdjustment : {0.0, 0.3}) {
+            IbuMethods::RecipeIbuConstants const constants{og, 21.0, 60.0, 0.9, 1.1, mashHopAdjustment};
+            double const total = IbuMethods::getIbus(hops, constants, ibusPerHop);
+
+            double expectedTotal = 0.0;
+            for (std::size_t ii = 0; ii < hops.size(); ++ii) {
+               double expected = 0.0;
+               auto scalarIbus = [&](double minutes) {
+                  return IbuMethods::getIbus(hops.alpha[ii], hops.grams[ii], constants.finalVolume_l, og, minutes);
+               };
+               if (hops.timing[ii] == IbuMethods::HopTiming::Boil) {
+                  expected = scalarIbus(hops.minutes[ii]);
+               } else if (hops.timing[ii] == IbuMethods::HopTiming::FirstWort) {
+                  expected = constants.firstWortHopAdjustment * scalarIbus(constants.boilTime_min);
+               } else if (hops.timing[ii] == IbuMethods::HopTiming::Mash && mashHopAdjustment > 0.0) {
+                  expected = mashHopAdjustment * scalarIbus(constants.boilTime_min);
+               }
+               expected *= constants.hopUtilization * hops.formFactor[ii];
+               expectedTotal += expected;
+               QVERIFY(fuzzyComp(ibusPerHop[ii], expected, 1e-9));
+            }
+            QVERIFY(fuzzyComp(total, expectedTotal, 1e-9));
+         }
+      }
+   }
+
+   IbuMethods::ibuFormula = savedIbuFormula;
+   return;
+}
+
+void Testing::benchmarkIbuKernel_data() {
+   QTest::addColumn<bool>("useBatch");
+   QTest::newRow("per-hop") << false;
+   QTest::newRow("batch")   << true;
+   return;
+}
+
+void Testing::benchmarkIbuKernel() {
+   QFETCH(bool, useBatch);
+
+   int constexpr numHops = 50;
+   IbuMethods::HopAdditions hops;
+   for (int ii = 0; ii < numHops; ++ii) {
+      // Every fifth hop is first wort, the rest are boil additions
+      hops.append(0.04 + ii / 1000.0,
+                  10.0 + ii,
+                  ii % 90,
+                  ii % 5 ? IbuMethods::HopTiming::Boil : IbuMethods::HopTiming::FirstWort,
+                  1.10);
+   }
+   IbuMethods::RecipeIbuConstants const constants{1.055, 21.0, 60.0, 1.0, 1.1, 0.0};
+   std::vector<double> ibusPerHop(numHops);
+
+   double total = 0.0;
+   QBENCHMARK {
+      if (useBatch) {
+         total = IbuMethods::getIbus(hops, constants, ibusPerHop);
+      } else {
+         // This is what Recipe::recalcIBU used to do for each hop
+         total = 0.0;
+         for (int ii = 0; ii < numHops; ++ii) {
+            bool const boil = hops.timing[ii] == IbuMethods::HopTiming::Boil;
+            double const minutes = boil ? hops.minutes[ii] : constants.boilTime_min;
+            double const useAdjustment = boil ? 1.0 : constants.firstWortHopAdjustment;
+            ibusPerHop[ii] = useAdjustment * 1.10 * constants.hopUtilization * IbuMethods::getIbus(
+               hops.alpha[ii], hops.grams[ii], constants.finalVolume_l, constants.og, minutes
+            );
+            total += ibusPerHop[ii];
+         }
+      }
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+void Testing::testTimeResolvedIbu() {
+   // No hop stand or chill, so we're calibrated to Tinseth at 60 minutes
+   IbuMethods::RecipeIbuConstants constants{1.050, 21.0, 60.0, 1.0, 1.1, 0.0};
+   constants.boilingPoint_c   = 100.0;
+   constants.hopStandTime_min = 0.0;
+   constants.chillTime_min    = 0.0;
+
+   IbuMethods::HopAdditions hops;
+   hops.append(0.05, 30.0, 60.0, IbuMethods::HopTiming::Boil    );
+   hops.append(0.05, 30.0, 15.0, IbuMethods::HopTiming::Boil    );
+   hops.append(0.05, 30.0,  0.0, IbuMethods::HopTiming::Boil    );
+   hops.append(0.05, 30.0, 20.0, IbuMethods::HopTiming::HopStand);
+   std::vector<double> ibusPerHop(hops.size());
+   std::vector<double> tinsethIbusPerHop(hops.size());
+
+   IbuMethods::getIbus(hops, constants, tinsethIbusPerHop, IbuMethods::TINSETH);
+   IbuMethods::getIbus(hops, constants, ibusPerHop, IbuMethods::TIME_RESOLVED);
+   QVERIFY(fuzzyComp(ibusPerHop[0], tinsethIbusPerHop[0], 1e-6));
+   // Shorter boil gives less, and nothing at all happens to hops added at flameout if the wort is chilled instantly
+   QVERIFY(ibusPerHop[1] > 0.0);
+   QVERIFY(ibusPerHop[1] < ibusPerHop[0]);
+   QCOMPARE(ibusPerHop[2], 0.0);
+   QCOMPARE(ibusPerHop[3], 0.0);
+
+   // The wort is still hot while it's being chilled, so that adds IBUs to every hop, including those at flameout
+   std::vector<double> const noChillIbusPerHop = ibusPerHop;
+   constants.chillTime_min = 15.0;
+   IbuMethods::getIbus(hops, constants, ibusPerHop, IbuMethods::TIME_RESOLVED);
+   for (std::size_t ii = 0; ii < 3; ++ii) {
+      QVERIFY(ibusPerHop[ii] > noChillIbusPerHop[ii]);
+   }
+   QVERIFY(ibusPerHop[3] > 0.0);
+
+   // A hop stand adds more again, and aroma hops in for longer get more
+   std::vector<double> const chillIbusPerHop = ibusPerHop;
+   constants.hopStandTime_min = 30.0;
+   IbuMethods::getIbus(hops, constants, ibusPerHop, IbuMethods::TIME_RESOLVED);
+   for (std::size_t ii = 0; ii < hops.size(); ++ii) {
+      QVERIFY(ibusPerHop[ii] > chillIbusPerHop[ii]);
+   }
+   double const aroma20Ibus = ibusPerHop[3];
+   hops.minutes[3] = 30.0;
+   IbuMethods::getIbus(hops, constants, ibusPerHop, IbuMethods::TIME_RESOLVED);
+   QVERIFY(ibusPerHop[3] > aroma20Ibus);
+
+   // Wort cools during the hop stand, so a bigger batch, which cools more slowly, gets more utilisation
+   auto const smallBatch = IbuMethods::utilisationCurve(IbuMethods::KettleProfile{60.0, 100.0, 30.0, 15.0, 20.0});
+   auto const bigBatch   = IbuMethods::utilisationCurve(IbuMethods::KettleProfile{60.0, 100.0, 30.0, 15.0, 200.0});
+   QVERIFY(smallBatch->temp_c(60.0) == 100.0);
+   QVERIFY(smallBatch->temp_c(80.0) < 100.0);
+   QVERIFY(bigBatch->temp_c(80.0) > smallBatch->temp_c(80.0));
+   QVERIFY(smallBatch->temp_c(105.0) < 25.0);
+   QVERIFY(bigBatch->hopStand(30.0) > smallBatch->hopStand(30.0));
+
+   // Boiling at altitude gives less
+   auto const altitude = IbuMethods::utilisationCurve(IbuMethods::KettleProfile{60.0, 95.0, 30.0, 15.0, 20.0});
+   QVERIFY(altitude->boil(60.0) < smallBatch->boil(60.0));
+
+   // Asking again for the same profile gives the cached curve
+   QCOMPARE(IbuMethods::utilisationCurve(IbuMethods::KettleProfile{60.0, 100.0, 30.0, 15.0, 20.0}).get(),
+            smallBatch.get());
+
+   // Selecting the formula makes the scalar version use it too
+   IbuMethods::IbuType const savedIbuFormula = IbuMethods::ibuFormula;
+   IbuMethods::ibuFormula = IbuMethods::TIME_RESOLVED;
+   QVERIFY(fuzzyComp(IbuMethods::getIbus(0.05, 30.0, 21.0, 1.050, 60.0), tinsethIbusPerHop[0], 1e-6));
+   IbuMethods::ibuFormula = savedIbuFormula;
+   return;
+}
+
+void Testing::benchmarkTimeResolvedIbu_data() {
+   QTest::addColumn<int>("method");
+   QTest::newRow("per-hop Tinseth")               << 0;
+   QTest::newRow("time-resolved, cached curve")   << 1;
+   QTest::newRow("time-resolved, uncached curve") << 2;
+   return;
+}
+
+void Testing::benchmarkTimeResolvedIbu() {
+   QFETCH(int, method);
+
+   int constexpr numHops = 50;
+   IbuMethods::HopAdditions hops;
+   for (int ii = 0; ii < numHops; ++ii) {
+      // Every fifth hop is a whirlpool addition, the rest are boil additions
+      hops.append(0.04 + ii / 1000.0,
+                  10.0 + ii,
+                  ii % 60,
+                  ii % 5 ? IbuMethods::HopTiming::Boil : IbuMethods::HopTiming::HopStand,
+                  1.10);
+   }
+   IbuMethods::RecipeIbuConstants constants{1.055, 21.0, 60.0, 1.0, 1.1, 0.0};
+   constants.hopStandTime_min = 20.0;
+   constants.chillTime_min    = 15.0;
+   IbuMethods::KettleProfile const profile{constants.boilTime_min,
+                                           constants.boilingPoint_c,
+                                           constants.hopStandTime_min,
+                                           constants.chillTime_min,
+                                           constants.finalVolume_l};
+   std::vector<double> ibusPerHop(numHops);
+
+   double total = 0.0;
+   QBENCHMARK {
+      if (method == 0) {
+         total = 0.0;
+         for (int ii = 0; ii < numHops; ++ii) {
+            ibusPerHop[ii] = hops.timing[ii] == IbuMethods::HopTiming::Boil ?
+               1.10 * IbuMethods::getIbus(hops.alpha[ii], hops.grams[ii], constants.finalVolume_l, constants.og,
+                                          hops.minutes[ii]) : 0.0;
+            total += ibusPerHop[ii];
+         }
+      } else if (method == 1) {
+         total = IbuMethods::getIbus(hops, constants, ibusPerHop, IbuMethods::TIME_RESOLVED);
+      } else {
+         // What we'd have to do without the cache: integrate over the profile again for every calculation
+         IbuMethods::UtilisationCurve const curve{profile};
+         total = 0.0;
+         for (int ii = 0; ii < numHops; ++ii) {
+            total += hops.timing[ii] == IbuMethods::HopTiming::Boil ? curve.boil(hops.minutes[ii]) :
+                                                                      curve.hopStand(hops.minutes[ii]);
+         }
+      }
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+void Testing::testRecipeSweep() {
+   //
+   // Grid layout: first range varies slowest, last fastest; parameters not in any range keep their baseline values
+   //
+   RecipeSweep::Variant baseline;
+   baseline[RecipeSweep::Parameter::Efficiency_pct] = 70.0;
+   baseline[RecipeSweep::Parameter::BoilTime_min]   = 60.0;
+   baseline[RecipeSweep::Parameter::BatchSize_l]    = 20.0;
+   std::vector<RecipeSweep::Variant> const grid = RecipeSweep::makeGrid(
+      baseline,
+      {{RecipeSweep::Parameter::BatchSize_l, 19.0, 25.0, 4}, {RecipeSweep::Parameter::Efficiency_pct, 68.0, 78.0, 3}}
+   );
+   QCOMPARE(grid.size(), static_cast<std::size_t>(12));
+   for (std::size_t ii = 0; ii < grid.size(); ++ii) {
+      QVERIFY(fuzzyComp(grid[ii][RecipeSweep::Parameter::BatchSize_l],    19.0 + 2.0 * (ii / 3), 1e-9));
+      QVERIFY(fuzzyComp(grid[ii][RecipeSweep::Parameter::Efficiency_pct], 68.0 + 5.0 * (ii % 3), 1e-9));
+      QVERIFY(fuzzyComp(grid[ii][RecipeSweep::Parameter::BoilTime_min],   60.0,                  1e-9));
+   }
+
+   //
+   // Results match the recipe's own calculations
+   //
+   auto rec = std::make_shared<Recipe>("Sweep Test Recipe");
+   rec->setBatchSize_l(20.0);
+   rec->setEfficiency_pct(70.0);
+   this->cascade_4pct->setAmount_kg(0.030);
+   rec->add(this->cascade_4pct);
+   this->twoRow->setAmount_kg(4.5);
+   rec->add<Fermentable>(this->twoRow);
+
+   auto checkAgainstRecipe = [&]() {
+      RecipeSweep::Snapshot const snapshot{*rec};
+      RecipeSweep::Results const results = RecipeSweep::run(snapshot, {snapshot.baseline()});
+      QVERIFY(fuzzyComp(results.column(RecipeSweep::Output::Og       )[0], rec->og(),        1e-9));
+      QVERIFY(fuzzyComp(results.column(RecipeSweep::Output::Fg       )[0], rec->fg(),        1e-9));
+      QVERIFY(fuzzyComp(results.column(RecipeSweep::Output::Abv_pct  )[0], rec->ABV_pct(),   1e-9));
+      QVERIFY(fuzzyComp(results.column(RecipeSweep::Output::Ibu      )[0], rec->IBU(),       1e-9));
+      QVERIFY(fuzzyComp(results.column(RecipeSweep::Output::Color_srm)[0], rec->color_srm(), 1e-9));
+   };
+   checkAgainstRecipe();
+
+   // Predict a variant with the sweep, then make the same change to the recipe and check the recipe agrees
+   RecipeSweep::Snapshot const snapshot{*rec};
+   RecipeSweep::Variant variant = snapshot.baseline();
+   variant[RecipeSweep::Parameter::Efficiency_pct] = 76.0;
+   variant[RecipeSweep::Parameter::BatchSize_l]    = 23.0;
+   RecipeSweep::Results const predicted = RecipeSweep::run(snapshot, {variant});
+   rec->setEfficiency_pct(76.0);
+   rec->setBatchSize_l(23.0);
+   QVERIFY(fuzzyComp(predicted.column(RecipeSweep::Output::Og )[0], rec->og(),  1e-9));
+   QVERIFY(fuzzyComp(predicted.column(RecipeSweep::Output::Ibu)[0], rec->IBU(), 1e-9));
+   checkAgainstRecipe();
+
+   //
+   // Multi-threaded results are the same as single-threaded ones
+   //
+   std::vector<RecipeSweep::Variant> const bigGrid = RecipeSweep::makeGrid(
+      snapshot.baseline(),
+      {{RecipeSweep::Parameter::Efficiency_pct, 60.0, 85.0, 26},
+       {RecipeSweep::Parameter::BoilTime_min,   30.0, 120.0, 10},
+       {RecipeSweep::Parameter::BatchSize_l,    10.0, 40.0, 31}}
+   );
+   RecipeSweep::Results const singleThreaded = RecipeSweep::run(snapshot, bigGrid, 1);
+   RecipeSweep::Results const multiThreaded  = RecipeSweep::run(snapshot, bigGrid, 4);
+   for (RecipeSweep::Output const output : RecipeSweep::allOutputs) {
+      QVERIFY(std::equal(singleThreaded.column(output).begin(), singleThreaded.column(output).end(),
+                         multiThreaded.column(output).begin()));
+   }
+   return;
+}
+
+void Testing::benchmarkRecipeSweep_data() {
+   QTest::addColumn<unsigned int>("maxThreads");
+   QTest::newRow("1 thread")    << 1U;
+   QTest::newRow("all threads") << 0U;
+   return;
+}
+
+void Testing::benchmarkRecipeSweep() {
+   QFETCH(unsigned int, maxThreads);
+
+   auto rec = std::make_shared<Recipe>("Sweep Benchmark Recipe");
+   rec->setBatchSize_l(20.0);
+   rec->setEfficiency_pct(70.0);
+   this->cascade_4pct->setAmount_kg(0.030);
+   rec->add(this->cascade_4pct);
+   this->twoRow->setAmount_kg(4.5);
+   rec->add<Fermentable>(this->twoRow);
+
+   RecipeSweep::Snapshot const snapshot{*rec};
+   std::vector<RecipeSweep::Variant> const variants = RecipeSweep::makeGrid(
+      snapshot.baseline(),
+      {{RecipeSweep::Parameter::Efficiency_pct, 65.0, 80.0, 25},
+       {RecipeSweep::Parameter::BoilTime_min,   60.0, 90.0, 20},
+       {RecipeSweep::Parameter::BatchSize_l,    19.0, 25.0, 20}}
+   );
+   RecipeSweep::Results results;
+   QBENCHMARK {
+      results = RecipeSweep::run(snapshot, variants, maxThreads);
+   }
+   QCOMPARE(results.size(), static_cast<std::size_t>(10000));
+   return;
+}
+
+void Testing::testSaltSolver() {
+   //
+   // Compositions must match what Salt uses to calculate the totals in the water chemistry dialog
+   //
+   for (std::size_t jj = 0; jj < SaltSolver::numSalts; ++jj) {
+      Salt salt{"Test Salt"};
+      salt.setType(SaltSolver::salts[jj]);
+      salt.setWhenToAdd(Salt::WhenToAdd::MASH);
+      salt.setAmount(0.001); // 1 gram
+      SaltSolver::Composition const & composition = SaltSolver::composition(jj);
+      QCOMPARE(composition.ions_mgPerG[static_cast<int>(Water::Ions::Ca  )], salt.Ca  ());
+      QCOMPARE(composition.ions_mgPerG[static_cast<int>(Water::Ions::Cl  )], salt.Cl  ());
+      QCOMPARE(composition.ions_mgPerG[static_cast<int>(Water::Ions::HCO3)], salt.HCO3());
+      QCOMPARE(composition.ions_mgPerG[static_cast<int>(Water::Ions::Mg  )], salt.Mg  ());
+      QCOMPARE(composition.ions_mgPerG[static_cast<int>(Water::Ions::Na  )], salt.Na  ());
+      QCOMPARE(composition.ions_mgPerG[static_cast<int>(Water::Ions::SO4 )], salt.SO4 ());
+      QCOMPARE(composition.co3_mgPerG,                                       salt.CO3 ());
+      QCOMPARE(SaltSolver::saltIndex(SaltSolver::salts[jj]), jj);
+   }
+   QCOMPARE(SaltSolver::saltIndex(Salt::Types::LACTIC), SaltSolver::numSalts);
+
+   //
+   // If the target is exactly what some salt additions give, the solver should find those additions
+   //
+   std::array<double, SaltSolver::numSalts> const expected_g{2.0, 0.0, 6.0, 1.5, 0.5, 1.0};
+   SaltSolver::Problem problem;
+   problem.water_l  = 30.0;
+   problem.base_ppm = {20.0, 15.0, 40.0, 5.0, 10.0, 12.0};
+   problem.target_ppm = problem.base_ppm;
+   for (std::size_t jj = 0; jj < SaltSolver::numSalts; ++jj) {
+      for (std::size_t ii = 0; ii < SaltSolver::numIons; ++ii) {
+         problem.target_ppm[ii] += SaltSolver::composition(jj).ions_mgPerG[ii] * expected_g[jj] / problem.water_l;
+      }
+   }
+   SaltSolver::Solution solution = SaltSolver::solve(problem);
+   for (std::size_t jj = 0; jj < SaltSolver::numSalts; ++jj) {
+      QVERIFY(std::fabs(solution.amounts_g[jj] - expected_g[jj]) < 1e-6);
+   }
+   for (std::size_t ii = 0; ii < SaltSolver::numIons; ++ii) {
+      QVERIFY(fuzzyComp(solution.result_ppm[ii], problem.target_ppm[ii], 1e-6));
+   }
+
+   // Salts we're not allowed to use stay at zero, and amounts are never negative even when the target is below the
+   // base water
+   problem.available[SaltSolver::saltIndex(Salt::Types::CASO4)] = false;
+   problem.target_ppm[static_cast<int>(Water::Ions::Na)] = 0.0;
+   solution = SaltSolver::solve(problem);
+   QCOMPARE(solution.amounts_g[SaltSolver::saltIndex(Salt::Types::CASO4)], 0.0);
+   for (double const amount_g : solution.amounts_g) {
+      QVERIFY(amount_g >= 0.0);
+   }
+
+   //
+   // pH bounds are respected when they can be, and reported when they can't
+   //
+   problem.available.fill(true);
+   problem.constrainPh = true;
+   problem.ph0         = 5.6;
+   problem.phPerG      = {-0.02, 0.03, -0.015, -0.01, 0.0, 0.04};
+   problem.minPh       = 5.2;
+   problem.maxPh       = 5.4;
+   solution = SaltSolver::solve(problem);
+   QVERIFY(solution.phInRange);
+   QVERIFY(solution.ph >= problem.minPh - 1e-6);
+   QVERIFY(solution.ph <= problem.maxPh + 1e-6);
+
+   problem.phPerG.fill(0.0);
+   solution = SaltSolver::solve(problem);
+   QVERIFY(!solution.phInRange);
+   QCOMPARE(solution.ph, problem.ph0);
+   return;
+}
+
+void Testing::benchmarkSaltSolver() {
+   SaltSolver::Problem problem;
+   problem.water_l     = 30.0;
+   problem.base_ppm    = {20.0, 15.0, 40.0, 5.0, 10.0, 12.0};
+   problem.target_ppm  = {110.0, 50.0, 40.0, 18.0, 16.0, 275.0};
+   problem.constrainPh = true;
+   problem.ph0         = 5.6;
+   problem.phPerG      = {-0.02, 0.03, -0.015, -0.01, 0.0, 0.04};
+   problem.minPh       = 5.2;
+   problem.maxPh       = 5.4;
+
+   double total = 0.0;
+   QBENCHMARK {
+      // Simulate the user dragging a target up and down
+      for (int ii = 0; ii < 1000; ++ii) {
+         problem.target_ppm[static_cast<int>(Water::Ions::SO4)] = 200.0 + (ii % 100);
+         total += SaltSolver::solve(problem).amounts_g[SaltSolver::saltIndex(Salt::Types::CASO4)];
+      }
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+namespace {
+   // Well-conditioned 6×6 test matrix
+   LinearAlgebra::Matrix<6, 6> constexpr testMatrix6{
+      5.0, 1.0, 0.5, 0.0, 2.0, 1.0,
+      1.0, 6.0, 1.0, 0.5, 0.0, 2.0,
+      0.5, 1.0, 7.0, 1.0, 0.5, 0.0,
+      0.0, 0.5, 1.0, 8.0, 1.0, 0.5,
+      2.0, 0.0, 0.5, 1.0, 9.0, 1.0,
+      1.0, 2.0, 0.0, 0.5, 1.0, 10.0,
+   };
+}
+
+void Testing::testLinearAlgebra() {
+   //
+   // Fixed-size matrices, including some things we can check at compile time
+   //
+   using Matrix2 = LinearAlgebra::Matrix<2, 2>;
+   static_assert(Matrix2{1.0, 2.0, 3.0, 4.0} * Matrix2::identity() == Matrix2{1.0, 2.0, 3.0, 4.0});
+   static_assert(Matrix2{1.0, 2.0, 3.0, 4.0} + Matrix2{1.0, 1.0, 1.0, 1.0} == Matrix2{2.0, 3.0, 4.0, 5.0});
+   static_assert(LinearAlgebra::Matrix<2, 3>{1.0, 2.0, 3.0, 4.0, 5.0, 6.0}.transpose()(2, 1) == 6.0);
+   static_assert(LinearAlgebra::LuDecomposition<2>{Matrix2{4.0, 3.0, 6.0, 3.0}}.determinant() == -6.0);
+   static_assert(LinearAlgebra::LuDecomposition<2>{Matrix2{1.0, 2.0, 2.0, 4.0}}.isSingular());
+
+   auto const inverse = LinearAlgebra::inverse(testMatrix6);
+   QVERIFY(inverse.has_value());
+   LinearAlgebra::Matrix<6, 6> const product = testMatrix6 * *inverse;
+   QVERIFY((product - LinearAlgebra::Matrix<6, 6>::identity()).maxAbs() < 1e-12);
+   QVERIFY(!LinearAlgebra::inverse(Matrix2{1.0, 2.0, 2.0, 4.0}).has_value());
+
+   // Row views write through to the matrix
+   LinearAlgebra::Matrix<6, 6> copy = testMatrix6;
+   copy.row(2)[3] = 42.0;
+   QCOMPARE(copy(2, 3), 42.0);
+
+   // Least squares: fit y = a + bx to points on the line y = 1 + 2x, plus some noise that cancels out
+   LinearAlgebra::Matrix<4, 2> const xs{1.0, 0.0,
+                                        1.0, 1.0,
+                                        1.0, 2.0,
+                                        1.0, 3.0};
+   LinearAlgebra::Vector<4> const ys{1.1, 2.9, 5.1, 6.9};
+   auto const fit = LinearAlgebra::leastSquares(xs, ys);
+   QVERIFY(fit.has_value());
+   QVERIFY(fuzzyComp((*fit)[0], 1.06, 1e-9));
+   QVERIFY(fuzzyComp((*fit)[1], 1.96, 1e-9));
+
+   // Non-negative least squares: unconstrained answer to this is x = (2, -1), so with x >= 0 the second element is
+   // clamped and the first is the best fit on its own.
+   LinearAlgebra::Matrix<3, 2> const a{1.0, 0.0,
+                                       0.0, 1.0,
+                                       1.0, 1.0};
+   LinearAlgebra::Vector<3> const b{2.0, -1.0, 1.0};
+   LinearAlgebra::Vector<2> const x = LinearAlgebra::nonNegativeLeastSquares(a, b);
+   QVERIFY(fuzzyComp(x[0], 1.5, 1e-12));
+   QCOMPARE(x[1], 0.0);
+
+   //
+   // Dynamic matrices from an arena give the same answers
+   //
+   LinearAlgebra::Arena arena{16};
+   LinearAlgebra::DynamicMatrix dynamicA{testMatrix6, &arena};
+   LinearAlgebra::DynamicMatrix dynamicInverse = LinearAlgebra::DynamicMatrix::identity(6, &arena);
+   QCOMPARE(dynamicInverse.arena(), &arena);
+   QVERIFY(LinearAlgebra::solveInPlace(dynamicA, dynamicInverse));
+   for (std::size_t ii = 0; ii < 6; ++ii) {
+      for (std::size_t jj = 0; jj < 6; ++jj) {
+         QVERIFY(std::fabs(dynamicInverse(ii, jj) - (*inverse)(ii, jj)) < 1e-12);
+      }
+   }
+   arena.reset();
+   LinearAlgebra::DynamicMatrix reused{6, 6, &arena};
+   QCOMPARE(reused(5, 5), 0.0);
+
+   //
+   // Legacy interface
+   //
+   Matrix legacy{6, 6};
+   for (unsigned int ii = 0; ii < 6; ++ii) {
+      for (unsigned int jj = 0; jj < 6; ++jj) {
+         legacy.setVal(ii, jj, testMatrix6(ii, jj));
+      }
+   }
+   QVERIFY(legacy.hasInverse());
+   Matrix const legacyProduct = legacy * legacy.inverse();
+   for (unsigned int ii = 0; ii < 6; ++ii) {
+      for (unsigned int jj = 0; jj < 6; ++jj) {
+         QVERIFY(std::fabs(legacyProduct.getVal(ii, jj) - (ii == jj ? 1.0 : 0.0)) < 1e-12);
+      }
+   }
+
+   Matrix legacyRref{3, 4};
+   legacyRref.setRow(0, { 2.0,  1.0, -1.0,   8.0});
+   legacyRref.setRow(1, {-3.0, -1.0,  2.0, -11.0});
+   legacyRref.setRow(2, {-2.0,  1.0,  2.0,  -3.0});
+   legacyRref.rref();
+   QVERIFY(fuzzyComp(legacyRref.getVal(0, 3),  2.0, 1e-12));
+   QVERIFY(fuzzyComp(legacyRref.getVal(1, 3),  3.0, 1e-12));
+   QVERIFY(fuzzyComp(legacyRref.getVal(2, 3), -1.0, 1e-12));
+
+   Matrix singular{2, 2};
+   singular.setRow(0, {1.0, 2.0});
+   singular.setRow(1, {2.0, 4.0});
+   QVERIFY(!singular.hasInverse());
+   QVERIFY_EXCEPTION_THROWN(singular.inverse(), IncomputableException);
+   QVERIFY_EXCEPTION_THROWN(singular.getVal(2, 0), DimensionException);
+   return;
+}
+
+void Testing::benchmarkLinearAlgebra_data() {
+   QTest::addColumn<QString>("implementation");
+   QTest::newRow("legacy Matrix") << QString("legacy");
+   QTest::newRow("DynamicMatrix in arena") << QString("dynamic");
+   QTest::newRow("fixed-size Matrix") << QString("fixed");
+   return;
+}
+
+void Testing::benchmarkLinearAlgebra() {
+   QFETCH(QString, implementation);
+   int constexpr numRepeats = 1000;
+   double total = 0.0;
+
+   if (implementation == "legacy") {
+      Matrix a{6, 6};
+      for (unsigned int ii = 0; ii < 6; ++ii) {
+         for (unsigned int jj = 0; jj < 6; ++jj) {
+            a.setVal(ii, jj, testMatrix6(ii, jj));
+         }
+      }
+      QBENCHMARK {
+         for (int ii = 0; ii < numRepeats; ++ii) {
+            Matrix const result = (a * a + a).inverse();
+            total += result.getVal(0, 0);
+         }
+      }
+   } else if (implementation == "dynamic") {
+      LinearAlgebra::Arena arena;
+      LinearAlgebra::DynamicMatrix const a{testMatrix6};
+      QBENCHMARK {
+         for (int ii = 0; ii < numRepeats; ++ii) {
+            arena.reset();
+            LinearAlgebra::DynamicMatrix sum{6, 6, &arena};
+            LinearAlgebra::multiply(a, a, sum);
+            sum += a;
+            LinearAlgebra::DynamicMatrix result = LinearAlgebra::DynamicMatrix::identity(6, &arena);
+            LinearAlgebra::solveInPlace(sum, result);
+            total += result(0, 0);
+         }
+      }
+   } else {
+      QBENCHMARK {
+         for (int ii = 0; ii < numRepeats; ++ii) {
+            total += (*LinearAlgebra::inverse(testMatrix6 * testMatrix6 + testMatrix6))(0, 0);
+         }
+      }
+   }
+   QVERIFY(total != 0.0);
+   return;
+}
+
+void Testing::testSequenceDiff() {
+   auto reuseMap = [](QStringList const & oldItems, QStringList const & newItems) {
+      return SequenceDiff::reuseMap(
+         oldItems.size(),
+         newItems.size(),
+         [&](std::size_t oldIndex, std::size_t newIndex) {
+            return oldItems[static_cast<int>(oldIndex)] == newItems[static_cast<int>(newIndex)];
+         }
+      );
+   };
+   int constexpr none = SequenceDiff::noMatch;
+   QStringList const steps{"Add grains", "Heat water", "Mash", "Boil", "Hop 60", "Flameout", "Pitch"};
+
+   // Nothing changed, so everything is reused where it is
+   QCOMPARE(reuseMap(steps, steps), (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+
+   // One new hop addition is one insert, and nothing else moves
+   QCOMPARE(reuseMap(steps, {"Add grains", "Heat water", "Mash", "Boil", "Hop 60", "Hop 15", "Flameout", "Pitch"}),
+            (std::vector<int>{0, 1, 2, 3, 4, none, 5, 6}));
+
+   // A changed hop amount is one update of the existing item
+   QCOMPARE(reuseMap(steps, {"Add grains", "Heat water", "Mash", "Boil", "Hop 60 (more)", "Flameout", "Pitch"}),
+            (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+
+   // Removing the mash leaves the three mash items unused (ie to be deleted)
+   QCOMPARE(reuseMap(steps, {"Boil", "Hop 60", "Flameout", "Pitch"}), (std::vector<int>{3, 4, 5, 6}));
+
+   // Changes in several places at once: two updates, one insert and the rest unchanged
+   QCOMPARE(reuseMap(steps, {"Add malt", "Heat water", "Mash", "Boil", "Hop 30", "Flameout", "Cool", "Pitch"}),
+            (std::vector<int>{0, 1, 2, 3, 4, 5, none, 6}));
+
+   // Reversed list: one item can stay as it is, and the others are updated rather than deleted and re-inserted
+   std::vector<int> const reversed = reuseMap({"a", "b", "c", "d"}, {"d", "c", "b", "a"});
+   QCOMPARE(std::count(reversed.begin(), reversed.end(), none), 0);
+   QCOMPARE((std::set<int>{reversed.begin(), reversed.end()}), (std::set<int>{0, 1, 2, 3}));
+
+   // Edge cases
+   QCOMPARE(reuseMap({}, steps), std::vector<int>(steps.size(), none));
+   QVERIFY(reuseMap(steps, {}).empty());
+   return;
+}
+
+void Testing::testApplyInstructions() {
+   auto rec = std::make_shared<Recipe>("Apply Instructions Test Recipe");
+   ObjectStoreWrapper::insert(rec);
+
+   QVector<PreInstruction> steps{
+      PreInstruction{"Heat 15 L of water to 72 C", "Heat water", 0.0},
+      PreInstruction{"Mash at 66 C",               "Mash",       60.0},
+      PreInstruction{"Boil",                       "Boil",       60.0},
+   };
+   rec->applyInstructions(steps);
+   QList<Instruction *> const original = rec->instructions();
+   QCOMPARE(original.size(), 3);
+   for (int ii = 0; ii < steps.size(); ++ii) {
+      QCOMPARE(original.at(ii)->name(),       steps.at(ii).getTitle());
+      QCOMPARE(original.at(ii)->directions(), steps.at(ii).getText());
+      QCOMPARE(original.at(ii)->interval(),   steps.at(ii).getTime());
+      QVERIFY(ObjectStoreWrapper::contains<Instruction>(original.at(ii)->key()));
+   }
+   original.at(0)->setCompleted(true);
+
+   // Applying the same list again changes nothing
+   rec->applyInstructions(steps);
+   QCOMPARE(rec->instructions(), original);
+   QVERIFY(original.at(0)->completed());
+
+   // Adding a step is one new instruction, and the others (including whether they were done) stay as they were
+   steps.insert(2, PreInstruction{"Sparge with 10 L of water at 77 C", "Sparge", 0.0});
+   rec->applyInstructions(steps);
+   QList<Instruction *> const added = rec->instructions();
+   QCOMPARE(added.size(), 4);
+   QVERIFY(added.at(0) == original.at(0));
+   QVERIFY(added.at(1) == original.at(1));
+   QCOMPARE(added.at(2)->name(), QString("Sparge"));
+   QVERIFY(added.at(3) == original.at(2));
+   QVERIFY(added.at(0)->completed());
+
+   // Changing a step updates its instruction in place, and it no longer counts as done
+   added.at(1)->setCompleted(true);
+   steps[1] = PreInstruction{"Mash at 64 C", "Mash", 90.0};
+   rec->applyInstructions(steps);
+   QCOMPARE(rec->instructions(), added);
+   QCOMPARE(added.at(1)->directions(), QString("Mash at 64 C"));
+   QCOMPARE(added.at(1)->interval(), 90.0);
+   QVERIFY(!added.at(1)->completed());
+
+   // Removing a step deletes its instruction and leaves the rest alone
+   steps.remove(2);
+   rec->applyInstructions(steps);
+   QList<Instruction *> const removed = rec->instructions();
+   QCOMPARE(removed.size(), 3);
+   QVERIFY(removed.at(0) == added.at(0));
+   QVERIFY(removed.at(1) == added.at(1));
+   QVERIFY(removed.at(2) == added.at(3));
+   QVERIFY(added.at(2)->deleted());
+
+   // And an empty list deletes everything
+   rec->applyInstructions({});
+   QVERIFY(rec->instructions().isEmpty());
+   for (Instruction * ins : removed) {
+      QVERIFY(ins->deleted());
+   }
+   return;
+}
+
+void Testing::testRecipeUncertainty() {
+   auto rec = std::make_shared<Recipe>("Uncertainty Test Recipe");
+   rec->setBatchSize_l(20.0);
+   rec->setEfficiency_pct(70.0);
+   this->cascade_4pct->setAmount_kg(0.030);
+   rec->add(this->cascade_4pct);
+   this->twoRow->setAmount_kg(4.5);
+   rec->add<Fermentable>(this->twoRow);
+
+   auto checkBandsOrdered = [](RecipeUncertainty::Results const & results) {
+      for (RecipeSweep::Output const output : RecipeSweep::allOutputs) {
+         auto const & values = results.band(output).values;
+         QVERIFY(std::is_sorted(values.begin(), values.end()));
+      }
+   };
+   auto isCollapsed = [](RecipeUncertainty::Band const & band) {
+      return band.values.front() == band.values.back() && band.stdDev == 0.0;
+   };
+
+   //
+   // With no standard deviations set, every band is just the recipe's own value
+   //
+   {
+      RecipeUncertainty::Snapshot const snapshot{*rec};
+      QVERIFY(!snapshot.hasVariation());
+      RecipeUncertainty::Results const results = RecipeUncertainty::run(snapshot, 10000);
+      QVERIFY(fuzzyComp(results.band(RecipeSweep::Output::Og       ).nominal, rec->og(),        1e-9));
+      QVERIFY(fuzzyComp(results.band(RecipeSweep::Output::Fg       ).nominal, rec->fg(),        1e-9));
+      QVERIFY(fuzzyComp(results.band(RecipeSweep::Output::Abv_pct  ).nominal, rec->ABV_pct(),   1e-9));
+      QVERIFY(fuzzyComp(results.band(RecipeSweep::Output::Ibu      ).nominal, rec->IBU(),       1e-9));
+      QVERIFY(fuzzyComp(results.band(RecipeSweep::Output::Color_srm).nominal, rec->color_srm(), 1e-9));
+      for (RecipeSweep::Output const output : RecipeSweep::allOutputs) {
+         QVERIFY(isCollapsed(results.band(output)));
+         QCOMPARE(results.band(output).values[0], results.band(output).nominal);
+      }
+   }
+
+   //
+   // Varying alpha acid only affects IBUs
+   //
+   this->cascade_4pct->setAlphaStdDev_pct(0.5);
+   {
+      RecipeUncertainty::Snapshot const snapshot{*rec};
+      QVERIFY(snapshot.hasVariation());
+      RecipeUncertainty::Results const results = RecipeUncertainty::run(snapshot, 20000);
+      QCOMPARE(results.numSamples, static_cast<std::size_t>(20000));
+      checkBandsOrdered(results);
+      QVERIFY(isCollapsed(results.band(RecipeSweep::Output::Og)));
+      QVERIFY(isCollapsed(results.band(RecipeSweep::Output::Color_srm)));
+      RecipeUncertainty::Band const & ibu = results.band(RecipeSweep::Output::Ibu);
+      QVERIFY(ibu.values.front() < ibu.nominal && ibu.nominal < ibu.values.back());
+      // IBUs are proportional to alpha acid, so the spread should be in proportion: 0.5/4 = 12.5%
+      QVERIFY(fuzzyComp(ibu.stdDev / ibu.nominal, 0.125, 0.01));
+      QVERIFY(fuzzyComp(ibu.values[2], ibu.nominal, 0.02 * ibu.nominal));
+   }
+
+   //
+   // Varying yield and efficiency widens the gravity bands, and the results don't depend on how many threads we use
+   //
+   this->twoRow->setYieldStdDev_pct(2.0);
+   rec->setEfficiencyStdDev_pct(3.0);
+   {
+      RecipeUncertainty::Snapshot const snapshot{*rec};
+      RecipeUncertainty::Results const singleThreaded = RecipeUncertainty::run(snapshot, 50000, 42, 1);
+      RecipeUncertainty::Results const multiThreaded  = RecipeUncertainty::run(snapshot, 50000, 42, 4);
+      checkBandsOrdered(singleThreaded);
+      RecipeUncertainty::Band const & og = singleThreaded.band(RecipeSweep::Output::Og);
+      QVERIFY(og.values.front() < og.nominal && og.nominal < og.values.back());
+      QVERIFY(fuzzyComp(og.values[2], og.nominal, 0.002));
+      for (RecipeSweep::Output const output : RecipeSweep::allOutputs) {
+         QCOMPARE(singleThreaded.band(output).values, multiThreaded.band(output).values);
+         QCOMPARE(singleThreaded.band(output).mean,   multiThreaded.band(output).mean);
+      }
+
+      // Same seed, same answer; different seed, (slightly) different answer
+      QCOMPARE(RecipeUncertainty::run(snapshot, 5000, 7).band(RecipeSweep::Output::Og).values,
+               RecipeUncertainty::run(snapshot, 5000, 7).band(RecipeSweep::Output::Og).values);
+      QVERIFY(RecipeUncertainty::run(snapshot, 5000, 7).band(RecipeSweep::Output::Og).values !=
+              RecipeUncertainty::run(snapshot, 5000, 8).band(RecipeSweep::Output::Og).values);
+   }
+
+   // Don't leave variation on the shared test ingredients
+   this->cascade_4pct->setAlphaStdDev_pct(0.0);
+   this->twoRow->setYieldStdDev_pct(0.0);
+   return;
+}
+
+void Testing::benchmarkRecipeUncertainty_data() {
+   QTest::addColumn<unsigned int>("maxThreads");
+   QTest::newRow("1 thread")    << 1U;
+   QTest::newRow("all threads") << 0U;
+   return;
+}
+
+void Testing::benchmarkRecipeUncertainty() {
+   QFETCH(unsigned int, maxThreads);
+
+   auto rec = std::make_shared<Recipe>("Uncertainty Benchmark Recipe");
+   rec->setBatchSize_l(20.0);
+   rec->setEfficiency_pct(70.0);
+   rec->setEfficiencyStdDev_pct(3.0);
+   this->cascade_4pct->setAmount_kg(0.030);
+   this->cascade_4pct->setAlphaStdDev_pct(0.5);
+   rec->add(this->cascade_4pct);
+   this->twoRow->setAmount_kg(4.5);
+   this->twoRow->setYieldStdDev_pct(2.0);
+   rec->add<Fermentable>(this->twoRow);
+
+   RecipeUncertainty::Snapshot const snapshot{*rec};
+   RecipeUncertainty::Results results;
+   QBENCHMARK {
+      results = RecipeUncertainty::run(snapshot, 100000, RecipeUncertainty::defaultSeed, maxThreads);
+   }
+   QCOMPARE(results.numSamples, static_cast<std::size_t>(100000));
+
+   this->cascade_4pct->setAlphaStdDev_pct(0.0);
+   this->twoRow->setYieldStdDev_pct(0.0);
+   return;
+}
+
+void Testing::testMashSimulation() {
+   // 5kg of grain and a 3kg tun, everything starting at 20°C
+   Mash mash{"Mash Simulation Test Mash"};
+   mash.setGrainTemp_c(20.0);
+   mash.setTunTemp_c(20.0);
+   mash.setTunWeight_kg(3.0);
+   mash.setTunSpecificHeat_calGC(0.12);
+   MashSimulation::Constants constants = MashSimulation::Constants::make(mash, nullptr, 5.0);
+   QVERIFY(qFuzzyCompare(constants.grainMC, 2.0));
+   QVERIFY(qFuzzyCompare(constants.tunMC, 0.36));
+   QVERIFY(qFuzzyCompare(constants.spargeMC, 2.0 + PhysicalConstants::grainAbsorption_Lkg * 5.0 + 0.36));
+   QVERIFY(qFuzzyCompare(constants.boilingPoint_c, 100.0));
+
+   MashSimulation::Simulator simulator{constants};
+
+   //
+   // First infusion has to heat the grain and the tun: (2.0 × 47 + 0.36 × 47) / 15 + 67
+   //
+   MashSimulation::Infusion const strike = simulator.infusion(0, MashStep::Type::Infusion, 67.0);
+   double const strikeTemp_c = strike.tempForVolume_c(15.0);
+   QVERIFY(qFuzzyCompare(strikeTemp_c, (2.0 * 47.0 + 0.36 * 47.0) / 15.0 + 67.0));
+   QVERIFY(qFuzzyCompare(strike.volumeForTemp_l(strikeTemp_c), 15.0));
+   // Limited to what can actually be done
+   QCOMPARE(strike.tempForVolume_c(0.1), 100.0);
+   QCOMPARE(strike.tempForVolume_c(0.0), 0.0);
+   QCOMPARE(strike.volumeForTemp_l(50.0), 0.0);
+
+   MashSimulation::Step step;
+   step.type           = MashStep::Type::Infusion;
+   step.stepTemp_c     = 67.0;
+   step.stepTime_min   = 60.0;
+   step.infuseAmount_l = 15.0;
+   step.infuseTemp_c   = strikeTemp_c;
+   simulator.appendStep(step);
+   QVERIFY(qFuzzyCompare(simulator.result(0).reached_c, 67.0));
+   MashSimulation::State const afterFirst = simulator.stateBefore(1);
+   QVERIFY(afterFirst.tunHeated);
+   QVERIFY(qFuzzyCompare(afterFirst.thermalMass, 2.0 + 15.0 + 0.36));
+   QVERIFY(qFuzzyCompare(afterFirst.water_l, 15.0));
+
+   //
+   // Boiling water to get to 72°C only has to heat what's now in the tun
+   //
+   MashSimulation::Infusion const boilingInfusion = simulator.infusion(1, MashStep::Type::Infusion, 72.0);
+   QVERIFY(qFuzzyCompare(boilingInfusion.volumeForTemp_l(100.0), 17.36 * 5.0 / 28.0));
+
+   //
+   // A decoction designed to reach 72°C gets there
+   //
+   step.type              = MashStep::Type::Decoction;
+   step.stepTemp_c        = 72.0;
+   step.stepTime_min      = 20.0;
+   step.infuseAmount_l    = 0.0;
+   step.decoctionAmount_l = simulator.decoctionAmount_l(1, 72.0);
+   QVERIFY(step.decoctionAmount_l > 0.0);
+   simulator.appendStep(step);
+   QVERIFY(qFuzzyCompare(simulator.result(1).reached_c, 72.0));
+   // Can't decoct our way down
+   QCOMPARE(simulator.decoctionAmount_l(2, 60.0), 0.0);
+
+   //
+   // Direct heat, then a sparge, which heats the grain, absorbed water and tun from 10°C below the last step
+   //
+   step.type              = MashStep::Type::Temperature;
+   step.stepTemp_c        = 76.0;
+   step.stepTime_min      = 10.0;
+   step.decoctionAmount_l = 0.0;
+   simulator.appendStep(step);
+   QCOMPARE(simulator.result(2).reached_c, 76.0);
+   MashSimulation::Infusion const sparge = simulator.infusion(3, MashStep::Type::batchSparge, 76.0);
+   QVERIFY(qFuzzyCompare(sparge.heat(), constants.spargeMC * MashSimulation::spargeCooling_c));
+   step.type           = MashStep::Type::batchSparge;
+   step.infuseAmount_l = 10.0;
+   step.infuseTemp_c   = sparge.tempForVolume_c(10.0);
+   simulator.appendStep(step);
+   QVERIFY(qFuzzyCompare(simulator.result(3).reached_c, 76.0));
+   QVERIFY(qFuzzyCompare(simulator.stateBefore(4).water_l, 25.0));
+
+   //
+   // With heat losses, the mash cools towards ambient during each rest, except when it's being heated
+   //
+   constants.heatLoss_MCPerMin = 0.05;
+   MashSimulation::Simulator cooling{constants};
+   step.type           = MashStep::Type::Infusion;
+   step.stepTemp_c     = 67.0;
+   step.stepTime_min   = 60.0;
+   step.infuseAmount_l = 15.0;
+   step.infuseTemp_c   = strikeTemp_c;
+   cooling.appendStep(step);
+   MashSimulation::StepResult const & rest = cooling.result(0);
+   QVERIFY(qFuzzyCompare(rest.reached_c, 67.0));
+   QVERIFY(qFuzzyCompare(rest.end.temp_c, 20.0 + 47.0 * std::exp(-0.05 * 60.0 / 17.36)));
+   step.type         = MashStep::Type::Temperature;
+   step.stepTemp_c   = 70.0;
+   step.stepTime_min = 30.0;
+   cooling.appendStep(step);
+   QCOMPARE(cooling.result(1).end.temp_c, 70.0);
+
+   //
+   // Changing the first step only re-simulates from there, and gives the same answer as starting again
+   //
+   step.type           = MashStep::Type::Infusion;
+   step.stepTemp_c     = 65.0;
+   step.stepTime_min   = 60.0;
+   step.infuseAmount_l = 14.0;
+   step.infuseTemp_c   = 74.0;
+   cooling.setStep(0, step);
+   MashSimulation::Simulator fresh{constants};
+   fresh.appendStep(step);
+   fresh.appendStep(MashSimulation::Step{MashStep::Type::Temperature, 70.0, 30.0, 0.0, 0.0, 0.0});
+   QCOMPARE(cooling.result(0).end.temp_c, fresh.result(0).end.temp_c);
+   QCOMPARE(cooling.stateBefore(2).thermalMass, fresh.stateBefore(2).thermalMass);
+   return;
+}
+
+void Testing::benchmarkMashSimulation_data() {
+   QTest::addColumn<bool>("cached");
+   QTest::newRow("cached")       << true;
+   QTest::newRow("re-simulated") << false;
+   return;
+}
+
+void Testing::benchmarkMashSimulation() {
+   QFETCH(bool, cached);
+
+   Mash mash{"Mash Simulation Benchmark Mash"};
+   mash.setGrainTemp_c(20.0);
+   mash.setTunTemp_c(20.0);
+   mash.setTunWeight_kg(3.0);
+   mash.setTunSpecificHeat_calGC(0.12);
+   MashSimulation::Constants constants = MashSimulation::Constants::make(mash, nullptr, 5.0);
+   constants.heatLoss_MCPerMin = 0.05;
+
+   // Protein rest, two saccharification rests, a decoction and mash out, with the user dragging the slider for the
+   // last step
+   MashSimulation::Simulator simulator{constants};
+   simulator.appendStep(MashSimulation::Step{MashStep::Type::Infusion,    52.0, 15.0, 12.0, 62.0, 0.0});
+   simulator.appendStep(MashSimulation::Step{MashStep::Type::Infusion,    63.0, 30.0,  4.0, 95.0, 0.0});
+   simulator.appendStep(MashSimulation::Step{MashStep::Type::Temperature, 67.0, 30.0,  0.0,  0.0, 0.0});
+   simulator.appendStep(MashSimulation::Step{MashStep::Type::Decoction,   72.0, 20.0,  0.0,  0.0, 3.0});
+   std::size_t const lastStep = simulator.numSteps();
+
+   // A slider has 100 positions, and each move asks for both the temperature and the volume
+   int constexpr numPositions = 100;
+   double total = 0.0;
+   QBENCHMARK {
+      MashSimulation::Infusion infusion = simulator.infusion(lastStep, MashStep::Type::Infusion, 76.0);
+      for (int ii = 0; ii < numPositions; ++ii) {
+         if (!cached) {
+            // What the mash designer used to do: work everything out again from the start for each move
+            simulator.setStep(0, MashSimulation::Step{MashStep::Type::Infusion, 52.0, 15.0, 12.0, 62.0, 0.0});
+            infusion = simulator.infusion(lastStep, MashStep::Type::Infusion, 76.0);
+         }
+         double const volume_l = 1.0 + 0.1 * ii;
+         total += infusion.tempForVolume_c(volume_l) + infusion.volumeForTemp_l(80.0 + 0.2 * ii);
+      }
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+namespace {
+   //! \brief Logistic fermentation from 1.060 to 1.012, half way there at 40 hours
+   double testFermentationSg(double const time_h) {
+      return 1.060 - 0.048 / (1.0 + std::exp(-0.08 * (time_h - 40.0)));
+   }
+}
+
+void Testing::testFermentationCurve() {
+   // Within 0.001 of 1.012 when 0.048 / (1 + e^(-0.08 (t - 40))) = 0.047
+   double const expectedTerminal_h = 40.0 + std::log(47.0) / 0.08;
+
+   //
+   // Not enough readings yet
+   //
+   FermentationCurve::Fitter fitter{1.060};
+   fitter.add(FermentationCurve::Reading{0.0, testFermentationSg(0.0)});
+   fitter.add(FermentationCurve::Reading{4.0, testFermentationSg(4.0)});
+   QVERIFY(!fitter.prediction().valid);
+
+   //
+   // Readings every 4 hours up to 60 hours -- ie only just past the steepest part of the curve -- are enough to predict
+   // the rest of it
+   //
+   for (double time_h = 8.0; time_h <= 60.0; time_h += 4.0) {
+      fitter.add(FermentationCurve::Reading{time_h, testFermentationSg(time_h)});
+   }
+   QCOMPARE(fitter.numReadings(), static_cast<std::size_t>(16));
+   FermentationCurve::Prediction const prediction = fitter.prediction();
+   QVERIFY(prediction.valid);
+   QVERIFY(std::abs(prediction.fg - 1.012) < 0.0005);
+   QVERIFY(std::abs(prediction.rate_perHour - 0.08) < 0.005);
+   QVERIFY(std::abs(prediction.apparentAttenuation_pct - 80.0) < 1.0);
+   QVERIFY(std::abs(prediction.terminalTime_h() - expectedTerminal_h) < 2.0);
+   QVERIFY(std::abs(prediction.sgAt(100.0) - testFermentationSg(100.0)) < 0.0005);
+   // The curve starts from the last reading
+   QVERIFY(qFuzzyCompare(prediction.sgAt(60.0), testFermentationSg(60.0)));
+
+   // A reading that isn't after the last one can't be used by the fitter on its own
+   fitter.add(FermentationCurve::Reading{30.0, 1.040});
+   QCOMPARE(fitter.numReadings(), static_cast<std::size_t>(16));
+
+   //
+   // Once we're at terminal gravity, we're done
+   //
+   FermentationCurve::Fitter finished{1.060};
+   for (double time_h = 0.0; time_h <= 150.0; time_h += 6.0) {
+      finished.add(FermentationCurve::Reading{time_h, testFermentationSg(time_h)});
+   }
+   QCOMPARE(finished.prediction().terminalTime_h(), 150.0);
+
+   //
+   // Readings in any order give the same fit as the same readings in order
+   //
+   FermentationCurve::Series inOrder{1.060};
+   FermentationCurve::Series outOfOrder{1.060};
+   for (double time_h = 0.0; time_h <= 72.0; time_h += 6.0) {
+      inOrder.add(FermentationCurve::Reading{time_h, testFermentationSg(time_h)});
+      double const reversed_h = 72.0 - time_h;
+      outOfOrder.add(FermentationCurve::Reading{reversed_h, testFermentationSg(reversed_h)});
+   }
+   QCOMPARE(outOfOrder.readings().size(), inOrder.readings().size());
+   QCOMPARE(outOfOrder.readings().first().time_h, 0.0);
+   QCOMPARE(outOfOrder.prediction().fg, inOrder.prediction().fg);
+   // A second reading at the same time replaces the first
+   outOfOrder.add(FermentationCurve::Reading{72.0, testFermentationSg(72.0) + 0.002});
+   QCOMPARE(outOfOrder.readings().size(), inOrder.readings().size());
+   QCOMPARE(outOfOrder.readings().last().sg, testFermentationSg(72.0) + 0.002);
+
+   // Without a given OG, the first reading is used
+   FermentationCurve::Series noOg;
+   noOg.add(FermentationCurve::Reading{0.0, 1.055});
+   QCOMPARE(noOg.prediction().og, 1.055);
+   noOg.setOg(1.060);
+   QCOMPARE(noOg.prediction().og, 1.060);
+
+   //
+   // Round trip through the stored form, including skipping junk
+   //
+   FermentationCurve::Series const restored = FermentationCurve::Series::fromString(inOrder.toString() + ";junk", 1.060);
+   QCOMPARE(restored.readings().size(), inOrder.readings().size());
+   QVERIFY(qFuzzyCompare(restored.prediction().fg, inOrder.prediction().fg));
+
+   //
+   // And through a BrewNote
+   //
+   BrewNote brewNote{QDate{2023, 3, 1}, "Fermentation Curve Test"};
+   brewNote.setOg(1.060);
+   QDateTime const pitched{QDate{2023, 3, 1}, QTime{18, 0}};
+   for (int hours = 0; hours <= 60; hours += 12) {
+      brewNote.addGravityReading(pitched.addSecs(hours * 3600), testFermentationSg(hours));
+   }
+   QCOMPARE(brewNote.gravityReadingsList().size(), 6);
+   QCOMPARE(BrewNote::readingTime(brewNote.gravityReadingsList().first().time_h), pitched);
+   FermentationCurve::Prediction const brewNotePrediction = brewNote.fermentationPrediction();
+   QVERIFY(brewNotePrediction.valid);
+   QVERIFY(std::abs(brewNotePrediction.fg - 1.012) < 0.001);
+   QVERIFY(std::abs(BrewNote::readingTime(brewNotePrediction.terminalTime_h()).toSecsSinceEpoch() -
+                    pitched.addSecs(static_cast<int>(expectedTerminal_h * 3600)).toSecsSinceEpoch()) < 4 * 3600);
+   // One GravityReading per reading, and a correction replaces the reading it corrects
+   QCOMPARE(brewNote.gravityReadings().size(), 6);
+   brewNote.addGravityReading(pitched.addSecs(24 * 3600), testFermentationSg(24));
+   QCOMPARE(brewNote.gravityReadings().size(), 6);
+   BrewNote copy{brewNote};
+   QCOMPARE(copy.gravityReadings().size(), 6);
+   QCOMPARE(copy.fermentationPrediction().fg, brewNotePrediction.fg);
+   brewNote.removeGravityReading(0);
+   QCOMPARE(brewNote.gravityReadingsList().size(), 5);
+   QCOMPARE(brewNote.gravityReadings().size(), 5);
+   QCOMPARE(copy.gravityReadings().size(), 6);
+   return;
+}
+
+void Testing::benchmarkFermentationCurve_data() {
+   QTest::addColumn<bool>("incremental");
+   QTest::newRow("incremental") << true;
+   QTest::newRow("refit")       << false;
+   return;
+}
+
+void Testing::benchmarkFermentationCurve() {
+   QFETCH(bool, incremental);
+
+   // A reading every 15 minutes for ten days, eg from a floating hydrometer
+   int constexpr numReadings = 1000;
+   QVector<FermentationCurve::Reading> readings;
+   FermentationCurve::Fitter fitted{1.060};
+   for (int ii = 0; ii < numReadings - 1; ++ii) {
+      readings.append(FermentationCurve::Reading{ii * 0.25, testFermentationSg(ii * 0.25)});
+      fitted.add(readings.last());
+   }
+   FermentationCurve::Reading const latest{(numReadings - 1) * 0.25, testFermentationSg((numReadings - 1) * 0.25)};
+
+   double total = 0.0;
+   QBENCHMARK {
+      FermentationCurve::Fitter fitter{1.060};
+      if (incremental) {
+         fitter = fitted;
+      } else {
+         for (FermentationCurve::Reading const & reading : readings) {
+            fitter.add(reading);
+         }
+      }
+      fitter.add(latest);
+      total += fitter.prediction().fg;
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+namespace {
+   StyleMatch::Ranges testStyleRanges(StyleMatch::Vitals const & min, StyleMatch::Vitals const & max) {
+      StyleMatch::Ranges ranges;
+      ranges.min = min;
+      ranges.max = max;
+      return ranges;
+   }
+
+   // Roughly the BJCP ranges for American IPA and Irish Stout
+   StyleMatch::Ranges const testIpa  = testStyleRanges({1.056, 1.008, 40.0,  6.0, 5.5, 2.2},
+                                                       {1.070, 1.014, 70.0, 14.0, 7.5, 2.7});
+   StyleMatch::Ranges const testStout = testStyleRanges({1.036, 1.007, 25.0, 25.0, 4.0, 1.8},
+                                                        {1.044, 1.011, 45.0, 40.0, 4.5, 2.5});
+}
+
+void Testing::testStyleMatch() {
+   StyleMatch::Table table;
+   table.setRecipe(1, {1.062, 1.011, 55.0, 10.0, 6.6, 2.4}); // Bang in the middle of IPA
+   table.setRecipe(2, {1.062, 1.011, 75.0, 10.0, 6.6, 2.4}); // IPA, but a bit too bitter
+   table.setRecipe(3, {1.040, 1.009, 35.0, 32.0, 4.1, 2.0}); // Stout
+   table.setRecipe(4, {1.062, 1.011, 55.0, 10.0, 6.6, 0.0}); // IPA with no carbonation set
+   QCOMPARE(table.numRecipes(), static_cast<std::size_t>(4));
+
+   QVector<StyleMatch::Match> matches = table.bestRecipes(testIpa, 0);
+   QCOMPARE(matches.size(), 4);
+   // Ties are in ID order, and vitals the recipe doesn't have are ignored
+   QCOMPARE(matches[0].id, 1);
+   QCOMPARE(matches[0].score, 0.0);
+   QCOMPARE(matches[1].id, 4);
+   QCOMPARE(matches[1].score, 0.0);
+   // 5 IBU over a 30 IBU range
+   QCOMPARE(matches[2].id, 2);
+   QVERIFY(qFuzzyCompare(matches[2].score, 1.0 / 36.0));
+   QCOMPARE(matches[3].id, 3);
+
+   // Asking for fewer gives the best ones
+   matches = table.bestRecipes(testStout, 1);
+   QCOMPARE(matches.size(), 1);
+   QCOMPARE(matches[0].id, 3);
+
+   // A style that doesn't specify anything fits everything
+   for (StyleMatch::Match const & match : table.bestRecipes(StyleMatch::Ranges{}, 0)) {
+      QCOMPARE(match.score, 0.0);
+   }
+
+   //
+   // Updates and removals only touch the row they're for
+   //
+   table.setRecipeVital(2, StyleMatch::Vital::Ibu, 65.0);
+   table.removeRecipe(1);
+   table.removeRecipe(99);
+   QCOMPARE(table.numRecipes(), static_cast<std::size_t>(3));
+   QVERIFY(!table.containsRecipe(1));
+   matches = table.bestRecipes(testIpa, 0);
+   QCOMPARE(matches.size(), 3);
+   QCOMPARE(matches[0].id, 2);
+   QCOMPARE(matches[0].score, 0.0);
+   QCOMPARE(matches[1].id, 4);
+   QCOMPARE(matches[2].id, 3);
+   // Row moved into the gap is still found by ID
+   table.setRecipeVital(4, StyleMatch::Vital::Color_srm, 30.0);
+   QVERIFY(table.bestRecipes(testIpa, 0)[1].score > 0.0);
+
+   //
+   // And the other way round
+   //
+   table.setStyle(10, testIpa);
+   table.setStyle(20, testStout);
+   QCOMPARE(table.numStyles(), static_cast<std::size_t>(2));
+   StyleMatch::Vitals const stout{1.040, 1.009, 35.0, 32.0, 4.1, 2.0};
+   matches = table.bestStyles(stout, 0);
+   QCOMPARE(matches.size(), 2);
+   QCOMPARE(matches[0].id, 20);
+   QCOMPARE(matches[0].score, 0.0);
+   QCOMPARE(matches[1].id, 10);
+   QVERIFY(matches[1].score > 1.0);
+   // Same answer as scoring the recipe against the style directly
+   table.setRecipe(3, stout);
+   QVERIFY(qFuzzyCompare(matches[1].score, table.bestRecipes(testIpa, 0).last().score));
+   table.removeStyle(20);
+   QCOMPARE(table.bestStyles(stout, 0).size(), 1);
+
+   //
+   // Ranges come from the right Style fields
+   //
+   Style style{"Style Match Test"};
+   style.setOgMin(1.056);
+   style.setOgMax(1.070);
+   style.setFgMin(1.008);
+   style.setFgMax(1.014);
+   style.setIbuMin(40.0);
+   style.setIbuMax(70.0);
+   style.setColorMin_srm(6.0);
+   style.setColorMax_srm(14.0);
+   style.setAbvMin_pct(5.5);
+   style.setAbvMax_pct(7.5);
+   style.setCarbMin_vol(2.2);
+   style.setCarbMax_vol(2.7);
+   StyleMatch::Ranges const ranges = StyleMatch::rangesOf(style);
+   QVERIFY(ranges.min == testIpa.min);
+   QVERIFY(ranges.max == testIpa.max);
+
+   QVERIFY(StyleMatch::recipeVital("IBU") == StyleMatch::Vital::Ibu);
+   QVERIFY(!StyleMatch::recipeVital("name"));
+   return;
+}
+
+void Testing::benchmarkStyleMatch_data() {
+   QTest::addColumn<bool>("columnWise");
+   QTest::newRow("columnWise") << true;
+   QTest::newRow("perRecipe")  << false;
+   return;
+}
+
+void Testing::benchmarkStyleMatch() {
+   QFETCH(bool, columnWise);
+
+   int constexpr numRecipes = 3000;
+   std::size_t constexpr maxResults = 25;
+   TestRandom random{20230301};
+   StyleMatch::Table table;
+   QVector<StyleMatch::Vitals> recipes;
+   for (int ii = 1; ii <= numRecipes; ++ii) {
+      double const og = 1.030 + random.generateDouble() * 0.060;
+      StyleMatch::Vitals const vitals{og,
+                                      1.0 + (og - 1.0) * (0.15 + random.generateDouble() * 0.15),
+                                      random.generateDouble() * 100.0,
+                                      2.0 + random.generateDouble() * 40.0,
+                                      3.0 + random.generateDouble() * 7.0,
+                                      1.5 + random.generateDouble() * 1.5};
+      table.setRecipe(ii, vitals);
+      recipes.append(vitals);
+   }
+
+   int best = 0;
+   QBENCHMARK {
+      if (columnWise) {
+         best += table.bestRecipes(testIpa, maxResults).first().id;
+      } else {
+         // What we'd do without the table: go through the recipes one by one and sort the lot
+         QVector<StyleMatch::Match> matches;
+         for (int ii = 0; ii < recipes.size(); ++ii) {
+            double score = 0.0;
+            for (std::size_t vv = 0; vv < StyleMatch::numVitals; ++vv) {
+               double const value = recipes[ii][vv];
+               double const width = testIpa.max[vv] - testIpa.min[vv];
+               if (value < testIpa.min[vv]) {
+                  score += std::pow((testIpa.min[vv] - value) / width, 2);
+               } else if (value > testIpa.max[vv]) {
+                  score += std::pow((value - testIpa.max[vv]) / width, 2);
+               }
+            }
+            matches.append(StyleMatch::Match{ii + 1, score});
+         }
+         std::sort(matches.begin(), matches.end(), [](StyleMatch::Match const & lhs, StyleMatch::Match const & rhs) {
+            return lhs.score < rhs.score;
+         });
+         matches.resize(maxResults);
+         best += matches.first().id;
+      }
+   }
+   QVERIFY(best > 0);
+   return;
+}
+
+void Testing::testRecipeSimilarity() {
+   using RecipeSimilarity::Addition;
+   using RecipeSimilarity::hopKey;
+   RecipeSimilarity::Fingerprint const pale = RecipeSimilarity::fingerprint(
+      {Addition{"Pale Malt", 4.5}, Addition{"Crystal 40", 0.5}},
+      {Addition{hopKey("Cascade", false, 60.0), 0.030}, Addition{hopKey("Cascade", false, 5.0), 0.030}}
+   );
+   // Twice the size, with the pale malt in two lots and names spelled differently, is the same recipe
+   RecipeSimilarity::Fingerprint const doubled = RecipeSimilarity::fingerprint(
+      {Addition{"pale malt", 4.0}, Addition{"Crystal  40", 1.0}, Addition{"Pale Malt", 5.0}},
+      {Addition{hopKey("Cascade", false, 5.0), 0.060}, Addition{hopKey("CASCADE", false, 45.0), 0.060}}
+   );
+   // Bit of Munich and a dry hop
+   RecipeSimilarity::Fingerprint const tweaked = RecipeSimilarity::fingerprint(
+      {Addition{"Pale Malt", 4.0}, Addition{"Crystal 40", 0.5}, Addition{"Munich", 0.5}},
+      {Addition{hopKey("Cascade", false, 60.0), 0.030},
+       Addition{hopKey("Cascade", false, 5.0), 0.030},
+       Addition{hopKey("Cascade", true, 0.0), 0.030}}
+   );
+   RecipeSimilarity::Fingerprint const stout = RecipeSimilarity::fingerprint(
+      {Addition{"Pale Malt", 3.5}, Addition{"Roasted Barley", 0.5}, Addition{"Flaked Barley", 0.5}},
+      {Addition{hopKey("East Kent Goldings", false, 60.0), 0.050}}
+   );
+   RecipeSimilarity::Fingerprint const empty = RecipeSimilarity::fingerprint({}, {Addition{"Nothing", 0.0}});
+
+   QCOMPARE(pale.grist.size(), static_cast<std::size_t>(2));
+   QVERIFY(qFuzzyCompare(RecipeSimilarity::similarity(pale, doubled), 1.0));
+   QCOMPARE(RecipeSimilarity::estimatedOverlap(pale, doubled), 1.0);
+   double const tweakedSimilarity = RecipeSimilarity::similarity(pale, tweaked);
+   double const stoutSimilarity   = RecipeSimilarity::similarity(pale, stout);
+   QVERIFY(tweakedSimilarity > 0.6 && tweakedSimilarity < 1.0);
+   QVERIFY(stoutSimilarity > 0.0 && stoutSimilarity < tweakedSimilarity);
+   QVERIFY(RecipeSimilarity::estimatedOverlap(pale, stout) < RecipeSimilarity::estimatedOverlap(pale, tweaked));
+   QVERIFY(empty.isEmpty());
+   QCOMPARE(RecipeSimilarity::similarity(pale, empty), 0.0);
+   QCOMPARE(RecipeSimilarity::estimatedOverlap(empty, empty), 0.0);
+
+   //
+   // Index gives the same ranking
+   //
+   RecipeSimilarity::Index index;
+   index.set(1, pale);
+   index.set(2, doubled);
+   index.set(3, stout);
+   index.set(4, tweaked);
+   index.set(5, empty);
+   QCOMPARE(index.size(), static_cast<std::size_t>(5));
+   QVector<RecipeSimilarity::Match> matches = index.nearest(pale, 0, 1);
+   QCOMPARE(matches.size(), 3);
+   QCOMPARE(matches[0].id, 2);
+   QCOMPARE(matches[1].id, 4);
+   QCOMPARE(matches[2].id, 3);
+   QVERIFY(qFuzzyCompare(matches[1].similarity, tweakedSimilarity));
+   QCOMPARE(index.nearest(pale, 1, 1).size(), 1);
+   QCOMPARE(index.nearest(pale, 0, 1, 0.5).size(), 2);
+   QVERIFY(index.nearest(empty, 0).isEmpty());
+
+   // Updating and removing rows
+   index.set(2, stout);
+   index.remove(3);
+   index.remove(99);
+   QCOMPARE(index.size(), static_cast<std::size_t>(4));
+   QVERIFY(!index.contains(3));
+   matches = index.nearest(pale, 0, 1);
+   QCOMPARE(matches.size(), 2);
+   QCOMPARE(matches[0].id, 4);
+   QCOMPARE(matches[1].id, 2);
+   QVERIFY(qFuzzyCompare(matches[1].similarity, stoutSimilarity));
+   return;
+}
+
+namespace {
+   //! \brief Library of random recipes made from a small pool of ingredients, so that plenty of them overlap
+   QVector<RecipeSimilarity::Fingerprint> testRecipeLibrary(int const numRecipes) {
+      TestRandom random{20230301};
+      QVector<RecipeSimilarity::Fingerprint> library;
+      for (int ii = 0; ii < numRecipes; ++ii) {
+         QVector<RecipeSimilarity::Addition> grist{RecipeSimilarity::Addition{"Base Malt", 4.0}};
+         for (int jj = random.bounded(1, 5); jj > 0; --jj) {
+            grist.append(RecipeSimilarity::Addition{QString("Malt %1").arg(random.bounded(40)),
+                                                    0.1 + random.generateDouble()});
+         }
+         QVector<RecipeSimilarity::Addition> hops;
+         for (int jj = random.bounded(1, 5); jj > 0; --jj) {
+            hops.append(RecipeSimilarity::Addition{
+               RecipeSimilarity::hopKey(QString("Hop %1").arg(random.bounded(30)), false, random.bounded(60)),
+               0.01 + random.generateDouble() * 0.05
+            });
+         }
+         library.append(RecipeSimilarity::fingerprint(grist, hops));
+      }
+      return library;
+   }
+}
+
+void Testing::benchmarkRecipeSimilarity_data() {
+   QTest::addColumn<bool>("screened");
+   QTest::newRow("screened")   << true;
+   QTest::newRow("bruteForce") << false;
+   return;
+}
+
+void Testing::benchmarkRecipeSimilarity() {
+   QFETCH(bool, screened);
+
+   std::size_t constexpr maxResults = 10;
+   QVector<RecipeSimilarity::Fingerprint> const library = testRecipeLibrary(10000);
+   RecipeSimilarity::Index index;
+   for (int ii = 0; ii < library.size(); ++ii) {
+      index.set(ii, library[ii]);
+   }
+
+   int found = 0;
+   QBENCHMARK {
+      if (screened) {
+         found += index.nearest(library.first(), maxResults, 0).size();
+      } else {
+         QVector<RecipeSimilarity::Match> matches;
+         for (int ii = 1; ii < library.size(); ++ii) {
+            matches.append(RecipeSimilarity::Match{ii, RecipeSimilarity::similarity(library.first(), library[ii])});
+         }
+         std::partial_sort(
+            matches.begin(),
+            matches.begin() + maxResults,
+            matches.end(),
+            [](auto const & lhs, auto const & rhs) { return lhs.similarity > rhs.similarity; }
+         );
+         found += static_cast<int>(maxResults);
+      }
+   }
+   QVERIFY(found > 0);
+   return;
+}
+
+void Testing::testBatchPlanning() {
+   using BatchPlanning::Item;
+   using BatchPlanning::Kind;
+   BatchPlanning::Stock stock;
+   stock.add(Item{Kind::Fermentable, "Pale Malt",   11, 10.0,  false});
+   stock.add(Item{Kind::Fermentable, "Crystal 40",  12,  0.4,  false});
+   stock.add(Item{Kind::Hop,         "Cascade",     11,  0.1,  false});
+   stock.add(Item{Kind::Misc,        "Lactic Acid", 13,  0.01, true });
+   // Same inventory again is ignored
+   stock.add(Item{Kind::Hop,         "Cascade",     11,  5.0,  false});
+   QCOMPARE(stock.numRows(), 4);
+
+   // Matching is by inventory first, then by name (ignoring case and spacing) with the same units, of the same kind
+   QCOMPARE(stock.rowFor(Item{Kind::Fermentable, "Renamed pale", 11, 1.0, false}), 0);
+   QCOMPARE(stock.rowFor(Item{Kind::Fermentable, "crystal  40",   0, 1.0, false}), 1);
+   QCOMPARE(stock.rowFor(Item{Kind::Hop,         "CASCADE",      99, 1.0, false}), 2);
+   QCOMPARE(stock.rowFor(Item{Kind::Misc,        "Lactic Acid",   0, 1.0, true }), 3);
+   QCOMPARE(stock.numRows(), 4);
+   int const unstocked = stock.rowFor(Item{Kind::Misc, "Lactic Acid", 0, 1.0, false});
+   QCOMPARE(unstocked, 4);
+   QCOMPARE(stock.row(unstocked).amount, 0.0);
+   QCOMPARE(stock.rowFor(Item{Kind::Fermentable, "Cascade", 0, 1.0, false}), 5);
+
+   BatchPlanning::Brew const paleAle{
+      1, "Pale Ale", 1,
+      {Item{Kind::Fermentable, "Pale Malt",  11, 4.5,  false},
+       Item{Kind::Fermentable, "Crystal 40", 12, 0.3,  false},
+       Item{Kind::Hop,         "Cascade",    11, 0.03, false},
+       Item{Kind::Hop,         "Cascade",    11, 0.02, false}}
+   };
+   BatchPlanning::Brew const ipa{
+      2, "IPA", 1,
+      {Item{Kind::Fermentable, "Pale Malt", 11, 5.0,  false},
+       Item{Kind::Hop,         "Cascade",   11, 0.08, false},
+       Item{Kind::Hop,         "Citra",      0, 0.05, false}}
+   };
+   BatchPlanning::Brew const bitter{
+      3, "Bitter", 2,
+      {Item{Kind::Fermentable, "Pale Malt", 11, 2.5,  false},
+       Item{Kind::Hop,         "Cascade",   11, 0.02, false}}
+   };
+   BatchPlanning::Plan const plan = BatchPlanning::plan(stock, {paleAle, ipa, bitter});
+
+   // The IPA can't have the Cascade the pale ale used (or any Citra), so the bitter, queued after it, gets brewed
+   QCOMPARE(plan.brews.size(), 3);
+   QVERIFY( plan.brews[0].canBrew);
+   QVERIFY(!plan.brews[1].canBrew);
+   QCOMPARE(plan.brews[1].missing, QStringList({"Cascade", "Citra"}));
+   QVERIFY( plan.brews[2].canBrew);
+   QCOMPARE(plan.brews[2].batches, 2);
+
+   // Requirements are for the whole queue, brewable or not, in the order first needed
+   QCOMPARE(plan.requirements.size(), 4);
+   QCOMPARE(plan.requirements[0].item.name, QString("Pale Malt"));
+   QVERIFY(qFuzzyCompare(plan.requirements[0].required, 14.5));
+   QVERIFY(qFuzzyCompare(plan.requirements[2].required, 0.17));
+   QVector<BatchPlanning::Requirement> const toBuy = plan.purchaseList();
+   QCOMPARE(toBuy.size(), 3);
+   QCOMPARE(toBuy[0].item.name, QString("Pale Malt"));
+   QVERIFY(qFuzzyCompare(toBuy[0].shortfall(), 4.5));
+   QCOMPARE(toBuy[1].item.name, QString("Cascade"));
+   QVERIFY(qFuzzyCompare(toBuy[1].shortfall(), 0.07));
+   QCOMPARE(toBuy[2].item.name, QString("Citra"));
+   QVERIFY(qFuzzyCompare(toBuy[2].shortfall(), 0.05));
+
+   // Nothing queued, nothing needed
+   QVERIFY(BatchPlanning::plan(stock, {}).requirements.isEmpty());
+   return;
+}
+
+namespace {
+   /**
+    * \brief How sorting by amount used to work: ask the model for the text it displays and parse the amount back out
+    *        of it, for both sides of every comparison
+    */
+   class HopDisplayTextSortProxy : public QSortFilterProxyModel {
+   public:
+      using QSortFilterProxyModel::QSortFilterProxyModel;
+   protected:
+      bool lessThan(QModelIndex const & left, QModelIndex const & right) const {
+         QString const leftText  = this->sourceModel()->data(left ).toString();
+         QString const rightText = this->sourceModel()->data(right).toString();
+         return Measurement::qStringToSI(leftText,  Measurement::PhysicalQuantity::Mass) <
+                Measurement::qStringToSI(rightText, Measurement::PhysicalQuantity::Mass);
+      }
+   };
+}
+
+void Testing::benchmarkHopSort_data() {
+   QTest::addColumn<bool>("sortRole");
+   QTest::newRow("sortRole")    << true;
+   QTest::newRow("displayText") << false;
+   return;
+}
+
+void Testing::benchmarkHopSort() {
+   QFETCH(bool, sortRole);
+
+   int constexpr numHops = 2000;
+   TestRandom random{20230401};
+   QList<std::shared_ptr<Hop>> hops;
+   for (int ii = 0; ii < numHops; ++ii) {
+      auto hop = std::make_shared<Hop>(QString("Hop %1").arg(ii));
+      hop->setAlpha_pct(2.0 + random.generateDouble() * 16.0);
+      hop->setAmount_kg(random.generateDouble() * 0.2);
+      hop->setTime_min(random.bounded(90));
+      hops.append(hop);
+   }
+   QTableView tableView;
+   HopTableModel model{&tableView, false};
+   model.addHops(hops);
+   QCOMPARE(model.rowCount(), numHops);
+
+   std::unique_ptr<QSortFilterProxyModel> proxy;
+   if (sortRole) {
+      proxy = std::make_unique<HopSortFilterProxyModel>(nullptr, false);
+   } else {
+      proxy = std::make_unique<HopDisplayTextSortProxy>();
+   }
+   proxy->setSourceModel(&model);
+   int const amountColumn = static_cast<int>(HopTableModel::ColumnIndex::Amount);
+
+   QBENCHMARK {
+      proxy->sort(amountColumn, Qt::DescendingOrder);
+      proxy->sort(amountColumn, Qt::AscendingOrder);
+   }
+
+   for (int row = 1; row < proxy->rowCount(); ++row) {
+      QVERIFY(proxy->data(proxy->index(row - 1, amountColumn), BtTableModel::SortRole).toDouble() <=
+              proxy->data(proxy->index(row,     amountColumn), BtTableModel::SortRole).toDouble());
+   }
+   return;
+}
+
+void Testing::testTextSearch() {
+   QCOMPARE(TextSearch::normalised("  East   Kent\tGoldings "), QString("east kent goldings"));
+
+   TextSearch::Index index;
+   index.set(1, "Cascade\nUS\nFloral, citrus");
+   index.set(2, "East Kent Goldings\nUK\nEarthy");
+   index.set(3, "Citra\nUS\nGrapefruit   and  lime");
+   index.set(4, "Casc\nAde");
+   QCOMPARE(index.size(), 4);
+
+   // Case and whitespace don't matter, and any field can match
+   QCOMPARE(index.matching("CASCADE"),       (QSet<int>{1}));
+   QCOMPARE(index.matching("kent  goldings"), (QSet<int>{2}));
+   QCOMPARE(index.matching("us"),            (QSet<int>{1, 3}));
+   QCOMPARE(index.matching("grapefruit and"), (QSet<int>{3}));
+   QCOMPARE(index.matching("cit"),           (QSet<int>{1, 3}));
+   // A query only matches within one field, even though "casc\nade" has all the trigrams of "cascade" but one
+   QCOMPARE(index.matching("cascade"),       (QSet<int>{1}));
+   QCOMPARE(index.matching("casc ade"),      (QSet<int>{}));
+   // Queries too short for trigrams still work, and an empty one matches everything
+   QCOMPARE(index.matching("k"),             (QSet<int>{2}));
+   QCOMPARE(index.matching(""),              (QSet<int>{1, 2, 3, 4}));
+   QCOMPARE(index.matching("zzz"),           (QSet<int>{}));
+
+   // Refining previous matches
+   QSet<int> const previous{1, 2};
+   QCOMPARE(index.matching("citr", &previous), (QSet<int>{1}));
+   QCOMPARE(index.matching("e",    &previous), (QSet<int>{1, 2}));
+
+   // Changing and removing texts
+   index.set(1, "Centennial");
+   QCOMPARE(index.matching("cascade"), (QSet<int>{}));
+   QCOMPARE(index.matching("cent"),    (QSet<int>{1}));
+   index.remove(3);
+   QVERIFY(!index.contains(3));
+   QCOMPARE(index.matching("us"),      (QSet<int>{}));
+   index.remove(3);
+   QCOMPARE(index.size(), 3);
+   return;
+}
+
+void Testing::benchmarkTextSearch_data() {
+   QTest::addColumn<bool>("indexed");
+   QTest::newRow("indexed") << true;
+   QTest::newRow("scan")    << false;
+   return;
+}
+
+void Testing::benchmarkTextSearch() {
+   QFETCH(bool, indexed);
+
+   int constexpr numTexts = 20000;
+   QStringList const words{"pale", "crystal", "munich", "cascade", "saaz", "citra", "wheat", "amber", "ale", "lager",
+                           "us",   "uk",      "german", "floral",  "spicy", "citrus", "earthy", "malty", "dry", "sweet"};
+   TestRandom random{20230501};
+   QStringList texts;
+   TextSearch::Index index;
+   for (int ii = 0; ii < numTexts; ++ii) {
+      QStringList fields;
+      for (int jj = 0; jj < 3; ++jj) {
+         fields.append(QString("%1 %2 %3").arg(words.at(random.bounded(words.size())))
+                                          .arg(words.at(random.bounded(words.size())))
+                                          .arg(ii * 3 + jj));
+      }
+      texts.append(fields.join('\n'));
+      index.set(ii, texts.last());
+   }
+
+   QString const query{"cascade"};
+   int found = 0;
+   QBENCHMARK {
+      QSet<int> matches;
+      for (int length = 1; length <= query.size(); ++length) {
+         QString const prefix = query.left(length);
+         if (indexed) {
+            matches = index.matching(prefix, length > 1 ? &matches : nullptr);
+         } else {
+            matches.clear();
+            for (int ii = 0; ii < texts.size(); ++ii) {
+               if (texts.at(ii).contains(prefix, Qt::CaseInsensitive)) {
+                  matches.insert(ii);
+               }
+            }
+         }
+      }
+      found = matches.size();
+   }
+   QVERIFY(found > 0);
+   return;
+}
+
+void Testing::testBtTreeModelLookup() {
+   int constexpr numFolders = 100;
+   int constexpr numRecipes = 10000;
+   BtTreeModel model{nullptr, BtTreeModel::RECIPEMASK};
+
+   // The recipes aren't in the database, so the model won't hear about them except through what we do to it directly
+   QVector<std::shared_ptr<Recipe>> recipes;
+   QStringList folderPaths;
+   for (int ii = 0; ii < numFolders; ++ii) {
+      folderPaths.append(QString("/Synthetic/Folder %1/Sub %2").arg(ii / 10).arg(ii));
+      QVERIFY(model.addFolder(folderPaths.last()));
+   }
+   for (int ii = 0; ii < numRecipes; ++ii) {
+      recipes.append(std::make_shared<Recipe>(QString("Synthetic %1").arg(ii)));
+      QModelIndex folder = model.findFolder(folderPaths.at(ii % numFolders));
+      QVERIFY(folder.isValid());
+      QVERIFY(model.insertRow(model.rowCount(folder), folder, recipes.last().get(), BtTreeItem::Type::RECIPE));
+   }
+   QVERIFY(model.findFolder("/Synthetic/Folder 3").isValid());
+   QVERIFY(!model.findFolder("/Synthetic/Folder 3/Sub 99").isValid());
+
+   // Every recipe is where we put it
+   for (int ii = 0; ii < numRecipes; ++ii) {
+      QModelIndex found = model.findElement(recipes.at(ii).get());
+      QVERIFY(found.isValid());
+      QCOMPARE(model.getItem<Recipe>(found), recipes.at(ii).get());
+      QCOMPARE(model.index(found.row(), 0, model.parent(found)), found);
+      QCOMPARE(model.parent(found), model.findFolder(folderPaths.at(ii % numFolders)));
+   }
+
+   // A brew note is found inside its recipe, but a recipe isn't found inside another recipe
+   auto brewNote = std::make_shared<BrewNote>(QString("Synthetic note"));
+   QModelIndex recipeIndex = model.findElement(recipes.at(42).get());
+   QVERIFY(model.insertRow(0, recipeIndex, brewNote.get(), BtTreeItem::Type::BREWNOTE));
+   QCOMPARE(model.parent(model.findElement(brewNote.get())), recipeIndex);
+   QVERIFY(model.insertRow(1, recipeIndex, recipes.at(43).get(), BtTreeItem::Type::RECIPE));
+   QCOMPARE(model.parent(model.findElement(recipes.at(43).get())), model.findFolder(folderPaths.at(43)));
+   QCOMPARE(model.parent(model.findElement(recipes.at(43).get(), model.item(recipeIndex))), recipeIndex);
+
+   // Removing a folder forgets everything in it, including the brew note
+   QModelIndex folder = model.findFolder(folderPaths.at(42));
+   QVERIFY(model.removeFolder(folder));
+   QVERIFY(!model.findFolder(folderPaths.at(42)).isValid());
+   QVERIFY(!model.findElement(recipes.at(42).get()).isValid());
+   QVERIFY(!model.findElement(recipes.at(42 + numFolders).get()).isValid());
+   QVERIFY(!model.findElement(brewNote.get()).isValid());
+   QVERIFY(model.findElement(recipes.at(43).get()).isValid());
+
+   // Folders are recreated on demand, and stay findable
+   QModelIndex recreated = model.findFolder(folderPaths.at(42), nullptr, true);
+   QVERIFY(recreated.isValid());
+   QCOMPARE(model.item(model.findFolder(folderPaths.at(42))), model.item(recreated));
+   return;
+}
+
+void Testing::testBtTreeModelToolTips() {
+   BtTreeModel model{nullptr, BtTreeModel::RECIPEMASK};
+   auto recipe = std::make_shared<Recipe>(QString("Tooltip Test"));
+   QModelIndex top = model.findFolder("");
+   QVERIFY(model.insertRow(model.rowCount(top), top, recipe.get(), BtTreeItem::Type::RECIPE));
+   QModelIndex recipeIndex = model.findElement(recipe.get());
+   QVERIFY(recipeIndex.isValid());
+
+   // Asking again gets the same string back, not just an equal one
+   QString const first = model.data(recipeIndex, Qt::ToolTipRole).toString();
+   QVERIFY(!first.isEmpty());
+   QVERIFY(model.data(recipeIndex, Qt::ToolTipRole).toString().isSharedWith(first));
+
+   // Changing the recipe means building it again
+   recipe->setName("Tooltip Test 2");
+   QString const second = model.data(recipeIndex, Qt::ToolTipRole).toString();
+   QVERIFY(!second.isSharedWith(first));
+   QVERIFY(model.data(recipeIndex, Qt::ToolTipRole).toString().isSharedWith(second));
+
+   // Folders don't have tooltips
+   QVERIFY(model.data(top, Qt::ToolTipRole).toString().isEmpty());
+   return;
+}
+
+namespace {
+   int countTreeRows(BtTreeModel const & model, QModelIndex const & parent) {
+      int rows = model.rowCount(parent);
+      for (int row = model.rowCount(parent) - 1; row >= 0; --row) {
+         rows += countTreeRows(model, model.index(row, 0, parent));
+      }
+      return rows;
+   }
+}
+
+void Testing::benchmarkBtTreeModelLoad_data() {
+   QTest::addColumn<bool>("expandAll");
+   QTest::newRow("lazy")      << false;
+   QTest::newRow("expandAll") << true;
+   return;
+}
+
+void Testing::benchmarkBtTreeModelLoad() {
+   QFETCH(bool, expandAll);
+
+   int constexpr numRecipes = 300;
+   int constexpr brewNotesPerRecipe = 3;
+   // Both rows of the benchmark share the same database, so we only fill it once
+   auto existing = ObjectStoreWrapper::findAllMatching<Recipe>(
+      [](std::shared_ptr<Recipe> recipe) { return recipe->name().startsWith("Tree Benchmark "); }
+   );
+   for (int ii = existing.size(); ii < numRecipes; ++ii) {
+      auto recipe = std::make_shared<Recipe>(QString("Tree Benchmark %1").arg(ii));
+      recipe->setFolder(QString("/Tree Benchmark/Folder %1").arg(ii % 20));
+      ObjectStoreWrapper::insert(recipe);
+      for (int jj = 0; jj < brewNotesPerRecipe; ++jj) {
+         ObjectStoreWrapper::insert(std::make_shared<BrewNote>(*recipe));
+      }
+   }
+
+   int rows = 0;
+   QBENCHMARK {
+      BtTreeModel model{nullptr, BtTreeModel::RECIPEMASK};
+      if (expandAll) {
+         // This is what building the tree used to do for every recipe
+         for (Recipe * recipe : ObjectStoreWrapper::getAllDisplayableRaw<Recipe>()) {
+            QModelIndex recipeIndex = model.findElement(recipe);
+            if (model.canFetchMore(recipeIndex)) {
+               model.fetchMore(recipeIndex);
+            }
+         }
+      }
+      rows = countTreeRows(model, QModelIndex());
+   }
+   qInfo() << Q_FUNC_INFO << (expandAll ? "Expanded" : "Lazy") << "tree has" << rows << "rows";
+   QVERIFY(rows >= numRecipes);
+   if (expandAll) {
+      QVERIFY(rows >= numRecipes * (1 + brewNotesPerRecipe));
+   }
+   return;
+}
+
+void Testing::testTableModelRowUpdates() {
+   auto rec = std::make_shared<Recipe>("Row Update Test Recipe");
+   ObjectStoreWrapper::insert(rec);
+   QTableView tableView;
+   HopTableModel model{&tableView, false};
+   model.observeRecipe(rec.get());
+
+   QList<std::shared_ptr<Hop>> hops;
+   for (int ii = 0; ii < 3; ++ii) {
+      hops.append(rec->add<Hop>(std::make_shared<Hop>(QString("Row Update Hop %1").arg(ii))));
+   }
+   QCOMPARE(model.rowCount(), 3);
+
+   QSignalSpy inserted{&model, &QAbstractItemModel::rowsInserted};
+   QSignalSpy removed {&model, &QAbstractItemModel::rowsRemoved };
+   QSignalSpy reset   {&model, &QAbstractItemModel::modelReset  };
+
+   // Adding a hop is one insert, at the end
+   hops.append(rec->add<Hop>(std::make_shared<Hop>("Row Update Hop 3")));
+   QCOMPARE(model.rowCount(), 4);
+   QCOMPARE(inserted.count(), 1);
+   QCOMPARE(inserted.at(0).at(1).toInt(), 3);
+   QCOMPARE(inserted.at(0).at(2).toInt(), 3);
+   QCOMPARE(removed.count(), 0);
+
+   // Removing one from the middle is one remove, and leaves the rest where they were
+   rec->remove<Hop>(hops.at(1));
+   QCOMPARE(model.rowCount(), 3);
+   QCOMPARE(removed.count(), 1);
+   QCOMPARE(removed.at(0).at(1).toInt(), 1);
+   QCOMPARE(removed.at(0).at(2).toInt(), 1);
+   QCOMPARE(inserted.count(), 1);
+   QCOMPARE(reset.count(), 0);
+   QVERIFY(model.getRow(0) == hops.at(0));
+   QVERIFY(model.getRow(1) == hops.at(2));
+   QVERIFY(model.getRow(2) == hops.at(3));
+
+   // Changes to two rows get to the view together, once control gets back to the event loop
+   QSignalSpy dataChanged{&model, &QAbstractItemModel::dataChanged};
+   hops.at(0)->setAlpha_pct(5.0);
+   hops.at(2)->setAlpha_pct(6.0);
+   QCOMPARE(dataChanged.count(), 0);
+   QTRY_COMPARE(dataChanged.count(), 1);
+   QCOMPARE(dataChanged.at(0).at(0).value<QModelIndex>().row(), 0);
+   QCOMPARE(dataChanged.at(0).at(1).value<QModelIndex>().row(), 1);
+   return;
+}
+
+void Testing::testRecipeDisplayQueue() {
+   // Properties that aren't on the recipe tab don't refresh anything
+   QCOMPARE(RecipeDisplayQueue::displaysFor(*PropertyNames::Recipe::notes), 0u);
+   QCOMPARE(RecipeDisplayQueue::displaysFor(*PropertyNames::NamedEntity::name),
+            static_cast<unsigned int>(RecipeDisplayQueue::Name));
+
+   QObject context;
+   QList<unsigned int> refreshes;
+   RecipeDisplayQueue queue{context, [&refreshes](unsigned int const displays) { refreshes.append(displays); }};
+
+   // Renaming a recipe refreshes just the name, once control gets back to the event loop
+   auto rec = std::make_shared<Recipe>("Display Queue Test Recipe");
+   ObjectStoreWrapper::insert(rec);
+   QObject::connect(rec.get(), &NamedEntity::changed, &context, [&queue](QMetaProperty const property) {
+      queue.queue(property.name());
+   });
+   rec->setName("Renamed Display Queue Test Recipe");
+   QCOMPARE(refreshes.size(), 0);
+   QTRY_COMPARE(refreshes.size(), 1);
+   QCOMPARE(refreshes.at(0), static_cast<unsigned int>(RecipeDisplayQueue::Name));
+
+   // Several changes before then are refreshed together, with each display refreshed once
+   refreshes.clear();
+   queue.queue(*PropertyNames::Recipe::og);
+   queue.queue(*PropertyNames::Recipe::fg);
+   queue.queue(*PropertyNames::Recipe::IBU);
+   queue.queue(*PropertyNames::Recipe::og);
+   QCOMPARE(refreshes.size(), 0);
+   QTRY_COMPARE(refreshes.size(), 1);
+   QCOMPARE(refreshes.at(0),
+            static_cast<unsigned int>(RecipeDisplayQueue::OgSlider  | RecipeDisplayQueue::FgSlider    |
+                                      RecipeDisplayQueue::IbuSlider | RecipeDisplayQueue::IbuGuSlider |
+                                      RecipeDisplayQueue::Calories));
+   QCoreApplication::processEvents();
+   QCOMPARE(refreshes.size(), 1);
+
+   // An unbound property doesn't even schedule a refresh
+   queue.queue(*PropertyNames::Recipe::notes);
+   QCoreApplication::processEvents();
+   QCOMPARE(refreshes.size(), 1);
+   return;
+}
+
+void Testing::benchmarkTableScroll_data() {
+   QTest::addColumn<bool>("keepCache");
+   QTest::newRow("cached")   << true;
+   QTest::newRow("uncached") << false;
+   return;
+}
+
+void Testing::benchmarkTableScroll() {
+   QFETCH(bool, keepCache);
+
+   int constexpr numHops = 2000;
+   int constexpr rowsOnScreen = 40;
+   TestRandom random{20230501};
+   QList<std::shared_ptr<Hop>> hops;
+   for (int ii = 0; ii < numHops; ++ii) {
+      auto hop = std::make_shared<Hop>(QString("Hop %1").arg(ii));
+      hop->setAlpha_pct(2.0 + random.generateDouble() * 16.0);
+      hop->setAmount_kg(random.generateDouble() * 0.2);
+      hop->setTime_min(random.bounded(90));
+      hops.append(hop);
+   }
+   QTableView tableView;
+   HopTableModel model{&tableView, false};
+   model.addHops(hops);
+   QCOMPARE(model.rowCount(), numHops);
+
+   auto repaint = [&model](int const firstRow) {
+      for (int row = firstRow; row < firstRow + rowsOnScreen; ++row) {
+         for (int column = 0; column < model.columnCount(); ++column) {
+            model.data(model.index(row, column), Qt::DisplayRole);
+         }
+      }
+   };
+
+   Measurement::clearDisplayCache();
+   QBENCHMARK {
+      for (int firstRow = 0; firstRow + rowsOnScreen <= numHops; ++firstRow) {
+         if (!keepCache) {
+            Measurement::clearDisplayCache();
+         }
+         repaint(firstRow);
+      }
+   }
+   Measurement::DisplayCacheStatistics const statistics = Measurement::displayCacheStatistics();
+   qInfo() <<
+      Q_FUNC_INFO << (keepCache ? "Cached" : "Uncached") << "scroll: hit rate" << statistics.hitRate() << "(" <<
+      statistics.hits << "hits," << statistics.misses << "misses)";
+
+   // Whatever the cache holds, what we display must be the same as formatting from scratch
+   int const amountColumn = static_cast<int>(HopTableModel::ColumnIndex::Amount);
+   QString const cachedText = model.data(model.index(0, amountColumn), Qt::DisplayRole).toString();
+   Measurement::clearDisplayCache();
+   QCOMPARE(model.data(model.index(0, amountColumn), Qt::DisplayRole).toString(), cachedText);
+   return;
+}
+
+void Testing::testAmountParsing() {
+   // Separators given explicitly, so these don't depend on the locale
+   auto usAmount = Measurement::parseAmount("1,083.5 kg", QChar('.'), QChar(','));
+   QVERIFY(usAmount);
+   QVERIFY(fuzzyComp(usAmount->quantity, 1083.5, 0.0000000001));
+   QCOMPARE(usAmount->unitName.toString(), QString("kg"));
+
+   auto frenchAmount = Measurement::parseAmount("environ 1 083,5L", QChar(','), QChar(' '));
+   QVERIFY(frenchAmount);
+   QVERIFY(fuzzyComp(frenchAmount->quantity, 1083.5, 0.0000000001));
+   QCOMPARE(frenchAmount->unitName.toString(), QString("L"));
+
+   auto fractionOnly = Measurement::parseAmount("about .5 gal or so", QChar('.'), QChar(','));
+   QVERIFY(fractionOnly);
+   QVERIFY(fuzzyComp(fractionOnly->quantity, 0.5, 0.0000000001));
+   QCOMPARE(fractionOnly->unitName.toString(), QString("gal"));
+
+   // A decimal point or group separator with no digits after it isn't part of the number
+   auto trailingPoint = Measurement::parseAmount("12. 5", QChar('.'), QChar(','));
+   QVERIFY(trailingPoint);
+   QVERIFY(fuzzyComp(trailingPoint->quantity, 12.0, 0.0000000001));
+   QVERIFY(trailingPoint->unitName.isEmpty());
+
+   QVERIFY(!Measurement::parseAmount("no number here", QChar('.'), QChar(',')));
+   QVERIFY(!Measurement::parseAmount("",               QChar('.'), QChar(',')));
+
+   //
+   // Unit names, including ones that are ambiguous within a physical quantity (eg "gal") or that we match regardless
+   // of case (eg "ML" for mL)
+   //
+   struct {
+      Measurement::UnitSystem const & unitSystem;
+      QString name;
+   } const lookups[] {
+      {Measurement::UnitSystems::volume_UsCustomary,            "gal"   },
+      {Measurement::UnitSystems::volume_Imperial,               "gal"   },
+      {Measurement::UnitSystems::volume_Metric,                 "ML"    },
+      {Measurement::UnitSystems::volume_Metric,                 "qt"    },
+      {Measurement::UnitSystems::mass_Metric,                   "kg"    },
+      {Measurement::UnitSystems::mass_UsCustomary,              "Oz"    },
+      {Measurement::UnitSystems::color_StandardReferenceMethod, "ebc"   },
+      {Measurement::UnitSystems::density_SpecificGravity,       "p"     },
+      {Measurement::UnitSystems::diastaticPower_Lintner,        "L"     },
+      {Measurement::UnitSystems::mass_Metric,                   "bogus" },
+   };
+   for (auto const & lookup : lookups) {
+      Measurement::Unit const * const expected = Measurement::Unit::getUnit(lookup.name, lookup.unitSystem, true);
+      Measurement::Unit const * const found    = Measurement::Unit::findUnit(QStringRef{&lookup.name},
+                                                                             lookup.unitSystem);
+      qDebug() << Q_FUNC_INFO << lookup.name << "in" << lookup.unitSystem << ":" << (found ? found->name : "none");
+      QVERIFY2(found == expected, qPrintable(lookup.name));
+   }
+   QCOMPARE(Measurement::Unit::findUnit(QStringRef{}, Measurement::UnitSystems::mass_Metric),
+            static_cast<Measurement::Unit const *>(nullptr));
+   return;
+}
+
+void Testing::benchmarkAmountParsing_data() {
+   QTest::addColumn<QString>("method");
+   QTest::newRow("parseAmount") << QString("parseAmount");
+   QTest::newRow("QRegExp")     << QString("QRegExp");
+   QTest::newRow("qstringToSI") << QString("qstringToSI");
+   return;
+}
+
+void Testing::benchmarkAmountParsing() {
+   QFETCH(QString, method);
+
+   QString const decimalPoint   = Localization::getLocale().decimalPoint();
+   QString const groupSeparator = Localization::getLocale().groupSeparator();
+   char const * const unitNames[] = {"", " L", " l", "qt", " gal", " mL", " tbsp"};
+   TestRandom random{20230502};
+   QStringList inputs;
+   for (int ii = 0; ii < 1000; ++ii) {
+      QString input = QString::number(random.bounded(5));
+      if (random.bounded(4) == 0) {
+         input += groupSeparator + QString::number(100 + random.bounded(900));
+      }
+      input += decimalPoint + QString::number(random.bounded(1000)) + unitNames[random.bounded(7)];
+      inputs.append(input);
+   }
+
+   // This is how UnitSystem::qstringToSI used to read amounts
+   QRegExp const amountRegExp{
+      "((?:\\d+" + QRegExp::escape(groupSeparator) + ")?\\d+(?:" + QRegExp::escape(decimalPoint) + "\\d+)?|" +
+      QRegExp::escape(decimalPoint) + "\\d+)\\s*(\\w+)?",
+      Qt::CaseInsensitive
+   };
+
+   double total = 0.0;
+   if (method == "parseAmount") {
+      QBENCHMARK {
+         for (QString const & input : inputs) {
+            total += Measurement::parseAmount(input)->quantity;
+         }
+      }
+   } else if (method == "QRegExp") {
+      QBENCHMARK {
+         for (QString const & input : inputs) {
+            amountRegExp.indexIn(input);
+            total += Localization::toDouble(amountRegExp.cap(1), Q_FUNC_INFO);
+         }
+      }
+   } else {
+      QBENCHMARK {
+         for (QString const & input : inputs) {
+            total += Measurement::UnitSystems::volume_Metric.qstringToSI(input, Measurement::Units::liters).quantity();
+         }
+      }
+   }
+   QVERIFY(total > 0.0);
+   return;
+}
+
+void Testing::testStaticQuantities() {
+   using namespace Measurement::StaticUnits;
+   using Measurement::Quantity;
+
+   // The whole point is that these are sorted out by the compiler
+   static_assert(!std::is_constructible_v<Quantity<Liters>,    Quantity<Kilograms>>);
+   static_assert(!std::is_constructible_v<Quantity<Celsius>,   Quantity<SpecificGravity>>);
+   static_assert(!std::is_convertible_v<double, Quantity<Pounds>>);
+   static_assert( std::is_convertible_v<Quantity<Kilograms>, Quantity<Pounds>>);
+   static_assert(Quantity<Fahrenheit>{Quantity<Celsius>{100.0}}.value() == 212.0);
+   static_assert(Quantity<Grams>{Quantity<Kilograms>{1.5}}.value() == 1500.0);
+   static_assert(Quantity<GravityPoints>{Quantity<SpecificGravity>{1.5}}.value() == 500.0);
+
+   struct {
+      double staticValue;
+      Measurement::Unit const & unit;
+      double canonical;
+   } const checks[] {
+      {Quantity<Grams          >{1.0}.canonical(), Measurement::Units::grams,            1.0},
+      {Quantity<Pounds         >{1.0}.canonical(), Measurement::Units::pounds,           1.0},
+      {Quantity<Ounces         >{1.0}.canonical(), Measurement::Units::ounces,           1.0},
+      {Quantity<Milliliters    >{1.0}.canonical(), Measurement::Units::milliliters,      1.0},
+      {Quantity<UsGallons      >{1.0}.canonical(), Measurement::Units::us_gallons,       1.0},
+      {Quantity<ImperialGallons>{1.0}.canonical(), Measurement::Units::imperial_gallons, 1.0},
+      {Quantity<Fahrenheit     >{1.0}.canonical(), Measurement::Units::fahrenheit,       1.0},
+      {Quantity<Fahrenheit     >{0.0}.canonical(), Measurement::Units::fahrenheit,       0.0},
+      {Quantity<Ebc            >{1.0}.canonical(), Measurement::Units::ebc,              1.0},
+   };
+   for (auto const & check : checks) {
+      double const runTimeValue = check.unit.toCanonical(check.canonical).quantity();
+      qDebug() << Q_FUNC_INFO << check.canonical << check.unit << "=" << check.staticValue << "/" << runTimeValue;
+      QVERIFY(fuzzyComp(check.staticValue, runTimeValue, 1e-12));
+   }
+
+   // Same dimension, different units: arithmetic converts to the left-hand side's unit
+   Quantity<Kilograms> const total = Quantity<Kilograms>{1.0} + Quantity<Pounds>{1.0};
+   QVERIFY(fuzzyComp(total.value(), 1.45359237, 1e-12));
+   QVERIFY(Quantity<Pounds>{1.0} < Quantity<Pounds>{Quantity<Kilograms>{1.0}});
+
+   // The traditional lb/gal to kg/L factor
+   QVERIFY(fuzzyComp(Measurement::ratioConversionFactor<Kilograms, Liters, Pounds, UsGallons>, 8.34538, 0.0001));
+   return;
+}
+
+void Testing::benchmarkStaticQuantities_data() {
+   QTest::addColumn<bool>("useStaticUnits");
+   QTest::newRow("Quantity") << true;
+   QTest::newRow("Unit")     << false;
+   return;
+}
+
+void Testing::benchmarkStaticQuantities() {
+   QFETCH(bool, useStaticUnits);
+   using namespace Measurement::StaticUnits;
+   using Measurement::Quantity;
+
+   int constexpr numValues = 10000;
+   std::vector<double> temperatures_c(numValues);
+   std::vector<double> amounts_kg(numValues);
+   for (int ii = 0; ii < numValues; ++ii) {
+      temperatures_c[ii] = 10.0 + ii * 20.0 / numValues;
+      amounts_kg[ii]     = 0.1 + ii * 5.0 / numValues;
+   }
+   double const volume_l = 23.0;
+
+   double total = 0.0;
+   if (useStaticUnits) {
+      QBENCHMARK {
+         for (int ii = 0; ii < numValues; ++ii) {
+            total += Quantity<Fahrenheit>{Quantity<Celsius>{temperatures_c[ii]}}.value();
+            total += Quantity<Pounds>{Quantity<Kilograms>{amounts_kg[ii]}}.value() /
+                     Quantity<UsGallons>{Quantity<Liters>{volume_l}}.value();
+         }
+      }
+   } else {
+      QBENCHMARK {
+         for (int ii = 0; ii < numValues; ++ii) {
+            total += Measurement::Units::fahrenheit.fromCanonical(temperatures_c[ii]);
+            total += Measurement::Units::pounds.fromCanonical(amounts_kg[ii]) /
+                     Measurement::Units::us_gallons.fromCanonical(volume_l);
+         }
+      }
+   }
+   QVERIFY(total > 0.0);
    return;
 }
 
@@ -92,6 +92,219 @@ private slots:
     */
    void testAlgorithms();
 
+   //! \brief Verify batch versions of functions in \c Algorithms give the same results as the scalar ones
+   void testBatchAlgorithms();
+
+   //! \brief Scalar versus batch conversion of 10,000 readings
+   void benchmarkBatchAlgorithms_data();
+   void benchmarkBatchAlgorithms();
+
+   //! \brief SG <-> Brix lookups on their own and as part of the conversions done by \c RefractoDialog
+   void benchmarkRefractometerConversions_data();
+   void benchmarkRefractometerConversions();
+
+   //! \brief Per-call cost of \c Algorithms::PlatoToSG_20C20C lookup versus root-finding (3000 calls per iteration)
+   void benchmarkPlatoToSg_data();
+   void benchmarkPlatoToSg();
+
+   /**
+    * \brief Verify the batch version of \c IbuMethods::getIbus gives the same results as the scalar one with the
+    *        adjustments for hop use, form and utilization that \c Recipe::ibuFromHop used to apply itself
+    */
+   void testIbuKernel();
+
+   //! \brief Per-hop scalar versus batch IBU calculation for 50 hop additions
+   void benchmarkIbuKernel_data();
+   void benchmarkIbuKernel();
+
+   /**
+    * \brief Check the \c TIME_RESOLVED IBU formula matches Tinseth where it's calibrated to, responds sensibly to
+    *        hop stand, chill and boiling point, and reuses cached utilisation curves
+    */
+   void testTimeResolvedIbu();
+
+   //! \brief 50 hop additions: per-hop Tinseth (as \c Recipe used to do) versus time-resolved with a cached curve
+   //!        versus time-resolved re-integrating the curve every time
+   void benchmarkTimeResolvedIbu_data();
+   void benchmarkTimeResolvedIbu();
+
+   /**
+    * \brief Verify \c RecipeSweep grids are laid out as documented and that, for a recipe's own parameters and for
+    *        variants we then set on the recipe, the sweep gives the same results as \c Recipe
+    */
+   void testRecipeSweep();
+
+   //! \brief Sweep of 10,000 recipe variants on one thread versus all available
+   void benchmarkRecipeSweep_data();
+   void benchmarkRecipeSweep();
+
+   /**
+    * \brief Verify \c SaltSolver uses the same salt compositions as \c Salt, recovers salt additions from the profile
+    *        they produce, and respects pH bounds
+    */
+   void testSaltSolver();
+
+   //! \brief Time to solve for salt additions, which needs to be well under a millisecond to re-solve interactively
+   void benchmarkSaltSolver();
+
+   /**
+    * \brief Check the \c LinearAlgebra operations and solvers against known answers, and that the legacy \c Matrix
+    *        interface still works
+    */
+   void testLinearAlgebra();
+
+   //! \brief 6×6 multiply, add and invert with the legacy \c Matrix, \c DynamicMatrix in an arena and fixed-size
+   //!        \c LinearAlgebra::Matrix
+   void benchmarkLinearAlgebra_data();
+   void benchmarkLinearAlgebra();
+
+   //! \brief Check \c SequenceDiff reuses unchanged items and turns changed ones into updates
+   void testSequenceDiff();
+
+   /**
+    * \brief Check \c Recipe::applyInstructions keeps instructions that are still right (and whether they were done),
+    *        updates changed ones in place, and only inserts and deletes the rest
+    */
+   void testApplyInstructions();
+
+   /**
+    * \brief Verify \c RecipeUncertainty bands collapse to the recipe's own values when nothing varies, only widen for
+    *        the outputs an input affects, and do not depend on the number of threads
+    */
+   void testRecipeUncertainty();
+
+   //! \brief 100,000 Monte Carlo samples of a recipe on one thread versus all available
+   void benchmarkRecipeUncertainty_data();
+   void benchmarkRecipeUncertainty();
+
+   /**
+    * \brief Check \c MashSimulation gives the same strike temperatures and volumes as the old mash designer maths,
+    *        that running a schedule forward reaches the step temperatures it was designed for, and that changing a step
+    *        gives the same result as simulating from scratch
+    */
+   void testMashSimulation();
+
+   //! \brief Slider drag in the mash designer: answering from a cached \c MashSimulation::Infusion versus
+   //!        re-simulating the schedule for every slider position
+   void benchmarkMashSimulation_data();
+   void benchmarkMashSimulation();
+
+   /**
+    * \brief Check \c FermentationCurve recovers the FG and finish time of a logistic fermentation from readings taken
+    *        part way through, that readings added out of order give the same fit as in order, and that readings
+    *        survive the round trip through a \c BrewNote and its stored form
+    */
+   void testFermentationCurve();
+
+   //! \brief Adding the latest of 1000 gravity readings: incremental fit versus refitting from scratch
+   void benchmarkFermentationCurve_data();
+   void benchmarkFermentationCurve();
+
+   /**
+    * \brief Check \c StyleMatch::Table ranks recipes against a style, and styles against a recipe, in the right order,
+    *        and stays right as rows are updated and removed
+    */
+   void testStyleMatch();
+
+   //! \brief Ranking 3000 recipes against a style: column-wise table versus scoring one recipe at a time
+   void benchmarkStyleMatch_data();
+   void benchmarkStyleMatch();
+
+   /**
+    * \brief Check \c RecipeSimilarity treats the same grist and hops in the same proportions as identical, however
+    *        they're scaled, spelled or split, and ranks other recipes by how much they have in common
+    */
+   void testRecipeSimilarity();
+
+   //! \brief Finding the 10 recipes nearest to one in a library of 10000: MinHash screening versus scoring them all
+   void benchmarkRecipeSimilarity_data();
+   void benchmarkRecipeSimilarity();
+
+   /**
+    * \brief Check \c BatchPlanning matches recipe ingredients to stock by inventory, then by name, adds up what the
+    *        whole queue needs, and gives stock to brews in queue order
+    */
+   void testBatchPlanning();
+
+   /**
+    * \brief Sorting a 2000-row hop table by amount: proxy sorting on \c BtTableModel::SortRole versus parsing the
+    *        displayed text back into amounts
+    */
+   void benchmarkHopSort_data();
+   void benchmarkHopSort();
+
+   /**
+    * \brief Check \c TextSearch::Index finds substrings case-insensitively in any field but never across two, and stays
+    *        right as texts are changed and removed
+    */
+   void testTextSearch();
+
+   //! \brief Typing "cascade" a letter at a time into a search of 20000 ingredients: trigram index versus a full scan
+   void benchmarkTextSearch_data();
+   void benchmarkTextSearch();
+
+   /**
+    * \brief Check \c BtTreeModel finds recipes, brew notes and folders in a 10000-recipe tree, and stops finding them
+    *        once they're removed
+    */
+   void testBtTreeModelLookup();
+
+   //! \brief Check \c BtTreeModel reuses a tooltip until the thing it describes changes or leaves the tree
+   void testBtTreeModelToolTips();
+
+   /**
+    * \brief Building the recipe tree for a database of 300 recipes with 3 brew notes each: adding brew notes when a
+    *        recipe is expanded versus expanding everything up front.  Also logs how many rows each way creates.
+    */
+   void benchmarkBtTreeModelLoad_data();
+   void benchmarkBtTreeModelLoad();
+
+   /**
+    * \brief Check adding or removing one hop in a recipe inserts or removes just that row of \c HopTableModel, and
+    *        that changes to rows reach the view as one \c dataChanged
+    */
+   void testTableModelRowUpdates();
+
+   /**
+    * \brief Check a change to one recipe property refreshes only the parts of the recipe tab that show it, and that
+    *        several changes before control gets back to the event loop are refreshed together, once
+    */
+   void testRecipeDisplayQueue();
+
+   /**
+    * \brief Scrolling a 2000-row hop table a row at a time, repainting 40 rows each step, with the display cache
+    *        kept between repaints versus emptied before each one.  Also logs the cache hit rate.
+    */
+   void benchmarkTableScroll_data();
+   void benchmarkTableScroll();
+
+   /**
+    * \brief Check \c Measurement::parseAmount reads numbers and unit names the way the regexp it replaced did, and that
+    *        \c Unit::findUnit gives the same units as \c Unit::getUnit
+    */
+   void testAmountParsing();
+
+   /**
+    * \brief Reading 1000 typed-in amounts with \c Measurement::parseAmount versus the regexp it replaced, and the
+    *        throughput of \c UnitSystem::qstringToSI as a whole
+    */
+   void benchmarkAmountParsing_data();
+   void benchmarkAmountParsing();
+
+   /**
+    * \brief Check \c Measurement::Quantity conversions agree with the corresponding \c Measurement::Units, and that
+    *        converting between different dimensions doesn't compile
+    */
+   void testStaticQuantities();
+
+   /**
+    * \brief Unit conversions in a tight loop (temperatures to Fahrenheit and grain bills to pounds per gallon, as in
+    *        the hydrometer correction and colour calculations), through \c Measurement::Quantity versus through
+    *        \c Measurement::Unit
+    */
+   void benchmarkStaticQuantities_data();
+   void benchmarkStaticQuantities();
+
    /**
     * \brief Verify the mechanism we use for looking up type info about a parameter in the "model" classes (ie
     *        \c NamedEntity and subclasses thereof).
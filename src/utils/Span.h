@@ -0,0 +1,117 @@
+/*
+ * utils/Span.h is part of Brewtarget, and is copyright the following
+ * authors 2023:
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_SPAN_H
+#define UTILS_SPAN_H
+#pragma once
+
+//
+// Use BtSpan::span rather than std::span directly.
+//
+// C++20 gives us std::span.  However, older versions of GCC (eg as shipped with Ubuntu 20.04 LTS) do not ship with the
+// new <span> header, so, for them, we supply the subset of std::span that we use.  Once we stop needing to support old
+// versions of GCC, BtSpan::span can just be replaced with std::span.
+//
+#include <cstddef>
+
+#if __has_include(<span>)
+
+#include <span>
+
+namespace BtSpan {
+   inline constexpr std::size_t dynamic_extent = std::dynamic_extent;
+
+   template<class T, std::size_t Extent = dynamic_extent> using span = std::span<T, Extent>;
+}
+
+#else
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace BtSpan {
+   inline constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+   template<class T, std::size_t Extent = dynamic_extent> class span {
+   public:
+      using element_type = T;
+      using value_type   = std::remove_cv_t<T>;
+      using size_type    = std::size_t;
+      using pointer      = T *;
+      using reference    = T &;
+      using iterator     = T *;
+      static constexpr std::size_t extent = Extent;
+
+      constexpr span() noexcept : m_data{nullptr}, m_size{0} {
+         return;
+      }
+
+      constexpr span(T * data, std::size_t const size) : m_data{data}, m_size{size} {
+         return;
+      }
+
+      constexpr span(T * first, T * last) : m_data{first}, m_size{static_cast<std::size_t>(last - first)} {
+         return;
+      }
+
+      //! Anything with contiguous storage and \c data() and \c size(), eg C array, \c std::vector, another span
+      template<class Container,
+               class = std::enable_if_t<
+                  std::is_convertible_v<std::remove_pointer_t<decltype(std::data(std::declval<Container &>()))> (*)[],
+                                        T (*)[]>
+               >>
+      constexpr span(Container && container) :
+         m_data{std::data(container)},
+         m_size{static_cast<std::size_t>(std::size(container))} {
+         return;
+      }
+
+      constexpr std::size_t size()  const noexcept { return this->m_size; }
+      constexpr bool        empty() const noexcept { return this->m_size == 0; }
+      constexpr T *         data()  const noexcept { return this->m_data; }
+      constexpr T *         begin() const noexcept { return this->m_data; }
+      constexpr T *         end()   const noexcept { return this->m_data + this->m_size; }
+      constexpr T &         front() const          { return this->m_data[0]; }
+      constexpr T &         back()  const          { return this->m_data[this->m_size - 1]; }
+
+      constexpr T & operator[](std::size_t const index) const {
+         return this->m_data[index];
+      }
+
+      constexpr span<T> first(std::size_t const count) const {
+         return span<T>{this->m_data, count};
+      }
+
+      constexpr span<T> last(std::size_t const count) const {
+         return span<T>{this->m_data + this->m_size - count, count};
+      }
+
+      constexpr span<T> subspan(std::size_t const offset, std::size_t const count = dynamic_extent) const {
+         return span<T>{this->m_data + offset, count == dynamic_extent ? this->m_size - offset : count};
+      }
+
+   private:
+      T * m_data;
+      std::size_t m_size;
+   };
+}
+
+#endif
+
+#endif
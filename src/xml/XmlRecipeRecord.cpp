@@ -21,6 +21,7 @@
 #include <cstring>
 #include <functional>
 
+#include "database/ObjectStoreWrapper.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Hop.h"
@@ -28,8 +29,13 @@
 #include "model/Style.h"
 #include "model/Water.h"
 #include "model/Yeast.h"
+#include "RecipeSimilarity.h"
 
 namespace {
+   // At least this similar, and we tell the user when they import a recipe
+   double constexpr nearDuplicateSimilarity = 0.9;
+   std::size_t constexpr maxNearDuplicatesReported = 3;
+
    //
    // To keep us on our toes, the various ingredients you might add to a recipe have different ways of specifying how
    // much to add and when to add them.  We'll use template specialisation to ensure we call the right member
@@ -149,6 +155,22 @@ XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_p
 
    this->addChildren<Instruction>();
 
+   //
+   // Exact duplicates have already been weeded out, but it's worth telling the user about near-duplicates -- eg the
+   // same recipe at a different batch size, or with a slightly different name -- so they can decide whether to keep
+   // both.
+   //
+   Recipe const & recipe = static_cast<Recipe const &>(*this->namedEntity);
+   for (RecipeSimilarity::Match const & match : RecipeSimilarityIndex::instance().nearest(recipe,
+                                                                                          maxNearDuplicatesReported,
+                                                                                          nearDuplicateSimilarity)) {
+      Recipe const * existing = ObjectStoreWrapper::getByIdRaw<Recipe>(match.id);
+      if (existing) {
+         userMessage << "\nRecipe \"" << recipe.name() << "\" is very similar to \"" << existing->name() << "\" (" <<
+            qRound(match.similarity * 100.0) << "% similar grist and hops)";
+      }
+   }
+
 
    // BrewNotes are a bit different than some of the other fields.  Each BrewNote relates to only one Recipe, but the
    // Recipe class does not (currently) have an interface for adding BrewNotes.  It suffices to tell each BrewNote what